@@ -5,6 +5,9 @@
 #include <Mesa/ConfigUtils.h>
 #include <Mesa/ConvertUtils.h>
 #include <Mesa/Exception.h>
+#include <Mesa/LookUpUtils.h>
+#include <Mesa/AccessTrace.h>
+#include <Mesa/MaterialFormat.h>
 
 struct Entry
 {
@@ -13,6 +16,7 @@ struct Entry
 	std::string m_Hash;
 	uint32_t m_Index;
 	uint32_t m_OriginalSize;
+	std::vector<unsigned char> mv_CompiledData; // Written to the archive instead of the original file if not empty
 
 	inline bool operator<(const Entry& e) const
 	{
@@ -1,6 +1,149 @@
 #include "Core.h"
 
-inline std::string PackData(const std::string& path, const std::string& targetPath)
+/*
+	Loads access trace recorded by the engine and converts it into order in which files were accessed.
+	Trace refers to entries by their archive and index so the lookup table from the previous build
+	is used to find the original file names. Files that were never accessed are not included.
+*/
+inline std::map<std::string, size_t> LoadAccessOrder(const std::string& tracePath)
+{
+	std::map<std::string, size_t> result;
+
+	if (!Mesa::FileUtils::FileExists(tracePath) || !Mesa::FileUtils::FileExists("lookup.csv"))
+		return result;
+
+	// Map archive name and index from the previous build to the original file name
+	std::map<std::pair<std::string, uint32_t>, std::string> fileNames;
+	for (const auto& entry : Mesa::LookUpUtils::LoadLookupTable())
+		fileNames[std::make_pair(entry.m_PackName, entry.m_Index)] = entry.m_OriginalName;
+
+	for (const auto& access : Mesa::AccessTrace::Load(tracePath))
+	{
+		auto it = fileNames.find(std::make_pair(Mesa::FileUtils::StripPathToFileName(access.m_PackPath), access.m_Index));
+		if (it == fileNames.end()) continue;
+
+		// Only the first access of every file matters
+		size_t order = result.size();
+		result.emplace(it->second, order);
+	}
+
+	LOG_F(INFO, "Loaded access order of %zu files from %s", result.size(), tracePath.c_str());
+
+	return result;
+}
+
+/*
+	Simulates reading files of one archive in order they were accessed in.
+	Returns number of seeks and number of bytes that had to be skipped over.
+*/
+inline std::pair<uint32_t, uint64_t> CountSeeks(const std::vector<Entry*>& v_Archive, const std::map<std::string, size_t>& accessOrder)
+{
+	// Calculate where each file lies in the archive
+	std::vector<const Entry*> v_Layout(v_Archive.begin(), v_Archive.end());
+	std::sort(v_Layout.begin(), v_Layout.end(), [](const Entry* a, const Entry* b) { return a->m_Index < b->m_Index; });
+
+	std::map<std::string, uint64_t> offsets;
+	uint64_t offset = 0;
+
+	for (const auto& entry : v_Layout)
+	{
+		offsets[entry->m_OriginalName] = offset;
+		offset += entry->m_OriginalSize;
+	}
+
+	// Collect accessed files in order they were accessed in
+	std::vector<const Entry*> v_Accessed;
+	for (const auto& entry : v_Archive)
+	{
+		if (accessOrder.find(entry->m_OriginalName) != accessOrder.end())
+			v_Accessed.push_back(entry);
+	}
+
+	std::sort(v_Accessed.begin(), v_Accessed.end(), [&](const Entry* a, const Entry* b) { return accessOrder.at(a->m_OriginalName) < accessOrder.at(b->m_OriginalName); });
+
+	uint32_t numSeeks = 0;
+	uint64_t bytesSkipped = 0;
+	uint64_t position = 0;
+
+	for (const auto& entry : v_Accessed)
+	{
+		uint64_t entryOffset = offsets[entry->m_OriginalName];
+
+		// Every read that doesn't start where the previous one ended requires a seek
+		if (entryOffset != position)
+		{
+			numSeeks++;
+			if (entryOffset > position) bytesSkipped += entryOffset - position;
+		}
+
+		position = entryOffset + entry->m_OriginalSize;
+	}
+
+	return std::make_pair(numSeeks, bytesSkipped);
+}
+
+/*
+	Reorders entries inside of every archive so that files are stored in order they were accessed in.
+	Files that were never accessed are placed after them in their original order.
+*/
+inline void ReorderEntries(std::vector<Entry>& v_Entries, const std::map<std::string, size_t>& accessOrder)
+{
+	if (accessOrder.empty()) return;
+
+	// Split entries into their respective archives
+	std::map<std::string, std::vector<Entry*>> archivesMap;
+	for (auto& entry : v_Entries)
+		archivesMap[entry.m_PackName].push_back(&entry);
+
+	for (auto& archive : archivesMap)
+	{
+		auto before = CountSeeks(archive.second, accessOrder);
+
+		auto rank = [&](const Entry* p_Entry)
+		{
+			auto it = accessOrder.find(p_Entry->m_OriginalName);
+			return it != accessOrder.end() ? it->second : std::numeric_limits<size_t>::max();
+		};
+
+		std::stable_sort(archive.second.begin(), archive.second.end(), [&](const Entry* a, const Entry* b)
+		{
+			if (rank(a) != rank(b)) return rank(a) < rank(b);
+			return a->m_Index < b->m_Index;
+		});
+
+		// Assign new indices according to new order
+		for (uint32_t i = 0; i < archive.second.size(); i++)
+			archive.second[i]->m_Index = i;
+
+		auto after = CountSeeks(archive.second, accessOrder);
+
+		LOG_F(INFO, "Reordered %s: %u seeks and %llu bytes skipped before, %u seeks and %llu bytes skipped after",
+			archive.first.c_str(), before.first, (unsigned long long)before.second, after.first, (unsigned long long)after.second);
+	}
+}
+
+/*
+	Compiles text materials into binary records so the engine doesn't have to parse them.
+	Size and hash of every entry are replaced with the ones of its compiled data.
+*/
+inline void CompileMaterials(std::vector<Entry>& v_Entries)
+{
+	for (auto& entry : v_Entries)
+	{
+		auto v_fileData = Mesa::FileUtils::ReadBinaryData(entry.m_OriginalName);
+
+		entry.mv_CompiledData = Mesa::MaterialFormat::Compile(Mesa::MaterialFormat::ParseText(v_fileData));
+		entry.m_OriginalSize = entry.mv_CompiledData.size();
+
+		std::stringstream hashStream;
+		hashStream << std::hex << Mesa::FileUtils::HashData(entry.mv_CompiledData) << std::dec;
+		entry.m_Hash = hashStream.str();
+	}
+
+	LOG_F(INFO, "Compiled %zu materials", v_Entries.size());
+}
+
+inline std::string PackData(const std::string& path, const std::string& targetPath, const std::map<std::string, size_t>& accessOrder, bool compileMaterials)
 {
 	std::ifstream file(path);
 
@@ -78,6 +221,12 @@ inline std::string PackData(const std::string& path, const std::string& targetPa
 		}
 	}
 
+	if (compileMaterials)
+		CompileMaterials(v_Entries);
+
+	// Store files in order the engine reads them
+	ReorderEntries(v_Entries, accessOrder);
+
 	// Split all entires into their respective archives
 	std::map<std::string, std::vector<Entry>> archivesMap;
 
@@ -186,6 +335,13 @@ inline std::string PackData(const std::string& path, const std::string& targetPa
 
 		for (const auto& entry : archive.second)
 		{
+			// Compiled entries are already in memory
+			if (!entry.mv_CompiledData.empty())
+			{
+				Mesa::FileUtils::AppendDataToFile(entry.m_PackName, entry.mv_CompiledData);
+				continue;
+			}
+
 			// Copy contents of the file into buffer
 			auto v_fileData = Mesa::FileUtils::ReadBinaryData(entry.m_OriginalName);
 			// Write buffer to archive
@@ -305,20 +461,23 @@ int main(void) try
 
 	std::string lookupData = std::string();
 
+	// Load order in which the engine accessed files (has to be done before lookup table is replaced)
+	std::map<std::string, size_t> accessOrder = LoadAccessOrder("access_trace.csv");
+
 	// Look for the file containing info on how to pack textures
 	if (Mesa::FileUtils::FileExists("textures.pcdef"))
 	{
 		LOG_F(INFO, "Packing textures...");
 		// Append generated lookup data to already existing data 
-		lookupData += PackData("textures.pcdef", Mesa::ConfigUtils::GetValueFromConfigCS("Path", "Texture"));
+		lookupData += PackData("textures.pcdef", Mesa::ConfigUtils::GetValueFromConfigCS("Path", "Texture"), accessOrder, false);
 	}
 
 	// Look for the file containing info on how to pack materials
 	if (Mesa::FileUtils::FileExists("materials.pcdef"))
 	{
 		LOG_F(INFO, "Packing materials...");
-		// Append generated lookup data to already existing data
-		lookupData += PackData("materials.pcdef", Mesa::ConfigUtils::GetValueFromConfigCS("Path", "Material"));
+		// Append generated lookup data to already existing data, materials are stored compiled
+		lookupData += PackData("materials.pcdef", Mesa::ConfigUtils::GetValueFromConfigCS("Path", "Material"), accessOrder, true);
 	}
 
 	// Look for the file containing info on how to pack directx shaders
@@ -326,7 +485,7 @@ int main(void) try
 	{
 		LOG_F(INFO, "Packing DirectX shaders...");
 		// Append generated lookup data to already existing data
-		lookupData += PackData("shaders_dx.pcdef", Mesa::ConfigUtils::GetValueFromConfigCS("Path", "Shader"));
+		lookupData += PackData("shaders_dx.pcdef", Mesa::ConfigUtils::GetValueFromConfigCS("Path", "Shader"), std::map<std::string, size_t>(), false);
 	}
 
 	// Look for the file containing info on how to pack models
@@ -334,7 +493,7 @@ int main(void) try
 	{
 		LOG_F(INFO, "Packing models...");
 		// Append generated lookup data to already existing data
-		lookupData += PackData("models.pcdef", Mesa::ConfigUtils::GetValueFromConfigCS("Path", "Model"));
+		lookupData += PackData("models.pcdef", Mesa::ConfigUtils::GetValueFromConfigCS("Path", "Model"), accessOrder, false);
 	}
 
 	// Generate lookup table that will be used for loading assets
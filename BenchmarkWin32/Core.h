@@ -0,0 +1,29 @@
+#pragma once
+#include <Mesa/Core.h>
+#include <Mesa/AsyncFileReader.h>
+#include <Mesa/Exception.h>
+#include <Mesa/FileUtils.h>
+
+/*
+	Pattern in which a benchmark reads the test file
+*/
+enum ReadPattern
+{
+	ReadPattern_Sequential = 0, // Chunks from the beginning to the end of the file, like a coalesced pack read
+	ReadPattern_Random = 1, // Chunks in shuffled order, like entries requested by different assets
+};
+
+/*
+	Result of reading the whole test file once
+*/
+struct ReadResult
+{
+	double m_Seconds = 0.0;
+	uint64_t m_Bytes = 0;
+	bool m_Success = true;
+
+	inline double GetMegabytesPerSecond() const
+	{
+		return m_Seconds > 0.0 ? (double)m_Bytes / (1024.0 * 1024.0) / m_Seconds : 0.0;
+	}
+};
\ No newline at end of file
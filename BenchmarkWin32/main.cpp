@@ -0,0 +1,170 @@
+#include "Core.h"
+
+// Name of the file read by the read benchmark
+static const std::string READ_FILE_NAME = "read_benchmark.bin";
+// Queue depths compared by the read benchmark
+static constexpr uint32_t READ_QUEUE_DEPTHS[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+/*
+	Creates test file of the given size filled with pseudo random bytes, an existing file is reused
+	if its size matches. File should be larger than memory of the machine to measure the disk
+	and not the file cache of the system.
+*/
+inline void PrepareReadFile(uint64_t size)
+{
+	std::optional<size_t> existingSize = Mesa::FileUtils::FileSizeSafe(READ_FILE_NAME);
+	if (existingSize.has_value() && existingSize.value() == size)
+		return;
+
+	LOG_F(INFO, "Creating %llu MiB test file %s...", (unsigned long long)(size >> 20), READ_FILE_NAME.c_str());
+
+	std::ofstream file(READ_FILE_NAME, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		throw Mesa::Exception();
+
+	std::mt19937 random(1);
+	std::vector<uint32_t> v_Chunk(1024 * 1024 / sizeof(uint32_t));
+
+	for (uint64_t written = 0; written < size; written += v_Chunk.size() * sizeof(uint32_t))
+	{
+		for (uint32_t& value : v_Chunk)
+			value = random();
+
+		uint64_t chunkSize = std::min<uint64_t>(v_Chunk.size() * sizeof(uint32_t), size - written);
+		file.write((const char*)v_Chunk.data(), chunkSize);
+	}
+
+	if (!file)
+		throw Mesa::Exception();
+}
+
+/*
+	Offsets of reads that together cover the whole file in the given pattern
+*/
+inline std::vector<uint64_t> PlanReads(uint64_t fileSize, uint32_t readSize, ReadPattern pattern)
+{
+	std::vector<uint64_t> v_Offsets;
+	for (uint64_t offset = 0; offset + readSize <= fileSize; offset += readSize)
+		v_Offsets.push_back(offset);
+
+	if (pattern == ReadPattern_Random)
+		std::shuffle(v_Offsets.begin(), v_Offsets.end(), std::mt19937(2));
+
+	return v_Offsets;
+}
+
+/*
+	Reads the planned chunks one by one with std::ifstream, which is how PackUtils read archives
+	before the async file reader
+*/
+inline ReadResult ReadWithStream(const std::vector<uint64_t>& v_Offsets, uint32_t readSize)
+{
+	ReadResult result;
+	std::vector<char> v_Buffer(readSize);
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::ifstream file(READ_FILE_NAME, std::ios::binary);
+	for (uint64_t offset : v_Offsets)
+	{
+		file.seekg(offset);
+		file.read(v_Buffer.data(), readSize);
+		result.m_Success &= (bool)file;
+		result.m_Bytes += file.gcount();
+	}
+
+	result.m_Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+/*
+	Submits every planned chunk to a new async file reader and waits until all of them complete
+*/
+inline ReadResult ReadWithReader(const std::vector<uint64_t>& v_Offsets, uint32_t readSize, Mesa::AsyncReadBackend backend, uint32_t queueDepth)
+{
+	ReadResult result;
+	Mesa::AsyncFileReader reader(backend, queueDepth, readSize);
+
+	size_t pendingReads = v_Offsets.size();
+	std::mutex resultMutex;
+	std::condition_variable pendingCondition;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (uint64_t offset : v_Offsets)
+	{
+		reader.Submit(READ_FILE_NAME, offset, readSize, [&](const Mesa::AsyncReadResult& read)
+		{
+			std::lock_guard<std::mutex> lock(resultMutex);
+			result.m_Success &= read.m_Success;
+			result.m_Bytes += read.m_BytesRead;
+			pendingReads--;
+			pendingCondition.notify_one();
+		});
+	}
+
+	std::unique_lock<std::mutex> lock(resultMutex);
+	pendingCondition.wait(lock, [&]() { return pendingReads == 0; });
+
+	result.m_Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	lock.unlock();
+
+	reader.CloseFile(READ_FILE_NAME);
+	return result;
+}
+
+inline void LogReadResult(const char* p_Name, uint32_t queueDepth, const ReadResult& result, const ReadResult& baseline)
+{
+	LOG_F(INFO, "%-16s depth %2u: %8.1f MiB/s (%.2fx ifstream)%s", p_Name, queueDepth, result.GetMegabytesPerSecond(),
+		result.GetMegabytesPerSecond() / std::max(baseline.GetMegabytesPerSecond(), 1e-9), result.m_Success ? "" : " FAILED");
+}
+
+/*
+	Compares throughput of the async file reader at every queue depth and with both of its backends
+	against sequential std::ifstream reads of the same chunks
+*/
+inline void RunReadBenchmark(uint64_t fileSize, uint32_t readSize)
+{
+	PrepareReadFile(fileSize);
+
+	for (ReadPattern pattern : { ReadPattern_Sequential, ReadPattern_Random })
+	{
+		std::vector<uint64_t> v_Offsets = PlanReads(fileSize, readSize, pattern);
+		LOG_F(INFO, "%s reads of %u KiB:", pattern == ReadPattern_Sequential ? "Sequential" : "Random", readSize >> 10);
+
+		ReadResult baseline = ReadWithStream(v_Offsets, readSize);
+		LOG_F(INFO, "%-16s          %8.1f MiB/s%s", "ifstream", baseline.GetMegabytesPerSecond(), baseline.m_Success ? "" : " FAILED");
+
+		for (uint32_t queueDepth : READ_QUEUE_DEPTHS)
+		{
+			LogReadResult("CompletionPort", queueDepth, ReadWithReader(v_Offsets, readSize, Mesa::AsyncReadBackend_CompletionPort, queueDepth), baseline);
+			LogReadResult("ThreadPool", queueDepth, ReadWithReader(v_Offsets, readSize, Mesa::AsyncReadBackend_ThreadPool, queueDepth), baseline);
+		}
+	}
+}
+
+/*
+	Usage:
+	BenchmarkWin32 read [file size in MiB] [read size in KiB]
+	Frames of the null renderer are measured by BM_NullFrame of MesaBenchmarks.
+*/
+int main(int argc, char** argv) try
+{
+	std::string mode = argc > 1 ? argv[1] : "";
+
+	if (mode == "read")
+	{
+		uint64_t fileSize = (argc > 2 ? std::stoull(argv[2]) : 1024) << 20;
+		uint32_t readSize = (uint32_t)(argc > 3 ? std::stoul(argv[3]) : 256) << 10;
+		RunReadBenchmark(fileSize, readSize);
+		return 0;
+	}
+
+	LOG_F(ERROR, "Usage: BenchmarkWin32 read [file size in MiB] [read size in KiB]");
+	return 1;
+}
+catch (Mesa::Exception& me)
+{
+	LOG_F(ERROR, "%s", me.what());
+	return 1;
+}
\ No newline at end of file
@@ -0,0 +1,295 @@
+#include <Mesa/BoundingVolumeTree.h>
+#include <Mesa/Camera.h>
+#include <Mesa/FrustumCuller.h>
+#include <Mesa/GameObject.h>
+#include <Mesa/SceneIndex.h>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace Mesa
+{
+	static constexpr float HALF_SIZE = 1000.0f; // Volumes are spread over a box of 2000 units
+	static constexpr float MOVE_DISTANCE = 5.0f; // Far enough to leave the enlarged box of a leaf
+
+	/*
+		Cubes with sizes from 1 to 8 units at random positions, always the same for a given count
+	*/
+	static std::vector<BoundingVolume> CreateVolumes(size_t count)
+	{
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> position(-HALF_SIZE, HALF_SIZE);
+		std::uniform_real_distribution<float> size(0.5f, 4.0f);
+
+		std::vector<BoundingVolume> v_Volumes(count);
+		for (BoundingVolume& volume : v_Volumes)
+		{
+			float extent = size(random);
+			volume.m_Center = glm::vec3(position(random), position(random), position(random));
+			volume.m_Extents = glm::vec3(extent);
+			volume.m_Radius = extent * 1.7320508f;
+		}
+		return v_Volumes;
+	}
+
+	static std::vector<uint32_t> CreateValues(size_t count)
+	{
+		std::vector<uint32_t> v_Values(count);
+		std::iota(v_Values.begin(), v_Values.end(), 0u);
+		return v_Values;
+	}
+
+	static void BM_BvhInsert(benchmark::State& state)
+	{
+		std::vector<BoundingVolume> v_Volumes = CreateVolumes(static_cast<size_t>(state.range(0)));
+
+		for (auto _ : state)
+		{
+			BoundingVolumeTree tree;
+			for (uint32_t i = 0; i < v_Volumes.size(); i++)
+				tree.Insert(v_Volumes[i], i);
+			benchmark::DoNotOptimize(tree.GetNumLeaves());
+
+			state.PauseTiming();
+			state.counters["height"] = static_cast<double>(tree.GetHeight());
+			tree.Clear();
+			state.ResumeTiming();
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_BvhInsert)->Arg(100000)->Arg(1000000)
+		->Unit(benchmark::kMillisecond)->UseRealTime();
+
+	static void BM_BvhBuild(benchmark::State& state)
+	{
+		std::vector<BoundingVolume> v_Volumes = CreateVolumes(static_cast<size_t>(state.range(0)));
+		std::vector<uint32_t> v_Values = CreateValues(v_Volumes.size());
+
+		BoundingVolumeTree tree;
+		for (auto _ : state)
+		{
+			tree.Build(v_Volumes, v_Values);
+			benchmark::DoNotOptimize(tree.GetNumLeaves());
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		state.counters["height"] = static_cast<double>(tree.GetHeight());
+	}
+	BENCHMARK(BM_BvhBuild)->Arg(100000)->Arg(1000000)
+		->Unit(benchmark::kMillisecond)->UseRealTime();
+
+	/*
+		Every iteration moves a tenth of the leaves out of their enlarged boxes, so each of them
+		is removed and inserted again with refits and rotations on the way to the root.
+		With the second argument set to 0 volumes stay inside their boxes, which only tests the margin.
+	*/
+	static void BM_BvhMove(benchmark::State& state)
+	{
+		std::vector<BoundingVolume> v_Volumes = CreateVolumes(static_cast<size_t>(state.range(0)));
+		float distance = state.range(1) ? MOVE_DISTANCE : 0.01f;
+
+		BoundingVolumeTree tree;
+		std::vector<uint32_t> v_Proxies(v_Volumes.size());
+		for (uint32_t i = 0; i < v_Volumes.size(); i++)
+			v_Proxies[i] = tree.Insert(v_Volumes[i], i);
+
+		std::mt19937 random(5);
+		size_t numMoves = v_Volumes.size() / 10;
+		size_t numReinserted = 0;
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < numMoves; i++)
+			{
+				size_t index = random() % v_Volumes.size();
+				v_Volumes[index].m_Center.x += (random() % 2) ? distance : -distance;
+				numReinserted += tree.Move(v_Proxies[index], v_Volumes[index]);
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * numMoves);
+		state.counters["reinserted"] = benchmark::Counter(static_cast<double>(numReinserted), benchmark::Counter::kAvgIterations);
+		state.counters["height"] = static_cast<double>(tree.GetHeight());
+	}
+	BENCHMARK(BM_BvhMove)->ArgsProduct({ { 100000, 1000000 }, { 0, 1 } })
+		->Unit(benchmark::kMillisecond)->UseRealTime();
+
+	/*
+		Update of the scene index after the given percentage of objects moved. A quarter or more
+		rebuilds the tree in parallel, fewer moves are applied to the tree one by one.
+	*/
+	static void BM_SceneIndexUpdate(benchmark::State& state)
+	{
+		std::vector<BoundingVolume> v_Volumes = CreateVolumes(static_cast<size_t>(state.range(0)));
+		float points[6] = { -1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+		BoundingVolume modelBounds = BoundingVolume::FromPoints(points, 2, 3 * sizeof(float));
+		auto getModelBounds = [&modelBounds](uint32_t) { return &modelBounds; };
+
+		std::vector<GameObject3D> v_Objects(v_Volumes.size());
+		SceneIndex index;
+		for (size_t i = 0; i < v_Objects.size(); i++)
+		{
+			v_Objects[i].SetModel(1);
+			v_Objects[i].SetPosition(v_Volumes[i].m_Center);
+			index.Insert(&v_Objects[i]);
+		}
+		index.Update(getModelBounds);
+
+		std::mt19937 random(5);
+		size_t numMoves = v_Objects.size() * static_cast<size_t>(state.range(1)) / 100;
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			for (size_t i = 0; i < numMoves; i++)
+			{
+				size_t index = random() % v_Objects.size();
+				v_Volumes[index].m_Center.x += (random() % 2) ? MOVE_DISTANCE : -MOVE_DISTANCE;
+				v_Objects[index].SetPosition(v_Volumes[index].m_Center);
+			}
+			state.ResumeTiming();
+
+			index.Update(getModelBounds);
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		state.counters["height"] = static_cast<double>(index.GetTree().GetHeight());
+	}
+	BENCHMARK(BM_SceneIndexUpdate)->ArgsProduct({ { 100000, 1000000 }, { 1, 10, 50 } })
+		->Unit(benchmark::kMillisecond)->UseRealTime();
+
+	/*
+		Queries run on a tree built from the volumes, results are counted as items
+	*/
+	static void BM_BvhQueryFrustum(benchmark::State& state)
+	{
+		std::vector<BoundingVolume> v_Volumes = CreateVolumes(static_cast<size_t>(state.range(0)));
+		BoundingVolumeTree tree;
+		tree.Build(v_Volumes, CreateValues(v_Volumes.size()));
+
+		// Camera in the middle of the scene that sees up to a fifth of its size
+		CameraNull camera;
+		camera.SetProjectionValues(90.0f, 16.0f / 9.0f, 0.1f, 0.2f * HALF_SIZE);
+		FrustumCuller culler;
+		culler.SetViewProjection(camera.GetViewProjectionMatrix());
+
+		std::vector<uint32_t> v_Results;
+		size_t numResults = 0;
+		for (auto _ : state)
+		{
+			v_Results.clear();
+			tree.QueryFrustum(culler.GetPlanes(), v_Results);
+			numResults += v_Results.size();
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(numResults));
+		state.counters["results"] = benchmark::Counter(static_cast<double>(numResults), benchmark::Counter::kAvgIterations);
+	}
+	BENCHMARK(BM_BvhQueryFrustum)->Arg(100000)->Arg(1000000)
+		->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+	static void BM_BvhQueryBox(benchmark::State& state)
+	{
+		std::vector<BoundingVolume> v_Volumes = CreateVolumes(static_cast<size_t>(state.range(0)));
+		BoundingVolumeTree tree;
+		tree.Build(v_Volumes, CreateValues(v_Volumes.size()));
+
+		std::mt19937 random(3);
+		std::uniform_real_distribution<float> position(-HALF_SIZE, HALF_SIZE);
+		std::vector<uint32_t> v_Results;
+		size_t numResults = 0;
+		for (auto _ : state)
+		{
+			glm::vec3 center(position(random), position(random), position(random));
+			BoundingVolumeTree::Box box;
+			box.m_Min = center - glm::vec3(50.0f);
+			box.m_Max = center + glm::vec3(50.0f);
+
+			v_Results.clear();
+			tree.QueryBox(box, v_Results);
+			numResults += v_Results.size();
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(numResults));
+		state.counters["results"] = benchmark::Counter(static_cast<double>(numResults), benchmark::Counter::kAvgIterations);
+	}
+	BENCHMARK(BM_BvhQueryBox)->Arg(100000)->Arg(1000000)
+		->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+	static void BM_BvhQuerySphere(benchmark::State& state)
+	{
+		std::vector<BoundingVolume> v_Volumes = CreateVolumes(static_cast<size_t>(state.range(0)));
+		BoundingVolumeTree tree;
+		tree.Build(v_Volumes, CreateValues(v_Volumes.size()));
+
+		std::mt19937 random(3);
+		std::uniform_real_distribution<float> position(-HALF_SIZE, HALF_SIZE);
+		std::vector<uint32_t> v_Results;
+		size_t numResults = 0;
+		for (auto _ : state)
+		{
+			v_Results.clear();
+			tree.QuerySphere(glm::vec3(position(random), position(random), position(random)), 50.0f, v_Results);
+			numResults += v_Results.size();
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(numResults));
+		state.counters["results"] = benchmark::Counter(static_cast<double>(numResults), benchmark::Counter::kAvgIterations);
+	}
+	BENCHMARK(BM_BvhQuerySphere)->Arg(100000)->Arg(1000000)
+		->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+	/*
+		Rays start at random points and cross the whole scene, leaves are tested with the slab test
+		of their boxes like in SceneIndex::RayCast()
+	*/
+	static void BM_BvhRayCast(benchmark::State& state)
+	{
+		std::vector<BoundingVolume> v_Volumes = CreateVolumes(static_cast<size_t>(state.range(0)));
+		BoundingVolumeTree tree;
+		tree.Build(v_Volumes, CreateValues(v_Volumes.size()));
+
+		glm::vec3 origin(0.0f);
+		glm::vec3 invDirection(0.0f);
+		auto testLeaf = [&v_Volumes, &origin, &invDirection](uint32_t value, float maxDistance)
+		{
+			const BoundingVolume& bounds = v_Volumes[value];
+
+			float enter = 0.0f;
+			float exit = maxDistance;
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float t1 = (bounds.m_Center[axis] - bounds.m_Extents[axis] - origin[axis]) * invDirection[axis];
+				float t2 = (bounds.m_Center[axis] + bounds.m_Extents[axis] - origin[axis]) * invDirection[axis];
+
+				if (t1 != t1 || t2 != t2) continue;
+
+				enter = std::max(enter, std::min(t1, t2));
+				exit = std::min(exit, std::max(t1, t2));
+			}
+
+			return enter <= exit ? enter : -1.0f;
+		};
+
+		std::mt19937 random(3);
+		std::uniform_real_distribution<float> position(-HALF_SIZE, HALF_SIZE);
+		std::normal_distribution<float> direction(0.0f, 1.0f);
+		size_t numHits = 0;
+		for (auto _ : state)
+		{
+			origin = glm::vec3(position(random), position(random), position(random));
+			glm::vec3 dir = glm::normalize(glm::vec3(direction(random), direction(random), direction(random)));
+			invDirection = glm::vec3(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+
+			uint32_t value = 0;
+			float distance = 0.0f;
+			numHits += tree.RayCast(origin, dir, 4.0f * HALF_SIZE, testLeaf, value, distance);
+		}
+
+		state.SetItemsProcessed(state.iterations());
+		state.counters["hits"] = benchmark::Counter(static_cast<double>(numHits), benchmark::Counter::kAvgIterations);
+	}
+	BENCHMARK(BM_BvhRayCast)->Arg(100000)->Arg(1000000)
+		->Unit(benchmark::kMicrosecond)->UseRealTime();
+}
\ No newline at end of file
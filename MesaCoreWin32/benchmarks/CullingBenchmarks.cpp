@@ -0,0 +1,107 @@
+#include <Mesa/Camera.h>
+#include <Mesa/FrustumCuller.h>
+#include <Mesa/GameObject.h>
+#include <Mesa/SceneIndex.h>
+#include <benchmark/benchmark.h>
+#include <random>
+
+namespace Mesa
+{
+	/*
+		Scene of unit cubes spread over a box of 2000 units, the camera in the middle looks along +z
+		with 90 degree field of view, so roughly a quarter of the objects is in front of it.
+	*/
+	struct CullScene
+	{
+		static constexpr float HALF_SIZE = 1000.0f;
+
+		std::vector<GameObject3D> v_Objects;
+		std::vector<glm::mat4x4> v_Worlds;
+		std::vector<BoundingVolume> v_Bounds;
+		BoundingVolume m_ModelBounds;
+		CameraNull m_Camera;
+
+		explicit CullScene(size_t numObjects) : v_Objects(numObjects), v_Worlds(numObjects)
+		{
+			float points[6] = { -1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+			m_ModelBounds = BoundingVolume::FromPoints(points, 2, 3 * sizeof(float));
+			v_Bounds.assign(numObjects, m_ModelBounds);
+
+			std::mt19937 random(7);
+			std::uniform_real_distribution<float> position(-HALF_SIZE, HALF_SIZE);
+			std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+			for (size_t i = 0; i < numObjects; i++)
+			{
+				v_Objects[i].SetModel(1);
+				v_Objects[i].SetPosition(glm::vec3(position(random), position(random), position(random)));
+				v_Objects[i].SetRotation(glm::vec3(angle(random), angle(random), 0.0f));
+				v_Worlds[i] = v_Objects[i].GetWorldMatrix();
+			}
+
+			m_Camera.SetProjectionValues(90.0f, 16.0f / 9.0f, 0.1f, 2.0f * HALF_SIZE);
+		}
+	};
+
+	/*
+		Exact test of every object against the frustum, which is what backends did before the scene index.
+	*/
+	static void BM_FrustumCullerCull(benchmark::State& state)
+	{
+		CullScene scene(static_cast<size_t>(state.range(0)));
+		FrustumCuller culler;
+		culler.SetViewProjection(scene.m_Camera.GetViewProjectionMatrix());
+
+		std::vector<uint8_t> v_Visible;
+		for (auto _ : state)
+		{
+			culler.Cull(scene.v_Worlds, scene.v_Bounds, v_Visible);
+			benchmark::DoNotOptimize(v_Visible.data());
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		state.counters["visible"] = static_cast<double>(culler.GetStatistics().m_NumVisible);
+	}
+	BENCHMARK(BM_FrustumCullerCull)->Arg(100000)->Arg(1000000)
+		->Unit(benchmark::kMillisecond)->UseRealTime();
+
+	/*
+		Path used by the backends: candidates from the scene index, then the exact test of the candidates only.
+	*/
+	static void BM_SceneIndexCull(benchmark::State& state)
+	{
+		CullScene scene(static_cast<size_t>(state.range(0)));
+		SceneIndex index;
+		for (GameObject3D& object : scene.v_Objects)
+			index.Insert(&object);
+		index.Update([&scene](uint32_t) { return &scene.m_ModelBounds; });
+
+		FrustumCuller culler;
+		culler.SetViewProjection(scene.m_Camera.GetViewProjectionMatrix());
+
+		std::vector<GameObject3D*> v_Candidates;
+		std::vector<glm::mat4x4> v_Worlds;
+		std::vector<BoundingVolume> v_Bounds;
+		std::vector<uint8_t> v_Visible;
+		for (auto _ : state)
+		{
+			v_Candidates.clear();
+			index.QueryFrustum(culler.GetPlanes(), v_Candidates);
+
+			v_Worlds.clear();
+			v_Bounds.clear();
+			for (const GameObject3D* p_Object : v_Candidates)
+			{
+				v_Worlds.push_back(p_Object->GetWorldMatrix());
+				v_Bounds.push_back(scene.m_ModelBounds);
+			}
+			culler.Cull(v_Worlds, v_Bounds, v_Visible);
+			benchmark::DoNotOptimize(v_Visible.data());
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		state.counters["candidates"] = static_cast<double>(v_Candidates.size());
+		state.counters["visible"] = static_cast<double>(culler.GetStatistics().m_NumVisible);
+	}
+	BENCHMARK(BM_SceneIndexCull)->Arg(100000)->Arg(1000000)
+		->Unit(benchmark::kMillisecond)->UseRealTime();
+}
\ No newline at end of file
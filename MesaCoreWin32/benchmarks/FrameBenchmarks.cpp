@@ -0,0 +1,82 @@
+#include "TestAssets.h"
+#include <Mesa/GraphicsNull.h>
+#include <Mesa/JobSystem.h>
+#include <benchmark/benchmark.h>
+
+namespace Mesa
+{
+	/*
+		Draws frames of the null renderer while the default job system is limited to 1, 2, ... up to all
+		of its workers, the main thread helps the workers in every case. Objects fill a cube around the camera,
+		every frame turns the camera a little and moves a hundredth of the objects, so culling, the scene index
+		and the render queue have new work in every frame.
+	*/
+	static void BM_NullFrame(benchmark::State& state)
+	{
+		static constexpr uint32_t NUM_OBJECTS = 100000;
+
+		TestAssets assets("MesaFrameBenchmarks");
+		GraphicsNull graphics;
+
+		uint32_t modelId = graphics.LoadModelFromPack(TestAssets::MODEL_NAME);
+		uint32_t shaderId = graphics.CompileForwardShaderFromPack(TestAssets::VERTEX_SHADER_NAME);
+		if (modelId == 0 || shaderId == 0)
+		{
+			state.SkipWithError("Could not load test assets");
+			return;
+		}
+
+		CameraNull camera;
+		camera.SetProjectionValues(60.0f, 16.0f / 9.0f, 0.01f, 1000.0f);
+		graphics.SetCamera(&camera);
+
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+		std::vector<GameObject3D> v_Objects(NUM_OBJECTS);
+		std::vector<glm::vec3> v_Positions(NUM_OBJECTS);
+
+		for (uint32_t i = 0; i < NUM_OBJECTS; i++)
+		{
+			v_Positions[i] = glm::vec3(position(random), position(random), position(random));
+			v_Objects[i].SetModel(modelId);
+			v_Objects[i].SetColorShader(shaderId);
+			v_Objects[i].SetSpecularShader(shaderId);
+			v_Objects[i].SetPosition(v_Positions[i]);
+			graphics.InsertGameObject(&v_Objects[i]);
+		}
+
+		JobSystem& jobSystem = JobSystem::GetDefault();
+		jobSystem.SetNumActiveWorkers(static_cast<uint32_t>(state.range(0)));
+
+		auto drawFrame = [&]()
+		{
+			camera.AdjustRotation(glm::vec3(0.0f, 0.01f, 0.0f));
+
+			for (uint32_t i = 0; i < NUM_OBJECTS / 100; i++)
+			{
+				uint32_t index = random() % NUM_OBJECTS;
+				v_Positions[index].y += (random() % 2) ? 1.0f : -1.0f;
+				v_Objects[index].SetPosition(v_Positions[index]);
+			}
+
+			graphics.DrawFrame(nullptr);
+		};
+
+		// First frames fill the scene index and grow buffers, they are not measured
+		for (uint32_t i = 0; i < 10; i++)
+			drawFrame();
+
+		for (auto _ : state)
+			drawFrame();
+
+		state.counters["workers"] = static_cast<double>(jobSystem.GetNumActiveWorkers());
+		state.counters["instances"] = static_cast<double>(graphics.GetFrameStatistics().m_NumInstances);
+
+		jobSystem.SetNumActiveWorkers(jobSystem.GetNumWorkers());
+	}
+	BENCHMARK(BM_NullFrame)->Apply([](benchmark::internal::Benchmark* p_Benchmark)
+	{
+		for (uint32_t numWorkers = 1; numWorkers <= JobSystem::GetDefault().GetNumWorkers(); numWorkers++)
+			p_Benchmark->Arg(numWorkers);
+	})->Unit(benchmark::kMillisecond)->UseRealTime();
+}
\ No newline at end of file
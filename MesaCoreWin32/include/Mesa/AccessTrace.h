@@ -0,0 +1,46 @@
+#pragma once
+#include "Core.h"
+
+namespace Mesa
+{
+	/*
+		Single archive entry access recorded during a run
+	*/
+	struct AccessTraceEntry
+	{
+		std::string m_PackPath; // Path to the archive that holds the entry
+		uint32_t m_Index = 0; // Index of the entry inside of the archive
+		uint32_t m_Time = 0; // Time of the first access in milliseconds (relative to the start of recording)
+	};
+
+	class MSAPI AccessTrace
+	{
+	private:
+		AccessTrace();
+		~AccessTrace();
+
+	public:
+		static void Start();
+		static void Stop();
+		static bool IsRecording();
+		static void Record(const std::string& packPath, uint32_t index);
+		static void RecordRead(uint64_t bytes, double milliseconds);
+		static bool Save(const std::string& path);
+		static std::vector<AccessTraceEntry> Load(const std::string& path);
+		static void WriteStartupReport(const std::string& path, bool prefetched);
+
+	private:
+		std::vector<AccessTraceEntry> mv_Entries;
+		std::set<std::pair<std::string, uint32_t>> m_RecordedEntries; // Used to keep only the first access of every entry
+		std::chrono::steady_clock::time_point m_StartTime;
+		bool m_Recording = false;
+
+		// Statistics of reads performed while recording
+		uint64_t m_BytesRead = 0;
+		double m_ReadTime = 0.0; // Time spent waiting for reads in milliseconds
+		uint32_t m_LastReadTime = 0; // Time of the last completed read in milliseconds
+
+		std::mutex m_Mutex;
+		static AccessTrace m_AccessTrace;
+	};
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "Core.h"
 #include "Window.h"
 #include "Graphics.h"
+#include "Prefetcher.h"
 
 namespace Mesa
 {
@@ -14,8 +15,14 @@ namespace Mesa
 		virtual void Run() = 0;
 
 	protected:
-		Window* mp_Window = nullptr;
+		bool Update();
+		float GetAspectRatio() const;
+
+	protected:
+		Window* mp_Window = nullptr; // Null when running without window (null renderer)
 		Graphics* mp_Graphics = nullptr;
+		Prefetcher* mp_Prefetcher = nullptr;
+		uint64_t m_NumHeadlessFrames = 0;
 	};
 
 	// Needs to be defined in SandboxWin32
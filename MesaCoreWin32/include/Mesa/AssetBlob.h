@@ -0,0 +1,37 @@
+#pragma once
+#include "Core.h"
+
+namespace Mesa
+{
+	// Read-only bytes borrowed for the duration of a call
+	using ByteView = std::span<const uint8_t>;
+
+	/*
+		Immutable bytes of an asset shared by reference counting.
+		Blob either owns a buffer that was moved into it or keeps a read-only mapping of a file alive.
+		Copying a blob or taking a slice of it never copies the bytes, so one buffer can be passed
+		through the whole loading chain and its memory is released with the last blob that refers to it.
+	*/
+	class MSAPI AssetBlob
+	{
+	public:
+		AssetBlob() = default;
+
+		static AssetBlob FromVector(std::vector<uint8_t>&& v_Data);
+		static AssetBlob MapFile(const std::string& path);
+
+		AssetBlob Slice(uint64_t offset, uint64_t size) const;
+
+		inline const uint8_t* GetData() const noexcept { return mp_Data; }
+		inline size_t GetSize() const noexcept { return m_Size; }
+		inline bool IsEmpty() const noexcept { return m_Size == 0; }
+
+		inline ByteView GetView() const noexcept { return ByteView(mp_Data, m_Size); }
+		inline operator ByteView() const noexcept { return GetView(); }
+
+	private:
+		std::shared_ptr<const void> mp_Owner; // Keeps the buffer or the mapping alive
+		const uint8_t* mp_Data = nullptr;
+		size_t m_Size = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include "Core.h"
+#include "AssetBlob.h"
+
+namespace Mesa
+{
+	/*
+		Persistent cache of processed asset data (e.g. decoded textures or imported meshes).
+		Entries are addressed by content: key is made of CRC32C and size of the source data together
+		with the kind and version of the processor, so changed data or an updated processor never
+		hits a stale entry and unchanged data is never processed twice, even across launches.
+		When the cache grows over its size limit the least recently used entries are deleted.
+	*/
+	class MSAPI AssetCache
+	{
+	private:
+		struct CacheEntry
+		{
+			uint64_t m_Size = 0; // Size of the file in bytes
+			uint64_t m_LastUsed = 0; // Larger value means more recent use
+		};
+
+	public:
+		AssetCache(const std::string& directory, uint64_t maxSize);
+
+		static AssetCache& GetDefault();
+		static std::string MakeKey(const std::string& kind, uint32_t version, ByteView sourceData);
+
+		bool Load(const std::string& key, std::vector<uint8_t>& v_OutData);
+		void Store(const std::string& key, const std::vector<uint8_t>& v_Data);
+
+		inline bool IsEnabled() const noexcept { return m_MaxSize > 0; }
+		inline uint64_t GetNumHits() const noexcept { return m_NumHits; }
+		inline uint64_t GetNumMisses() const noexcept { return m_NumMisses; }
+
+	private:
+		std::string GetEntryPath(const std::string& key) const;
+		void Trim();
+
+	private:
+		std::string m_Directory;
+		uint64_t m_MaxSize = 0; // 0 disables the cache
+
+		std::map<std::string, CacheEntry> m_Entries;
+		uint64_t m_Size = 0; // Total size of all entries
+		uint64_t m_UseCounter = 0;
+		std::mutex m_Mutex;
+
+		std::atomic<uint64_t> m_NumHits = 0;
+		std::atomic<uint64_t> m_NumMisses = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#pragma once
+#include "Core.h"
+#include "Exception.h"
+
+namespace Mesa
+{
+	enum AssetState : uint32_t
+	{
+		AssetState_Pending = 0, // Asset is still being loaded
+		AssetState_Ready = 1, // Asset finished loading, its value can be read
+		AssetState_Failed = 2, // Loading threw an exception
+		AssetState_Cancelled = 3, // Loading was cancelled before it finished
+	};
+
+	/*
+		Thrown inside of a load coroutine when it resumes after its handle was cancelled.
+	*/
+	class AssetLoadCancelled : public Exception
+	{
+	public:
+		AssetLoadCancelled(std::source_location loc = std::source_location::current())
+			: Exception(loc)
+		{}
+
+		const char* what() const noexcept override { return "Asset load was cancelled"; }
+	};
+
+	/*
+		Result of an asynchronous asset load.
+		Functions that return AssetHandle are coroutines, they start immediately and return
+		the handle on their first suspension. Handle can be polled every frame with IsReady()
+		or awaited with co_await from another coroutine. Copies of a handle share the same load.
+	*/
+	template<typename T>
+	class AssetHandle
+	{
+	private:
+		struct SharedState
+		{
+			std::mutex m_Mutex;
+			AssetState m_State = AssetState_Pending;
+			T m_Value = T();
+			std::vector<std::coroutine_handle<>> mv_Waiters; // Coroutines that wait for the load
+			std::atomic<bool> m_CancelRequested = false;
+		};
+
+		// Wraps awaitables used inside of a load so it stops at the first suspension point after being cancelled
+		template<typename Awaitable>
+		struct CancellableAwaiter
+		{
+			Awaitable m_Awaitable;
+			SharedState* mp_State;
+
+			bool await_ready()
+			{
+				// Skip suspending at all and throw from await_resume()
+				if (mp_State->m_CancelRequested) return true;
+				return m_Awaitable.await_ready();
+			}
+
+			template<typename Promise>
+			auto await_suspend(std::coroutine_handle<Promise> handle) { return m_Awaitable.await_suspend(handle); }
+
+			decltype(auto) await_resume()
+			{
+				if (mp_State->m_CancelRequested) throw AssetLoadCancelled();
+				return m_Awaitable.await_resume();
+			}
+		};
+
+	public:
+		struct promise_type
+		{
+			std::shared_ptr<SharedState> mp_State = std::make_shared<SharedState>();
+			AssetState m_Result = AssetState_Failed;
+			T m_Value = T();
+
+			// Publishes the result after the coroutine frame is destroyed so waiters can't outlive it
+			struct FinalAwaiter
+			{
+				bool await_ready() const noexcept { return false; }
+				void await_resume() const noexcept {}
+
+				void await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+				{
+					std::shared_ptr<SharedState> p_State = handle.promise().mp_State;
+					AssetState result = handle.promise().m_Result;
+					T value = std::move(handle.promise().m_Value);
+
+					handle.destroy();
+
+					std::vector<std::coroutine_handle<>> v_Waiters;
+
+					{
+						std::lock_guard<std::mutex> lock(p_State->m_Mutex);
+						p_State->m_State = result;
+						p_State->m_Value = std::move(value);
+						v_Waiters.swap(p_State->mv_Waiters);
+					}
+
+					for (auto waiter : v_Waiters)
+						waiter.resume();
+				}
+			};
+
+			AssetHandle get_return_object() { return AssetHandle(mp_State); }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			FinalAwaiter final_suspend() noexcept { return {}; }
+
+			void return_value(T value)
+			{
+				m_Value = std::move(value);
+				m_Result = AssetState_Ready;
+			}
+
+			void unhandled_exception()
+			{
+				try
+				{
+					throw;
+				}
+				catch (const AssetLoadCancelled&)
+				{
+					m_Result = AssetState_Cancelled;
+				}
+				catch (const std::exception& e)
+				{
+					LOG_F(ERROR, "Asset load failed: %s", e.what());
+					m_Result = AssetState_Failed;
+				}
+			}
+
+			template<typename Awaitable>
+			auto await_transform(Awaitable&& awaitable)
+			{
+				return CancellableAwaiter<std::decay_t<Awaitable>>{ std::forward<Awaitable>(awaitable), mp_State.get() };
+			}
+		};
+
+	public:
+		AssetHandle() = default;
+
+		inline bool IsValid() const noexcept { return mp_State != nullptr; }
+		inline bool IsReady() const { return GetState() != AssetState_Pending; }
+		inline bool IsCancelled() const { return GetState() == AssetState_Cancelled; }
+		inline bool IsCancelRequested() const noexcept { return mp_State && mp_State->m_CancelRequested; }
+
+		AssetState GetState() const
+		{
+			if (!mp_State) return AssetState_Failed;
+
+			std::lock_guard<std::mutex> lock(mp_State->m_Mutex);
+			return mp_State->m_State;
+		}
+
+		/*
+			Returns loaded value or default value of T if the asset isn't ready or failed to load.
+		*/
+		T Get() const
+		{
+			if (!mp_State) return T();
+
+			std::lock_guard<std::mutex> lock(mp_State->m_Mutex);
+			return mp_State->m_State == AssetState_Ready ? mp_State->m_Value : T();
+		}
+
+		/*
+			Requests cancellation of the load. Load stops the next time it's about to suspend,
+			so work that has already started (e.g. a read or decode) is finished first.
+			Every copy of the handle sees the load as cancelled.
+		*/
+		void Cancel()
+		{
+			if (mp_State) mp_State->m_CancelRequested = true;
+		}
+
+	public: // Awaiting from another coroutine
+		bool await_ready() const { return IsReady(); }
+
+		bool await_suspend(std::coroutine_handle<> waiter)
+		{
+			std::lock_guard<std::mutex> lock(mp_State->m_Mutex);
+
+			// Load could have finished since await_ready() was called
+			if (mp_State->m_State != AssetState_Pending) return false;
+
+			mp_State->mv_Waiters.push_back(waiter);
+			return true;
+		}
+
+		T await_resume() const { return Get(); }
+
+	private:
+		AssetHandle(std::shared_ptr<SharedState> p_State)
+			: mp_State(std::move(p_State))
+		{}
+
+	private:
+		std::shared_ptr<SharedState> mp_State;
+	};
+}
\ No newline at end of file
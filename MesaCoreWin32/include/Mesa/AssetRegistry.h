@@ -0,0 +1,386 @@
+#pragma once
+#include "Core.h"
+
+namespace Mesa
+{
+	struct AssetRegistryStatistics
+	{
+		uint64_t m_NumAssets = 0;
+		uint64_t m_NumBytes = 0;
+		uint64_t m_Budget = 0; // 0 if the registry has no budget
+		uint64_t m_NumEvictions = 0;
+		uint64_t m_NumEvictedBytes = 0;
+		uint64_t m_NumReloads = 0; // Assets that were loaded again after being evicted
+	};
+
+	/*
+		Storage for loaded assets of one kind.
+		Assets are identified by 32-bit handles made of a slot index and a generation of the slot,
+		so handle of a removed asset never resolves to an asset that reused its slot. 0 is never a valid handle.
+		Slots are allocated in chunks that never move, which lets any thread resolve handles without
+		locking while loading threads insert new assets. Pointer returned by Get() stays valid until
+		the asset is removed, so assets should only be removed by the thread that renders them.
+		Every asset has a reference count and size in bytes. When the registry exceeds its budget
+		assets without references are evicted, starting with the least recently used one.
+	*/
+	template<typename T>
+	class AssetRegistry
+	{
+	private:
+		static constexpr uint32_t INDEX_BITS = 20; // Lower bits of a handle hold the slot index, upper bits its generation
+		static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+		static constexpr uint32_t MAX_GENERATION = (1u << (32 - INDEX_BITS)) - 1;
+		static constexpr uint32_t CHUNK_SIZE = 256;
+		static constexpr uint32_t MAX_CHUNKS = (INDEX_MASK + 1) / CHUNK_SIZE;
+
+		struct Slot
+		{
+			T m_Value = T();
+			std::atomic<uint32_t> m_Handle = 0; // Handle of the asset stored in the slot or 0 if the slot is free
+			uint32_t m_Generation = 0; // Generation of the last asset that was stored in the slot
+			uint32_t m_DenseIndex = 0; // Position of the slot in mv_Dense
+			std::string m_Name;
+
+			std::atomic<uint32_t> m_RefCount = 0;
+			std::atomic<uint64_t> m_LastUsed = 0; // Frame in which the asset was used for the last time
+			uint64_t m_NumBytes = 0;
+		};
+
+	public:
+		AssetRegistry() = default;
+		AssetRegistry(const AssetRegistry&) = delete;
+		AssetRegistry& operator=(const AssetRegistry&) = delete;
+
+		~AssetRegistry()
+		{
+			for (auto& p_Chunk : ma_Chunks)
+				delete[] p_Chunk.load();
+		}
+
+		/*
+			Adds asset under specified name and returns its handle. Asset starts without references.
+			assignHandle(value, handle) is called before the asset becomes visible to other threads,
+			so the asset can keep its own handle. Returns 0 if asset with the same name is already registered.
+		*/
+		template<typename AssignHandle>
+		uint32_t Insert(const std::string& name, T value, uint64_t numBytes, AssignHandle&& assignHandle)
+		{
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+
+			// Names are only modified while the write mutex is locked
+			if (!name.empty() && m_Names.find(name) != m_Names.end()) return 0;
+
+			uint32_t index = 0;
+
+			if (!mv_FreeSlots.empty())
+			{
+				index = mv_FreeSlots.back();
+				mv_FreeSlots.pop_back();
+			}
+			else
+			{
+				if (m_NumSlots == MAX_CHUNKS * CHUNK_SIZE)
+				{
+					LOG_F(ERROR, "Asset registry is full! Could not register %s", name.c_str());
+					return 0;
+				}
+
+				index = m_NumSlots++;
+
+				if (index % CHUNK_SIZE == 0)
+					ma_Chunks[index / CHUNK_SIZE].store(new Slot[CHUNK_SIZE], std::memory_order_release);
+			}
+
+			Slot& slot = GetSlot(index);
+
+			// Generation 0 is skipped so that no handle is ever 0
+			slot.m_Generation = slot.m_Generation == MAX_GENERATION ? 1 : slot.m_Generation + 1;
+			uint32_t handle = (slot.m_Generation << INDEX_BITS) | index;
+
+			assignHandle(value, handle);
+			slot.m_Value = std::move(value);
+			slot.m_Name = name;
+			slot.m_DenseIndex = (uint32_t)mv_Dense.size();
+			slot.m_RefCount.store(0, std::memory_order_relaxed);
+			slot.m_LastUsed.store(m_Frame, std::memory_order_relaxed);
+			slot.m_NumBytes = numBytes;
+			mv_Dense.push_back(index);
+			m_NumBytes += numBytes;
+
+			if (m_EvictedNames.erase(name) > 0) m_NumReloads++;
+
+			// Publish the asset only after it's fully written
+			slot.m_Handle.store(handle, std::memory_order_release);
+
+			if (!name.empty())
+			{
+				std::unique_lock<std::shared_mutex> nameLock(m_NameMutex);
+				m_Names[name] = handle;
+			}
+
+			return handle;
+		}
+
+		/*
+			Removes asset and frees its slot for reuse. Returns false if the handle is not valid.
+		*/
+		bool Remove(uint32_t handle)
+		{
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+
+			if (FindSlot(handle) == nullptr) return false;
+
+			RemoveSlot(handle & INDEX_MASK);
+			return true;
+		}
+
+		/*
+			Swaps asset with specified value while keeping its handle, name and references,
+			value receives the previous asset. Like Remove() it should only be called by the thread that renders assets.
+			Returns false if the handle is not valid.
+		*/
+		bool Replace(uint32_t handle, T& value, uint64_t numBytes)
+		{
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+
+			Slot* p_Slot = FindSlot(handle);
+			if (p_Slot == nullptr) return false;
+
+			std::swap(p_Slot->m_Value, value);
+			m_NumBytes = m_NumBytes - p_Slot->m_NumBytes + numBytes;
+			p_Slot->m_NumBytes = numBytes;
+			return true;
+		}
+
+		/*
+			Adds reference to the asset, referenced assets are never evicted.
+			Returns false if the handle is not valid.
+		*/
+		bool AddReference(uint32_t handle)
+		{
+			// Locked so the asset can't be evicted between the check and the increment
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+
+			Slot* p_Slot = FindSlot(handle);
+			if (p_Slot == nullptr) return false;
+
+			p_Slot->m_RefCount++;
+			return true;
+		}
+
+		/*
+			Releases reference to the asset. Asset isn't removed right away,
+			it can be evicted once the registry exceeds its budget.
+		*/
+		void ReleaseReference(uint32_t handle)
+		{
+			Slot* p_Slot = FindSlot(handle);
+			if (p_Slot == nullptr) return;
+
+			uint32_t refCount = p_Slot->m_RefCount.load();
+			do
+			{
+				if (refCount == 0)
+				{
+					LOG_F(WARNING, "Released reference to %s that has no references", p_Slot->m_Name.c_str());
+					return;
+				}
+			} while (!p_Slot->m_RefCount.compare_exchange_weak(refCount, refCount - 1));
+		}
+
+		/*
+			Returns asset like Get() and marks it as used in specified frame. Doesn't lock.
+		*/
+		T* Use(uint32_t handle, uint64_t frame)
+		{
+			Slot* p_Slot = FindSlot(handle);
+			if (p_Slot == nullptr) return nullptr;
+
+			p_Slot->m_LastUsed.store(frame, std::memory_order_relaxed);
+			return &p_Slot->m_Value;
+		}
+
+		/*
+			Evicts unreferenced assets, least recently used first, until the registry fits into its budget.
+			Assets used in this or the previous frame are kept. canContinue() is checked after every eviction
+			so the work can be spread over several frames. onEvict(asset) is called before the asset is destroyed.
+			Returns number of evicted assets.
+		*/
+		size_t EvictUnused(uint64_t frame, const std::function<bool()>& canContinue, const std::function<void(T&)>& onEvict)
+		{
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+
+			m_Frame = frame;
+			if (m_Budget == 0 || m_NumBytes <= m_Budget) return 0;
+
+			// Candidates as pairs of last use and slot index
+			std::vector<std::pair<uint64_t, uint32_t>> v_Candidates;
+
+			for (uint32_t index : mv_Dense)
+			{
+				Slot& slot = GetSlot(index);
+				uint64_t lastUsed = slot.m_LastUsed.load(std::memory_order_relaxed);
+
+				if (slot.m_RefCount.load() == 0 && lastUsed + 1 < frame)
+					v_Candidates.push_back({ lastUsed, index });
+			}
+
+			std::sort(v_Candidates.begin(), v_Candidates.end());
+
+			size_t numEvicted = 0;
+
+			for (const auto& candidate : v_Candidates)
+			{
+				if (m_NumBytes <= m_Budget || (numEvicted > 0 && !canContinue())) break;
+
+				Slot& slot = GetSlot(candidate.second);
+
+				if (onEvict) onEvict(slot.m_Value);
+
+				m_EvictedNames.insert(slot.m_Name);
+				m_NumEvictions++;
+				m_NumEvictedBytes += slot.m_NumBytes;
+
+				RemoveSlot(candidate.second);
+				numEvicted++;
+			}
+
+			return numEvicted;
+		}
+
+		/*
+			Returns asset identified by the handle or nullptr if the handle is not valid. Doesn't lock.
+		*/
+		T* Get(uint32_t handle)
+		{
+			Slot* p_Slot = FindSlot(handle);
+			return p_Slot != nullptr ? &p_Slot->m_Value : nullptr;
+		}
+
+		const T* Get(uint32_t handle) const
+		{
+			return const_cast<AssetRegistry*>(this)->Get(handle);
+		}
+
+		/*
+			Returns handle of the asset registered under the name or 0 if there is none.
+		*/
+		uint32_t Find(const std::string& name) const
+		{
+			std::shared_lock<std::shared_mutex> lock(m_NameMutex);
+
+			auto it = m_Names.find(name);
+			return it != m_Names.end() ? it->second : 0;
+		}
+
+		/*
+			Calls function(handle, asset) for every registered asset.
+			Assets can't be inserted or removed from inside of the function.
+		*/
+		void ForEach(const std::function<void(uint32_t, T&)>& function)
+		{
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+
+			for (uint32_t index : mv_Dense)
+			{
+				Slot& slot = GetSlot(index);
+				function(slot.m_Handle.load(std::memory_order_relaxed), slot.m_Value);
+			}
+		}
+
+		size_t GetSize() const
+		{
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+			return mv_Dense.size();
+		}
+
+		AssetRegistryStatistics GetStatistics() const
+		{
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+
+			AssetRegistryStatistics statistics = {};
+			statistics.m_NumAssets = mv_Dense.size();
+			statistics.m_NumBytes = m_NumBytes;
+			statistics.m_Budget = m_Budget;
+			statistics.m_NumEvictions = m_NumEvictions;
+			statistics.m_NumEvictedBytes = m_NumEvictedBytes;
+			statistics.m_NumReloads = m_NumReloads;
+
+			return statistics;
+		}
+
+		/*
+			Sets how many bytes assets can take before they are evicted, 0 disables eviction.
+		*/
+		void SetBudget(uint64_t budget)
+		{
+			std::lock_guard<std::mutex> lock(m_WriteMutex);
+			m_Budget = budget;
+		}
+
+	private:
+		inline Slot& GetSlot(uint32_t index)
+		{
+			return ma_Chunks[index / CHUNK_SIZE].load(std::memory_order_acquire)[index % CHUNK_SIZE];
+		}
+
+		// Has to be called with the write mutex locked
+		void RemoveSlot(uint32_t index)
+		{
+			Slot& slot = GetSlot(index);
+			slot.m_Handle.store(0, std::memory_order_release);
+
+			if (!slot.m_Name.empty())
+			{
+				std::unique_lock<std::shared_mutex> nameLock(m_NameMutex);
+				m_Names.erase(slot.m_Name);
+			}
+
+			m_NumBytes -= slot.m_NumBytes;
+			slot.m_NumBytes = 0;
+			slot.m_Value = T();
+			slot.m_Name.clear();
+
+			// Move the last dense entry into the place of the removed one
+			uint32_t lastIndex = mv_Dense.back();
+			mv_Dense[slot.m_DenseIndex] = lastIndex;
+			GetSlot(lastIndex).m_DenseIndex = slot.m_DenseIndex;
+			mv_Dense.pop_back();
+
+			mv_FreeSlots.push_back(index);
+		}
+
+		Slot* FindSlot(uint32_t handle)
+		{
+			if (handle == 0) return nullptr;
+
+			uint32_t index = handle & INDEX_MASK;
+
+			Slot* p_Chunk = ma_Chunks[index / CHUNK_SIZE].load(std::memory_order_acquire);
+			if (p_Chunk == nullptr) return nullptr;
+
+			Slot& slot = p_Chunk[index % CHUNK_SIZE];
+			return slot.m_Handle.load(std::memory_order_acquire) == handle ? &slot : nullptr;
+		}
+
+	private:
+		std::array<std::atomic<Slot*>, MAX_CHUNKS> ma_Chunks = {};
+		uint32_t m_NumSlots = 0; // Number of slots that were ever used
+
+		std::vector<uint32_t> mv_Dense; // Indices of occupied slots
+		std::vector<uint32_t> mv_FreeSlots;
+		mutable std::mutex m_WriteMutex;
+
+		std::unordered_map<std::string, uint32_t> m_Names;
+		mutable std::shared_mutex m_NameMutex;
+
+		// Memory accounting, modified while the write mutex is locked
+		uint64_t m_NumBytes = 0;
+		uint64_t m_Budget = 0;
+		uint64_t m_Frame = 0; // Frame of the last eviction, assigned as last use of new assets
+		uint64_t m_NumEvictions = 0;
+		uint64_t m_NumEvictedBytes = 0;
+		uint64_t m_NumReloads = 0;
+		std::set<std::string> m_EvictedNames;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+#include "Core.h"
+
+namespace Mesa
+{
+	enum AsyncReadBackend
+	{
+		AsyncReadBackend_CompletionPort = 0, // Overlapped reads completed through I/O completion port
+		AsyncReadBackend_ThreadPool = 1, // Positional reads executed by a pool of threads, one read in flight per thread
+	};
+
+	/*
+		Result of a single asynchronous read.
+		Data pointer is only valid for the duration of the callback.
+	*/
+	struct AsyncReadResult
+	{
+		const uint8_t* mp_Data = nullptr; // Bytes that were read
+		uint64_t m_Offset = 0; // Position in file the read started at
+		uint32_t m_Size = 0; // Number of bytes that were requested
+		uint32_t m_BytesRead = 0; // Number of bytes that were actually read
+		bool m_Success = false; // True if all requested bytes were read
+	};
+
+	using AsyncReadCallback = std::function<void(const AsyncReadResult&)>;
+
+#ifndef MESA_PORTABLE
+	class MSAPI AsyncFileReader
+	{
+	private:
+		struct ReadOperation
+		{
+			OVERLAPPED m_Overlapped = {}; // Must stay the first member so completions can be mapped back to the operation
+			HANDLE m_File = INVALID_HANDLE_VALUE;
+			uint64_t m_Offset = 0;
+			uint32_t m_Size = 0;
+			uint8_t* mp_Buffer = nullptr;
+			bool m_Pooled = false; // True if buffer was taken from the preallocated pool
+			AsyncReadCallback m_Callback;
+		};
+
+	public:
+		AsyncFileReader(AsyncReadBackend backend, uint32_t queueDepth, uint32_t bufferSize);
+		~AsyncFileReader();
+
+		static AsyncFileReader& GetDefault();
+
+		void Submit(const std::string& path, uint64_t offset, uint32_t size, AsyncReadCallback callback);
+		void CloseFile(const std::string& path);
+
+		inline AsyncReadBackend GetBackend() const noexcept { return m_Backend; }
+		inline uint32_t GetQueueDepth() const noexcept { return m_QueueDepth; }
+
+	private:
+		HANDLE GetFileHandle(const std::string& path);
+		uint8_t* AcquireBuffer(uint32_t size, bool& pooled);
+		void ReleaseBuffer(uint8_t* p_Buffer, bool pooled);
+		void Complete(ReadOperation* p_Operation, uint32_t bytesRead, bool success);
+		void CompletionPortLoop();
+		void ThreadPoolLoop();
+
+	private:
+		AsyncReadBackend m_Backend = AsyncReadBackend_CompletionPort;
+		uint32_t m_QueueDepth = 0;
+		uint32_t m_BufferSize = 0;
+
+		// Limits number of reads that can be in flight at once
+		std::counting_semaphore<> m_QueueSlots;
+
+		// Buffers allocated up front and reused by every read that fits in them
+		std::vector<uint8_t> mv_BufferMemory;
+		std::vector<uint8_t*> mv_FreeBuffers;
+		std::mutex m_BufferMutex;
+
+		// Handles of files that were already opened by the reader
+		std::map<std::string, HANDLE> m_Files;
+		std::mutex m_FileMutex;
+
+		// Completion port backend
+		HANDLE mp_CompletionPort = nullptr;
+
+		// Thread pool backend
+		std::deque<ReadOperation*> m_PendingOperations;
+		std::mutex m_PendingMutex;
+		std::condition_variable m_PendingCondition;
+		bool m_Shutdown = false;
+
+		std::vector<std::thread> mv_Workers;
+	};
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+#include "Core.h"
+#include "GfxUtils.h"
+
+namespace Mesa
+{
+	/*
+		Dynamic tree of axis aligned boxes used as a spatial index.
+		Leaves store boxes enlarged by a margin, so objects that move a little don't change the tree.
+		Leaves are inserted next to the sibling that adds the least surface area, and every node on the
+		way back to the root tries a rotation of its grandchildren that reduces surface area of its children.
+		Build() creates a new tree from a list of volumes with median splits, large subtrees are built
+		on the job system.
+		Every leaf has a proxy ID that stays valid until the leaf is removed or the tree is built again.
+	*/
+	class MSAPI BoundingVolumeTree
+	{
+	public:
+		static constexpr uint32_t NULL_NODE = UINT32_MAX;
+		static constexpr float FAT_MARGIN = 0.1f; // Part of the size of a box added on every side of a leaf
+		static constexpr size_t PARALLEL_BUILD_SIZE = 4096; // Smallest number of leaves whose subtrees are built in parallel
+
+		struct Box
+		{
+			glm::vec3 m_Min = glm::vec3(0.0f);
+			glm::vec3 m_Max = glm::vec3(0.0f);
+		};
+
+	private:
+		struct Node
+		{
+			Box m_Box;
+			uint32_t m_Parent = NULL_NODE;
+			uint32_t m_Child1 = NULL_NODE;
+			uint32_t m_Child2 = NULL_NODE;
+			uint32_t m_Leaf = NULL_NODE; // Proxy of the leaf, NULL_NODE for internal nodes
+		};
+
+		struct Leaf
+		{
+			uint32_t m_Node = NULL_NODE; // NULL_NODE if the proxy is free
+			uint32_t m_Value = 0;
+		};
+
+	public:
+		uint32_t Insert(const BoundingVolume& bounds, uint32_t value);
+		void Remove(uint32_t proxy);
+		bool Move(uint32_t proxy, const BoundingVolume& bounds);
+		void Build(std::span<const BoundingVolume> bounds, std::span<const uint32_t> values);
+		void Clear();
+
+		void QueryFrustum(const std::array<glm::vec4, 6>& planes, std::vector<uint32_t>& v_OutValues) const;
+		void QueryBox(const Box& box, std::vector<uint32_t>& v_OutValues) const;
+		void QuerySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& v_OutValues) const;
+		bool RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+			const std::function<float(uint32_t value, float maxDistance)>& testLeaf, uint32_t& outValue, float& outDistance) const;
+
+		inline uint32_t GetValue(uint32_t proxy) const { return mv_Leaves[proxy].m_Value; }
+		inline size_t GetNumLeaves() const noexcept { return mv_Leaves.size() - mv_FreeLeaves.size(); }
+		uint32_t GetHeight() const;
+
+		static Box ToBox(const BoundingVolume& bounds);
+
+	private:
+		uint32_t AllocateNode();
+		void FreeNode(uint32_t node);
+		uint32_t AllocateLeaf(uint32_t value);
+
+		void InsertLeafNode(uint32_t leafNode);
+		void RemoveLeafNode(uint32_t leafNode);
+		void Refit(uint32_t node);
+		void Rotate(uint32_t node);
+		void BuildRange(uint32_t* p_Leaves, size_t count, const Box* p_Boxes, uint32_t nodeIndex, uint32_t parent);
+		void CollectLeaves(uint32_t node, std::vector<uint32_t>& v_OutValues) const;
+
+	private:
+		std::vector<Node> mv_Nodes;
+		std::vector<uint32_t> mv_FreeNodes;
+		std::vector<Leaf> mv_Leaves;
+		std::vector<uint32_t> mv_FreeLeaves;
+		uint32_t m_Root = NULL_NODE;
+	};
+}
\ No newline at end of file
@@ -12,11 +12,62 @@ namespace Mesa
         CameraMovementDown
     };
 
+	/*
+		Camera used by graphics backends.
+		View-projection matrix uses layout of DirectXMath (points are row vectors, clip depth goes from 0 to w),
+		which is what FrustumCuller expects.
+	*/
 	class MSAPI Camera
 	{
 	public:
+		virtual ~Camera() = default;
+
+		virtual glm::mat4x4 GetViewProjectionMatrix() const = 0;
+		virtual glm::vec3 GetPosition() const = 0;
+	};
+
+	/*
+		Camera with the same controls and matrices as CameraDx11, computed with glm.
+		It doesn't need DirectXMath, so it's used by the null backend and portable builds.
+	*/
+	class MSAPI CameraNull : public Camera
+	{
+	public:
+		CameraNull();
+		void SetProjectionValues(float fov, float aspectRatio, float nz, float fz);
+
+		void HandleMovement(CameraMovement direction, float deltaTime = 1.0f);
+
+		glm::mat4x4 GetViewProjectionMatrix() const override;
+		glm::vec3 GetPosition() const override;
+
+		inline const glm::mat4x4& GetViewMatrix() const noexcept { return m_View; }
+		inline const glm::mat4x4& GetProjectionMatrix() const noexcept { return m_Proj; }
+		inline const glm::vec3& GetRotation() const noexcept { return m_Rot; }
+
+		void SetPosition(const glm::vec3& pos);
+		void AdjustPosition(const glm::vec3& pos);
+		void SetRotation(const glm::vec3& rot);
+		void AdjustRotation(const glm::vec3& rot);
+		void SetLookAtPos(const glm::vec3& lookAtPos);
+
+	private:
+		void UpdateViewMatrix();
+		static glm::vec3 RotateRollPitchYaw(const glm::vec3& v, float pitch, float yaw, float roll);
+
+	private:
+		glm::vec3 m_Pos = glm::vec3(0.0f);
+		glm::vec3 m_Rot = glm::vec3(0.0f); // Pitch, yaw and roll in radians
+		glm::mat4x4 m_View = glm::mat4x4(1.0f);
+		glm::mat4x4 m_Proj = glm::mat4x4(1.0f);
+
+		glm::vec3 m_ForwardVec = glm::vec3(0.0f, 0.0f, 1.0f);
+		glm::vec3 m_LeftVec = glm::vec3(-1.0f, 0.0f, 0.0f);
+		glm::vec3 m_RightVec = glm::vec3(1.0f, 0.0f, 0.0f);
+		glm::vec3 m_BackwardVec = glm::vec3(0.0f, 0.0f, -1.0f);
 	};
 
+#ifndef MESA_PORTABLE
     class MSAPI CameraDx11 : public Camera
 	{
 	public:
@@ -25,6 +76,9 @@ namespace Mesa
 
 		void HandleMovement(CameraMovement direction, float deltaTime = 1.0f);
 
+		glm::mat4x4 GetViewProjectionMatrix() const override;
+		glm::vec3 GetPosition() const override;
+
 		const DirectX::XMMATRIX& GetViewMatrix() const;
 		const DirectX::XMMATRIX& GetProjectionMatrix() const;
 
@@ -67,4 +121,5 @@ namespace Mesa
 		DirectX::XMVECTOR m_RightVec;
 		DirectX::XMVECTOR m_BackwardVec;
 	};
+#endif
 }
\ No newline at end of file
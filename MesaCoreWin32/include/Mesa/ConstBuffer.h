@@ -5,6 +5,7 @@ namespace Mesa
 {
 	namespace ConstBufferDx11
 	{
+#ifndef MESA_PORTABLE
 		struct alignas(16) MvpBuffer
 		{
 			DirectX::XMMATRIX m_Model;
@@ -17,6 +18,21 @@ namespace Mesa
 			DirectX::XMFLOAT4 m_BaseColor;
 			DirectX::XMFLOAT4 m_SubColor;
 		};
+#else
+		// Same layouts as on Windows, so the null renderer counts the same constant sizes
+		struct alignas(16) MvpBuffer
+		{
+			glm::mat4x4 m_Model;
+			glm::mat4x4 m_View;
+			glm::mat4x4 m_Proj;
+		};
+
+		struct alignas(16) MaterialBufferColorPass
+		{
+			glm::vec4 m_BaseColor;
+			glm::vec4 m_SubColor;
+		};
+#endif
 
 		struct alignas(16) MaterialBufferSpecularPass
 		{
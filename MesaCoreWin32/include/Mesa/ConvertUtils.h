@@ -11,11 +11,17 @@ namespace Mesa
 		static float StringToFloat(const std::string& s);
 		static std::string ToLowerCase(const std::string& s);
 		static int StringToInt(const std::string& s);
+		static uint32_t HexStringToUInt(const std::string& s);
+		static std::string RemoveCharFromString(const std::string& s, char c);
+		static std::string ReplaceCharInString(const std::string& s, char original, char replacement);
+
+#ifndef MESA_PORTABLE
+		static std::string WideStringToString(const std::wstring& s);
 		static DirectX::XMFLOAT4 ArrayToXmFloat4(const std::array<float, 4>& data);
 		static DirectX::XMMATRIX Mat4x4ToXmMatrix(const glm::mat4x4& m);
+		static glm::mat4x4 XmMatrixToMat4x4(const DirectX::XMMATRIX& m);
 		static DirectX::XMFLOAT3 Vec3ToXmFloat3(const glm::vec3& data);
-		static std::string RemoveCharFromString(const std::string& s, char c);
-		static std::string ReplaceCharInString(const std::string& s, char original, char replacement);
 		static DirectX::XMFLOAT4 Vec4ToXmFloat4(const glm::vec4& data);
+#endif
 	};
 }
\ No newline at end of file
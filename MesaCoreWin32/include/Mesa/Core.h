@@ -1,11 +1,23 @@
 #pragma once
 
-#ifdef _WINDLL
+/*
+	Backend-neutral modules (job system, frame graph, render queue, culling, null renderer, ...) are also built
+	as a static library without Windows, DirectX and GLFW, so they can be tested and benchmarked anywhere.
+	MESA_PORTABLE is defined by that build and on every platform other than Windows.
+*/
+#if !defined(_WIN32) && !defined(MESA_PORTABLE)
+	#define MESA_PORTABLE
+#endif
+
+#if defined(MESA_PORTABLE)
+	#define MSAPI
+#elif defined(_WINDLL)
 	#define MSAPI __declspec(dllexport)
 #else
 	#define MSAPI __declspec(dllimport)
 #endif
 
+#ifndef MESA_PORTABLE
 // Windows related macros
 #define WIN32_LEAN_AND_MEAN // Disable additional WIN32 functionality
 #define GLFW_EXPOSE_NATIVE_WIN32 // Expose GLFW library to native WINAPI interfaces
@@ -13,10 +25,16 @@
 // Windows related headers
 #include <Windows.h>
 #include <wrl.h>
+#endif
 
 // C++ standard library headers
 #include <cstdint>
+#include <cstring>
+#include <cmath>
 #include <sstream>
+#include <iomanip>
+#include <span>
+#include <charconv>
 #include <source_location>
 #include <filesystem>
 #include <exception>
@@ -25,52 +43,71 @@
 #include <array>
 #include <fstream>
 #include <map>
+#include <unordered_map>
 #include <set>
 #include <optional>
 #include <limits>
 #include <algorithm>
 #include <random>
 #include <semaphore>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include <atomic>
+#include <coroutine>
+#include <future>
+
+// SSE intrinsics
+#include <xmmintrin.h>
 
+#ifndef MESA_PORTABLE
 // GLFW headers
 #include <GLFW/glfw3.h>
 #include <GLFW/glfw3native.h>
 
 // DirectX 11 headers
 #include <d3d11.h>
+#include <d3d11_1.h>
 #include <dxgi.h>
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
 
+// LZAV headers
+#include <lzav.h>
+#endif
+
 // mINI headers
 #include <mini/ini.h>
 
 // Lodepng headers
 #include <lodepng.h>
 
-// GLM headers
-#include <glm/mat4x4.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/quaternion.hpp>
-
 // Assimp Headers
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+// GLM headers
+#include <glm/vec2.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
 // Loguru headers
 #include <loguru/loguru.hpp>
 
 // Crc32c headers
 #include <crc32c/crc32c.h>
 
-// LZAV headers
-#include <lzav.h>
-
+#ifndef MESA_PORTABLE
 /*
 	This macro checks the HRESULT (hr) returned by a DirectX/COM function.
 	If the result indicates a failure (using the standard FAILED() macro),
 	it throws a GraphicsException, capturing the error code and the
 	current source location (file, line, function) automatically.
 */
-#define THROW_IF_FAILED_DX(hr) if(FAILED(hr)) throw GraphicsDx11Exception(hr)
\ No newline at end of file
+#define THROW_IF_FAILED_DX(hr) if(FAILED(hr)) throw GraphicsDx11Exception(hr)
+#endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+#include "Core.h"
+#include "InstanceBatcher.h"
+#include "UploadRing.h"
+
+namespace Mesa
+{
+	enum DrawCommandType : uint32_t
+	{
+		DrawCommandType_SetShader = 0,
+		DrawCommandType_SetMvp = 1,
+		DrawCommandType_SetMesh = 2,
+		DrawCommandType_SetMaterial = 3, // Always follows SetMesh of the mesh it belongs to
+		DrawCommandType_Draw = 4,
+		DrawCommandType_DrawInstanced = 5,
+	};
+
+	// Single command of a draw stream, fields that the command doesn't use are 0
+	struct DrawCommand
+	{
+		DrawCommandType m_Type = DrawCommandType_Draw;
+		uint32_t m_Id = 0; // Shader ID of SetShader, model ID of SetMvp and SetMesh, material ID of SetMaterial
+		uint32_t m_MeshIndex = 0;
+		uint32_t m_FirstInstance = 0;
+		uint32_t m_NumInstances = 0;
+		uint32_t m_Offset = 0; // Constants of SetMvp and SetMaterial in constant data of the stream
+	};
+
+	// Commands of a range of batches and constants they bind
+	struct DrawStream
+	{
+		std::vector<DrawCommand> mv_Commands;
+		std::vector<uint8_t> mv_Constants; // Slices aligned to UploadRing::ALIGNMENT
+		uint64_t m_ConstantOffset = 0; // Offset of constant data in the upload ring, set by the backend before replay
+	};
+
+	// Work that frames would submit to the GPU, counted by GraphicsNull
+	struct DrawStatistics
+	{
+		uint64_t m_NumDrawCalls = 0;
+		uint64_t m_NumIndices = 0;
+		uint64_t m_NumShaderBinds = 0;
+		uint64_t m_NumTextureBinds = 0;
+		uint64_t m_NumBufferUpdates = 0;
+		uint64_t m_NumCopies = 0;
+		uint64_t m_NumInstances = 0; // Objects drawn by instanced draw calls
+		uint64_t m_NumConstantBytes = 0; // Constant data sub-allocated from the upload ring
+		uint64_t m_NumDrawStreams = 0; // Streams recorded by workers
+	};
+
+	// Assets that commands of draw streams refer to, functions return false if the asset isn't loaded
+	struct DrawAssetLookup
+	{
+		std::function<bool(uint32_t shaderId)> m_HasShader;
+		std::function<bool(uint32_t modelId)> m_HasModel;
+		std::function<bool(uint32_t modelId, uint32_t meshIndex, uint32_t& outNumIndices)> m_GetMesh;
+		std::function<bool(uint32_t materialId, uint32_t& outTextureId)> m_GetMaterialTexture; // Texture the material binds in the replayed pass
+		std::function<bool(uint32_t textureId)> m_UseTexture;
+	};
+
+	// Write backend specific constants of draws, called by several workers at once
+	struct DrawConstantWriters
+	{
+		uint32_t m_MvpSize = 0;
+		uint32_t m_MaterialSize = 0;
+		std::function<void(const GameObject3D* p_Object, uint8_t* p_Out)> m_WriteMvp; // Object is null for instanced batches
+		std::function<bool(uint32_t materialId, uint8_t* p_Out)> m_WriteMaterial; // Returns false if the material isn't loaded
+	};
+
+	/*
+		Records batches of a pass into backend independent draw streams on the job system.
+		Batches are split into streams of BATCHES_PER_STREAM, so the streams and their commands only depend
+		on the batches and not on the number of workers. Every stream starts with nothing bound and
+		only records state that changes, constants are written into its own memory.
+		Backend copies constants of the streams into the upload ring and replays them in order,
+		which draws the same as replaying the batches one by one.
+	*/
+	class MSAPI DrawRecorder
+	{
+	public:
+		static constexpr size_t BATCHES_PER_STREAM = 256;
+
+	public:
+		void Record(std::span<const InstanceBatch> batches, const DrawConstantWriters& writers);
+		static void CountStream(const DrawStream& stream, const DrawAssetLookup& assets, DrawStatistics& outStatistics);
+
+		inline std::span<DrawStream> GetStreams() noexcept { return std::span<DrawStream>(mv_Streams.data(), m_NumStreams); }
+
+	private:
+		static void RecordStream(std::span<const InstanceBatch> batches, const DrawConstantWriters& writers, DrawStream& stream);
+
+	private:
+		std::vector<DrawStream> mv_Streams; // Streams keep their memory between passes
+		size_t m_NumStreams = 0; // Streams of the last recorded pass
+	};
+}
\ No newline at end of file
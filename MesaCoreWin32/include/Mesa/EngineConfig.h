@@ -0,0 +1,207 @@
+#pragma once
+#include "Core.h"
+
+namespace Mesa
+{
+	enum ConfigValueType
+	{
+		ConfigValueType_Int = 0,
+		ConfigValueType_Float,
+		ConfigValueType_Bool,
+		ConfigValueType_String, // Lowercased, for values compared against fixed options
+		ConfigValueType_Path, // Keeps its case
+	};
+
+	// Keys of engine.ini known to the engine, order matches CONFIG_KEYS
+	enum ConfigKey : uint32_t
+	{
+		ConfigKey_DebugLog = 0,
+		ConfigKey_DebugLogPath,
+		ConfigKey_DebugLogType,
+		ConfigKey_DebugLogName,
+		ConfigKey_DebugLoadGraph,
+		ConfigKey_DebugHotReload,
+		ConfigKey_GeneralApi,
+		ConfigKey_GeneralNullFrames,
+		ConfigKey_WindowWidth,
+		ConfigKey_WindowHeight,
+		ConfigKey_WindowFullscreen,
+		ConfigKey_Dx11RenderDistance,
+		ConfigKey_Dx11SamplingMode,
+		ConfigKey_Dx11AntiAliasing,
+		ConfigKey_PathShader,
+		ConfigKey_PathModel,
+		ConfigKey_PathTexture,
+		ConfigKey_PathMaterial,
+		ConfigKey_StreamingIoBackend,
+		ConfigKey_StreamingIoQueueDepth,
+		ConfigKey_StreamingRecordAccessTrace,
+		ConfigKey_StreamingPrefetch,
+		ConfigKey_StreamingAccessTrace,
+		ConfigKey_StreamingStartupReport,
+		ConfigKey_StreamingUploadBudget,
+		ConfigKey_StreamingTextureBudget,
+		ConfigKey_StreamingModelBudget,
+		ConfigKey_StreamingMaterialBudget,
+		ConfigKey_StreamingEvictionBudget,
+		ConfigKey_StreamingAssetCache,
+		ConfigKey_StreamingAssetCacheDirectory,
+		ConfigKey_StreamingAssetCacheSize,
+		ConfigKey_StreamingPipelineMemory,
+		ConfigKey_StreamingPipelineReadWorkers,
+		ConfigKey_StreamingPipelineDecodeWorkers,
+		ConfigKey_StreamingPipelineUploadWorkers,
+		ConfigKey_Count
+	};
+
+	// Declaration of a single key, default value is used when the key is missing from the file
+	struct ConfigKeyInfo
+	{
+		ConfigKey m_Id;
+		std::string_view m_Section;
+		std::string_view m_Key;
+		ConfigValueType m_Type;
+		std::string_view m_Default;
+	};
+
+	inline constexpr std::array<ConfigKeyInfo, ConfigKey_Count> CONFIG_KEYS = { {
+		// --- Debug & Logging Settings ---
+		{ ConfigKey_DebugLog, "Debug", "Log", ConfigValueType_Bool, "False" },
+		{ ConfigKey_DebugLogPath, "Debug", "LogPath", ConfigValueType_Path, "" },
+		{ ConfigKey_DebugLogType, "Debug", "LogType", ConfigValueType_String, "Truncate" },
+		{ ConfigKey_DebugLogName, "Debug", "LogName", ConfigValueType_Path, "mesa.log.txt" },
+		// File the task graph of every asset load is saved to (empty disables saving).
+		{ ConfigKey_DebugLoadGraph, "Debug", "LoadGraph", ConfigValueType_Path, "" },
+		// Assets whose packs are rebuilt while the engine runs are reloaded in place.
+		{ ConfigKey_DebugHotReload, "Debug", "HotReload", ConfigValueType_Bool, "False" },
+
+		// --- General Engine Settings ---
+		// Rendering backend ("dx11", or "null" that loads assets and counts draw calls without a GPU).
+		{ ConfigKey_GeneralApi, "General", "Api", ConfigValueType_String, "dx11" },
+		// Frames drawn by the null backend before the application exits, it has no window that could be closed.
+		{ ConfigKey_GeneralNullFrames, "General", "NullFrames", ConfigValueType_Int, "1000" },
+
+		// --- Window Settings ---
+		{ ConfigKey_WindowWidth, "Window", "Width", ConfigValueType_Int, "800" },
+		{ ConfigKey_WindowHeight, "Window", "Height", ConfigValueType_Int, "600" },
+		{ ConfigKey_WindowFullscreen, "Window", "Fullscreen", ConfigValueType_Bool, "False" },
+
+		// --- DX11 Specific Graphics Settings ---
+		{ ConfigKey_Dx11RenderDistance, "Graphics_Dx11", "RenderDistance", ConfigValueType_Float, "1000.0f" },
+		{ ConfigKey_Dx11SamplingMode, "Graphics_Dx11", "SamplingMode", ConfigValueType_String, "Linear" },
+		{ ConfigKey_Dx11AntiAliasing, "Graphics_Dx11", "AntiAliasing", ConfigValueType_String, "Fxaa" },
+
+		// --- Resource Paths ---
+		// These define where the engine looks for assets.
+		{ ConfigKey_PathShader, "Path", "Shader", ConfigValueType_Path, "Asset/Shader/" },
+		{ ConfigKey_PathModel, "Path", "Model", ConfigValueType_Path, "Asset/Model/" },
+		{ ConfigKey_PathTexture, "Path", "Texture", ConfigValueType_Path, "Asset/Texture/" },
+		{ ConfigKey_PathMaterial, "Path", "Material", ConfigValueType_Path, "Asset/Material/" },
+
+		// --- Streaming Settings ---
+		// Backend used for asynchronous pack reads ("Iocp" or "ThreadPool").
+		{ ConfigKey_StreamingIoBackend, "Streaming", "IoBackend", ConfigValueType_String, "Iocp" },
+		{ ConfigKey_StreamingIoQueueDepth, "Streaming", "IoQueueDepth", ConfigValueType_Int, "32" },
+		// Archive reads of every run are recorded and prefetched on the next startup.
+		{ ConfigKey_StreamingRecordAccessTrace, "Streaming", "RecordAccessTrace", ConfigValueType_Bool, "True" },
+		{ ConfigKey_StreamingPrefetch, "Streaming", "Prefetch", ConfigValueType_Bool, "True" },
+		{ ConfigKey_StreamingAccessTrace, "Streaming", "AccessTrace", ConfigValueType_Path, "access_trace.csv" },
+		{ ConfigKey_StreamingStartupReport, "Streaming", "StartupReport", ConfigValueType_Path, "startup_report.csv" },
+		// Milliseconds per frame spent on creating GPU resources of asynchronously loaded assets.
+		{ ConfigKey_StreamingUploadBudget, "Streaming", "UploadBudget", ConfigValueType_Float, "2.0" },
+		// Megabytes that loaded assets can take before unused ones are evicted (0 disables eviction).
+		{ ConfigKey_StreamingTextureBudget, "Streaming", "TextureBudget", ConfigValueType_Float, "512" },
+		{ ConfigKey_StreamingModelBudget, "Streaming", "ModelBudget", ConfigValueType_Float, "256" },
+		{ ConfigKey_StreamingMaterialBudget, "Streaming", "MaterialBudget", ConfigValueType_Float, "16" },
+		// Milliseconds per frame spent on evicting unused assets.
+		{ ConfigKey_StreamingEvictionBudget, "Streaming", "EvictionBudget", ConfigValueType_Float, "0.5" },
+		// Decoded textures and imported meshes are kept on disk so unchanged assets aren't processed again.
+		{ ConfigKey_StreamingAssetCache, "Streaming", "AssetCache", ConfigValueType_Bool, "True" },
+		{ ConfigKey_StreamingAssetCacheDirectory, "Streaming", "AssetCacheDirectory", ConfigValueType_Path, "AssetCache/" },
+		// Megabytes the asset cache can take before least recently used entries are deleted.
+		{ ConfigKey_StreamingAssetCacheSize, "Streaming", "AssetCacheSize", ConfigValueType_Int, "1024" },
+		// Megabytes that entries of a pack streamed through read, decode and upload stages can take at once.
+		{ ConfigKey_StreamingPipelineMemory, "Streaming", "PipelineMemory", ConfigValueType_Float, "64" },
+		// Threads of every pipeline stage (0 uses one decode worker per hardware thread except the main one).
+		{ ConfigKey_StreamingPipelineReadWorkers, "Streaming", "PipelineReadWorkers", ConfigValueType_Int, "2" },
+		{ ConfigKey_StreamingPipelineDecodeWorkers, "Streaming", "PipelineDecodeWorkers", ConfigValueType_Int, "0" },
+		{ ConfigKey_StreamingPipelineUploadWorkers, "Streaming", "PipelineUploadWorkers", ConfigValueType_Int, "1" },
+	} };
+
+	/*
+		Checks that every key is declared at the position of its id
+	*/
+	constexpr bool AreConfigKeysOrdered()
+	{
+		for (uint32_t i = 0; i < ConfigKey_Count; i++)
+		{
+			if (CONFIG_KEYS[i].m_Id != i) return false;
+		}
+
+		return true;
+	}
+
+	static_assert(AreConfigKeysOrdered(), "CONFIG_KEYS has to be declared in order of ConfigKey");
+
+	/*
+		Immutable values of all keys parsed from a single read of the config file.
+		Values are converted to their declared types once, so reading them doesn't parse or allocate.
+		Keys that aren't declared can still be read as text.
+	*/
+	class MSAPI ConfigSnapshot
+	{
+	private:
+		struct ConfigValue
+		{
+			std::string m_Text;
+			int32_t m_Int = 0;
+			float m_Float = 0.0f;
+			bool m_Bool = false;
+		};
+
+	public:
+		ConfigSnapshot(const mINI::INIStructure& iniStruct, uint64_t version);
+
+		/*
+			Returns value of the key as its declared type (int32_t, float, bool or std::string)
+		*/
+		template<ConfigKey key>
+		const auto& Get() const noexcept
+		{
+			constexpr ConfigValueType type = CONFIG_KEYS[key].m_Type;
+
+			if constexpr (type == ConfigValueType_Int) return ma_Values[key].m_Int;
+			else if constexpr (type == ConfigValueType_Float) return ma_Values[key].m_Float;
+			else if constexpr (type == ConfigValueType_Bool) return ma_Values[key].m_Bool;
+			else return ma_Values[key].m_Text;
+		}
+
+		std::string GetText(const std::string& section, const std::string& key) const;
+
+		inline uint64_t GetVersion() const noexcept { return m_Version; }
+
+	private:
+		std::array<ConfigValue, ConfigKey_Count> ma_Values;
+		// Every value of the file keyed by lowercased "section\nkey"
+		std::unordered_map<std::string, std::string> m_Text;
+		uint64_t m_Version = 0;
+	};
+
+	/*
+		Engine configuration read from engine.ini.
+		File is parsed once into a snapshot that all readers share. Reading the current snapshot is
+		a single atomic load, and Reload() publishes a new snapshot with an atomic swap.
+		Previous snapshots are kept alive, so references returned by Get() never dangle.
+		They're only created when the file changes, so this costs little memory.
+	*/
+	class MSAPI EngineConfig
+	{
+	public:
+		static const ConfigSnapshot& GetSnapshot();
+		static void Reload();
+		static void GenerateDefault();
+
+		template<ConfigKey key>
+		static const auto& Get() { return GetSnapshot().Get<key>(); }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include "Core.h"
+
+namespace Mesa
+{
+	/*
+		Watches directories or single files for modifications on a background thread.
+		Files are reported only after they stop changing for the settle time,
+		so archives that are still being written aren't picked up halfway.
+	*/
+	class MSAPI FileWatcher
+	{
+	private:
+		struct WatchedDirectory
+		{
+			std::string m_Path;
+			std::string m_FileName; // If set only this file of the directory is watched
+			HANDLE m_Handle = INVALID_HANDLE_VALUE;
+			OVERLAPPED m_Overlapped = {};
+			std::vector<DWORD> mv_Buffer; // DWORD aligned as required by ReadDirectoryChangesW
+			bool m_Pending = false; // True while a read of notifications is in progress
+		};
+
+	public:
+		// Time in milliseconds a file has to stay unchanged before it's reported
+		static constexpr uint32_t DEFAULT_SETTLE_TIME = 500;
+
+	public:
+		FileWatcher(const std::vector<std::string>& v_Paths, uint32_t settleTime = DEFAULT_SETTLE_TIME);
+		~FileWatcher();
+
+		std::vector<std::string> PollChanges();
+
+	private:
+		bool BeginRead(WatchedDirectory& directory);
+		void ReadNotifications(WatchedDirectory& directory, DWORD numBytes);
+		void WatchLoop();
+
+	private:
+		std::vector<std::unique_ptr<WatchedDirectory>> mv_Directories;
+		uint32_t m_SettleTime = DEFAULT_SETTLE_TIME;
+
+		// Changed paths with time of their last change
+		std::map<std::string, std::chrono::steady_clock::time_point> m_Changes;
+		std::mutex m_Mutex;
+
+		HANDLE mp_StopEvent = nullptr;
+		std::thread m_Thread;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#pragma once
+#include "Core.h"
+#include "RenderQueue.h"
+
+namespace Mesa
+{
+	// Identifier of a texture inside of the frame graph (0 is never a valid resource)
+	using FrameResource = uint32_t;
+
+	enum FrameResourceState : uint32_t
+	{
+		FrameResourceState_Undefined = 0,
+		FrameResourceState_RenderTarget = 1,
+		FrameResourceState_ShaderRead = 2,
+		FrameResourceState_CopySource = 3,
+		FrameResourceState_CopyDest = 4,
+		FrameResourceState_Present = 5,
+	};
+
+	// Size and format of a texture, format is a value of the backend (e.g. DXGI_FORMAT)
+	struct FrameTextureDesc
+	{
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		uint32_t m_Format = 0;
+
+		bool operator==(const FrameTextureDesc& other) const = default;
+	};
+
+	// Change of state of a physical texture that has to happen before a pass
+	struct FrameBarrier
+	{
+		uint32_t m_Texture = 0;
+		FrameResourceState m_Before = FrameResourceState_Undefined;
+		FrameResourceState m_After = FrameResourceState_Undefined;
+	};
+
+	// Work removed by the last compilation of the graph
+	struct FrameGraphStatistics
+	{
+		uint32_t m_NumPasses = 0; // Passes and copies added to the graph
+		uint32_t m_NumCulledPasses = 0;
+		uint32_t m_NumEliminatedCopies = 0;
+		uint32_t m_NumTransientResources = 0; // Transient textures used by the remaining passes
+		uint32_t m_NumPhysicalTextures = 0; // Textures that back them after aliasing
+	};
+
+	class FrameGraph;
+
+	using FramePassFunction = std::function<void(const FrameGraph& graph)>;
+	using FrameCopyFunction = std::function<void(uint32_t sourceTexture, uint32_t destinationTexture)>;
+	using FrameBarrierFunction = std::function<void(const FrameBarrier& barrier)>;
+	using FrameLayerFunction = std::function<void(const FrameGraph& graph, FrameResource target, uint32_t layer, DrawPass pass)>;
+	using FrameBlendFunction = std::function<void(const FrameGraph& graph, FrameResource target, FrameResource layer, FrameResource previous)>;
+
+	/*
+		Graph of the passes of a frame and the textures they read and write.
+		Every texture is written by a single pass, and passes are added after the passes they read from.
+		Compile() removes passes whose results never reach an output, removes copies whose destination
+		can be replaced with their source (or whose source can be written to the destination directly),
+		places transient textures with disjoint lifetimes into the same physical texture and
+		finds state changes of physical textures between passes.
+		Graph doesn't know about any graphics API, backends create physical textures and
+		run passes, copies and barriers in Execute().
+	*/
+	class MSAPI FrameGraph
+	{
+	public:
+		static constexpr uint32_t NO_TEXTURE = UINT32_MAX;
+
+	private:
+		static constexpr uint32_t NO_PASS = UINT32_MAX;
+		static constexpr uint32_t NO_STEP = UINT32_MAX;
+
+		struct Resource
+		{
+			std::string m_Name;
+			FrameTextureDesc m_Desc;
+			bool m_IsImported = false;
+			bool m_IsOutput = false;
+			FrameResourceState m_ImportedState = FrameResourceState_Undefined; // State of imported texture before and after the frame
+			uint32_t m_Writer = NO_PASS;
+
+			// Compilation results
+			FrameResource m_Alias = 0; // Resource that holds contents of this one after copy elimination, 0 if none
+			uint32_t m_FirstStep = NO_STEP;
+			uint32_t m_LastStep = NO_STEP;
+			uint32_t m_Texture = NO_TEXTURE;
+		};
+
+		struct Pass
+		{
+			std::string m_Name;
+			std::vector<FrameResource> mv_Reads;
+			std::vector<FrameResource> mv_Writes;
+			FramePassFunction m_Execute; // Empty for copies
+			bool m_IsCopy = false;
+
+			// Compilation results
+			bool m_IsNeeded = false;
+			bool m_IsEliminated = false;
+		};
+
+		struct Step
+		{
+			uint32_t m_Pass = 0;
+			std::vector<FrameBarrier> mv_Barriers; // Applied before the pass
+		};
+
+		struct Texture
+		{
+			FrameTextureDesc m_Desc;
+			FrameResource m_Imported = 0; // Imported resource of the texture, 0 for transient textures
+			uint32_t m_LastStep = 0;
+		};
+
+	public:
+		FrameResource ImportTexture(const std::string& name, const FrameTextureDesc& desc, FrameResourceState state);
+		FrameResource CreateTexture(const std::string& name, const FrameTextureDesc& desc);
+		void AddPass(const std::string& name, const std::vector<FrameResource>& v_Reads, const std::vector<FrameResource>& v_Writes, FramePassFunction execute);
+		void AddCopy(const std::string& name, FrameResource source, FrameResource destination);
+		void MarkOutput(FrameResource resource);
+		void AddLayerPasses(FrameResource output, const FrameTextureDesc& desc, uint32_t numLayers, const FrameLayerFunction& draw, const FrameBlendFunction& blend);
+		void Reset();
+
+		void Compile();
+		void Execute(const FrameBarrierFunction& barrier, const FrameCopyFunction& copy) const;
+
+		uint32_t GetTexture(FrameResource resource) const;
+		inline size_t GetNumTextures() const noexcept { return mv_Textures.size(); }
+		inline const FrameTextureDesc& GetTextureDesc(uint32_t texture) const { return mv_Textures[texture].m_Desc; }
+		inline FrameResource GetImportedResource(uint32_t texture) const { return mv_Textures[texture].m_Imported; }
+		inline const FrameGraphStatistics& GetStatistics() const noexcept { return m_Statistics; }
+		std::string Dump() const;
+
+	private:
+		bool IsValid(FrameResource resource) const;
+		FrameResource Resolve(FrameResource resource) const;
+		bool AddWrite(uint32_t pass, FrameResource resource);
+
+		void CullPasses();
+		void EliminateCopies();
+		void AssignTextures();
+		void PlaceBarriers();
+
+	private:
+		std::vector<Resource> mv_Resources;
+		std::vector<Pass> mv_Passes;
+
+		// Compiled graph
+		std::vector<Step> mv_Steps;
+		std::vector<Texture> mv_Textures;
+		std::vector<FrameBarrier> mv_FinalBarriers; // Return imported textures to their states after the last pass
+		FrameGraphStatistics m_Statistics;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include "Core.h"
+#include "GfxUtils.h"
+#include "JobSystem.h"
+
+namespace Mesa
+{
+	// Objects tested by the last frame and how many of them were inside the view frustum
+	struct CullingStatistics
+	{
+		uint64_t m_NumTested = 0;
+		uint64_t m_NumVisible = 0;
+	};
+
+	/*
+		Tests bounding volumes against the six planes of the camera frustum.
+		Objects are tested four at a time with SSE, and large scenes are split into
+		batches that run on the job system. Tests are conservative, so volumes that only
+		touch the frustum are treated as visible.
+	*/
+	class MSAPI FrustumCuller
+	{
+	public:
+		static constexpr size_t BATCH_SIZE = 4096; // Objects tested by a single job
+
+	public:
+		void SetViewProjection(const glm::mat4x4& viewProj);
+
+		void Cull(std::span<const glm::mat4x4> worlds, std::span<const BoundingVolume> bounds, std::vector<uint8_t>& v_OutVisible);
+		bool IsVisible(const BoundingVolume& worldBounds) const;
+
+		inline const std::array<glm::vec4, 6>& GetPlanes() const noexcept { return ma_Planes; }
+		inline const CullingStatistics& GetStatistics() const noexcept { return m_Statistics; }
+
+	private:
+		size_t CullBatch(const glm::mat4x4* p_Worlds, const BoundingVolume* p_Bounds, uint8_t* p_OutVisible, size_t count) const;
+
+	private:
+		// Planes as (normal, distance), points with non-negative distance from all planes are inside
+		std::array<glm::vec4, 6> ma_Planes = {};
+		CullingStatistics m_Statistics;
+	};
+}
\ No newline at end of file
@@ -16,6 +16,7 @@ namespace Mesa
 		inline uint32_t GetPositionShader() const noexcept { return m_RelatedPositionShader; }
 		inline glm::mat4x4 GetWorldMatrix() const noexcept { return m_WorldMatrix; }
 		inline uint32_t GetModel() const noexcept { return m_RelatedModel; }
+		inline uint64_t GetVersion() const noexcept { return m_Version; }
 
 	public: // Setters
 		inline void SetColorShader(const uint32_t& shaderId) noexcept { m_RelatedColorShader = shaderId; }
@@ -46,5 +47,6 @@ namespace Mesa
 		glm::vec3 m_Scale = glm::vec3(1,1,1); // Scale of the object in 3D space
 
 		glm::mat4x4 m_WorldMatrix = glm::mat4x4(1); // World matrix used in MVP calculations
+		uint64_t m_Version = 0; // Incremented whenever the world matrix changes
 	};
 }
\ No newline at end of file
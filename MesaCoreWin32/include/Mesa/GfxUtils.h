@@ -7,6 +7,7 @@ namespace Mesa
 		Vertex structure used for forward rendering
 	*/
 
+#ifndef MESA_PORTABLE
 	/*
 		Vertex structure used for deferred rendering
 	*/
@@ -15,6 +16,7 @@ namespace Mesa
 		DirectX::XMFLOAT3 m_Position;
 		DirectX::XMFLOAT2 m_TexCoord;
 	};
+#endif
 
 	enum ShaderType
 	{
@@ -22,12 +24,45 @@ namespace Mesa
 		ShaderType_Deferred = 1, // Used for deferred rendering
 	};
 
+	enum AssetType
+	{
+		AssetType_Shader = 0,
+		AssetType_Texture = 1,
+		AssetType_Model = 2,
+		AssetType_Material = 3,
+	};
+
+#ifndef MESA_PORTABLE
 	struct VertexDx11
 	{
 		DirectX::XMFLOAT3 m_Position;
 		DirectX::XMFLOAT2 m_TexCoord;
 		DirectX::XMFLOAT3 m_Normal;
 	};
+#else
+	// Same layout as on Windows, so the null renderer counts the same buffer sizes
+	struct VertexDx11
+	{
+		glm::vec3 m_Position;
+		glm::vec2 m_TexCoord;
+		glm::vec3 m_Normal;
+	};
+#endif
+
+	/*
+		Axis aligned box and sphere around the same center, used to test visibility of meshes.
+		Box is tighter for long thin meshes and sphere for rotated ones, so tests use the smaller of both.
+	*/
+	struct MSAPI BoundingVolume
+	{
+		glm::vec3 m_Center = glm::vec3(0.0f);
+		glm::vec3 m_Extents = glm::vec3(0.0f); // Half of the size of the box along every axis
+		float m_Radius = 0.0f;
+
+		static BoundingVolume FromPoints(const float* p_Positions, size_t count, size_t stride);
+		static BoundingVolume Merge(const BoundingVolume& a, const BoundingVolume& b);
+		BoundingVolume Transform(const glm::mat4x4& world) const;
+	};
 
 	class MSAPI Shader
 	{
@@ -36,12 +71,18 @@ namespace Mesa
 		inline ShaderType GetShaderType() const noexcept { return m_ShaderType; }
 		inline std::string GetVertexShaderName() const noexcept { return m_VertexShaderName; }
 		inline std::string GetPixelShaderName() const noexcept { return m_PixelShaderName; }
+		inline bool IsInstanced() const noexcept { return m_IsInstanced; }
+
+	public:
+		// Semantic of per-instance world matrix rows, vertex shaders that declare it are drawn with instancing
+		static constexpr const char* INSTANCE_SEMANTIC = "INSTANCE_WORLD";
 
 	protected:
 		std::string m_VertexShaderName = std::string();
 		std::string m_PixelShaderName = std::string();
 		uint32_t m_ShaderUID = 0;
 		ShaderType m_ShaderType = ShaderType_Forward;
+		bool m_IsInstanced = false;
 	};
 
 	class MSAPI Model
@@ -66,6 +107,7 @@ namespace Mesa
 		uint32_t m_TextureUID = 0;
 	};
 
+#ifndef MESA_PORTABLE
 	class MSAPI ShaderDx11 : public Shader
 	{
 		friend class GraphicsDx11;
@@ -87,12 +129,18 @@ namespace Mesa
 	{
 		friend class GraphicsDx11;
 		friend class ModelDx11;
+	public:
+		inline const BoundingVolume& GetBounds() const noexcept { return m_Bounds; }
+		inline uint32_t GetMaterialId() const noexcept { return m_MaterialId; }
+
 	private:
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mp_VertexBuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mp_IndexBuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mp_ColorPassBuffer;
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mp_SpecularPassBuffer;
 		uint32_t m_NumIndices = 0;
+		uint64_t m_NumBytes = 0; // Size of all buffers of the mesh
+		BoundingVolume m_Bounds; // Bounds of vertices in model space
 		uint32_t m_MaterialId = 0;
 		std::string m_MaterialName = std::string();
 		std::string m_MeshMatName = std::string();
@@ -101,14 +149,64 @@ namespace Mesa
 	class MSAPI ModelDx11 : public Model
 	{
 		friend class GraphicsDx11;
+	public:
+		inline const std::vector<MeshDx11>& GetMeshes() const noexcept { return mv_Meshes; }
+		inline const BoundingVolume& GetBounds() const noexcept { return m_Bounds; }
+
 	private:
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mp_ConstBufferMVP;
 		std::vector<MeshDx11> mv_Meshes;
+		BoundingVolume m_Bounds; // Bounds of all meshes in model space
+	};
+#endif
+
+	/*
+		Assets of GraphicsNull, they keep only what is needed to walk draw calls of a frame
+	*/
+	class MSAPI ShaderNull : public Shader
+	{
+		friend class GraphicsNull;
+	};
+
+	class MSAPI TextureNull : public Texture
+	{
+		friend class GraphicsNull;
+	private:
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+	};
+
+	class MSAPI MeshNull
+	{
+		friend class GraphicsNull;
+	public:
+		inline const BoundingVolume& GetBounds() const noexcept { return m_Bounds; }
+		inline uint32_t GetMaterialId() const noexcept { return m_MaterialId; }
+
+	private:
+		uint32_t m_NumIndices = 0;
+		BoundingVolume m_Bounds; // Bounds of vertices in model space
+		uint32_t m_MaterialId = 0;
+		std::string m_MaterialName = std::string();
+		std::string m_MeshMatName = std::string();
+	};
+
+	class MSAPI ModelNull : public Model
+	{
+		friend class GraphicsNull;
+	public:
+		inline const std::vector<MeshNull>& GetMeshes() const noexcept { return mv_Meshes; }
+		inline const BoundingVolume& GetBounds() const noexcept { return m_Bounds; }
+
+	private:
+		std::vector<MeshNull> mv_Meshes;
+		BoundingVolume m_Bounds; // Bounds of all meshes in model space
 	};
 
 	class MSAPI Material
 	{
 		friend class GraphicsDx11;
+		friend class GraphicsNull;
 	public: // Setters
 		inline void SetBaseColor(const glm::vec4& color) noexcept { m_BaseColor = color; }
 		inline void SetSubColor(const glm::vec4& color) noexcept { m_SubColor = color; }
@@ -1,13 +1,38 @@
 #pragma once
 #include "Core.h"
+#ifndef MESA_PORTABLE
 #include "Window.h"
+#endif
 #include "Exception.h"
 #include "GfxUtils.h"
 #include "GameObject.h"
 #include "Camera.h"
+#include "TaskGraph.h"
+#include "AssetHandle.h"
+#include "UploadQueue.h"
+#include "SingleFlight.h"
+#include "AssetRegistry.h"
+#include "AssetBlob.h"
+#include "MaterialDefinitionCache.h"
+#include "MaterialFormat.h"
+#ifndef MESA_PORTABLE
+#include "FileWatcher.h"
+#endif
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
+#include "SceneIndex.h"
+#include "InstanceBatcher.h"
+#include "FrameGraph.h"
+#include "UploadRing.h"
+#include "DrawRecorder.h"
 
 namespace Mesa
 {
+#ifdef MESA_PORTABLE
+	// There are no windows in portable builds, frames are drawn without presenting them
+	class Window;
+#endif
+
 	class MSAPI Graphics
 	{
 	public:
@@ -24,12 +49,300 @@ namespace Mesa
 		virtual void SetCamera(Camera* p_Camera) = 0;
 		virtual void InsertGameObject(GameObject3D* p_GameObject) = 0;
 		virtual uint32_t LoadModelFromPack(const std::string& originalName) = 0;
+		virtual std::map<std::string, uint32_t> LoadModelsFromPack(const std::vector<std::string>& v_OriginalNames) = 0;
 		virtual uint32_t CompileForwardShaderFromPack(const std::string& vertexName) = 0;
 		virtual uint32_t LoadTextureFromPack(const std::string& originalName) = 0;
+		virtual std::map<std::string, uint32_t> LoadTexturesFromPack(const std::vector<std::string>& v_OriginalNames) = 0;
 		virtual uint32_t LoadMaterialFromPack(const std::string& originalName) = 0;
 		virtual void SetBlendingShader(uint32_t shaderId) = 0;
+
+		virtual AssetHandle<uint32_t> LoadModelAsync(std::string originalName) = 0;
+		virtual AssetHandle<uint32_t> LoadTextureAsync(std::string originalName) = 0;
+		virtual AssetHandle<uint32_t> LoadMaterialAsync(std::string originalName) = 0;
+		virtual AssetHandle<std::map<std::string, uint32_t>> LoadModelPackAsync(std::string packPath) = 0;
+		virtual AssetHandle<std::map<std::string, uint32_t>> LoadTexturePackAsync(std::string packPath) = 0;
+		virtual AssetHandle<std::map<std::string, uint32_t>> LoadMaterialPackAsync(std::string packPath) = 0;
+
+		virtual bool AddReference(AssetType type, uint32_t id) = 0;
+		virtual void ReleaseReference(AssetType type, uint32_t id) = 0;
+		virtual AssetRegistryStatistics GetAssetStatistics(AssetType type) = 0;
+		virtual CullingStatistics GetCullingStatistics() = 0;
+		virtual FrameGraphStatistics GetFrameGraphStatistics() = 0;
+
+		virtual void QueryObjectsInBox(const glm::vec3& min, const glm::vec3& max, std::vector<GameObject3D*>& v_OutObjects) = 0;
+		virtual void QueryObjectsInSphere(const glm::vec3& center, float radius, std::vector<GameObject3D*>& v_OutObjects) = 0;
+		virtual GameObject3D* RayCastObjects(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) = 0;
+
+	protected:
+		static AssetBlob ReadAssetFromPack(const std::string& assetType, const std::string& originalName);
 	};
 
+	/*
+		Part of graphics backends that doesn't depend on the graphics API.
+		It owns registries of loaded assets, the scene and the render queue, evicts unused assets
+		and queues draws of visible objects, so every backend culls, sorts and evicts the same way.
+		Backends only create their own assets and execute the queue.
+	*/
+	template<typename TShader, typename TTexture, typename TModel>
+	class GraphicsBackend : public Graphics
+	{
+	public: // Frame drawing functions
+		void SetNumberOfLayers(const uint32_t& layers) override
+		{
+			// Validate if the requested number of layers is valid
+			if (layers > RenderQueue::MAX_LAYERS)
+			{
+				LOG_F(WARNING, "Requested %u layers, only %u are supported", layers, RenderQueue::MAX_LAYERS);
+				m_NumLayers = RenderQueue::MAX_LAYERS;
+			}
+			else if (layers > 0)
+				m_NumLayers = layers;
+			else // If not set it to minimal valid option
+				m_NumLayers = 1;
+		}
+
+		void InsertGameObject(GameObject3D* p_GameObject) override
+		{
+			if (p_GameObject != nullptr)
+			{
+				mv_Objects.push_back(p_GameObject);
+				m_SceneIndex.Insert(p_GameObject);
+			}
+			else
+				LOG_F(WARNING, "Nullptr was passed to InsertGameObject function");
+		}
+
+	public: // Asset lifetime
+		/*
+			Adds reference to the asset so it's never evicted.
+			Returns false if the asset isn't loaded.
+		*/
+		bool AddReference(AssetType type, uint32_t id) override
+		{
+			switch (type)
+			{
+			case AssetType_Texture: return m_Textures.AddReference(id);
+			case AssetType_Model: return m_Models.AddReference(id);
+			case AssetType_Material: return m_Materials.AddReference(id);
+			default: return m_Shaders.AddReference(id);
+			}
+		}
+
+		/*
+			Releases reference to the asset. Asset stays loaded until it has to be evicted to fit into the memory budget.
+		*/
+		void ReleaseReference(AssetType type, uint32_t id) override
+		{
+			switch (type)
+			{
+			case AssetType_Texture: m_Textures.ReleaseReference(id); break;
+			case AssetType_Model: m_Models.ReleaseReference(id); break;
+			case AssetType_Material: m_Materials.ReleaseReference(id); break;
+			default: m_Shaders.ReleaseReference(id); break;
+			}
+		}
+
+		/*
+			Returns memory usage, eviction and reload statistics of one category of assets
+		*/
+		AssetRegistryStatistics GetAssetStatistics(AssetType type) override
+		{
+			switch (type)
+			{
+			case AssetType_Texture: return m_Textures.GetStatistics();
+			case AssetType_Model: return m_Models.GetStatistics();
+			case AssetType_Material: return m_Materials.GetStatistics();
+			default: return m_Shaders.GetStatistics();
+			}
+		}
+
+		/*
+			Returns number of objects tested against the camera frustum in the last frame and how many of them were visible
+		*/
+		CullingStatistics GetCullingStatistics() override
+		{
+			return m_FrustumCuller.GetStatistics();
+		}
+
+		/*
+			Returns how many passes and copies the frame graph of the last frame removed and how many textures it used
+		*/
+		FrameGraphStatistics GetFrameGraphStatistics() override
+		{
+			return m_FrameGraph.GetStatistics();
+		}
+
+	public: // Spatial queries of objects, answered from bounds of the last drawn frame
+		void QueryObjectsInBox(const glm::vec3& min, const glm::vec3& max, std::vector<GameObject3D*>& v_OutObjects) override
+		{
+			m_SceneIndex.QueryBox(min, max, v_OutObjects);
+		}
+
+		void QueryObjectsInSphere(const glm::vec3& center, float radius, std::vector<GameObject3D*>& v_OutObjects) override
+		{
+			m_SceneIndex.QuerySphere(center, radius, v_OutObjects);
+		}
+
+		/*
+			Returns the closest object hit by the ray, or nullptr if the ray doesn't hit any object
+		*/
+		GameObject3D* RayCastObjects(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) override
+		{
+			return m_SceneIndex.RayCast(origin, direction, maxDistance);
+		}
+
+	protected: // Rendering functions
+		/*
+			Evicts assets without references from categories that exceed their memory budget.
+			Models are evicted first since they hold references to materials, which in turn hold references to textures.
+			Eviction stops once its time budget is used up and continues in the next frame.
+		*/
+		void EvictUnusedAssets()
+		{
+			auto start = std::chrono::steady_clock::now();
+			auto canContinue = [this, start]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() < m_EvictionBudget; };
+
+			m_Models.EvictUnused(m_FrameIndex, canContinue, [this](TModel& model)
+			{
+				LOG_F(INFO, "Evicting model %s", model.GetModelName().c_str());
+
+				for (const auto& mesh : model.GetMeshes())
+					m_Materials.ReleaseReference(mesh.GetMaterialId());
+			});
+
+			if (!canContinue()) return;
+
+			m_Materials.EvictUnused(m_FrameIndex, canContinue, [this](Material& material)
+			{
+				LOG_F(INFO, "Evicting material %s", material.GetMaterialName().c_str());
+
+				m_Textures.ReleaseReference(material.GetDiffuseTextureId());
+				m_Textures.ReleaseReference(material.GetSpecularTextureId());
+				m_Textures.ReleaseReference(material.GetNormalTextureId());
+			});
+
+			if (!canContinue()) return;
+
+			m_Textures.EvictUnused(m_FrameIndex, canContinue, [](TTexture& texture)
+			{
+				LOG_F(INFO, "Evicting texture %s", texture.GetTextureName().c_str());
+			});
+		}
+
+		/*
+			Queues color and specular draw of every mesh of visible objects on drawn layers and sorts the queue.
+			Scene index is updated with objects that moved and finds objects near the camera frustum,
+			which are then culled exactly. Meshes of visible models with several meshes are tested on their own.
+			Models and materials are marked as used here, so passes only have to read them.
+			Without a camera every object is visible and draws are ordered by distance from the origin.
+		*/
+		void BuildRenderQueue(const Camera* p_Camera)
+		{
+			m_RenderQueue.Clear();
+
+			// Models of all objects are marked as used, so models of objects outside of the view aren't evicted
+			m_SceneIndex.Update([this](uint32_t modelId) -> const BoundingVolume*
+			{
+				const TModel* p_Model = m_Models.Use(modelId, m_FrameIndex);
+				return p_Model != nullptr ? &p_Model->GetBounds() : nullptr;
+			});
+
+			glm::vec3 cameraPos = glm::vec3(0.0f);
+
+			if (p_Camera != nullptr)
+			{
+				cameraPos = p_Camera->GetPosition();
+				m_FrustumCuller.SetViewProjection(p_Camera->GetViewProjectionMatrix());
+			}
+			else // Culler without a frustum keeps every object
+				m_FrustumCuller = FrustumCuller();
+
+			mv_CullObjects.clear();
+			mv_CullModels.clear();
+			mv_CullWorlds.clear();
+			mv_CullBounds.clear();
+
+			// Scene index skips parts of the scene outside of the frustum, remaining objects are tested exactly
+			m_SceneIndex.QueryFrustum(m_FrustumCuller.GetPlanes(), mv_CullObjects);
+
+			std::erase_if(mv_CullObjects, [this](const GameObject3D* object) { return object->GetLayer() >= m_NumLayers; });
+
+			for (const auto& object : mv_CullObjects)
+			{
+				const TModel* p_Model = m_Models.Get(object->GetModel());
+
+				mv_CullModels.push_back(p_Model);
+				mv_CullWorlds.push_back(object->GetWorldMatrix());
+				mv_CullBounds.push_back(p_Model->GetBounds());
+			}
+
+			m_FrustumCuller.Cull(mv_CullWorlds, mv_CullBounds, mv_CullResults);
+
+			// Draws of visible objects are made by workers, each of them handles a slice of the objects
+			m_RenderQueue.PushParallel(mv_CullObjects.size(), [this, &cameraPos](size_t i, std::vector<DrawItem>& v_OutItems)
+			{
+				if (!mv_CullResults[i]) return;
+
+				const GameObject3D* object = mv_CullObjects[i];
+				const auto& v_Meshes = mv_CullModels[i]->GetMeshes();
+				const glm::mat4x4& world = mv_CullWorlds[i];
+
+				float depth = glm::distance(glm::vec3(world[3]), cameraPos);
+
+				for (uint32_t j = 0; j < v_Meshes.size(); j++)
+				{
+					const auto& mesh = v_Meshes[j];
+
+					// Bounds of a single mesh are the bounds of the model that already passed
+					if (v_Meshes.size() > 1 && !m_FrustumCuller.IsVisible(mesh.GetBounds().Transform(world))) continue;
+
+					if (mesh.GetMaterialId() != 0)
+						m_Materials.Use(mesh.GetMaterialId(), m_FrameIndex);
+
+					DrawItem item = {};
+					item.mp_Object = object;
+					item.m_ModelId = object->GetModel();
+					item.m_MaterialId = mesh.GetMaterialId();
+					item.m_MeshIndex = j;
+
+					item.m_ShaderId = object->GetColorShader();
+					item.m_SortKey = RenderQueue::MakeSortKey(object->GetLayer(), DrawPass_Color, item.m_ShaderId, item.m_MaterialId, item.m_ModelId, depth);
+					v_OutItems.push_back(item);
+
+					item.m_ShaderId = object->GetSpecularShader();
+					item.m_SortKey = RenderQueue::MakeSortKey(object->GetLayer(), DrawPass_Specular, item.m_ShaderId, item.m_MaterialId, item.m_ModelId, depth);
+					v_OutItems.push_back(item);
+				}
+			});
+
+			m_RenderQueue.Sort();
+		}
+
+	protected: // Registries of loaded assets, IDs of assets are their handles
+		AssetRegistry<TShader> m_Shaders;
+		AssetRegistry<TTexture> m_Textures;
+		AssetRegistry<TModel> m_Models;
+		AssetRegistry<Material> m_Materials;
+
+	protected: // Frame data
+		double m_EvictionBudget = 0.5; // Time in milliseconds that can be spent on evicting unused assets every frame
+		uint64_t m_FrameIndex = 0; // Number of drawn frames, used to find least recently used assets
+		std::vector<GameObject3D*> mv_Objects;
+		RenderQueue m_RenderQueue; // Draws of the current frame, rebuilt every frame
+		FrameGraph m_FrameGraph; // Passes of the current frame, rebuilt every frame
+		uint32_t m_NumLayers = 1; // Use only 1 layer by default
+
+	protected: // Visibility of objects, vectors are reused every frame
+		SceneIndex m_SceneIndex;
+		FrustumCuller m_FrustumCuller;
+		std::vector<GameObject3D*> mv_CullObjects; // Objects whose boxes in the scene index touch the frustum
+		std::vector<const TModel*> mv_CullModels;
+		std::vector<glm::mat4x4> mv_CullWorlds;
+		std::vector<BoundingVolume> mv_CullBounds;
+		std::vector<uint8_t> mv_CullResults;
+	};
+
+#ifndef MESA_PORTABLE
 	class MSAPI GraphicsDx11Exception : public Exception
 	{
 	public:
@@ -40,7 +353,7 @@ namespace Mesa
 		HRESULT m_Code;
 	};
 
-	class MSAPI GraphicsDx11 : public Graphics
+	class MSAPI GraphicsDx11 : public GraphicsBackend<ShaderDx11, TextureDx11, ModelDx11>
 	{
 	public:
 		GraphicsDx11(Window* p_Window);
@@ -49,9 +362,7 @@ namespace Mesa
 
 	public: // Frame drawing functions
 		void DrawFrame(Window* p_Window) override;
-		void SetNumberOfLayers(const uint32_t& layers) override;
 		void SetCamera(Camera* p_Camera) override;
-		void InsertGameObject(GameObject3D* p_GameObject) override;
 		void SetBlendingShader(uint32_t shaderId) override;
 
 	public: // Asset loading functions
@@ -62,10 +373,23 @@ namespace Mesa
 		std::map<std::string, uint32_t> LoadMaterialPack(const std::string& packPath) override;
 
 		uint32_t LoadModelFromPack(const std::string& originalName) override;
+		std::map<std::string, uint32_t> LoadModelsFromPack(const std::vector<std::string>& v_OriginalNames) override;
 		uint32_t CompileForwardShaderFromPack(const std::string& vertexName) override;
 		uint32_t LoadTextureFromPack(const std::string& originalName) override;
+		std::map<std::string, uint32_t> LoadTexturesFromPack(const std::vector<std::string>& v_OriginalNames) override;
 		uint32_t LoadMaterialFromPack(const std::string& originalName) override;
 
+	public: // Asynchronous asset loading functions
+		AssetHandle<uint32_t> LoadModelAsync(std::string originalName) override;
+		AssetHandle<uint32_t> LoadTextureAsync(std::string originalName) override;
+		AssetHandle<uint32_t> LoadMaterialAsync(std::string originalName) override;
+		AssetHandle<std::map<std::string, uint32_t>> LoadModelPackAsync(std::string packPath) override;
+		AssetHandle<std::map<std::string, uint32_t>> LoadTexturePackAsync(std::string packPath) override;
+		AssetHandle<std::map<std::string, uint32_t>> LoadMaterialPackAsync(std::string packPath) override;
+
+	public: // Statistics
+		void LogLoadStatistics();
+
 	public: // Getters
 		uint32_t GetShaderIdByVertexName(const std::string& name);
 		uint32_t GetShaderIdByPixelName(const std::string& name);
@@ -73,7 +397,26 @@ namespace Mesa
 		uint32_t GetModelIdByName(const std::string& name);
 		uint32_t GetMaterialIdByName(const std::string& name);
 
+	private: // Asset data prepared on CPU before DirectX resources are created
+		// Texture decoded on CPU that waits for its DirectX resources
+		struct DecodedTexture
+		{
+			std::vector<uint8_t> mv_Pixels;
+			uint32_t m_Width = 0;
+			uint32_t m_Height = 0;
+		};
+
+		// Mesh imported by ASSIMP that waits for its buffers
+		struct MeshData
+		{
+			std::vector<VertexDx11> mv_Vertices;
+			std::vector<uint32_t> mv_Indices;
+			std::string m_MeshMatName;
+		};
+
 	private: // Pipeline initialization functions
+		void ReadStreamingSettings();
+		void InitializeHotReload();
 		void InitializeFactory();
 		IDXGIAdapter* FindSuitableAdapter();
 		void InitializeDevice();
@@ -86,63 +429,102 @@ namespace Mesa
 		void InitializeRasterizer();
 		void InitializeSampler();
 		void InitializeBlendState();
+		void InitializeUploadRing();
+		void InitializeDeferredContexts();
 
 	private: // Model data processing
-		void ProcessNode(ModelDx11& outMdl, aiNode* p_Node, const aiScene* p_Scene);
-		MeshDx11 ProcessMesh(aiMesh* p_Mesh, const aiScene* p_Scene);
+		void ProcessNode(std::vector<MeshData>& v_OutMeshes, aiNode* p_Node, const aiScene* p_Scene);
+		MeshData ProcessMesh(aiMesh* p_Mesh, const aiScene* p_Scene);
+		bool CreateMeshBuffers(const MeshData& meshData, MeshDx11& outMesh);
+
+	private: // Asset cache serialization
+		static std::vector<uint8_t> SerializeTexture(const DecodedTexture& texture);
+		static bool DeserializeTexture(const std::vector<uint8_t>& v_Data, DecodedTexture& outTexture);
+		static std::vector<uint8_t> SerializeMeshes(const std::vector<MeshData>& v_Meshes);
+		static bool DeserializeMeshes(const std::vector<uint8_t>& v_Data, std::vector<MeshData>& v_OutMeshes);
 
 	private: // Engine side assets initializers
 		void InitializeBlendingMesh();
 
 	private: // Rendering functions
-		void RenderColorBuffer(int layer);
-		void RenderSpecularBuffer(int layer);
-		void BlendLayers();
+		void SubmitDrawItems(uint32_t layer, DrawPass pass);
+		bool UploadInstances(std::span<const glm::mat4x4> instances);
+		void RecordDrawStreams(DrawPass pass);
+		void UploadDrawStreams();
+		bool CopyDrawStreams(uint8_t* p_Data);
+		void ReplayDrawStreams(DrawPass pass, bool hasInstances);
+		void ReplayDrawStream(ID3D11DeviceContext* p_Context, ID3D11DeviceContext1* p_Context1, const DrawStream& stream, DrawPass pass, bool hasInstances);
+		void BindConstants(ID3D11DeviceContext* p_Context, ID3D11DeviceContext1* p_Context1, bool isPixelStage, uint64_t offset, uint32_t size, ID3D11Buffer* p_Buffer);
+		void CreateUploadBuffer(uint64_t capacity);
+		void ReleaseCompletedFrames(bool waitForOldest);
+		void BlendLayer(ID3D11ShaderResourceView* p_Layer, ID3D11ShaderResourceView* p_Previous);
+
+	private: // Frame graph
+		void BuildFrameGraph();
+		void CreateFrameTextures();
+		void BeginFramePass(const FrameGraph& graph, FrameResource target);
+		void ApplyFrameBarrier(const FrameBarrier& barrier);
+		ID3D11Texture2D* GetFrameTexture(uint32_t texture) const;
+
+	private: // Hot reload of changed packs
+		void ProcessHotReload();
+		bool ReloadShader(uint32_t id, const std::string& vertexName);
+		bool ReloadTexture(uint32_t id, const std::string& textureName);
+		bool ReloadMaterial(uint32_t id, const std::string& matName);
+		bool ReloadModel(uint32_t id, const std::string& modelName);
 
 	private: // Synchronus asset loading functions
 		std::map<std::string, std::string> LoadMaterialDefinitions(const std::string& matDefName);
 
+	private: // Asset load graph
+		TaskId ScheduleModelLoad(TaskGraph& graph, const std::string& modelName, AssetBlob modelData = {});
+		TaskId ScheduleMaterialLoad(TaskGraph& graph, const std::string& materialName, AssetBlob matData = {});
+		TaskId ScheduleTextureLoad(TaskGraph& graph, const std::string& textureName, AssetBlob textureData = {});
+		void ExecuteLoadGraph(TaskGraph& graph);
+
+	private: // Asynchronous asset loading helpers
+		AssetHandle<uint32_t> BeginModelLoad(std::string originalName);
+		AssetHandle<uint32_t> BeginTextureLoad(std::string originalName);
+		AssetHandle<uint32_t> BeginMaterialLoad(std::string originalName);
+		AssetHandle<std::map<std::string, uint32_t>> LoadPackAsync(std::string packPath, AssetHandle<uint32_t>(GraphicsDx11::* p_LoadAsync)(std::string));
+
 	private: // Asynchronus asset loading functions
 		// Vertex buffer creation
-		static void CreateVertexBuffer(std::vector<VertexDx11> v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result);
-		static void CreateDeferredVertexBuffer(std::vector<DeferredVertexDx11> v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result);
-		static void CreateVertexBufferCritical(std::vector<VertexDx11> v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx);
-		static void CreateDeferredVertexBufferCritical(std::vector<DeferredVertexDx11> v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx);
+		static void CreateVertexBuffer(const std::vector<VertexDx11>& v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result);
+		static void CreateDeferredVertexBuffer(const std::vector<DeferredVertexDx11>& v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result);
+		static void CreateVertexBufferCritical(const std::vector<VertexDx11>& v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx);
+		static void CreateDeferredVertexBufferCritical(const std::vector<DeferredVertexDx11>& v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx);
 
 		// Shader compilation
-		static void CompileShader(std::vector<uint8_t> v_VertexData, std::vector<uint8_t> v_PixelData, ShaderType type, GraphicsDx11* p_Gfx, std::string vertexName, std::string pixelName);
-		static void CompileVertexShader(std::vector<uint8_t> v_VertexData, ShaderType type, ID3D11VertexShader** pp_Shader, ID3D11InputLayout** pp_Layout, GraphicsDx11* p_Gfx);
-		static void CompilePixelShader(std::vector<uint8_t> v_PixelData, ShaderType type, ID3D11PixelShader** pp_Shader, GraphicsDx11* p_Gfx);
+		static void CompileShader(ByteView vertexData, ByteView pixelData, ShaderType type, GraphicsDx11* p_Gfx, std::string vertexName, std::string pixelName);
+		static bool BuildShader(ByteView vertexData, ByteView pixelData, ShaderType type, GraphicsDx11* p_Gfx, ShaderDx11& outShader);
+		static void CompileVertexShader(ByteView vertexData, ShaderType type, ID3D11VertexShader** pp_Shader, ID3D11InputLayout** pp_Layout, bool* p_OutInstanced, GraphicsDx11* p_Gfx);
+		static void CompilePixelShader(ByteView pixelData, ShaderType type, ID3D11PixelShader** pp_Shader, GraphicsDx11* p_Gfx);
 		
 		// Index buffer creation
-		static void CreateIndexBuffer(std::vector<uint32_t> v_inds, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result);
+		static void CreateIndexBuffer(const std::vector<uint32_t>& v_inds, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result);
 		
 		// Const buffer creation
 		static void CreateEmptyBuffer(size_t size, UINT bindFlag, D3D11_USAGE usage, UINT cpuAccess, GraphicsDx11* p_Gfx, ID3D11Buffer** pp_Buffer, bool& result);
 		static void CreateCriticalBuffer(size_t size, UINT bindFlag, D3D11_USAGE usage, UINT cpuAccess, GraphicsDx11* p_Gfx, ID3D11Buffer** pp_Buffer);
 		
 		// Texture loading
-		static void LoadTexture(std::vector<uint8_t> v_TextureData, GraphicsDx11* p_Gfx, std::string textureName);
+		static void LoadTexture(AssetBlob textureData, GraphicsDx11* p_Gfx, std::string textureName);
+		uint32_t LoadTextureOnce(const std::string& textureName, const std::function<AssetBlob()>& readData);
+		static bool DecodeTexture(ByteView textureData, const std::string& textureName, DecodedTexture& outTexture);
+		static void CreateTexture(const DecodedTexture& decodedTexture, GraphicsDx11* p_Gfx, std::string textureName);
+		static bool BuildTexture(const DecodedTexture& decodedTexture, GraphicsDx11* p_Gfx, TextureDx11& outTexture);
 		static void LoadTextureFromPackAsync(std::string originalName, GraphicsDx11* p_Gfx);
 		static void CreateCriticalTexture(uint32_t width, uint32_t height, DXGI_FORMAT format, D3D11_BIND_FLAG bindFlag, GraphicsDx11* p_Gfx, ID3D11Texture2D** pp_Texture, ID3D11ShaderResourceView** pp_View);
 		
 		// Model loading
-		static void LoadModel(std::vector<uint8_t> v_ModelData, GraphicsDx11* p_Gfx, std::string modelName);
+		static bool ImportMeshes(ByteView modelData, GraphicsDx11* p_Gfx, const std::string& modelName, std::vector<MeshData>& v_OutMeshes);
+		static bool ImportModel(ByteView modelData, GraphicsDx11* p_Gfx, const std::string& modelName, ModelDx11& outModel);
+		static void RegisterModel(ModelDx11 model, GraphicsDx11* p_Gfx, std::string modelName);
 		
 		// Material loading
-		static void CreateMaterial(std::vector<uint8_t> v_MatData, GraphicsDx11* p_Gfx, std::string matName);
-
-	private: // ID generating functions
-		uint32_t GenerateShaderUID();
-		uint32_t GenerateTextureUID();
-		uint32_t GenerateModelUID();
-		uint32_t GenerateMaterialUID();
-
-	private: // ID generators semaphores
-		std::binary_semaphore m_TextureIdSemaphore{ 1 };
-		std::binary_semaphore m_ShaderIdSemaphore{ 1 };
-		std::binary_semaphore m_MaterialIdSemaphore{ 1 };
-		std::binary_semaphore m_ModelIdSemaphore{ 1 };
+		static void CreateMaterial(const MaterialDescription& description, GraphicsDx11* p_Gfx, std::string matName);
+		static Material BuildMaterial(const MaterialDescription& description, GraphicsDx11* p_Gfx, const std::string& matName);
 
 	private: // Basic D3D11 pipeline interfaces
 		Microsoft::WRL::ComPtr<IDXGIFactory> mp_Factory;
@@ -160,32 +542,72 @@ namespace Mesa
 		Microsoft::WRL::ComPtr<ID3D11BlendState> mp_BlendState;
 
 	private: // Layer rendering interfaces
-		Microsoft::WRL::ComPtr<ID3D11Texture2D> mp_LayerColorBuffer;
-		Microsoft::WRL::ComPtr<ID3D11Texture2D> mp_PrevLayerColorBuffer;
-		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mp_ColorResourceView;
-		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mp_PrevColorResourceView;
+		struct FrameTextureDx11
+		{
+			Microsoft::WRL::ComPtr<ID3D11Texture2D> mp_Texture;
+			Microsoft::WRL::ComPtr<ID3D11RenderTargetView> mp_TargetView;
+			Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mp_ResourceView;
+			FrameTextureDesc m_Desc;
+		};
 
-		Microsoft::WRL::ComPtr<ID3D11Texture2D> mp_LayerSpecBuffer;
-		Microsoft::WRL::ComPtr<ID3D11Texture2D> mp_PrevLayerSpecBuffer;
-		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mp_SpecResourceView;
-		Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> mp_PrevSpecResourceView;
+		FrameResource m_BackBufferResource = 0;
+		FrameTextureDesc m_BackBufferDesc;
+		std::vector<FrameTextureDx11> mv_FrameTextures; // Physical textures of the frame graph, imported ones are left empty
 
 		Microsoft::WRL::ComPtr<ID3D11Buffer> mp_BlendingPlaneBuffer;
 
-	private: // Buffers for loaded assets
-		std::vector<ShaderDx11> mv_Shaders;
-		std::vector<TextureDx11> mv_Textures;
-		std::vector<ModelDx11> mv_Models;
-		std::vector<Material> mv_Materials;
+	private: // Main thread part of asynchronous loads
+		UploadQueue m_UploadQueue;
+		double m_UploadBudget = 2.0; // Time in milliseconds that can be spent on the upload queue every frame
 
-	private: // Vector to hold drawable game objects
-		std::vector<GameObject3D*> mv_Objects;
+	private: // Streaming of whole packs
+		struct PipelineSettings
+		{
+			uint64_t m_MaxBytesInFlight = 64 * 1024 * 1024; // Memory that entries streamed through a pipeline can take at once
+			uint32_t m_NumReadWorkers = 2;
+			uint32_t m_NumDecodeWorkers = 1; // Hardware threads - 1 unless set in config
+			uint32_t m_NumUploadWorkers = 1;
+		};
+
+		PipelineSettings m_PipelineSettings;
+
+	private: // Requests that are currently loading, used to load every asset only once
+		SingleFlight<uint32_t> m_TextureRequests;
+		AsyncSingleFlight<uint32_t> m_AsyncTextureRequests;
+		AsyncSingleFlight<uint32_t> m_AsyncMaterialRequests;
+		AsyncSingleFlight<uint32_t> m_AsyncModelRequests;
+		std::atomic<uint64_t> m_NumDuplicateResources = 0; // Resources dropped because the same asset was registered first by another load
+
+	private: // Material definitions of models shared by all loads
+		MaterialDefinitionCache m_MaterialDefinitions;
+
+	private: // Hot reload of changed packs
+		std::unique_ptr<FileWatcher> mp_FileWatcher; // Null if hot reload is disabled
+		std::map<std::string, uint32_t> m_EntryHashes; // Hashes of pack entries from the last read of lookup table
+
+	private: // Instanced drawing
+		InstanceBatcher m_InstanceBatcher;
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mp_InstanceBuffer; // World matrices of instanced draws of the current pass
+		uint32_t m_InstanceCapacity = 0; // Number of matrices that fit into the instance buffer
+
+	private: // Constant data of draws, sub-allocated from one buffer shared by all frames
+		UploadRing m_UploadRing;
+		Microsoft::WRL::ComPtr<ID3D11DeviceContext1> mp_Context1; // Null if constant buffers can't be bound by offset
+		Microsoft::WRL::ComPtr<ID3D11Buffer> mp_UploadBuffer;
+		bool m_IsUploadBufferNew = true; // First map of a buffer has to discard it
+		std::array<Microsoft::WRL::ComPtr<ID3D11Query>, UploadRing::MAX_FRAMES_IN_FLIGHT> ma_FrameFences; // Signaled when GPU finishes a frame
+		std::vector<uint8_t> mv_UploadStaging; // Holds constants instead of the buffer if they can't be bound by offset
+
+	private: // Parallel recording of draws
+		DrawRecorder m_DrawRecorder;
+		std::vector<Microsoft::WRL::ComPtr<ID3D11DeviceContext1>> mv_DeferredContexts; // Empty if the driver doesn't support command lists
+		std::vector<Microsoft::WRL::ComPtr<ID3D11CommandList>> mv_CommandLists; // Command lists of the current pass, one per deferred context
 
 	private: // Camera related data
 		CameraDx11* mp_Camera = nullptr;
 
 	private: // Data related to layer drawing
-		uint32_t m_NumLayers = 1; // Use only 1 layer by default
 		uint32_t m_BlendingShaderId = 0;
 	};
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+#include "Core.h"
+#include "Graphics.h"
+
+namespace Mesa
+{
+	/*
+		Graphics backend that doesn't use any GPU.
+		Packs are read, textures decoded and models imported the same way as by GraphicsDx11 and
+		assets are registered under the same kind of IDs, but no GPU resources are created.
+		Frames walk the scene like GraphicsDx11 does and count draw calls instead of issuing them,
+		so load times and CPU cost of frames can be measured on machines without a GPU.
+		Shaders are read from their packs but not compiled.
+	*/
+	class MSAPI GraphicsNull : public GraphicsBackend<ShaderNull, TextureNull, ModelNull>
+	{
+	public:
+		GraphicsNull();
+		~GraphicsNull();
+
+	public: // Frame drawing functions
+		void DrawFrame(Window* p_Window) override;
+		void SetCamera(Camera* p_Camera) override;
+		void SetBlendingShader(uint32_t shaderId) override;
+
+	public: // Asset loading functions
+		std::map<std::string, uint32_t> CompileForwardShaderPack(const std::string& packPath) override;
+		std::map<std::string, uint32_t> CompileDeferredShaderPack(const std::string& packPath) override;
+		std::map<std::string, uint32_t> LoadTexturePack(const std::string& packPath) override;
+		std::map<std::string, uint32_t> LoadModelPack(const std::string& packPath) override;
+		std::map<std::string, uint32_t> LoadMaterialPack(const std::string& packPath) override;
+
+		uint32_t LoadModelFromPack(const std::string& originalName) override;
+		std::map<std::string, uint32_t> LoadModelsFromPack(const std::vector<std::string>& v_OriginalNames) override;
+		uint32_t CompileForwardShaderFromPack(const std::string& vertexName) override;
+		uint32_t LoadTextureFromPack(const std::string& originalName) override;
+		std::map<std::string, uint32_t> LoadTexturesFromPack(const std::vector<std::string>& v_OriginalNames) override;
+		uint32_t LoadMaterialFromPack(const std::string& originalName) override;
+
+	public: // Asynchronous asset loading functions
+		AssetHandle<uint32_t> LoadModelAsync(std::string originalName) override;
+		AssetHandle<uint32_t> LoadTextureAsync(std::string originalName) override;
+		AssetHandle<uint32_t> LoadMaterialAsync(std::string originalName) override;
+		AssetHandle<std::map<std::string, uint32_t>> LoadModelPackAsync(std::string packPath) override;
+		AssetHandle<std::map<std::string, uint32_t>> LoadTexturePackAsync(std::string packPath) override;
+		AssetHandle<std::map<std::string, uint32_t>> LoadMaterialPackAsync(std::string packPath) override;
+
+	public: // Statistics
+		void LogLoadStatistics();
+		void LogFrameStatistics();
+		inline const DrawStatistics& GetFrameStatistics() const noexcept { return m_FrameStatistics; }
+		inline const DrawStatistics& GetTotalStatistics() const noexcept { return m_TotalStatistics; }
+		inline uint64_t GetNumFrames() const noexcept { return m_FrameIndex; }
+		inline double GetTotalFrameTime() const noexcept { return m_TotalFrameTime; }
+
+	public: // Getters
+		uint32_t GetShaderIdByVertexName(const std::string& name);
+		uint32_t GetTextureIdByName(const std::string& name);
+		uint32_t GetModelIdByName(const std::string& name);
+		uint32_t GetMaterialIdByName(const std::string& name);
+
+	private: // Initialization
+		void ReadStreamingSettings();
+
+	private: // Rendering functions
+		void RecordLayerPass(uint32_t layer, DrawPass pass);
+		void AllocateConstants(uint64_t size);
+		void RecordBlendPass();
+		void BuildFrameGraph();
+
+	private: // Synchronus asset loading functions
+		std::map<std::string, uint32_t> LoadShaderPack(const std::string& packPath, ShaderType type);
+		uint32_t RegisterShader(const std::string& vertexName, const std::string& pixelName, ShaderType type, ByteView vertexData);
+		uint32_t LoadTexture(ByteView textureData, const std::string& textureName);
+		uint32_t LoadModel(ByteView modelData, const std::string& modelName);
+		uint32_t LoadMaterial(ByteView matData, const std::string& matName);
+		static void ProcessNode(std::vector<MeshNull>& v_OutMeshes, uint64_t& outNumBytes, aiNode* p_Node, const aiScene* p_Scene);
+
+	private: // Asynchronous asset loading helpers
+		AssetHandle<uint32_t> BeginLoad(std::string originalName, uint32_t(GraphicsNull::* p_Load)(const std::string&));
+		AssetHandle<std::map<std::string, uint32_t>> LoadPackAsync(std::string packPath, AssetHandle<uint32_t>(GraphicsNull::* p_LoadAsync)(std::string));
+
+	private: // Requests that are currently loading, used to load every asset only once
+		SingleFlight<uint32_t> m_TextureRequests;
+		AsyncSingleFlight<uint32_t> m_AsyncTextureRequests;
+		AsyncSingleFlight<uint32_t> m_AsyncMaterialRequests;
+		AsyncSingleFlight<uint32_t> m_AsyncModelRequests;
+		std::atomic<uint64_t> m_NumDuplicateResources = 0; // Assets dropped because the same asset was registered first by another load
+
+	private: // Material definitions of models shared by all loads
+		MaterialDefinitionCache m_MaterialDefinitions;
+
+	private: // Frame data
+		double m_TotalFrameTime = 0.0; // Milliseconds spent in DrawFrame() by all frames
+		DrawStatistics m_FrameStatistics; // Work of the last frame
+		DrawStatistics m_TotalStatistics; // Work of all frames
+
+		InstanceBatcher m_InstanceBatcher;
+		DrawRecorder m_DrawRecorder;
+		UploadRing m_UploadRing; // Space is released right after every frame since nothing waits for a GPU
+		Camera* mp_Camera = nullptr; // Any camera, e.g. CameraNull, drives culling and depth of draws
+		uint32_t m_BlendingShaderId = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+#include "Core.h"
+#include "RenderQueue.h"
+
+namespace Mesa
+{
+	/*
+		Draws of one mesh that are submitted together.
+		Instanced batches read world matrices of their objects from the instance list,
+		other batches hold a single draw of mp_Object.
+	*/
+	struct InstanceBatch
+	{
+		const GameObject3D* mp_Object = nullptr; // First object of the batch
+		uint32_t m_ShaderId = 0;
+		uint32_t m_ModelId = 0;
+		uint32_t m_MaterialId = 0;
+		uint32_t m_MeshIndex = 0;
+		uint32_t m_FirstInstance = 0; // Index of the first world matrix of the batch in the instance list
+		uint32_t m_NumInstances = 1;
+		bool m_IsInstanced = false;
+	};
+
+	/*
+		Groups sorted draws of a pass into instanced batches.
+		Draws of instanced shaders that share shader, material, model and mesh become one batch and
+		world matrices of their objects are packed into a flat list, ready to be copied into an instance buffer.
+		Queue already keeps these draws next to each other except for meshes of one model, which are
+		interleaved by depth, so they are split by mesh with a stable sort that keeps depth order of instances.
+		Draws of other shaders are passed through one per batch in the order of the queue.
+	*/
+	class MSAPI InstanceBatcher
+	{
+	public:
+		void Build(std::span<const DrawItem> items, const std::function<bool(uint32_t shaderId)>& isInstanced);
+
+		inline std::span<const InstanceBatch> GetBatches() const noexcept { return mv_Batches; }
+		inline std::span<const glm::mat4x4> GetInstances() const noexcept { return mv_Instances; }
+
+	private:
+		static bool IsSameGroup(const DrawItem& a, const DrawItem& b);
+
+	private:
+		std::vector<InstanceBatch> mv_Batches;
+		std::vector<glm::mat4x4> mv_Instances; // World matrices of instanced batches
+		std::vector<uint32_t> mv_Order; // Draws of the current group ordered by mesh
+	};
+}
\ No newline at end of file
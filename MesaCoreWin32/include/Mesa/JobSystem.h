@@ -0,0 +1,90 @@
+#pragma once
+#include "Core.h"
+
+namespace Mesa
+{
+	using Job = std::function<void()>;
+
+	/*
+		Counts jobs that haven't finished yet.
+		Jobs are attached to the counter by JobSystem::Run() and
+		the counter can be waited on with JobSystem::Wait().
+	*/
+	class MSAPI JobCounter
+	{
+		friend class JobSystem;
+
+	public:
+		inline bool IsDone() const noexcept { return m_Pending.load() == 0; }
+
+	private:
+		std::atomic<uint32_t> m_Pending = 0;
+		std::exception_ptr mp_Exception; // First exception thrown by one of the jobs
+		std::mutex m_ExceptionMutex;
+	};
+
+	class MSAPI JobSystem
+	{
+	private:
+		struct JobEntry
+		{
+			Job m_Job;
+			JobCounter* mp_Counter = nullptr;
+		};
+
+		struct WorkQueue
+		{
+			std::deque<JobEntry> m_Jobs;
+			std::mutex m_Mutex;
+		};
+
+	public:
+		// Awaiting it from a coroutine resumes the coroutine on one of the workers
+		struct ScheduleAwaiter
+		{
+			JobSystem& m_JobSystem;
+
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> handle) { m_JobSystem.Run([handle]() { handle.resume(); }); }
+			void await_resume() const noexcept {}
+		};
+
+	public:
+		JobSystem(uint32_t numWorkers);
+		~JobSystem();
+
+		static JobSystem& GetDefault();
+
+		void Run(Job job, JobCounter* p_Counter = nullptr);
+		void Wait(JobCounter& counter);
+		bool RunPendingJob();
+		void ParallelFor(size_t count, const std::function<void(size_t)>& body, size_t batchSize = 1);
+		inline ScheduleAwaiter Schedule() noexcept { return { *this }; }
+
+		void SetNumActiveWorkers(uint32_t numWorkers);
+
+		inline uint32_t GetNumWorkers() const noexcept { return (uint32_t)mv_Workers.size(); }
+		inline uint32_t GetNumActiveWorkers() const noexcept { return m_NumActiveWorkers.load(); }
+
+	private:
+		size_t GetQueueIndex() const;
+		bool TryRunJob(size_t queueIndex);
+		void Execute(JobEntry& entry);
+		void WorkerLoop(size_t queueIndex);
+
+	private:
+		// One queue per worker and one shared queue (the last one) for threads from outside of the job system
+		std::vector<std::unique_ptr<WorkQueue>> mv_Queues;
+		std::vector<std::thread> mv_Workers;
+
+		// Number of jobs waiting in all of the queues
+		std::atomic<int32_t> m_QueuedJobs = 0;
+		// Workers with higher index sleep until the limit is raised
+		std::atomic<uint32_t> m_NumActiveWorkers = 0;
+
+		// Used to put idle threads to sleep
+		std::mutex m_SleepMutex;
+		std::condition_variable m_SleepCondition;
+		bool m_Shutdown = false;
+	};
+}
\ No newline at end of file
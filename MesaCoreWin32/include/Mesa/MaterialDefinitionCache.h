@@ -0,0 +1,48 @@
+#pragma once
+#include "Core.h"
+#include "AssetBlob.h"
+#include "LookUpUtils.h"
+#include "SingleFlight.h"
+
+namespace Mesa
+{
+	/*
+		Material definitions (.matdef files) of models parsed once per pack and shared by all model loads.
+		Lookup table is indexed by file name the first time a definition is requested. When a definition
+		of a pack that wasn't read yet is requested, definitions of all models in that pack are read with
+		a single coalesced read and parsed together, so loading every model of a pack reads the pack once.
+	*/
+	class MSAPI MaterialDefinitionCache
+	{
+	public:
+		using Definitions = std::map<std::string, std::string>; // Material name keyed by name of the mesh material
+
+	public:
+		std::shared_ptr<const Definitions> Find(const std::string& matDefName);
+		void Clear();
+
+		static Definitions Parse(ByteView data);
+
+		inline uint64_t GetNumRequests() const noexcept { return m_NumRequests; }
+		inline uint64_t GetNumPackReads() const noexcept { return m_NumPackReads; }
+
+	private:
+		void BuildIndex();
+		void ParsePack(const std::string& packName, uint64_t generation);
+
+	private:
+		bool m_Indexed = false;
+		std::map<std::string, std::string> m_FilePacks; // Pack of every definition file keyed by file name
+		std::map<std::string, std::vector<LookUpEntry>> m_PackEntries; // Definition files of every pack
+
+		std::map<std::string, std::shared_ptr<const Definitions>> m_Definitions; // Parsed files keyed by file name
+		std::set<std::string> m_ParsedPacks;
+		uint64_t m_Generation = 0; // Increased by Clear() so parses that started before it are discarded
+		std::mutex m_Mutex;
+
+		SingleFlight<bool> m_PackRequests;
+
+		std::atomic<uint64_t> m_NumRequests = 0;
+		std::atomic<uint64_t> m_NumPackReads = 0;
+	};
+}
\ No newline at end of file
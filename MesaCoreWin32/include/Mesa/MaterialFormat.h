@@ -0,0 +1,59 @@
+#pragma once
+#include "Core.h"
+#include "AssetBlob.h"
+
+namespace Mesa
+{
+	// Material parameters read from material file
+	struct MaterialDescription
+	{
+		glm::vec4 m_BaseColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+		glm::vec4 m_SubColor = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+		float m_SpecularPower = 1.0f;
+		std::string m_DiffuseTexture;
+		std::string m_SpecularTexture;
+		std::string m_NormalTexture;
+	};
+
+	// Texture used by compiled material, its name is stored after the record
+	struct MaterialTextureRef
+	{
+		uint32_t m_Offset = 0; // Position of the name relative to the end of the record
+		uint32_t m_Length = 0; // 0 if the material doesn't use this texture
+	};
+
+	/*
+		Fixed layout of compiled material.
+		Record is followed by names of textures the material uses.
+	*/
+	struct MaterialRecord
+	{
+		uint32_t m_Magic = 0;
+		uint32_t m_Version = 0;
+		float ma_BaseColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		float ma_SubColor[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float m_SpecularPower = 1.0f;
+		MaterialTextureRef ma_Textures[3]; // Diffuse, specular and normal texture
+	};
+
+	/*
+		Reads materials either as text files written by hand or as records compiled by the packer.
+		Compiled materials are copied straight into their description, so text is only parsed
+		for materials that weren't packed yet.
+	*/
+	class MSAPI MaterialFormat
+	{
+	public:
+		// Marks compiled materials ("MSMT")
+		static constexpr uint32_t MATERIAL_MAGIC = 0x544D534D;
+		// Has to be increased whenever layout of the record changes
+		static constexpr uint32_t MATERIAL_VERSION = 1;
+
+	public:
+		static MaterialDescription Parse(ByteView data);
+		static MaterialDescription ParseText(ByteView data);
+		static bool ReadCompiled(ByteView data, MaterialDescription& outDescription);
+		static std::vector<uint8_t> Compile(const MaterialDescription& description);
+		static bool IsCompiled(ByteView data);
+	};
+}
\ No newline at end of file
@@ -2,13 +2,39 @@
 #include "Core.h"
 #include "CompressionUtils.h"
 #include "FileUtils.h"
+#include "PackUtils.h"
+#include "AsyncFileReader.h"
+#include "AccessTrace.h"
+#include "Prefetcher.h"
+#include "JobSystem.h"
+#include "TaskGraph.h"
+#include "AssetHandle.h"
+#include "UploadQueue.h"
+#include "SingleFlight.h"
+#include "AssetRegistry.h"
+#include "AssetBlob.h"
+#include "AssetCache.h"
+#include "MaterialDefinitionCache.h"
+#include "MaterialFormat.h"
+#include "StreamingPipeline.h"
+#include "FileWatcher.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
+#include "BoundingVolumeTree.h"
+#include "SceneIndex.h"
+#include "InstanceBatcher.h"
+#include "FrameGraph.h"
+#include "UploadRing.h"
+#include "DrawRecorder.h"
 #include "ConvertUtils.h"
 #include "ConfigUtils.h"
+#include "EngineConfig.h"
 #include "Event.h"
 #include "Exception.h"
 #include "Window.h"
 #include "Application.h"
 #include "Entrypoint.h"
 #include "Graphics.h"
+#include "GraphicsNull.h"
 #include "Camera.h"
 #include "GameObject.h"
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include "Core.h"
+#include "AssetBlob.h"
+
+namespace Mesa
+{
+	/*
+		Location of a single entry inside of an archive
+	*/
+	struct PackEntryLocation
+	{
+		uint64_t m_Offset = 0; // Position of the first byte of the entry (relative to the beginning of the archive)
+		uint32_t m_Size = 0; // Size of the entry in bytes
+	};
+
+	/*
+		Single entry requested from an archive
+	*/
+	struct PackReadRequest
+	{
+		std::string m_PackPath; // Path to the archive that holds the entry
+		uint32_t m_Index = 0; // Index of the entry inside of the archive
+	};
+
+	class MSAPI PackUtils
+	{
+	public:
+		// Ranges separated by less than this amount of bytes are read together
+		static constexpr uint64_t DEFAULT_MERGE_GAP = 256 * 1024;
+		// Upper limit for a single coalesced read
+		static constexpr uint64_t MAX_MERGED_READ = 32 * 1024 * 1024;
+
+	public:
+		static std::vector<PackEntryLocation> ParsePackHeader(ByteView packData);
+		static std::vector<PackEntryLocation> ReadPackHeader(const std::string& packPath);
+		static AssetBlob ExtractEntry(const AssetBlob& pack, const PackEntryLocation& location);
+		static std::vector<uint8_t> ReadEntry(const std::string& packPath, uint32_t index);
+		static std::vector<uint8_t> ReadEntryAt(const std::string& packPath, uint32_t index, const PackEntryLocation& location);
+		static std::vector<std::vector<uint8_t>> ReadEntries(const std::vector<PackReadRequest>& v_Requests, uint64_t mergeGap = DEFAULT_MERGE_GAP);
+		static uint64_t PrefetchEntries(const std::vector<PackReadRequest>& v_Requests, uint64_t mergeGap = DEFAULT_MERGE_GAP);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#include "Core.h"
+
+namespace Mesa
+{
+	/*
+		Replays access trace recorded during a previous run on a background thread,
+		so archive entries are already in the system cache when loaders ask for them.
+	*/
+	class MSAPI Prefetcher
+	{
+	public:
+		Prefetcher(const std::string& tracePath);
+		~Prefetcher();
+
+		void Wait();
+		inline bool IsFinished() const noexcept { return m_Finished; }
+
+	private:
+		void Run(const std::string& tracePath);
+
+	private:
+		std::thread m_Thread;
+		std::atomic<bool> m_Finished = false;
+	};
+}
\ No newline at end of file
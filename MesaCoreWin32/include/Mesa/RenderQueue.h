@@ -0,0 +1,64 @@
+#pragma once
+#include "Core.h"
+#include "GameObject.h"
+
+namespace Mesa
+{
+	enum DrawPass : uint32_t
+	{
+		DrawPass_Color = 0,
+		DrawPass_Specular = 1,
+	};
+
+	// Draw of a single mesh in one pass, assets are resolved when the queue is built
+	struct DrawItem
+	{
+		uint64_t m_SortKey = 0;
+		const GameObject3D* mp_Object = nullptr;
+		uint32_t m_ShaderId = 0;
+		uint32_t m_ModelId = 0;
+		uint32_t m_MaterialId = 0;
+		uint32_t m_MeshIndex = 0;
+	};
+
+	/*
+		Flat list of draws of a frame ordered by 64-bit sort keys.
+		Key holds (from the most significant bits) layer, pass, shader, material, model and depth,
+		so draws of one pass of a layer are next to each other and draws that share state are grouped.
+		Asset IDs are truncated to the lower bits of their slot index, which only affects grouping.
+		Queue is sorted once per frame with a radix sort and keeps its memory between frames.
+		Draws can be pushed from several workers at once with PushParallel(), which keeps the order
+		of the pushed draws independent of the timing of the workers.
+	*/
+	class MSAPI RenderQueue
+	{
+	public:
+		static constexpr uint32_t MAX_LAYERS = 64;
+
+		// Widths of the key fields, they add up to 64 bits
+		static constexpr uint32_t LAYER_BITS = 6;
+		static constexpr uint32_t PASS_BITS = 2;
+		static constexpr uint32_t SHADER_BITS = 12;
+		static constexpr uint32_t MATERIAL_BITS = 16;
+		static constexpr uint32_t MODEL_BITS = 12;
+		static constexpr uint32_t DEPTH_BITS = 16;
+
+		static constexpr size_t PARALLEL_PUSH_SIZE = 1024; // Sources of draws handled by a single job
+
+	public:
+		static uint64_t MakeSortKey(uint32_t layer, DrawPass pass, uint32_t shaderId, uint32_t materialId, uint32_t modelId, float depth);
+
+		void Clear();
+		void Push(const DrawItem& item);
+		void PushParallel(size_t count, const std::function<void(size_t index, std::vector<DrawItem>& v_OutItems)>& push);
+		void Sort();
+
+		std::span<const DrawItem> GetItems(uint32_t layer, DrawPass pass) const;
+		inline size_t GetSize() const noexcept { return mv_Items.size(); }
+
+	private:
+		std::vector<DrawItem> mv_Items;
+		std::vector<DrawItem> mv_SortBuffer;
+		std::vector<std::vector<DrawItem>> mv_Slices; // Draws pushed by jobs of PushParallel()
+	};
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include "Core.h"
+#include "GameObject.h"
+#include "BoundingVolumeTree.h"
+
+namespace Mesa
+{
+	/*
+		Spatial index of game objects kept in a BoundingVolumeTree.
+		Objects don't report their movement, so Update() compares version of their world matrix and
+		bounds of their model with the ones in the tree. Changed objects are moved in the tree,
+		or the tree is rebuilt in parallel when a large part of the scene changed at once.
+		Box, sphere and ray queries test world bounds of the objects, boxes of the tree only limit the search.
+		Frustum query returns every object whose box in the tree touches the frustum, so callers can
+		run their own exact test on fewer objects.
+	*/
+	class MSAPI SceneIndex
+	{
+	private:
+		struct Entry
+		{
+			GameObject3D* mp_Object = nullptr;
+			uint32_t m_Proxy = BoundingVolumeTree::NULL_NODE; // Leaf of the object, NULL_NODE if it isn't in the tree
+			uint32_t m_ModelId = 0;
+			uint64_t m_Version = 0;
+			bool m_HasBounds = false; // False while the model of the object isn't loaded
+			BoundingVolume m_LocalBounds; // Bounds of the model
+			BoundingVolume m_WorldBounds;
+		};
+
+	public:
+		static constexpr float REBUILD_FRACTION = 0.25f; // Part of the objects that has to change in one update for a rebuild
+		static constexpr size_t MIN_REBUILD_SIZE = 1024; // Smaller scenes are always updated incrementally
+
+	public:
+		void Insert(GameObject3D* p_Object);
+		void Update(const std::function<const BoundingVolume*(uint32_t modelId)>& getModelBounds);
+
+		void QueryFrustum(const std::array<glm::vec4, 6>& planes, std::vector<GameObject3D*>& v_OutObjects);
+		void QueryBox(const glm::vec3& min, const glm::vec3& max, std::vector<GameObject3D*>& v_OutObjects);
+		void QuerySphere(const glm::vec3& center, float radius, std::vector<GameObject3D*>& v_OutObjects);
+		GameObject3D* RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* p_OutDistance = nullptr) const;
+
+		inline const BoundingVolumeTree& GetTree() const noexcept { return m_Tree; }
+
+	private:
+		void Rebuild();
+
+	private:
+		BoundingVolumeTree m_Tree; // Values of leaves are indices of entries
+		std::vector<Entry> mv_Entries;
+		std::vector<uint32_t> mv_Changed; // Entries changed by the current update
+		std::vector<uint32_t> mv_Results; // Entries returned by the tree, reused by queries
+	};
+}
\ No newline at end of file
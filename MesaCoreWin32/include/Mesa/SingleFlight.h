@@ -0,0 +1,126 @@
+#pragma once
+#include "Core.h"
+#include "AssetHandle.h"
+
+namespace Mesa
+{
+	/*
+		Makes concurrent requests with the same key share one execution.
+		The first caller runs the function while callers that arrive before it's
+		finished wait for its result instead of repeating the work.
+		Function must not request the same key again or it will wait for itself.
+	*/
+	template<typename T>
+	class SingleFlight
+	{
+	public:
+		T Do(const std::string& key, const std::function<T()>& function)
+		{
+			std::promise<T> promise;
+			std::shared_future<T> future;
+			bool owner = false;
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_NumRequests++;
+
+				auto it = m_InFlight.find(key);
+				if (it != m_InFlight.end())
+				{
+					future = it->second;
+					m_NumCoalesced++;
+				}
+				else
+				{
+					future = promise.get_future().share();
+					m_InFlight[key] = future;
+					owner = true;
+				}
+			}
+
+			if (!owner) return future.get();
+
+			try
+			{
+				T result = function();
+				Finish(key);
+				promise.set_value(result);
+				return result;
+			}
+			catch (...)
+			{
+				// Waiting callers get the same exception
+				Finish(key);
+				promise.set_exception(std::current_exception());
+				throw;
+			}
+		}
+
+		inline uint64_t GetNumRequests() const noexcept { return m_NumRequests; }
+		inline uint64_t GetNumCoalesced() const noexcept { return m_NumCoalesced; }
+
+	private:
+		void Finish(const std::string& key)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_InFlight.erase(key);
+		}
+
+	private:
+		std::map<std::string, std::shared_future<T>> m_InFlight;
+		std::mutex m_Mutex;
+
+		std::atomic<uint64_t> m_NumRequests = 0;
+		std::atomic<uint64_t> m_NumCoalesced = 0; // Requests that reused result of a running request
+	};
+
+	/*
+		Single flight for coroutine loads. Instead of blocking, requests for a key
+		that is already being loaded receive handle of the running load.
+	*/
+	template<typename T>
+	class AsyncSingleFlight
+	{
+	public:
+		AssetHandle<T> Do(const std::string& key, const std::function<AssetHandle<T>()>& start)
+		{
+			// Recursive since the load runs on this thread until its first suspension and may request other keys
+			std::lock_guard<std::recursive_mutex> lock(m_Mutex);
+			m_NumRequests++;
+
+			auto it = m_InFlight.find(key);
+			if (it != m_InFlight.end())
+			{
+				// Cancelled load can't be shared since it won't produce a result
+				if (!it->second.IsReady() && !it->second.IsCancelRequested())
+				{
+					m_NumCoalesced++;
+					return it->second;
+				}
+
+				m_InFlight.erase(it);
+			}
+
+			AssetHandle<T> handle = start();
+			if (!handle.IsReady()) m_InFlight[key] = handle;
+
+			// Drop finished loads from time to time so the map doesn't grow with every loaded asset
+			if (m_InFlight.size() >= MAX_FINISHED_LOADS)
+				std::erase_if(m_InFlight, [](const auto& entry) { return entry.second.IsReady(); });
+
+			return handle;
+		}
+
+		inline uint64_t GetNumRequests() const noexcept { return m_NumRequests; }
+		inline uint64_t GetNumCoalesced() const noexcept { return m_NumCoalesced; }
+
+	private:
+		static constexpr size_t MAX_FINISHED_LOADS = 256;
+
+		std::map<std::string, AssetHandle<T>> m_InFlight;
+		std::recursive_mutex m_Mutex;
+
+		std::atomic<uint64_t> m_NumRequests = 0;
+		std::atomic<uint64_t> m_NumCoalesced = 0; // Requests that received handle of a running load
+	};
+}
\ No newline at end of file
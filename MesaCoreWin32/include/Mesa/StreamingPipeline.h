@@ -0,0 +1,261 @@
+#pragma once
+#include "Core.h"
+#include "JobSystem.h"
+
+namespace Mesa
+{
+	/*
+		Processes a stream of items through a chain of stages (e.g. read, decode, upload) that run concurrently.
+		Stages run as jobs of the job system, every stage has a queue of items and at most its number of workers
+		jobs that drain it, so no threads are started for a run.
+		Source stops producing while the items in flight take more than the byte budget,
+		which keeps memory usage of the whole pipeline bounded regardless of the number of items.
+		While it waits the source runs queued jobs itself, so the pipeline can't stall even if it runs on a worker.
+		Bytes of an item are measured again after every stage, so stages that grow items
+		(e.g. decoding) are accounted for, but only the source waits for the budget.
+	*/
+	template<typename T>
+	class StreamingPipeline
+	{
+	public:
+		using StageFunction = std::function<bool(T&)>; // Returns false to drop the item
+		using MeasureFunction = std::function<uint64_t(const T&)>;
+
+	private:
+		struct QueuedItem
+		{
+			T m_Item;
+			uint64_t m_Bytes = 0; // Bytes of the item that are counted as in flight
+		};
+
+		struct Stage
+		{
+			std::string m_Name;
+			uint32_t m_NumWorkers = 1; // Jobs that may process the stage at once
+			StageFunction m_Function;
+
+			// Items waiting for the stage and the number of jobs that drain them
+			std::deque<QueuedItem> m_Items;
+			uint32_t m_NumActive = 0;
+			std::mutex m_Mutex;
+
+			// Statistics
+			std::atomic<uint64_t> m_NumItems = 0;
+			std::atomic<uint64_t> m_NumDropped = 0;
+			std::atomic<uint64_t> m_BusyTime = 0; // Time spent processing items in microseconds
+		};
+
+	public:
+		StreamingPipeline(uint64_t maxBytesInFlight, MeasureFunction measure, JobSystem& jobSystem = JobSystem::GetDefault())
+			: m_MaxBytesInFlight(maxBytesInFlight), m_Measure(std::move(measure)), m_JobSystem(jobSystem)
+		{}
+
+		/*
+			Adds stage processed by up to specified number of jobs at once.
+			Stages process items in order they were added.
+		*/
+		void AddStage(const std::string& name, uint32_t numWorkers, StageFunction function)
+		{
+			auto p_Stage = std::make_unique<Stage>();
+			p_Stage->m_Name = name;
+			p_Stage->m_NumWorkers = std::max(numWorkers, 1u);
+			p_Stage->m_Function = std::move(function);
+			mv_Stages.push_back(std::move(p_Stage));
+		}
+
+		/*
+			Pulls items from produce() on the calling thread and pushes them through all stages.
+			produce(item) returns false once there are no more items.
+			Returns after every item left the last stage, also when produce() throws.
+			Exception thrown by a stage drops its item and the first such exception is rethrown here after the pipeline drains,
+			exception of produce() is rethrown in its place.
+		*/
+		void Run(const std::function<bool(T&)>& produce)
+		{
+			if (mv_Stages.empty()) return;
+
+			mp_Exception = nullptr;
+			auto startTime = std::chrono::steady_clock::now();
+
+			JobCounter counter;
+			std::exception_ptr p_SourceException;
+
+			try
+			{
+				while (true)
+				{
+					T item = T();
+					if (!produce(item)) break;
+
+					uint64_t bytes = m_Measure(item);
+					WaitForBudget(bytes);
+
+					Push(0, { std::move(item), bytes }, counter);
+				}
+			}
+			catch (...)
+			{
+				p_SourceException = std::current_exception();
+			}
+
+			// Items that were already pushed are finished even if the source failed
+			m_JobSystem.Wait(counter);
+
+			m_Duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+			if (p_SourceException) std::rethrow_exception(p_SourceException);
+			if (mp_Exception) std::rethrow_exception(mp_Exception);
+		}
+
+		/*
+			Logs time spent in every stage and the peak of bytes in flight
+		*/
+		void LogSummary(const std::string& name) const
+		{
+			LOG_F(INFO, "%s streamed in %.2f ms, peak %llu KB in flight (budget %llu KB)", name.c_str(), m_Duration,
+				(unsigned long long)(m_PeakBytesInFlight / 1024), (unsigned long long)(m_MaxBytesInFlight / 1024));
+
+			for (const auto& p_Stage : mv_Stages)
+			{
+				LOG_F(INFO, "  %s: %u workers, %llu items (%llu dropped), busy %.2f ms", p_Stage->m_Name.c_str(), p_Stage->m_NumWorkers,
+					(unsigned long long)p_Stage->m_NumItems.load(), (unsigned long long)p_Stage->m_NumDropped.load(), p_Stage->m_BusyTime.load() / 1000.0);
+			}
+		}
+
+		inline uint64_t GetPeakBytesInFlight() const noexcept { return m_PeakBytesInFlight; }
+
+	private:
+		/*
+			Blocks until an item of specified size fits into the budget, running queued jobs in the meantime.
+			Item is always let in when nothing else is in flight, so items larger than the budget can't stall the pipeline.
+		*/
+		void WaitForBudget(uint64_t bytes)
+		{
+			std::unique_lock<std::mutex> lock(m_BudgetMutex);
+
+			while (m_BytesInFlight != 0 && m_BytesInFlight + bytes > m_MaxBytesInFlight)
+			{
+				lock.unlock();
+				bool ranJob = m_JobSystem.RunPendingJob();
+				lock.lock();
+
+				// Without queued jobs all items in flight are being processed, and every finished one wakes the source
+				if (!ranJob)
+					m_BudgetCondition.wait(lock, [&]() { return m_BytesInFlight == 0 || m_BytesInFlight + bytes <= m_MaxBytesInFlight; });
+			}
+
+			m_BytesInFlight += bytes;
+			m_PeakBytesInFlight = std::max(m_PeakBytesInFlight, m_BytesInFlight);
+		}
+
+		/*
+			Replaces bytes counted for an item with its new size, 0 releases the item
+		*/
+		void UpdateBytes(uint64_t oldBytes, uint64_t newBytes)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_BudgetMutex);
+				m_BytesInFlight = m_BytesInFlight - oldBytes + newBytes;
+				m_PeakBytesInFlight = std::max(m_PeakBytesInFlight, m_BytesInFlight);
+			}
+
+			if (newBytes < oldBytes) m_BudgetCondition.notify_one();
+		}
+
+		/*
+			Queues item for a stage and starts another job for the stage if it has less than its number of workers
+		*/
+		void Push(size_t stageIndex, QueuedItem item, JobCounter& counter)
+		{
+			Stage& stage = *mv_Stages[stageIndex];
+
+			{
+				std::lock_guard<std::mutex> lock(stage.m_Mutex);
+				stage.m_Items.push_back(std::move(item));
+
+				if (stage.m_NumActive == stage.m_NumWorkers) return;
+				stage.m_NumActive++;
+			}
+
+			m_JobSystem.Run([this, stageIndex, &counter]() { DrainStage(stageIndex, counter); }, &counter);
+		}
+
+		/*
+			Processes items of one stage until its queue is empty.
+			Job of the previous stage is still running when it pushes an item, so the counter can't reach 0 before the item is processed.
+		*/
+		void DrainStage(size_t stageIndex, JobCounter& counter)
+		{
+			Stage& stage = *mv_Stages[stageIndex];
+			bool lastStage = stageIndex + 1 == mv_Stages.size();
+
+			while (true)
+			{
+				QueuedItem queued;
+
+				{
+					std::lock_guard<std::mutex> lock(stage.m_Mutex);
+
+					if (stage.m_Items.empty())
+					{
+						stage.m_NumActive--;
+						return;
+					}
+
+					queued = std::move(stage.m_Items.front());
+					stage.m_Items.pop_front();
+				}
+
+				auto startTime = std::chrono::steady_clock::now();
+				bool keep = false;
+				uint64_t bytes = 0;
+
+				try
+				{
+					keep = stage.m_Function(queued.m_Item);
+					if (keep && !lastStage) bytes = m_Measure(queued.m_Item);
+				}
+				catch (...)
+				{
+					keep = false;
+
+					std::lock_guard<std::mutex> lock(m_ExceptionMutex);
+					if (!mp_Exception) mp_Exception = std::current_exception();
+				}
+
+				stage.m_BusyTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+				stage.m_NumItems++;
+				if (!keep) stage.m_NumDropped++;
+
+				if (!keep || lastStage)
+				{
+					// Item leaves the pipeline
+					UpdateBytes(queued.m_Bytes, 0);
+					continue;
+				}
+
+				UpdateBytes(queued.m_Bytes, bytes);
+				queued.m_Bytes = bytes;
+
+				Push(stageIndex + 1, std::move(queued), counter);
+			}
+		}
+
+	private:
+		std::vector<std::unique_ptr<Stage>> mv_Stages;
+
+		uint64_t m_MaxBytesInFlight = 0;
+		uint64_t m_BytesInFlight = 0;
+		uint64_t m_PeakBytesInFlight = 0;
+		MeasureFunction m_Measure;
+		std::mutex m_BudgetMutex;
+		std::condition_variable m_BudgetCondition;
+
+		JobSystem& m_JobSystem;
+
+		std::exception_ptr mp_Exception; // First exception thrown by one of the stages
+		std::mutex m_ExceptionMutex;
+
+		double m_Duration = 0.0; // Duration of the last run in milliseconds
+	};
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include "Core.h"
+#include "JobSystem.h"
+
+namespace Mesa
+{
+	// Identifier of a task inside of the graph (0 is never a valid task)
+	using TaskId = uint32_t;
+
+	/*
+		Directed acyclic graph of jobs.
+		Tasks run on the job system as soon as all of their dependencies are finished.
+		Tasks and dependencies can be added while the graph is executing, as long as
+		the task that receives a new dependency hasn't started yet.
+	*/
+	class MSAPI TaskGraph
+	{
+	private:
+		struct Task
+		{
+			std::string m_Name;
+			Job m_Job;
+			std::vector<TaskId> mv_Dependencies;
+			std::vector<TaskId> mv_Dependents;
+			uint32_t m_PendingDependencies = 0;
+			bool m_Started = false;
+			bool m_Finished = false;
+
+			// Timings relative to the start of the execution
+			double m_StartTime = 0.0;
+			double m_Duration = 0.0;
+		};
+
+	public:
+		TaskGraph(JobSystem& jobSystem = JobSystem::GetDefault());
+		~TaskGraph();
+
+		TaskId AddTask(const std::string& name, Job job, const std::vector<TaskId>& v_Dependencies = {});
+		TaskId FindOrAddTasks(const std::string& key, const std::function<TaskId()>& builder);
+		void AddDependency(TaskId task, TaskId dependency);
+		void Execute();
+
+		std::vector<TaskId> GetCriticalPath() const;
+		std::string Dump() const;
+		bool SaveDump(const std::string& path) const;
+		void LogSummary() const;
+
+		inline size_t GetNumTasks() const noexcept { return mv_Tasks.size(); }
+
+	private:
+		void ScheduleReadyTasks();
+		void Schedule(TaskId id);
+		void RunTask(TaskId id);
+		double GetElapsedTime() const;
+
+	private:
+		JobSystem& m_JobSystem;
+		JobCounter m_Counter;
+
+		// Deque keeps references to tasks valid while new ones are added
+		std::deque<Task> mv_Tasks;
+		std::vector<TaskId> mv_ReadyTasks; // Tasks with finished dependencies that wait to be queued
+		mutable std::mutex m_Mutex;
+
+		// Groups of tasks registered by FindOrAddTasks() under their key
+		std::map<std::string, TaskId> m_Keys;
+		std::recursive_mutex m_BuildMutex;
+		uint32_t m_BuildDepth = 0; // Tasks added while a group is built wait until the whole group is added
+
+		bool m_Executing = false;
+		std::chrono::steady_clock::time_point m_StartTime;
+		double m_TotalTime = 0.0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include "Core.h"
+#include "JobSystem.h"
+
+namespace Mesa
+{
+	/*
+		Queue of jobs that have to run on the main thread, such as creation of GPU resources
+		for assets loaded in the background. Jobs are executed once per frame by Process()
+		which stops as soon as the frame's time budget is used up.
+	*/
+	class MSAPI UploadQueue
+	{
+	public:
+		// Awaiting it from a coroutine resumes the coroutine on the main thread during Process()
+		struct ScheduleAwaiter
+		{
+			UploadQueue& m_Queue;
+
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> handle) { m_Queue.Enqueue([handle]() { handle.resume(); }); }
+			void await_resume() const noexcept {}
+		};
+
+	public:
+		UploadQueue();
+		~UploadQueue();
+
+		void Enqueue(Job job);
+		uint32_t Process(double budget);
+		size_t GetNumPending() const;
+
+		inline ScheduleAwaiter Schedule() noexcept { return { *this }; }
+
+	private:
+		std::deque<Job> mv_Jobs;
+		mutable std::mutex m_Mutex;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+#include "Core.h"
+
+namespace Mesa
+{
+	/*
+		Linear allocator of constant data over a ring buffer shared by all frames.
+		Allocations are aligned to 256 bytes, so every one of them can be bound as a constant buffer by its offset.
+		Space taken by a frame is only reused after the backend reports that the GPU finished the frame,
+		so data of frames in flight is never overwritten. Allocations fail instead, and the backend waits for
+		older frames or creates a larger buffer and calls Reset().
+		Allocations of the current frame can be undone back to a checkpoint, e.g. when only a part of a group of
+		allocations succeeded and the group is allocated again after older frames are released.
+		Ring only hands out offsets, the backend owns the memory they point to.
+	*/
+	class MSAPI UploadRing
+	{
+	private:
+		// Bytes taken by a finished frame that the GPU may still read
+		struct FrameRange
+		{
+			uint64_t m_FrameIndex = 0;
+			uint64_t m_NumBytes = 0;
+		};
+
+	public:
+		// Position of the ring within the current frame that later allocations can be rolled back to
+		struct Checkpoint
+		{
+			uint64_t m_Head = 0;
+			uint64_t m_FrameBytes = 0;
+		};
+
+	public:
+		static constexpr uint64_t ALIGNMENT = 256;
+		static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+		static constexpr uint64_t DEFAULT_CAPACITY = 8 * 1024 * 1024;
+
+	public:
+		void Reset(uint64_t capacity);
+		void BeginFrame(uint64_t frameIndex);
+		bool Allocate(uint64_t size, uint64_t& outOffset);
+		Checkpoint GetCheckpoint() const;
+		void Rollback(const Checkpoint& checkpoint);
+		void EndFrame();
+		void ReleaseFrames(uint64_t lastCompletedFrame);
+
+		inline uint64_t GetCapacity() const noexcept { return m_Capacity; }
+		inline uint64_t GetUsedBytes() const noexcept { return m_Used; }
+		inline uint64_t GetFrameBytes() const noexcept { return m_FrameBytes; }
+		inline size_t GetNumFramesInFlight() const noexcept { return mv_Frames.size(); }
+		inline uint64_t GetOldestFrame() const { return mv_Frames.front().m_FrameIndex; }
+
+		static constexpr uint64_t AlignSize(uint64_t size) { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+	private:
+		uint64_t m_Capacity = 0;
+		uint64_t m_Head = 0; // Offset of the next allocation
+		uint64_t m_Used = 0; // Bytes of frames in flight and of the current frame, they end at the head
+		uint64_t m_FrameIndex = 0;
+		uint64_t m_FrameBytes = 0; // Bytes taken by the current frame, including space skipped at the end of the buffer
+		std::deque<FrameRange> mv_Frames; // Finished frames from the oldest one
+	};
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include <Mesa/AccessTrace.h>
+#include <Mesa/FileUtils.h>
+#include <Mesa/ConvertUtils.h>
+
+namespace Mesa
+{
+	AccessTrace AccessTrace::m_AccessTrace;
+
+	/*
+		Constructor
+	*/
+	AccessTrace::AccessTrace()
+	{}
+
+	/*
+		Destructor
+	*/
+	AccessTrace::~AccessTrace()
+	{}
+
+	/*
+		Clears previously recorded accesses and starts recording new ones.
+	*/
+	void AccessTrace::Start()
+	{
+		std::lock_guard<std::mutex> lock(m_AccessTrace.m_Mutex);
+
+		m_AccessTrace.mv_Entries.clear();
+		m_AccessTrace.m_RecordedEntries.clear();
+		m_AccessTrace.m_StartTime = std::chrono::steady_clock::now();
+		m_AccessTrace.m_BytesRead = 0;
+		m_AccessTrace.m_ReadTime = 0.0;
+		m_AccessTrace.m_LastReadTime = 0;
+		m_AccessTrace.m_Recording = true;
+	}
+
+	/*
+		Stops recording. Recorded accesses are kept until the next call to Start().
+	*/
+	void AccessTrace::Stop()
+	{
+		std::lock_guard<std::mutex> lock(m_AccessTrace.m_Mutex);
+		m_AccessTrace.m_Recording = false;
+	}
+
+	bool AccessTrace::IsRecording()
+	{
+		std::lock_guard<std::mutex> lock(m_AccessTrace.m_Mutex);
+		return m_AccessTrace.m_Recording;
+	}
+
+	/*
+		Records access to an archive entry.
+		Only the first access to every entry is kept.
+	*/
+	void AccessTrace::Record(const std::string& packPath, uint32_t index)
+	{
+		std::lock_guard<std::mutex> lock(m_AccessTrace.m_Mutex);
+
+		if (!m_AccessTrace.m_Recording) return;
+		if (!m_AccessTrace.m_RecordedEntries.insert(std::make_pair(packPath, index)).second) return;
+
+		AccessTraceEntry entry = {};
+		entry.m_PackPath = packPath;
+		entry.m_Index = index;
+		entry.m_Time = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_AccessTrace.m_StartTime).count();
+
+		m_AccessTrace.mv_Entries.push_back(entry);
+	}
+
+	/*
+		Adds completed read to the statistics used by the startup report.
+	*/
+	void AccessTrace::RecordRead(uint64_t bytes, double milliseconds)
+	{
+		std::lock_guard<std::mutex> lock(m_AccessTrace.m_Mutex);
+
+		if (!m_AccessTrace.m_Recording) return;
+
+		m_AccessTrace.m_BytesRead += bytes;
+		m_AccessTrace.m_ReadTime += milliseconds;
+		m_AccessTrace.m_LastReadTime = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_AccessTrace.m_StartTime).count();
+	}
+
+	/*
+		Saves recorded accesses as a manifest.
+		Every line of the manifest holds archive path, entry index and time of the access.
+	*/
+	bool AccessTrace::Save(const std::string& path)
+	{
+		std::ostringstream oss;
+
+		{
+			std::lock_guard<std::mutex> lock(m_AccessTrace.m_Mutex);
+
+			for (const auto& entry : m_AccessTrace.mv_Entries)
+				oss << entry.m_PackPath << ',' << entry.m_Index << ',' << entry.m_Time << '\n';
+		}
+
+		FileUtils::MakeFileWithContent(path, oss.str());
+
+		if (!FileUtils::FileExists(path))
+		{
+			LOG_F(ERROR, "Failed to save access trace to %s", path.c_str());
+			return false;
+		}
+
+		LOG_F(INFO, "Saved access trace to %s", path.c_str());
+		return true;
+	}
+
+	/*
+		Loads manifest saved by Save().
+		Entries are returned in order they were accessed in.
+	*/
+	std::vector<AccessTraceEntry> AccessTrace::Load(const std::string& path)
+	{
+		std::vector<AccessTraceEntry> v_result;
+
+		std::vector<std::string> v_Lines = ConvertUtils::SplitStringByChar(FileUtils::ReadTextData(path), '\n');
+
+		for (const auto& line : v_Lines)
+		{
+			if (line.empty()) continue;
+
+			std::vector<std::string> v_Details = ConvertUtils::SplitStringByChar(line, ',');
+
+			if (v_Details.size() < 3)
+			{
+				LOG_F(ERROR, "Invalid entry detected in access trace! Skipping...");
+				continue;
+			}
+
+			AccessTraceEntry entry = {};
+			entry.m_PackPath = v_Details[0];
+			entry.m_Index = ConvertUtils::StringToInt(v_Details[1]);
+			entry.m_Time = ConvertUtils::StringToInt(v_Details[2]);
+
+			v_result.push_back(entry);
+		}
+
+		// Keep entries sorted by time even if the manifest was edited by hand
+		std::stable_sort(v_result.begin(), v_result.end(), [](const auto& a, const auto& b) { return a.m_Time < b.m_Time; });
+
+		return v_result;
+	}
+
+	/*
+		Appends statistics of the current run to the startup report and compares them
+		with previous runs made with and without prefetching.
+		Every line of the report holds: prefetched, entries, bytes, read time, time of the last read.
+	*/
+	void AccessTrace::WriteStartupReport(const std::string& path, bool prefetched)
+	{
+		std::ostringstream oss;
+		size_t numEntries = 0;
+		uint64_t bytesRead = 0;
+		double readTime = 0.0;
+		uint32_t lastReadTime = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(m_AccessTrace.m_Mutex);
+			numEntries = m_AccessTrace.mv_Entries.size();
+			bytesRead = m_AccessTrace.m_BytesRead;
+			readTime = m_AccessTrace.m_ReadTime;
+			lastReadTime = m_AccessTrace.m_LastReadTime;
+		}
+
+		// Collect results of previous runs before adding the current one
+		double coldTime = 0.0, warmTime = 0.0;
+		size_t numCold = 0, numWarm = 0;
+
+		std::vector<std::string> v_Lines = ConvertUtils::SplitStringByChar(FileUtils::ReadTextData(path), '\n');
+		for (const auto& line : v_Lines)
+		{
+			std::vector<std::string> v_Details = ConvertUtils::SplitStringByChar(line, ',');
+			if (v_Details.size() < 5) continue;
+
+			if (ConvertUtils::StringToInt(v_Details[0]) == 1)
+			{
+				warmTime += ConvertUtils::StringToFloat(v_Details[3]);
+				numWarm++;
+			}
+			else
+			{
+				coldTime += ConvertUtils::StringToFloat(v_Details[3]);
+				numCold++;
+			}
+		}
+
+		oss << (prefetched ? 1 : 0) << ',' << numEntries << ',' << bytesRead << ',' << readTime << ',' << lastReadTime << '\n';
+		std::string line = oss.str();
+		FileUtils::AppendDataToFile(path, std::vector<unsigned char>(line.begin(), line.end()));
+
+		if (prefetched) { warmTime += readTime; numWarm++; }
+		else { coldTime += readTime; numCold++; }
+
+		LOG_F(INFO, "Startup read %zu entries (%llu bytes), waited %.2f ms for reads, last read after %u ms (prefetch %s)",
+			numEntries, (unsigned long long)bytesRead, readTime, lastReadTime, prefetched ? "enabled" : "disabled");
+
+		if (numCold > 0 && numWarm > 0)
+		{
+			LOG_F(INFO, "Average read wait: %.2f ms without prefetch (%zu runs), %.2f ms with prefetch (%zu runs)",
+				coldTime / numCold, numCold, warmTime / numWarm, numWarm);
+		}
+	}
+}
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include <Mesa/Application.h>
+#include <Mesa/GraphicsNull.h>
 #include <Mesa/ConvertUtils.h>
-#include <Mesa/ConfigUtils.h>
+#include <Mesa/EngineConfig.h>
+#include <Mesa/FileUtils.h>
+#include <Mesa/AccessTrace.h>
 
 namespace Mesa
 {
@@ -12,9 +15,26 @@ namespace Mesa
 	{
 		LOG_F(INFO, "Starting Mesa application...");
 
+		// Replay archive reads recorded during the previous run so they are cached before loaders need them.
+		const std::string& tracePath = EngineConfig::Get<ConfigKey_StreamingAccessTrace>();
+		if (EngineConfig::Get<ConfigKey_StreamingPrefetch>() && !tracePath.empty() && FileUtils::FileExists(tracePath))
+			mp_Prefetcher = new Prefetcher(tracePath);
+
+		// Record archive reads of this run.
+		if (EngineConfig::Get<ConfigKey_StreamingRecordAccessTrace>() && !tracePath.empty())
+			AccessTrace::Start();
+
+		// Null renderer only counts draw calls, used to measure CPU cost without a GPU, so it doesn't need a window
+		if (EngineConfig::Get<ConfigKey_GeneralApi>() == "null")
+		{
+			LOG_F(INFO, "Null renderer selected, running without window for %i frames", EngineConfig::Get<ConfigKey_GeneralNullFrames>());
+			mp_Graphics = new GraphicsNull();
+			return;
+		}
+
 		// Retrieve window dimensions from engine.ini.
-		int windowWidth = ConvertUtils::StringToInt(ConfigUtils::GetValueFromConfig("Window", "Width"));
-		int windowHeight = ConvertUtils::StringToInt(ConfigUtils::GetValueFromConfig("Window", "Height"));
+		int windowWidth = EngineConfig::Get<ConfigKey_WindowWidth>();
+		int windowHeight = EngineConfig::Get<ConfigKey_WindowHeight>();
 
 		// Ensure the window isn't too small to display content properly.
 		if (windowWidth < 800) windowWidth = 800;
@@ -25,10 +45,11 @@ namespace Mesa
 		LOG_F(INFO, "Window height set to %i px", windowHeight);
 
 		// Check for fullscreen mode.
-		bool fullscreen = strcmp(ConfigUtils::GetValueFromConfig("Window", "Fullscreen").c_str(), "true") == 0;
+		bool fullscreen = EngineConfig::Get<ConfigKey_WindowFullscreen>();
 
 		// Create the OS-level window instance.
 		mp_Window = new Window(windowWidth, windowHeight, "SandboxWin32", fullscreen);
+
 		// Initialize DX11 renderer
 		mp_Graphics = new GraphicsDx11(mp_Window);
 	}
@@ -38,7 +59,37 @@ namespace Mesa
 	*/
 	Application::~Application()
 	{
+		// Save recorded reads for the next run and compare startup with previous runs.
+		if (AccessTrace::IsRecording())
+		{
+			AccessTrace::Stop();
+			AccessTrace::WriteStartupReport(EngineConfig::Get<ConfigKey_StreamingStartupReport>(), mp_Prefetcher != nullptr);
+			AccessTrace::Save(EngineConfig::Get<ConfigKey_StreamingAccessTrace>());
+		}
+
+		if (mp_Prefetcher) delete mp_Prefetcher;
 		if (mp_Graphics) delete mp_Graphics;
 		if (mp_Window) delete mp_Window;
 	}
+
+	/*
+		Processes events of the window and returns false once the application should exit.
+		Without a window (null renderer) it returns false after the configured number of frames.
+	*/
+	bool Application::Update()
+	{
+		if (mp_Window) return mp_Window->Update();
+
+		return m_NumHeadlessFrames++ < (uint64_t)std::max(EngineConfig::Get<ConfigKey_GeneralNullFrames>(), 0);
+	}
+
+	/*
+		Returns aspect ratio of the window, or of the configured window size when running without one.
+	*/
+	float Application::GetAspectRatio() const
+	{
+		if (mp_Window) return mp_Window->GetWindowWidth() / (float)mp_Window->GetWindowHeight();
+
+		return std::max(EngineConfig::Get<ConfigKey_WindowWidth>(), 1) / (float)std::max(EngineConfig::Get<ConfigKey_WindowHeight>(), 1);
+	}
 }
\ No newline at end of file
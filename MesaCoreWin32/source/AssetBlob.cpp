@@ -0,0 +1,132 @@
+#include <Mesa/AssetBlob.h>
+#include <Mesa/ConvertUtils.h>
+#include <Mesa/FileUtils.h>
+
+#if defined(MESA_PORTABLE) && (defined(__unix__) || defined(__APPLE__))
+#define MESA_POSIX_MAPPING
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Mesa
+{
+	/*
+		Takes ownership of the vector without copying its contents
+	*/
+	AssetBlob AssetBlob::FromVector(std::vector<uint8_t>&& v_Data)
+	{
+		AssetBlob blob;
+		if (v_Data.empty()) return blob;
+
+		auto p_Buffer = std::make_shared<const std::vector<uint8_t>>(std::move(v_Data));
+
+		blob.mp_Data = p_Buffer->data();
+		blob.m_Size = p_Buffer->size();
+		blob.mp_Owner = std::move(p_Buffer);
+		return blob;
+	}
+
+	/*
+		Maps whole file into memory as read-only. Pages are read from the disk when they are first accessed
+		and the mapping is closed once the last blob that refers to it is destroyed.
+		Portable builds map the file with mmap, platforms without it read the whole file instead.
+		Returns empty blob if the file can't be mapped.
+	*/
+	AssetBlob AssetBlob::MapFile(const std::string& path)
+	{
+		AssetBlob blob;
+
+#if defined(MESA_POSIX_MAPPING)
+		int file = open(path.c_str(), O_RDONLY);
+		if (file == -1)
+		{
+			LOG_F(ERROR, "Could not open %s", path.c_str());
+			return blob;
+		}
+
+		struct stat fileStat = {};
+		if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			close(file);
+			return blob;
+		}
+
+		size_t fileSize = (size_t)fileStat.st_size;
+		void* p_View = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, file, 0);
+		// Mapping keeps its own reference to the file, so a replaced pack stays readable until it's unmapped
+		close(file);
+
+		if (p_View == MAP_FAILED)
+		{
+			LOG_F(ERROR, "Could not map %s", path.c_str());
+			return blob;
+		}
+
+		blob.mp_Owner = std::shared_ptr<const void>(p_View, [fileSize](const void* p_View) { munmap(const_cast<void*>(p_View), fileSize); });
+		blob.mp_Data = (const uint8_t*)p_View;
+		blob.m_Size = fileSize;
+		return blob;
+#elif defined(MESA_PORTABLE)
+		blob = FromVector(FileUtils::ReadBinaryData(path));
+		if (blob.IsEmpty()) LOG_F(ERROR, "Could not read %s", path.c_str());
+
+		return blob;
+#else
+		// Same sharing as AsyncFileReader, so the packer can replace the pack while slices of it are alive
+		HANDLE file = CreateFile(ConvertUtils::StringToWideString(path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			LOG_F(ERROR, "Could not open %s", path.c_str());
+			return blob;
+		}
+
+		LARGE_INTEGER fileSize = {};
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return blob;
+		}
+
+		HANDLE mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		// Mapping keeps its own reference to the file
+		CloseHandle(file);
+
+		if (mapping == nullptr)
+		{
+			LOG_F(ERROR, "Could not map %s", path.c_str());
+			return blob;
+		}
+
+		const void* p_View = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+
+		if (p_View == nullptr)
+		{
+			LOG_F(ERROR, "Could not map view of %s", path.c_str());
+			return blob;
+		}
+
+		blob.mp_Owner = std::shared_ptr<const void>(p_View, [](const void* p_View) { UnmapViewOfFile(p_View); });
+		blob.mp_Data = (const uint8_t*)p_View;
+		blob.m_Size = (size_t)fileSize.QuadPart;
+		return blob;
+#endif
+	}
+
+	/*
+		Returns blob that refers to part of this one and shares its buffer.
+		Returns empty blob if the range doesn't fit.
+	*/
+	AssetBlob AssetBlob::Slice(uint64_t offset, uint64_t size) const
+	{
+		AssetBlob blob;
+		if (offset > m_Size || size > m_Size - offset || size == 0) return blob;
+
+		blob.mp_Owner = mp_Owner;
+		blob.mp_Data = mp_Data + offset;
+		blob.m_Size = (size_t)size;
+		return blob;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include <Mesa/AssetCache.h>
+#include <Mesa/EngineConfig.h>
+#include <Mesa/ConvertUtils.h>
+
+namespace Mesa
+{
+	// Marks files written by the cache ("MSAC")
+	static constexpr uint32_t CACHE_MAGIC = 0x4341534D;
+	// Default size limit of the cache in megabytes
+	static constexpr uint64_t DEFAULT_CACHE_SIZE = 1024;
+
+	// Header stored in front of every cached entry, used to detect truncated or damaged files
+	struct CacheFileHeader
+	{
+		uint32_t m_Magic = CACHE_MAGIC;
+		uint32_t m_Hash = 0; // CRC32C of the data
+		uint64_t m_Size = 0; // Size of the data in bytes
+	};
+
+	/*
+		Constructor: Indexes entries that are already stored in the directory and trims them to the size limit.
+		Entries written most recently by previous runs are treated as the most recently used ones.
+		Size limit of 0 disables the cache.
+	*/
+	AssetCache::AssetCache(const std::string& directory, uint64_t maxSize)
+		: m_Directory(directory), m_MaxSize(maxSize)
+	{
+		if (!IsEnabled()) return;
+
+		std::error_code error;
+		std::filesystem::create_directories(m_Directory, error);
+
+		std::vector<std::tuple<std::filesystem::file_time_type, std::string, uint64_t>> v_Files;
+
+		for (const auto& file : std::filesystem::directory_iterator(m_Directory, error))
+		{
+			if (!file.is_regular_file(error)) continue;
+
+			// Leftovers of writes that were interrupted
+			if (file.path().extension() == ".tmp")
+			{
+				std::filesystem::remove(file.path(), error);
+				continue;
+			}
+
+			if (file.path().extension() != ".bin") continue;
+
+			v_Files.push_back({ file.last_write_time(error), file.path().stem().string(), file.file_size(error) });
+		}
+
+		std::sort(v_Files.begin(), v_Files.end());
+
+		for (const auto& [time, key, size] : v_Files)
+		{
+			m_Entries[key] = { size, ++m_UseCounter };
+			m_Size += size;
+		}
+
+		Trim();
+
+		LOG_F(INFO, "Asset cache %s holds %zu entries (%llu MB)", m_Directory.c_str(), m_Entries.size(), (unsigned long long)(m_Size / (1024 * 1024)));
+	}
+
+	/*
+		Returns cache configured in [Streaming] section of config
+	*/
+	AssetCache& AssetCache::GetDefault()
+	{
+		static AssetCache cache = []()
+		{
+			std::string directory = EngineConfig::Get<ConfigKey_StreamingAssetCacheDirectory>();
+			if (directory.empty()) directory = "AssetCache/";
+
+			// Size is set in megabytes
+			int size = EngineConfig::Get<ConfigKey_StreamingAssetCacheSize>();
+			uint64_t maxSize = (size > 0 ? (uint64_t)size : DEFAULT_CACHE_SIZE) * 1024 * 1024;
+
+			bool enabled = EngineConfig::Get<ConfigKey_StreamingAssetCache>();
+
+			return AssetCache(directory, enabled ? maxSize : 0);
+		}();
+
+		return cache;
+	}
+
+	/*
+		Creates key of processed data from the data it was made of.
+		Version has to be increased whenever the processor changes its output.
+	*/
+	std::string AssetCache::MakeKey(const std::string& kind, uint32_t version, ByteView sourceData)
+	{
+		std::ostringstream oss;
+		oss << kind << "_v" << version << "_" << std::hex << std::setw(8) << std::setfill('0')
+			<< crc32c::Crc32c(sourceData.data(), sourceData.size()) << "_" << sourceData.size();
+
+		return oss.str();
+	}
+
+	/*
+		Reads entry with specified key. Returns false if the entry isn't cached or its file is damaged.
+	*/
+	bool AssetCache::Load(const std::string& key, std::vector<uint8_t>& v_OutData)
+	{
+		if (!IsEnabled()) return false;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (m_Entries.find(key) == m_Entries.end())
+			{
+				m_NumMisses++;
+				return false;
+			}
+		}
+
+		std::string path = GetEntryPath(key);
+		std::ifstream file(path, std::ios::binary);
+
+		CacheFileHeader header = {};
+		bool valid = file.read((char*)&header, sizeof(header)) && header.m_Magic == CACHE_MAGIC;
+
+		if (valid)
+		{
+			v_OutData.resize(header.m_Size);
+			valid = file.read((char*)v_OutData.data(), header.m_Size) && crc32c::Crc32c(v_OutData.data(), v_OutData.size()) == header.m_Hash;
+		}
+
+		file.close();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto it = m_Entries.find(key);
+
+		if (!valid)
+		{
+			LOG_F(WARNING, "Cached entry %s is damaged, removing it", key.c_str());
+
+			if (it != m_Entries.end())
+			{
+				m_Size -= it->second.m_Size;
+				m_Entries.erase(it);
+			}
+
+			std::error_code error;
+			std::filesystem::remove(path, error);
+
+			v_OutData.clear();
+			m_NumMisses++;
+			return false;
+		}
+
+		if (it != m_Entries.end()) it->second.m_LastUsed = ++m_UseCounter;
+
+		// Write time of the file is the last use seen by the next run
+		std::error_code error;
+		std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+		m_NumHits++;
+		return true;
+	}
+
+	/*
+		Saves entry with specified key unless it's cached already.
+		Entry is written to a temporary file first so readers never see it half written.
+	*/
+	void AssetCache::Store(const std::string& key, const std::vector<uint8_t>& v_Data)
+	{
+		if (!IsEnabled()) return;
+
+		uint64_t writeId = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_Entries.find(key) != m_Entries.end()) return;
+
+			writeId = ++m_UseCounter;
+		}
+
+		std::string path = GetEntryPath(key);
+		std::string tempPath = path + "." + std::to_string(writeId) + ".tmp";
+
+		CacheFileHeader header = {};
+		header.m_Hash = crc32c::Crc32c(v_Data.data(), v_Data.size());
+		header.m_Size = v_Data.size();
+
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)v_Data.data(), v_Data.size());
+		file.close();
+
+		std::error_code error;
+
+		if (!file)
+		{
+			LOG_F(WARNING, "Could not write %s to asset cache", key.c_str());
+			std::filesystem::remove(tempPath, error);
+			return;
+		}
+
+		std::filesystem::rename(tempPath, path, error);
+
+		if (error)
+		{
+			// Another thread could have stored the same entry in the meantime
+			std::filesystem::remove(tempPath, error);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (m_Entries.find(key) != m_Entries.end()) return;
+
+		m_Entries[key] = { sizeof(header) + v_Data.size(), ++m_UseCounter };
+		m_Size += sizeof(header) + v_Data.size();
+
+		Trim();
+	}
+
+	/*
+		Returns path of the file that holds entry with specified key
+	*/
+	std::string AssetCache::GetEntryPath(const std::string& key) const
+	{
+		return (std::filesystem::path(m_Directory) / (key + ".bin")).string();
+	}
+
+	/*
+		Deletes least recently used entries until the cache fits into its size limit.
+		Mutex has to be locked by the caller.
+	*/
+	void AssetCache::Trim()
+	{
+		if (m_Size <= m_MaxSize) return;
+
+		std::vector<std::pair<uint64_t, std::string>> v_Candidates;
+		for (const auto& [key, entry] : m_Entries)
+			v_Candidates.push_back({ entry.m_LastUsed, key });
+
+		std::sort(v_Candidates.begin(), v_Candidates.end());
+
+		size_t numRemoved = 0;
+
+		for (const auto& [lastUsed, key] : v_Candidates)
+		{
+			if (m_Size <= m_MaxSize) break;
+
+			std::error_code error;
+			std::filesystem::remove(GetEntryPath(key), error);
+
+			m_Size -= m_Entries[key].m_Size;
+			m_Entries.erase(key);
+			numRemoved++;
+		}
+
+		LOG_F(INFO, "Trimmed %zu entries from asset cache", numRemoved);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include <Mesa/AsyncFileReader.h>
+#include <Mesa/EngineConfig.h>
+#include <Mesa/ConvertUtils.h>
+
+namespace Mesa
+{
+	// Completion key used to wake completion threads up when the reader is destroyed
+	static constexpr ULONG_PTR SHUTDOWN_KEY = 1;
+	// Default size of a single preallocated read buffer
+	static constexpr uint32_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+	// Default number of reads that can be in flight at once
+	static constexpr uint32_t DEFAULT_QUEUE_DEPTH = 32;
+	// Upper limit of threads of the thread pool backend, each of them keeps one read in flight
+	static constexpr uint32_t MAX_POOL_WORKERS = 64;
+
+	/*
+		Constructor: Allocates read buffers and starts threads that complete the reads.
+		If I/O completion port cannot be created reader falls back to the thread pool backend.
+	*/
+	AsyncFileReader::AsyncFileReader(AsyncReadBackend backend, uint32_t queueDepth, uint32_t bufferSize)
+		: m_Backend(backend), m_QueueDepth(std::max(queueDepth, 1u)), m_BufferSize(bufferSize), m_QueueSlots(std::max(queueDepth, 1u))
+	{
+		// Allocate one buffer for every read that can be in flight
+		mv_BufferMemory.resize((size_t)m_QueueDepth * m_BufferSize);
+		for (uint32_t i = 0; i < m_QueueDepth; i++)
+			mv_FreeBuffers.push_back(mv_BufferMemory.data() + (size_t)i * m_BufferSize);
+
+		if (m_Backend == AsyncReadBackend_CompletionPort)
+		{
+			mp_CompletionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 0);
+
+			if (mp_CompletionPort == nullptr)
+			{
+				LOG_F(WARNING, "Failed to create I/O completion port! Falling back to thread pool reads");
+				m_Backend = AsyncReadBackend_ThreadPool;
+			}
+		}
+
+		if (m_Backend == AsyncReadBackend_CompletionPort)
+		{
+			// Completions only copy data out of the buffers so two threads are plenty
+			for (int i = 0; i < 2; i++)
+				mv_Workers.push_back(std::thread(&AsyncFileReader::CompletionPortLoop, this));
+		}
+		else
+		{
+			// Every worker keeps one read in flight, workers mostly wait for the disk so their number follows the queue depth
+			uint32_t numWorkers = std::min(m_QueueDepth, MAX_POOL_WORKERS);
+			for (uint32_t i = 0; i < numWorkers; i++)
+				mv_Workers.push_back(std::thread(&AsyncFileReader::ThreadPoolLoop, this));
+		}
+
+		LOG_F(INFO, "Async file reader started with %s backend and queue depth of %u",
+			m_Backend == AsyncReadBackend_CompletionPort ? "completion port" : "thread pool", m_QueueDepth);
+	}
+
+	/*
+		Destructor: Stops all threads and closes every opened file.
+		All submitted reads should be completed before the reader is destroyed.
+	*/
+	AsyncFileReader::~AsyncFileReader()
+	{
+		if (m_Backend == AsyncReadBackend_CompletionPort)
+		{
+			for (size_t i = 0; i < mv_Workers.size(); i++)
+				PostQueuedCompletionStatus(mp_CompletionPort, 0, SHUTDOWN_KEY, nullptr);
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(m_PendingMutex);
+			m_Shutdown = true;
+			m_PendingCondition.notify_all();
+		}
+
+		for (auto& worker : mv_Workers)
+		{
+			if (worker.joinable())
+				worker.join();
+		}
+
+		for (auto& file : m_Files)
+			CloseHandle(file.second);
+
+		if (mp_CompletionPort != nullptr)
+			CloseHandle(mp_CompletionPort);
+	}
+
+	/*
+		Returns reader shared by the whole engine.
+		Backend and queue depth are read from the configuration file.
+	*/
+	AsyncFileReader& AsyncFileReader::GetDefault()
+	{
+		static AsyncFileReader reader(
+			EngineConfig::Get<ConfigKey_StreamingIoBackend>() == "threadpool" ? AsyncReadBackend_ThreadPool : AsyncReadBackend_CompletionPort,
+			EngineConfig::Get<ConfigKey_StreamingIoQueueDepth>() > 0 ? EngineConfig::Get<ConfigKey_StreamingIoQueueDepth>() : DEFAULT_QUEUE_DEPTH,
+			DEFAULT_BUFFER_SIZE);
+
+		return reader;
+	}
+
+	/*
+		Queues read of specified range of a file.
+		If the queue is full this function blocks until one of the reads completes.
+		Callback is invoked from one of the reader threads once the read is done.
+	*/
+	void AsyncFileReader::Submit(const std::string& path, uint64_t offset, uint32_t size, AsyncReadCallback callback)
+	{
+		// Wait for a free slot in the queue
+		m_QueueSlots.acquire();
+
+		ReadOperation* p_Operation = new ReadOperation();
+		p_Operation->m_File = GetFileHandle(path);
+		p_Operation->m_Offset = offset;
+		p_Operation->m_Size = size;
+		p_Operation->m_Callback = std::move(callback);
+		p_Operation->mp_Buffer = AcquireBuffer(size, p_Operation->m_Pooled);
+
+		if (p_Operation->m_File == INVALID_HANDLE_VALUE)
+		{
+			LOG_F(ERROR, "Could not open %s", path.c_str());
+			Complete(p_Operation, 0, false);
+			return;
+		}
+
+		// There is nothing to read
+		if (size == 0)
+		{
+			Complete(p_Operation, 0, true);
+			return;
+		}
+
+		if (m_Backend == AsyncReadBackend_CompletionPort)
+		{
+			p_Operation->m_Overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+			p_Operation->m_Overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+			// Completion will be delivered to the completion port even if the read finishes immediately
+			if (!ReadFile(p_Operation->m_File, p_Operation->mp_Buffer, size, nullptr, &p_Operation->m_Overlapped) && GetLastError() != ERROR_IO_PENDING)
+			{
+				LOG_F(ERROR, "ReadFile failed for %s with error %lu", path.c_str(), GetLastError());
+				Complete(p_Operation, 0, false);
+			}
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(m_PendingMutex);
+			m_PendingOperations.push_back(p_Operation);
+			m_PendingCondition.notify_one();
+		}
+	}
+
+	/*
+		Closes cached handle of specified file.
+		Has to be called before the file is replaced on the disk.
+	*/
+	void AsyncFileReader::CloseFile(const std::string& path)
+	{
+		std::lock_guard<std::mutex> lock(m_FileMutex);
+
+		auto it = m_Files.find(path);
+		if (it == m_Files.end()) return;
+
+		CloseHandle(it->second);
+		m_Files.erase(it);
+	}
+
+	/*
+		Returns handle of specified file opening it if necessary.
+		If the file cannot be opened returns INVALID_HANDLE_VALUE.
+	*/
+	HANDLE AsyncFileReader::GetFileHandle(const std::string& path)
+	{
+		std::lock_guard<std::mutex> lock(m_FileMutex);
+
+		auto it = m_Files.find(path);
+		if (it != m_Files.end()) return it->second;
+
+		// Both backends read through overlapped handles, synchronous reads of one file object would be serialized by the system
+		DWORD flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED;
+
+		// Allow other processes to read and replace the file while it's open
+		HANDLE file = CreateFile(ConvertUtils::StringToWideString(path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, flags, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return file;
+
+		// Route completions of every read from this file to the completion port
+		if (m_Backend == AsyncReadBackend_CompletionPort && CreateIoCompletionPort(file, mp_CompletionPort, 0, 0) == nullptr)
+		{
+			CloseHandle(file);
+			return INVALID_HANDLE_VALUE;
+		}
+
+		m_Files[path] = file;
+		return file;
+	}
+
+	/*
+		Returns buffer big enough to hold specified amount of bytes.
+		Preallocated buffers are used whenever possible.
+	*/
+	uint8_t* AsyncFileReader::AcquireBuffer(uint32_t size, bool& pooled)
+	{
+		if (size <= m_BufferSize)
+		{
+			std::lock_guard<std::mutex> lock(m_BufferMutex);
+
+			// Queue slots guarantee that there is always a free buffer left
+			if (!mv_FreeBuffers.empty())
+			{
+				uint8_t* p_Buffer = mv_FreeBuffers.back();
+				mv_FreeBuffers.pop_back();
+				pooled = true;
+				return p_Buffer;
+			}
+		}
+
+		pooled = false;
+		return new uint8_t[std::max(size, 1u)];
+	}
+
+	/*
+		Returns buffer to the pool or frees it if it was allocated separately.
+	*/
+	void AsyncFileReader::ReleaseBuffer(uint8_t* p_Buffer, bool pooled)
+	{
+		if (!pooled)
+		{
+			delete[] p_Buffer;
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_BufferMutex);
+		mv_FreeBuffers.push_back(p_Buffer);
+	}
+
+	/*
+		Delivers read results to the callback and frees resources used by the read.
+	*/
+	void AsyncFileReader::Complete(ReadOperation* p_Operation, uint32_t bytesRead, bool success)
+	{
+		AsyncReadResult result = {};
+		result.mp_Data = p_Operation->mp_Buffer;
+		result.m_Offset = p_Operation->m_Offset;
+		result.m_Size = p_Operation->m_Size;
+		result.m_BytesRead = bytesRead;
+		result.m_Success = success && bytesRead == p_Operation->m_Size;
+
+		if (p_Operation->m_Callback)
+			p_Operation->m_Callback(result);
+
+		ReleaseBuffer(p_Operation->mp_Buffer, p_Operation->m_Pooled);
+		delete p_Operation;
+
+		// Let the next read in
+		m_QueueSlots.release();
+	}
+
+	/*
+		Waits for completed overlapped reads and hands them to their callbacks.
+	*/
+	void AsyncFileReader::CompletionPortLoop()
+	{
+		while (true)
+		{
+			DWORD bytesRead = 0;
+			ULONG_PTR key = 0;
+			OVERLAPPED* p_Overlapped = nullptr;
+
+			BOOL result = GetQueuedCompletionStatus(mp_CompletionPort, &bytesRead, &key, &p_Overlapped, INFINITE);
+
+			// Packets without overlapped structure are only sent when the reader shuts down
+			if (p_Overlapped == nullptr)
+			{
+				if (key == SHUTDOWN_KEY) return;
+				continue;
+			}
+
+			ReadOperation* p_Operation = CONTAINING_RECORD(p_Overlapped, ReadOperation, m_Overlapped);
+			Complete(p_Operation, bytesRead, result != FALSE);
+		}
+	}
+
+	/*
+		Executes queued reads one by one using positional reads.
+		Reads are overlapped and every worker waits on its own event, so reads of workers
+		run concurrently even when they share the handle of one file.
+	*/
+	void AsyncFileReader::ThreadPoolLoop()
+	{
+		HANDLE event = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+		while (true)
+		{
+			ReadOperation* p_Operation = nullptr;
+
+			{
+				std::unique_lock<std::mutex> lock(m_PendingMutex);
+				m_PendingCondition.wait(lock, [this]() { return m_Shutdown || !m_PendingOperations.empty(); });
+
+				if (m_PendingOperations.empty()) break;
+
+				p_Operation = m_PendingOperations.front();
+				m_PendingOperations.pop_front();
+			}
+
+			// Offset in overlapped structure makes the read independent from the file pointer
+			OVERLAPPED overlapped = {};
+			overlapped.Offset = (DWORD)(p_Operation->m_Offset & 0xFFFFFFFF);
+			overlapped.OffsetHigh = (DWORD)(p_Operation->m_Offset >> 32);
+			overlapped.hEvent = event;
+
+			DWORD bytesRead = 0;
+			BOOL result = ReadFile(p_Operation->m_File, p_Operation->mp_Buffer, p_Operation->m_Size, nullptr, &overlapped);
+
+			if (result || GetLastError() == ERROR_IO_PENDING)
+				result = GetOverlappedResult(p_Operation->m_File, &overlapped, &bytesRead, TRUE);
+
+			Complete(p_Operation, bytesRead, result != FALSE);
+		}
+
+		CloseHandle(event);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,701 @@
+#include <Mesa/BoundingVolumeTree.h>
+#include <Mesa/JobSystem.h>
+
+namespace Mesa
+{
+	using Box = BoundingVolumeTree::Box;
+
+	static Box Union(const Box& a, const Box& b)
+	{
+		Box box;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			box.m_Min[axis] = std::min(a.m_Min[axis], b.m_Min[axis]);
+			box.m_Max[axis] = std::max(a.m_Max[axis], b.m_Max[axis]);
+		}
+
+		return box;
+	}
+
+	// Half of the surface area, only used to compare boxes
+	static float Area(const Box& box)
+	{
+		float dx = box.m_Max.x - box.m_Min.x;
+		float dy = box.m_Max.y - box.m_Min.y;
+		float dz = box.m_Max.z - box.m_Min.z;
+
+		return dx * dy + dy * dz + dz * dx;
+	}
+
+	static bool Contains(const Box& outer, const Box& inner)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (inner.m_Min[axis] < outer.m_Min[axis] || inner.m_Max[axis] > outer.m_Max[axis]) return false;
+		}
+
+		return true;
+	}
+
+	static bool Overlaps(const Box& a, const Box& b)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (a.m_Max[axis] < b.m_Min[axis] || b.m_Max[axis] < a.m_Min[axis]) return false;
+		}
+
+		return true;
+	}
+
+	static Box Fatten(const Box& box)
+	{
+		Box fat = box;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float margin = (box.m_Max[axis] - box.m_Min[axis]) * BoundingVolumeTree::FAT_MARGIN;
+			fat.m_Min[axis] -= margin;
+			fat.m_Max[axis] += margin;
+		}
+
+		return fat;
+	}
+
+	/*
+		Returns distance along the ray at which it enters the box, or a negative value if it misses the box
+		before maxDistance. Ray that starts inside the box enters it at 0.
+	*/
+	static float IntersectRay(const glm::vec3& origin, const glm::vec3& invDirection, const Box& box, float maxDistance)
+	{
+		float enter = 0.0f;
+		float exit = maxDistance;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float t1 = (box.m_Min[axis] - origin[axis]) * invDirection[axis];
+			float t2 = (box.m_Max[axis] - origin[axis]) * invDirection[axis];
+
+			// NaN appears when the ray lies on a face of the box, treat it as a hit of that slab
+			if (t1 != t1 || t2 != t2) continue;
+
+			enter = std::max(enter, std::min(t1, t2));
+			exit = std::min(exit, std::max(t1, t2));
+		}
+
+		return enter <= exit ? enter : -1.0f;
+	}
+
+	Box BoundingVolumeTree::ToBox(const BoundingVolume& bounds)
+	{
+		Box box;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			box.m_Min[axis] = bounds.m_Center[axis] - bounds.m_Extents[axis];
+			box.m_Max[axis] = bounds.m_Center[axis] + bounds.m_Extents[axis];
+		}
+
+		return box;
+	}
+
+	/*
+		Adds a leaf and returns its proxy
+	*/
+	uint32_t BoundingVolumeTree::Insert(const BoundingVolume& bounds, uint32_t value)
+	{
+		uint32_t proxy = AllocateLeaf(value);
+		uint32_t node = AllocateNode();
+
+		mv_Nodes[node].m_Box = Fatten(ToBox(bounds));
+		mv_Nodes[node].m_Leaf = proxy;
+		mv_Leaves[proxy].m_Node = node;
+
+		InsertLeafNode(node);
+
+		return proxy;
+	}
+
+	void BoundingVolumeTree::Remove(uint32_t proxy)
+	{
+		if (proxy >= mv_Leaves.size() || mv_Leaves[proxy].m_Node == NULL_NODE) return;
+
+		uint32_t node = mv_Leaves[proxy].m_Node;
+
+		RemoveLeafNode(node);
+		FreeNode(node);
+
+		mv_Leaves[proxy].m_Node = NULL_NODE;
+		mv_FreeLeaves.push_back(proxy);
+	}
+
+	/*
+		Updates bounds of a leaf. Tree only changes when the new bounds leave the enlarged box of the leaf,
+		or when the box is much larger than the bounds (e.g. after the object was scaled down).
+		Returns true if the leaf was moved in the tree.
+	*/
+	bool BoundingVolumeTree::Move(uint32_t proxy, const BoundingVolume& bounds)
+	{
+		uint32_t node = mv_Leaves[proxy].m_Node;
+
+		Box box = ToBox(bounds);
+		Box fatBox = Fatten(box);
+
+		const Box& current = mv_Nodes[node].m_Box;
+		if (Contains(current, box) && Area(current) <= 4.0f * Area(fatBox)) return false;
+
+		RemoveLeafNode(node);
+		mv_Nodes[node].m_Box = fatBox;
+		InsertLeafNode(node);
+
+		return true;
+	}
+
+	/*
+		Replaces the whole tree with leaves of specified volumes. Proxy of every leaf is its index in the input.
+		Nodes of a subtree with n leaves take 2n - 1 consecutive slots, so subtrees can be built
+		in parallel without synchronization.
+	*/
+	void BoundingVolumeTree::Build(std::span<const BoundingVolume> bounds, std::span<const uint32_t> values)
+	{
+		Clear();
+
+		size_t count = std::min(bounds.size(), values.size());
+		if (count == 0) return;
+
+		std::vector<Box> v_Boxes(count);
+		std::vector<uint32_t> v_Order(count);
+
+		mv_Leaves.resize(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			v_Boxes[i] = Fatten(ToBox(bounds[i]));
+			v_Order[i] = (uint32_t)i;
+			mv_Leaves[i].m_Value = values[i];
+		}
+
+		mv_Nodes.resize(2 * count - 1);
+		BuildRange(v_Order.data(), count, v_Boxes.data(), 0, NULL_NODE);
+
+		m_Root = 0;
+	}
+
+	void BoundingVolumeTree::Clear()
+	{
+		mv_Nodes.clear();
+		mv_FreeNodes.clear();
+		mv_Leaves.clear();
+		mv_FreeLeaves.clear();
+		m_Root = NULL_NODE;
+	}
+
+	/*
+		Returns values of leaves whose boxes are at least partially inside the frustum.
+		Planes point inside the frustum. Subtrees fully inside it are collected without further tests.
+	*/
+	void BoundingVolumeTree::QueryFrustum(const std::array<glm::vec4, 6>& planes, std::vector<uint32_t>& v_OutValues) const
+	{
+		if (m_Root == NULL_NODE) return;
+
+		std::vector<uint32_t> v_Stack = { m_Root };
+
+		while (!v_Stack.empty())
+		{
+			uint32_t index = v_Stack.back();
+			v_Stack.pop_back();
+
+			const Node& node = mv_Nodes[index];
+			bool isOutside = false;
+			bool isInside = true;
+
+			for (const auto& plane : planes)
+			{
+				float distance = 0.0f;
+				float radius = 0.0f;
+
+				for (int axis = 0; axis < 3; axis++)
+				{
+					float center = (node.m_Box.m_Min[axis] + node.m_Box.m_Max[axis]) * 0.5f;
+					float extent = (node.m_Box.m_Max[axis] - node.m_Box.m_Min[axis]) * 0.5f;
+
+					distance += plane[axis] * center;
+					radius += std::abs(plane[axis]) * extent;
+				}
+
+				distance += plane[3];
+
+				if (distance + radius < 0.0f)
+				{
+					isOutside = true;
+					break;
+				}
+
+				if (distance - radius < 0.0f) isInside = false;
+			}
+
+			if (isOutside) continue;
+
+			if (isInside || node.m_Leaf != NULL_NODE)
+			{
+				CollectLeaves(index, v_OutValues);
+				continue;
+			}
+
+			v_Stack.push_back(node.m_Child1);
+			v_Stack.push_back(node.m_Child2);
+		}
+	}
+
+	/*
+		Returns values of leaves whose boxes overlap the box
+	*/
+	void BoundingVolumeTree::QueryBox(const Box& box, std::vector<uint32_t>& v_OutValues) const
+	{
+		if (m_Root == NULL_NODE) return;
+
+		std::vector<uint32_t> v_Stack = { m_Root };
+
+		while (!v_Stack.empty())
+		{
+			const Node& node = mv_Nodes[v_Stack.back()];
+			v_Stack.pop_back();
+
+			if (!Overlaps(node.m_Box, box)) continue;
+
+			if (node.m_Leaf != NULL_NODE)
+			{
+				v_OutValues.push_back(mv_Leaves[node.m_Leaf].m_Value);
+				continue;
+			}
+
+			v_Stack.push_back(node.m_Child1);
+			v_Stack.push_back(node.m_Child2);
+		}
+	}
+
+	/*
+		Returns values of leaves whose boxes overlap the sphere
+	*/
+	void BoundingVolumeTree::QuerySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& v_OutValues) const
+	{
+		if (m_Root == NULL_NODE) return;
+
+		std::vector<uint32_t> v_Stack = { m_Root };
+
+		while (!v_Stack.empty())
+		{
+			const Node& node = mv_Nodes[v_Stack.back()];
+			v_Stack.pop_back();
+
+			// Squared distance from the center to the closest point of the box
+			float distance = 0.0f;
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float d = std::max(node.m_Box.m_Min[axis] - center[axis], std::max(0.0f, center[axis] - node.m_Box.m_Max[axis]));
+				distance += d * d;
+			}
+
+			if (distance > radius * radius) continue;
+
+			if (node.m_Leaf != NULL_NODE)
+			{
+				v_OutValues.push_back(mv_Leaves[node.m_Leaf].m_Value);
+				continue;
+			}
+
+			v_Stack.push_back(node.m_Child1);
+			v_Stack.push_back(node.m_Child2);
+		}
+	}
+
+	/*
+		Finds the closest leaf hit by the ray. Boxes of leaves only limit the search, every leaf hit
+		by the ray is passed to testLeaf that returns exact distance of the hit or a negative value on a miss.
+		Distances are in units of the direction vector. Returns false if nothing was hit.
+	*/
+	bool BoundingVolumeTree::RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+		const std::function<float(uint32_t value, float maxDistance)>& testLeaf, uint32_t& outValue, float& outDistance) const
+	{
+		if (m_Root == NULL_NODE) return false;
+
+		glm::vec3 invDirection = glm::vec3(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+		bool isHit = false;
+
+		std::vector<uint32_t> v_Stack = { m_Root };
+
+		while (!v_Stack.empty())
+		{
+			const Node& node = mv_Nodes[v_Stack.back()];
+			v_Stack.pop_back();
+
+			if (IntersectRay(origin, invDirection, node.m_Box, maxDistance) < 0.0f) continue;
+
+			if (node.m_Leaf != NULL_NODE)
+			{
+				uint32_t value = mv_Leaves[node.m_Leaf].m_Value;
+				float distance = testLeaf(value, maxDistance);
+
+				// Closer hits shorten the ray so farther subtrees are skipped
+				if (distance >= 0.0f && distance <= maxDistance)
+				{
+					maxDistance = distance;
+					outValue = value;
+					outDistance = distance;
+					isHit = true;
+				}
+
+				continue;
+			}
+
+			v_Stack.push_back(node.m_Child1);
+			v_Stack.push_back(node.m_Child2);
+		}
+
+		return isHit;
+	}
+
+	/*
+		Returns number of nodes on the longest path from the root to a leaf
+	*/
+	uint32_t BoundingVolumeTree::GetHeight() const
+	{
+		if (m_Root == NULL_NODE) return 0;
+
+		uint32_t height = 0;
+		std::vector<std::pair<uint32_t, uint32_t>> v_Stack = { { m_Root, 1 } };
+
+		while (!v_Stack.empty())
+		{
+			auto [index, depth] = v_Stack.back();
+			v_Stack.pop_back();
+
+			height = std::max(height, depth);
+
+			if (mv_Nodes[index].m_Leaf != NULL_NODE) continue;
+
+			v_Stack.push_back({ mv_Nodes[index].m_Child1, depth + 1 });
+			v_Stack.push_back({ mv_Nodes[index].m_Child2, depth + 1 });
+		}
+
+		return height;
+	}
+
+	uint32_t BoundingVolumeTree::AllocateNode()
+	{
+		if (mv_FreeNodes.empty())
+		{
+			mv_Nodes.emplace_back();
+			return (uint32_t)mv_Nodes.size() - 1;
+		}
+
+		uint32_t node = mv_FreeNodes.back();
+		mv_FreeNodes.pop_back();
+
+		mv_Nodes[node] = Node();
+		return node;
+	}
+
+	void BoundingVolumeTree::FreeNode(uint32_t node)
+	{
+		mv_FreeNodes.push_back(node);
+	}
+
+	uint32_t BoundingVolumeTree::AllocateLeaf(uint32_t value)
+	{
+		uint32_t proxy = 0;
+
+		if (mv_FreeLeaves.empty())
+		{
+			mv_Leaves.emplace_back();
+			proxy = (uint32_t)mv_Leaves.size() - 1;
+		}
+		else
+		{
+			proxy = mv_FreeLeaves.back();
+			mv_FreeLeaves.pop_back();
+		}
+
+		mv_Leaves[proxy].m_Value = value;
+		return proxy;
+	}
+
+	/*
+		Links leaf node into the tree. Sibling is found by descending into the child whose box grows the least,
+		and stops at the node where creating a new parent is cheaper than going deeper.
+	*/
+	void BoundingVolumeTree::InsertLeafNode(uint32_t leafNode)
+	{
+		if (m_Root == NULL_NODE)
+		{
+			m_Root = leafNode;
+			mv_Nodes[leafNode].m_Parent = NULL_NODE;
+			return;
+		}
+
+		Box box = mv_Nodes[leafNode].m_Box;
+		uint32_t index = m_Root;
+
+		while (mv_Nodes[index].m_Leaf == NULL_NODE)
+		{
+			const Node& node = mv_Nodes[index];
+
+			float combinedArea = Area(Union(node.m_Box, box));
+
+			// Cost of making a new parent for this node and the leaf
+			float cost = 2.0f * combinedArea;
+
+			// Cost of pushing the leaf further down, which grows this node
+			float inheritanceCost = 2.0f * (combinedArea - Area(node.m_Box));
+
+			auto descendCost = [&](uint32_t child)
+			{
+				const Node& childNode = mv_Nodes[child];
+				float area = Area(Union(childNode.m_Box, box));
+
+				return childNode.m_Leaf != NULL_NODE ? area + inheritanceCost : area - Area(childNode.m_Box) + inheritanceCost;
+			};
+
+			float cost1 = descendCost(node.m_Child1);
+			float cost2 = descendCost(node.m_Child2);
+
+			if (cost < cost1 && cost < cost2) break;
+
+			index = cost1 < cost2 ? node.m_Child1 : node.m_Child2;
+		}
+
+		uint32_t sibling = index;
+		uint32_t oldParent = mv_Nodes[sibling].m_Parent;
+		uint32_t newParent = AllocateNode();
+
+		mv_Nodes[newParent].m_Parent = oldParent;
+		mv_Nodes[newParent].m_Box = Union(box, mv_Nodes[sibling].m_Box);
+		mv_Nodes[newParent].m_Child1 = sibling;
+		mv_Nodes[newParent].m_Child2 = leafNode;
+		mv_Nodes[sibling].m_Parent = newParent;
+		mv_Nodes[leafNode].m_Parent = newParent;
+
+		if (oldParent == NULL_NODE)
+		{
+			m_Root = newParent;
+			return;
+		}
+
+		if (mv_Nodes[oldParent].m_Child1 == sibling)
+			mv_Nodes[oldParent].m_Child1 = newParent;
+		else
+			mv_Nodes[oldParent].m_Child2 = newParent;
+
+		Refit(oldParent);
+	}
+
+	/*
+		Unlinks leaf node from the tree, its parent is freed and replaced by the sibling
+	*/
+	void BoundingVolumeTree::RemoveLeafNode(uint32_t leafNode)
+	{
+		if (leafNode == m_Root)
+		{
+			m_Root = NULL_NODE;
+			return;
+		}
+
+		uint32_t parent = mv_Nodes[leafNode].m_Parent;
+		uint32_t grandParent = mv_Nodes[parent].m_Parent;
+		uint32_t sibling = mv_Nodes[parent].m_Child1 == leafNode ? mv_Nodes[parent].m_Child2 : mv_Nodes[parent].m_Child1;
+
+		FreeNode(parent);
+
+		mv_Nodes[sibling].m_Parent = grandParent;
+
+		if (grandParent == NULL_NODE)
+		{
+			m_Root = sibling;
+			return;
+		}
+
+		if (mv_Nodes[grandParent].m_Child1 == parent)
+			mv_Nodes[grandParent].m_Child1 = sibling;
+		else
+			mv_Nodes[grandParent].m_Child2 = sibling;
+
+		Refit(grandParent);
+	}
+
+	/*
+		Recomputes boxes from the node up to the root and rotates every node on the way
+	*/
+	void BoundingVolumeTree::Refit(uint32_t node)
+	{
+		while (node != NULL_NODE)
+		{
+			Rotate(node);
+
+			Node& current = mv_Nodes[node];
+			current.m_Box = Union(mv_Nodes[current.m_Child1].m_Box, mv_Nodes[current.m_Child2].m_Box);
+
+			node = current.m_Parent;
+		}
+	}
+
+	/*
+		Swaps a child of the node with a grandchild under its other child if that reduces surface area
+		of the child that gets the new grandchild. Box of the node itself doesn't change since it keeps the same leaves.
+	*/
+	void BoundingVolumeTree::Rotate(uint32_t node)
+	{
+		enum Rotation { Rotation_None, Rotation_BF, Rotation_BG, Rotation_CD, Rotation_CE };
+
+		uint32_t b = mv_Nodes[node].m_Child1;
+		uint32_t c = mv_Nodes[node].m_Child2;
+
+		Rotation best = Rotation_None;
+		float bestDifference = 0.0f;
+
+		// Swap B with a child of C
+		if (mv_Nodes[c].m_Leaf == NULL_NODE)
+		{
+			uint32_t f = mv_Nodes[c].m_Child1;
+			uint32_t g = mv_Nodes[c].m_Child2;
+			float area = Area(mv_Nodes[c].m_Box);
+
+			float difference = Area(Union(mv_Nodes[b].m_Box, mv_Nodes[g].m_Box)) - area;
+			if (difference < bestDifference) { best = Rotation_BF; bestDifference = difference; }
+
+			difference = Area(Union(mv_Nodes[b].m_Box, mv_Nodes[f].m_Box)) - area;
+			if (difference < bestDifference) { best = Rotation_BG; bestDifference = difference; }
+		}
+
+		// Swap C with a child of B
+		if (mv_Nodes[b].m_Leaf == NULL_NODE)
+		{
+			uint32_t d = mv_Nodes[b].m_Child1;
+			uint32_t e = mv_Nodes[b].m_Child2;
+			float area = Area(mv_Nodes[b].m_Box);
+
+			float difference = Area(Union(mv_Nodes[c].m_Box, mv_Nodes[e].m_Box)) - area;
+			if (difference < bestDifference) { best = Rotation_CD; bestDifference = difference; }
+
+			difference = Area(Union(mv_Nodes[c].m_Box, mv_Nodes[d].m_Box)) - area;
+			if (difference < bestDifference) { best = Rotation_CE; bestDifference = difference; }
+		}
+
+		// Moves child of the node under its other child in place of a grandchild
+		auto swap = [this, node](uint32_t child, uint32_t other, bool isFirstChild, bool isFirstGrandChild)
+		{
+			uint32_t grandChild = isFirstGrandChild ? mv_Nodes[other].m_Child1 : mv_Nodes[other].m_Child2;
+			uint32_t remaining = isFirstGrandChild ? mv_Nodes[other].m_Child2 : mv_Nodes[other].m_Child1;
+
+			if (isFirstChild) mv_Nodes[node].m_Child1 = grandChild;
+			else mv_Nodes[node].m_Child2 = grandChild;
+
+			if (isFirstGrandChild) mv_Nodes[other].m_Child1 = child;
+			else mv_Nodes[other].m_Child2 = child;
+
+			mv_Nodes[grandChild].m_Parent = node;
+			mv_Nodes[child].m_Parent = other;
+			mv_Nodes[other].m_Box = Union(mv_Nodes[child].m_Box, mv_Nodes[remaining].m_Box);
+		};
+
+		switch (best)
+		{
+		case Rotation_BF: swap(b, c, true, true); break;
+		case Rotation_BG: swap(b, c, true, false); break;
+		case Rotation_CD: swap(c, b, false, true); break;
+		case Rotation_CE: swap(c, b, false, false); break;
+		default: break;
+		}
+	}
+
+	/*
+		Builds subtree of the leaves at specified node. Leaves are split at the median of their centers
+		along the longest axis, the left subtree starts right after the node and the right one after it.
+	*/
+	void BoundingVolumeTree::BuildRange(uint32_t* p_Leaves, size_t count, const Box* p_Boxes, uint32_t nodeIndex, uint32_t parent)
+	{
+		Node& node = mv_Nodes[nodeIndex];
+		node.m_Parent = parent;
+
+		if (count == 1)
+		{
+			node.m_Box = p_Boxes[p_Leaves[0]];
+			node.m_Leaf = p_Leaves[0];
+			node.m_Child1 = NULL_NODE;
+			node.m_Child2 = NULL_NODE;
+			mv_Leaves[p_Leaves[0]].m_Node = nodeIndex;
+			return;
+		}
+
+		auto getCenter = [p_Boxes](uint32_t leaf, int axis) { return p_Boxes[leaf].m_Min[axis] + p_Boxes[leaf].m_Max[axis]; };
+
+		// Bounds of centers of the leaves decide the split axis
+		Box centers;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			centers.m_Min[axis] = getCenter(p_Leaves[0], axis);
+			centers.m_Max[axis] = centers.m_Min[axis];
+		}
+
+		for (size_t i = 1; i < count; i++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float center = getCenter(p_Leaves[i], axis);
+				centers.m_Min[axis] = std::min(centers.m_Min[axis], center);
+				centers.m_Max[axis] = std::max(centers.m_Max[axis], center);
+			}
+		}
+
+		int splitAxis = 0;
+		for (int axis = 1; axis < 3; axis++)
+		{
+			if (centers.m_Max[axis] - centers.m_Min[axis] > centers.m_Max[splitAxis] - centers.m_Min[splitAxis]) splitAxis = axis;
+		}
+
+		size_t half = count / 2;
+		std::nth_element(p_Leaves, p_Leaves + half, p_Leaves + count, [&](uint32_t a, uint32_t b) { return getCenter(a, splitAxis) < getCenter(b, splitAxis); });
+
+		uint32_t left = nodeIndex + 1;
+		uint32_t right = nodeIndex + (uint32_t)(2 * half);
+
+		if (count >= PARALLEL_BUILD_SIZE)
+		{
+			JobCounter counter;
+			JobSystem::GetDefault().Run([=, this]() { BuildRange(p_Leaves + half, count - half, p_Boxes, right, nodeIndex); }, &counter);
+			BuildRange(p_Leaves, half, p_Boxes, left, nodeIndex);
+			JobSystem::GetDefault().Wait(counter);
+		}
+		else
+		{
+			BuildRange(p_Leaves, half, p_Boxes, left, nodeIndex);
+			BuildRange(p_Leaves + half, count - half, p_Boxes, right, nodeIndex);
+		}
+
+		// Reference could be invalid only if nodes were reallocated, which Build() prevents
+		node.m_Box = Union(mv_Nodes[left].m_Box, mv_Nodes[right].m_Box);
+		node.m_Child1 = left;
+		node.m_Child2 = right;
+		node.m_Leaf = NULL_NODE;
+	}
+
+	void BoundingVolumeTree::CollectLeaves(uint32_t node, std::vector<uint32_t>& v_OutValues) const
+	{
+		std::vector<uint32_t> v_Stack = { node };
+
+		while (!v_Stack.empty())
+		{
+			const Node& current = mv_Nodes[v_Stack.back()];
+			v_Stack.pop_back();
+
+			if (current.m_Leaf != NULL_NODE)
+			{
+				v_OutValues.push_back(mv_Leaves[current.m_Leaf].m_Value);
+				continue;
+			}
+
+			v_Stack.push_back(current.m_Child1);
+			v_Stack.push_back(current.m_Child2);
+		}
+	}
+}
\ No newline at end of file
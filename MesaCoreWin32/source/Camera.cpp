@@ -1,7 +1,137 @@
 #include <Mesa/Camera.h>
+#include <Mesa/ConvertUtils.h>
 
 namespace Mesa
 {
+	CameraNull::CameraNull()
+	{
+		UpdateViewMatrix();
+	}
+
+	/*
+		Builds the same matrix as DirectX::XMMatrixPerspectiveFovLH(), fov is in degrees.
+		Element of row r and column c is stored in m_Proj[c][r].
+	*/
+	void CameraNull::SetProjectionValues(float fov, float aspectRatio, float nz, float fz)
+	{
+		float height = 1.0f / std::tan(glm::radians(fov) * 0.5f);
+		float range = fz / (fz - nz);
+
+		m_Proj = glm::mat4x4(0.0f);
+		m_Proj[0][0] = height / aspectRatio;
+		m_Proj[1][1] = height;
+		m_Proj[2][2] = range;
+		m_Proj[2][3] = -range * nz;
+		m_Proj[3][2] = 1.0f;
+	}
+
+	void CameraNull::HandleMovement(CameraMovement direction, float deltaTime)
+	{
+		switch (direction)
+		{
+		case Mesa::CameraMovementForward:
+			AdjustPosition(m_ForwardVec * deltaTime);
+			break;
+		case Mesa::CameraMovementBackward:
+			AdjustPosition(m_BackwardVec * deltaTime);
+			break;
+		case Mesa::CameraMovementLeft:
+			AdjustPosition(m_LeftVec * deltaTime);
+			break;
+		case Mesa::CameraMovementRight:
+			AdjustPosition(m_RightVec * deltaTime);
+			break;
+		default:
+			break;
+		}
+	}
+
+	glm::mat4x4 CameraNull::GetViewProjectionMatrix() const
+	{
+		// Points are row vectors, so view is applied first
+		return m_View * m_Proj;
+	}
+
+	glm::vec3 CameraNull::GetPosition() const
+	{
+		return m_Pos;
+	}
+
+	void CameraNull::SetPosition(const glm::vec3& pos)
+	{
+		m_Pos = pos;
+		UpdateViewMatrix();
+	}
+
+	void CameraNull::AdjustPosition(const glm::vec3& pos)
+	{
+		m_Pos += pos;
+		UpdateViewMatrix();
+	}
+
+	void CameraNull::SetRotation(const glm::vec3& rot)
+	{
+		m_Rot = rot;
+		UpdateViewMatrix();
+	}
+
+	void CameraNull::AdjustRotation(const glm::vec3& rot)
+	{
+		m_Rot += rot;
+		UpdateViewMatrix();
+	}
+
+	/*
+		Rotates the camera towards a point like CameraDx11::SetLookAtPos(),
+		angles come from atan2 so points straight to the side of the camera are handled too.
+	*/
+	void CameraNull::SetLookAtPos(const glm::vec3& lookAtPos)
+	{
+		if (lookAtPos == m_Pos) return;
+
+		glm::vec3 direction = m_Pos - lookAtPos;
+
+		float pitch = std::atan2(direction.y, std::sqrt(direction.x * direction.x + direction.z * direction.z));
+		float yaw = std::atan2(direction.x, direction.z) + glm::pi<float>();
+
+		SetRotation(glm::vec3(pitch, yaw, 0.0f));
+	}
+
+	/*
+		Rotates a vector like a row vector multiplied by DirectX::XMMatrixRotationRollPitchYaw(),
+		roll around Z is applied first, then pitch around X and yaw around Y.
+	*/
+	glm::vec3 CameraNull::RotateRollPitchYaw(const glm::vec3& v, float pitch, float yaw, float roll)
+	{
+		glm::vec3 r = glm::vec3(v.x * std::cos(roll) - v.y * std::sin(roll), v.x * std::sin(roll) + v.y * std::cos(roll), v.z);
+		r = glm::vec3(r.x, r.y * std::cos(pitch) - r.z * std::sin(pitch), r.y * std::sin(pitch) + r.z * std::cos(pitch));
+		return glm::vec3(r.x * std::cos(yaw) + r.z * std::sin(yaw), r.y, r.z * std::cos(yaw) - r.x * std::sin(yaw));
+	}
+
+	/*
+		Builds the same matrix as DirectX::XMMatrixLookToLH(), column c of the matrix
+		holds axis c of the camera and its offset.
+	*/
+	void CameraNull::UpdateViewMatrix()
+	{
+		glm::vec3 forward = glm::normalize(RotateRollPitchYaw(glm::vec3(0.0f, 0.0f, 1.0f), m_Rot.x, m_Rot.y, m_Rot.z));
+		glm::vec3 up = RotateRollPitchYaw(glm::vec3(0.0f, 1.0f, 0.0f), m_Rot.x, m_Rot.y, m_Rot.z);
+		glm::vec3 right = glm::normalize(glm::cross(up, forward));
+		up = glm::cross(forward, right);
+
+		m_View[0] = glm::vec4(right, -glm::dot(right, m_Pos));
+		m_View[1] = glm::vec4(up, -glm::dot(up, m_Pos));
+		m_View[2] = glm::vec4(forward, -glm::dot(forward, m_Pos));
+		m_View[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+		// Movement only follows yaw, like in CameraDx11
+		m_ForwardVec = RotateRollPitchYaw(glm::vec3(0.0f, 0.0f, 1.0f), 0.0f, m_Rot.y, 0.0f);
+		m_BackwardVec = -m_ForwardVec;
+		m_RightVec = RotateRollPitchYaw(glm::vec3(1.0f, 0.0f, 0.0f), 0.0f, m_Rot.y, 0.0f);
+		m_LeftVec = -m_RightVec;
+	}
+
+#ifndef MESA_PORTABLE
 	CameraDx11::CameraDx11()
 	{
 		m_Pos = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
@@ -42,6 +172,16 @@ namespace Mesa
 		}
 	}
 
+	glm::mat4x4 CameraDx11::GetViewProjectionMatrix() const
+	{
+		return ConvertUtils::XmMatrixToMat4x4(DirectX::XMMatrixMultiply(m_View, m_Proj));
+	}
+
+	glm::vec3 CameraDx11::GetPosition() const
+	{
+		return glm::vec3(m_Pos.x, m_Pos.y, m_Pos.z);
+	}
+
 	const DirectX::XMMATRIX& CameraDx11::GetViewMatrix() const
 	{
 		return m_View;
@@ -194,5 +334,5 @@ namespace Mesa
 		m_LeftVec = DirectX::XMVector3TransformCoord(DEFAULT_LEFT_VECTOR, vecRotationMatrix);
 		m_RightVec = DirectX::XMVector3TransformCoord(DEFAULT_RIGHT_VECTOR, vecRotationMatrix);
 	}
-}
-
+#endif
+}
\ No newline at end of file
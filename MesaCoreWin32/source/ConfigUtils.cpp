@@ -1,28 +1,18 @@
 #include <Mesa/ConfigUtils.h>
 #include <Mesa/Exception.h>
 #include <Mesa/ConvertUtils.h>
+#include <Mesa/EngineConfig.h>
 
 namespace Mesa
 {
     /*
        Retrieves a value from the default configuration file ("engine.ini").
+       File is parsed once, values are read from its cached snapshot.
     */
     std::string ConfigUtils::GetValueFromConfig(const std::string& section, const std::string& key)
     {
-        std::string result = std::string();
-
-        // Initialize the handler for the default engine configuration file.
-        mINI::INIFile iniFile("engine.ini");
-        mINI::INIStructure iniStruct;
-
-        // Attempt to parse the file into the internal data structure.
-        if (iniFile.read(iniStruct))
-            result = iniStruct[section][key];
-        else
-            result = "";
-
         // Convert to lowercase to ensure that comparisons (like "true" vs "True") are case-insensitive throughout the engine.
-        return ConvertUtils::ToLowerCase(result);
+        return ConvertUtils::ToLowerCase(EngineConfig::GetSnapshot().GetText(section, key));
     }
 
     /*
@@ -49,18 +39,7 @@ namespace Mesa
     */
     std::string ConfigUtils::GetValueFromConfigCS(const std::string& section, const std::string& key)
     {
-        std::string result = "";
-
-        mINI::INIFile iniFile("engine.ini");
-        mINI::INIStructure iniStruct;
-
-        // Read the file and return the exact string found in the INI.
-        if (iniFile.read(iniStruct))
-        {
-            result = iniStruct[section][key];
-        }
-
-        return result;
+        return EngineConfig::GetSnapshot().GetText(section, key);
     }
 
     /*
@@ -87,39 +66,7 @@ namespace Mesa
     */
     void ConfigUtils::GenerateConfig()
     {
-        mINI::INIStructure iniStruct;
-
-        // --- Debug & Logging Settings ---
-        iniStruct["Debug"]["Log"] = "False";
-        iniStruct["Debug"]["LogPath"] = "";
-        iniStruct["Debug"]["LogType"] = "Truncate";
-        iniStruct["Debug"]["LogName"] = "mesa.log.txt";
-
-        // --- General Engine Settings ---
-        iniStruct["General"]["Api"] = "dx11";
-
-        // --- Window Settings ---
-        iniStruct["Window"]["Width"] = "800";
-        iniStruct["Window"]["Height"] = "600";
-        iniStruct["Window"]["Fullscreen"] = "False";
-
-        // --- DX11 Specific Graphics Settings ---
-        iniStruct["Graphics_Dx11"]["RenderDistance"] = "1000.0f";
-        iniStruct["Graphics_Dx11"]["SamplingMode"] = "Linear";
-        iniStruct["Graphics_Dx11"]["AntiAliasing"] = "Fxaa";
-
-        // --- Resource Paths ---
-        // These define where the engine looks for assets.
-        iniStruct["Path"]["Shader"] = "Asset/Shader/";
-        iniStruct["Path"]["Model"] = "Asset/Model/";
-        iniStruct["Path"]["Texture"] = "Asset/Texture/";
-        iniStruct["Path"]["Material"] = "Asset/Material/";
-
-        // Finalize the file creation.
-        mINI::INIFile iniFile("engine.ini");
-
-        // If the library fails to write to the disk throw exception.
-        if (!iniFile.generate(iniStruct))
-            throw Exception();
+        // Keys and their default values are declared in CONFIG_KEYS
+        EngineConfig::GenerateDefault();
     }
 }
\ No newline at end of file
@@ -1,4 +1,3 @@
-#pragma once
 #include <Mesa/ConvertUtils.h>
 
 namespace Mesa
@@ -76,6 +75,52 @@ namespace Mesa
 		}
 	}
 
+	/*
+		Converts hexadecimal string to unsigned int.
+		If the string cannot be converted returns 0.
+	*/
+	uint32_t ConvertUtils::HexStringToUInt(const std::string& s)
+	{
+		try
+		{
+			return (uint32_t)std::stoul(s, nullptr, 16);
+		}
+		catch (const std::exception&)
+		{
+			return 0;
+		}
+	}
+
+	std::string ConvertUtils::RemoveCharFromString(const std::string& s, char c)
+	{
+		std::string str = s;
+		str.erase(std::remove(str.begin(), str.end(), c), str.end());
+		return str;
+	}
+
+	std::string ConvertUtils::ReplaceCharInString(const std::string& s, char original, char replacement)
+	{
+		std::string result = s;
+		std::replace(result.begin(), result.end(), original, replacement);
+		return result;
+	}
+
+#ifndef MESA_PORTABLE
+	/*
+		Converts wide string into UTF-8 string.
+	*/
+	std::string ConvertUtils::WideStringToString(const std::wstring& s)
+	{
+		if (s.empty()) return std::string();
+
+		int size = WideCharToMultiByte(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0, nullptr, nullptr);
+
+		std::string result(size, '\0');
+		WideCharToMultiByte(CP_UTF8, 0, s.c_str(), (int)s.size(), result.data(), size, nullptr, nullptr);
+
+		return result;
+	}
+
 	/*
 		Converts std::array of 4 floats into XMFLOAT4 structure.
 	*/
@@ -123,29 +168,36 @@ namespace Mesa
 	}
 
 	/*
-		Converts glm::vec3 to XMFLOAT3 structure.
+		Converts XMMATRIX to glm::mat4x4, reverse of Mat4x4ToXmMatrix().
+		Both matrices have the same elements, only their memory order differs.
 	*/
-	DirectX::XMFLOAT3 ConvertUtils::Vec3ToXmFloat3(const glm::vec3& data)
+	glm::mat4x4 ConvertUtils::XmMatrixToMat4x4(const DirectX::XMMATRIX& m)
 	{
-		return DirectX::XMFLOAT3(data.x, data.y, data.z);
-	}
+		DirectX::XMFLOAT4X4 temp;
+		DirectX::XMStoreFloat4x4(&temp, m);
 
-	std::string ConvertUtils::RemoveCharFromString(const std::string& s, char c)
-	{
-		std::string str = s;
-		str.erase(std::remove(str.begin(), str.end(), c), str.end());
-		return str;
+		glm::mat4x4 result;
+
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+				result[column][row] = temp.m[row][column];
+		}
+
+		return result;
 	}
 
-	std::string ConvertUtils::ReplaceCharInString(const std::string& s, char original, char replacement)
+	/*
+		Converts glm::vec3 to XMFLOAT3 structure.
+	*/
+	DirectX::XMFLOAT3 ConvertUtils::Vec3ToXmFloat3(const glm::vec3& data)
 	{
-		std::string result = s;
-		std::replace(result.begin(), result.end(), original, replacement);
-		return result;
+		return DirectX::XMFLOAT3(data.x, data.y, data.z);
 	}
 
 	DirectX::XMFLOAT4 ConvertUtils::Vec4ToXmFloat4(const glm::vec4& data)
 	{
 		return DirectX::XMFLOAT4(data.x, data.y, data.z, data.w);
 	}
+#endif
 }
\ No newline at end of file
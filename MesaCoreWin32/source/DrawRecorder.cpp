@@ -0,0 +1,176 @@
+#include <Mesa/DrawRecorder.h>
+#include <Mesa/JobSystem.h>
+
+namespace Mesa
+{
+	/*
+		Takes aligned slice of constant data of the stream and returns its offset
+	*/
+	static uint32_t AllocateConstants(DrawStream& stream, uint32_t size)
+	{
+		uint32_t offset = (uint32_t)stream.mv_Constants.size();
+		stream.mv_Constants.resize(offset + UploadRing::AlignSize(size));
+
+		return offset;
+	}
+
+	/*
+		Records batches into streams, streams are recorded in parallel when there is more than one
+	*/
+	void DrawRecorder::Record(std::span<const InstanceBatch> batches, const DrawConstantWriters& writers)
+	{
+		m_NumStreams = (batches.size() + BATCHES_PER_STREAM - 1) / BATCHES_PER_STREAM;
+		if (mv_Streams.size() < m_NumStreams) mv_Streams.resize(m_NumStreams);
+
+		auto recordStream = [&](size_t index)
+		{
+			size_t begin = index * BATCHES_PER_STREAM;
+			RecordStream(batches.subspan(begin, std::min(BATCHES_PER_STREAM, batches.size() - begin)), writers, mv_Streams[index]);
+		};
+
+		if (m_NumStreams == 1)
+		{
+			recordStream(0);
+			return;
+		}
+
+		JobSystem::GetDefault().ParallelFor(m_NumStreams, recordStream);
+	}
+
+	/*
+		Records commands of batches with the same state changes as submitting them one by one.
+		MVP constants are written when the object or model changes, since models without
+		constant buffer offsets have their own buffer, and material constants for the first draw of a mesh.
+	*/
+	void DrawRecorder::RecordStream(std::span<const InstanceBatch> batches, const DrawConstantWriters& writers, DrawStream& stream)
+	{
+		stream.mv_Commands.clear();
+		stream.mv_Constants.clear();
+		stream.m_ConstantOffset = 0;
+
+		uint32_t boundShaderId = 0;
+		const GameObject3D* p_BoundObject = nullptr; // Null while MVP constants hold identity model matrix of instanced draws
+		uint32_t boundModelId = 0; // Model of the bound MVP constants, 0 before the first draw
+		uint32_t meshModelId = 0;
+		uint32_t meshIndex = 0;
+
+		for (const auto& batch : batches)
+		{
+			DrawCommand command = {};
+
+			if (batch.m_ShaderId != boundShaderId)
+			{
+				command.m_Type = DrawCommandType_SetShader;
+				command.m_Id = batch.m_ShaderId;
+				stream.mv_Commands.push_back(command);
+
+				boundShaderId = batch.m_ShaderId;
+			}
+
+			const GameObject3D* p_Object = batch.m_IsInstanced ? nullptr : batch.mp_Object;
+
+			if (boundModelId == 0 || p_Object != p_BoundObject || batch.m_ModelId != boundModelId)
+			{
+				command = {};
+				command.m_Type = DrawCommandType_SetMvp;
+				command.m_Id = batch.m_ModelId;
+				command.m_Offset = AllocateConstants(stream, writers.m_MvpSize);
+				writers.m_WriteMvp(p_Object, stream.mv_Constants.data() + command.m_Offset);
+				stream.mv_Commands.push_back(command);
+
+				p_BoundObject = p_Object;
+				boundModelId = batch.m_ModelId;
+			}
+
+			if (meshModelId == 0 || batch.m_ModelId != meshModelId || batch.m_MeshIndex != meshIndex)
+			{
+				command = {};
+				command.m_Type = DrawCommandType_SetMesh;
+				command.m_Id = batch.m_ModelId;
+				command.m_MeshIndex = batch.m_MeshIndex;
+				stream.mv_Commands.push_back(command);
+
+				meshModelId = batch.m_ModelId;
+				meshIndex = batch.m_MeshIndex;
+
+				if (batch.m_MaterialId != 0)
+				{
+					command = {};
+					command.m_Type = DrawCommandType_SetMaterial;
+					command.m_Id = batch.m_MaterialId;
+					command.m_Offset = AllocateConstants(stream, writers.m_MaterialSize);
+
+					// Slice of a material that isn't loaded is given back
+					if (writers.m_WriteMaterial(batch.m_MaterialId, stream.mv_Constants.data() + command.m_Offset))
+						stream.mv_Commands.push_back(command);
+					else
+						stream.mv_Constants.resize(command.m_Offset);
+				}
+			}
+
+			command = {};
+			command.m_Type = batch.m_IsInstanced ? DrawCommandType_DrawInstanced : DrawCommandType_Draw;
+			command.m_FirstInstance = batch.m_FirstInstance;
+			command.m_NumInstances = batch.m_NumInstances;
+			stream.mv_Commands.push_back(command);
+		}
+	}
+
+	/*
+		Counts binds, buffer updates and draws that replaying the stream would submit, without a GPU.
+		Commands of assets that are not loaded are skipped like backends skip them.
+	*/
+	void DrawRecorder::CountStream(const DrawStream& stream, const DrawAssetLookup& assets, DrawStatistics& outStatistics)
+	{
+		bool hasMesh = false;
+		uint32_t numIndices = 0;
+		uint32_t boundTextureId = 0;
+
+		for (const auto& command : stream.mv_Commands)
+		{
+			switch (command.m_Type)
+			{
+			case DrawCommandType_SetShader:
+			{
+				if (assets.m_HasShader(command.m_Id)) outStatistics.m_NumShaderBinds++;
+				break;
+			}
+			case DrawCommandType_SetMvp:
+			{
+				if (assets.m_HasModel(command.m_Id)) outStatistics.m_NumBufferUpdates++;
+				break;
+			}
+			case DrawCommandType_SetMesh:
+			{
+				hasMesh = assets.m_GetMesh(command.m_Id, command.m_MeshIndex, numIndices);
+				break;
+			}
+			case DrawCommandType_SetMaterial:
+			{
+				uint32_t textureId = 0;
+				if (!hasMesh || !assets.m_GetMaterialTexture(command.m_Id, textureId)) break;
+
+				outStatistics.m_NumBufferUpdates++;
+
+				if (textureId != boundTextureId && assets.m_UseTexture(textureId))
+				{
+					outStatistics.m_NumTextureBinds++;
+					boundTextureId = textureId;
+				}
+
+				break;
+			}
+			case DrawCommandType_Draw:
+			case DrawCommandType_DrawInstanced:
+			{
+				if (!hasMesh) break;
+
+				outStatistics.m_NumDrawCalls++;
+				outStatistics.m_NumIndices += (uint64_t)numIndices * command.m_NumInstances;
+				if (command.m_Type == DrawCommandType_DrawInstanced) outStatistics.m_NumInstances += command.m_NumInstances;
+				break;
+			}
+			}
+		}
+	}
+}
\ No newline at end of file
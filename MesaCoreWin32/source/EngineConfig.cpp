@@ -0,0 +1,143 @@
+#include <Mesa/EngineConfig.h>
+#include <Mesa/ConvertUtils.h>
+#include <Mesa/Exception.h>
+
+namespace Mesa
+{
+	// Snapshot that readers currently see
+	static std::atomic<const ConfigSnapshot*> sp_CurrentSnapshot = nullptr;
+	// Every snapshot that was published, kept alive so references to their values stay valid
+	static std::vector<std::unique_ptr<const ConfigSnapshot>> sv_Snapshots;
+	static std::mutex s_ReloadMutex;
+
+	/*
+		Skips whitespace and plus sign that std::from_chars doesn't accept
+	*/
+	static std::string_view TrimNumber(std::string_view text)
+	{
+		while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '+'))
+			text.remove_prefix(1);
+
+		return text;
+	}
+
+	/*
+		Converts text into value of specified type. Returns false if the text isn't a valid value.
+		Numbers may be followed by other characters (e.g. "1000.0f").
+	*/
+	static bool ParseValue(ConfigValueType type, std::string_view text, int32_t& outInt, float& outFloat, bool& outBool)
+	{
+		text = TrimNumber(text);
+
+		switch (type)
+		{
+		case ConfigValueType_Int:
+			return std::from_chars(text.data(), text.data() + text.size(), outInt).ec == std::errc();
+		case ConfigValueType_Float:
+			return std::from_chars(text.data(), text.data() + text.size(), outFloat).ec == std::errc();
+		case ConfigValueType_Bool:
+			outBool = ConvertUtils::ToLowerCase(std::string(text)) == "true";
+			return true;
+		default:
+			return true;
+		}
+	}
+
+	/*
+		Returns key of a value in the flattened file
+	*/
+	static std::string MakeTextKey(const std::string& section, const std::string& key)
+	{
+		return ConvertUtils::ToLowerCase(section) + '\n' + ConvertUtils::ToLowerCase(key);
+	}
+
+	/*
+		Constructor: Converts values of all declared keys to their types.
+		Missing keys and values that can't be converted use their defaults.
+	*/
+	ConfigSnapshot::ConfigSnapshot(const mINI::INIStructure& iniStruct, uint64_t version)
+		: m_Version(version)
+	{
+		for (const auto& [section, values] : iniStruct)
+		{
+			for (const auto& [key, value] : values)
+				m_Text[MakeTextKey(section, key)] = value;
+		}
+
+		for (const auto& info : CONFIG_KEYS)
+		{
+			ConfigValue& value = ma_Values[info.m_Id];
+			std::string textKey = MakeTextKey(std::string(info.m_Section), std::string(info.m_Key));
+
+			auto it = m_Text.find(textKey);
+			if (it == m_Text.end()) it = m_Text.emplace(textKey, std::string(info.m_Default)).first;
+
+			if (!ParseValue(info.m_Type, it->second, value.m_Int, value.m_Float, value.m_Bool))
+			{
+				LOG_F(WARNING, "Invalid value of %s in [%s], using default %s", std::string(info.m_Key).c_str(), std::string(info.m_Section).c_str(), std::string(info.m_Default).c_str());
+				ParseValue(info.m_Type, info.m_Default, value.m_Int, value.m_Float, value.m_Bool);
+			}
+
+			value.m_Text = info.m_Type == ConfigValueType_Path ? it->second : ConvertUtils::ToLowerCase(it->second);
+		}
+	}
+
+	/*
+		Returns value of any key as it's written in the file, or the default of a declared key that is missing.
+		Returns empty string if the key doesn't exist.
+	*/
+	std::string ConfigSnapshot::GetText(const std::string& section, const std::string& key) const
+	{
+		auto it = m_Text.find(MakeTextKey(section, key));
+		return it != m_Text.end() ? it->second : std::string();
+	}
+
+	/*
+		Returns the current snapshot, the file is parsed on first use
+	*/
+	const ConfigSnapshot& EngineConfig::GetSnapshot()
+	{
+		const ConfigSnapshot* p_Snapshot = sp_CurrentSnapshot.load(std::memory_order_acquire);
+		if (p_Snapshot) return *p_Snapshot;
+
+		Reload();
+		return *sp_CurrentSnapshot.load(std::memory_order_acquire);
+	}
+
+	/*
+		Parses engine.ini again and publishes new snapshot.
+		Readers keep using the previous snapshot until the swap.
+	*/
+	void EngineConfig::Reload()
+	{
+		mINI::INIFile iniFile("engine.ini");
+		mINI::INIStructure iniStruct;
+
+		if (!iniFile.read(iniStruct))
+			LOG_F(WARNING, "Could not read engine.ini, using default configuration");
+
+		std::lock_guard<std::mutex> lock(s_ReloadMutex);
+
+		sv_Snapshots.push_back(std::make_unique<const ConfigSnapshot>(iniStruct, sv_Snapshots.size() + 1));
+		sp_CurrentSnapshot.store(sv_Snapshots.back().get(), std::memory_order_release);
+	}
+
+	/*
+		Writes engine.ini with default values of all declared keys and loads it
+	*/
+	void EngineConfig::GenerateDefault()
+	{
+		mINI::INIStructure iniStruct;
+
+		for (const auto& info : CONFIG_KEYS)
+			iniStruct[std::string(info.m_Section)][std::string(info.m_Key)] = std::string(info.m_Default);
+
+		mINI::INIFile iniFile("engine.ini");
+
+		// If the library fails to write to the disk throw exception.
+		if (!iniFile.generate(iniStruct))
+			throw Exception();
+
+		Reload();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include <Mesa/FileWatcher.h>
+#include <Mesa/FileUtils.h>
+#include <Mesa/ConvertUtils.h>
+
+namespace Mesa
+{
+	// Size of the buffer that receives notifications of a single directory
+	static constexpr size_t NOTIFY_BUFFER_SIZE = 64 * 1024;
+
+	/*
+		Constructor: Opens specified directories and starts watching them.
+		Paths that aren't directories are watched as single files through their parent directory.
+		Paths that can't be opened are skipped.
+	*/
+	FileWatcher::FileWatcher(const std::vector<std::string>& v_Paths, uint32_t settleTime)
+		: m_SettleTime(settleTime)
+	{
+		mp_StopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+		for (const auto& watchedPath : v_Paths)
+		{
+			auto p_Directory = std::make_unique<WatchedDirectory>();
+			p_Directory->m_Path = watchedPath;
+			p_Directory->mv_Buffer.resize(NOTIFY_BUFFER_SIZE / sizeof(DWORD));
+
+			std::string path = watchedPath;
+
+			std::error_code error;
+			if (!std::filesystem::is_directory(watchedPath, error))
+			{
+				std::filesystem::path filePath(watchedPath);
+				path = filePath.has_parent_path() ? filePath.parent_path().string() : ".";
+				p_Directory->m_FileName = filePath.filename().string();
+			}
+
+			p_Directory->m_Handle = CreateFile(ConvertUtils::StringToWideString(path).c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+				nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+			if (p_Directory->m_Handle == INVALID_HANDLE_VALUE)
+			{
+				LOG_F(WARNING, "Could not watch directory %s", path.c_str());
+				continue;
+			}
+
+			p_Directory->m_Overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+			if (!BeginRead(*p_Directory))
+			{
+				LOG_F(WARNING, "Could not watch directory %s", path.c_str());
+				CloseHandle(p_Directory->m_Overlapped.hEvent);
+				CloseHandle(p_Directory->m_Handle);
+				continue;
+			}
+
+			mv_Directories.push_back(std::move(p_Directory));
+		}
+
+		m_Thread = std::thread(&FileWatcher::WatchLoop, this);
+
+		LOG_F(INFO, "Watching %zu directories for changes", mv_Directories.size());
+	}
+
+	/*
+		Destructor: Stops watching and closes all directories.
+	*/
+	FileWatcher::~FileWatcher()
+	{
+		SetEvent(mp_StopEvent);
+
+		if (m_Thread.joinable())
+			m_Thread.join();
+
+		for (auto& p_Directory : mv_Directories)
+		{
+			// Pending read has to finish before its buffer is freed
+			if (p_Directory->m_Pending)
+			{
+				CancelIoEx(p_Directory->m_Handle, &p_Directory->m_Overlapped);
+
+				DWORD numBytes = 0;
+				GetOverlappedResult(p_Directory->m_Handle, &p_Directory->m_Overlapped, &numBytes, TRUE);
+			}
+
+			CloseHandle(p_Directory->m_Overlapped.hEvent);
+			CloseHandle(p_Directory->m_Handle);
+		}
+
+		CloseHandle(mp_StopEvent);
+	}
+
+	/*
+		Returns paths of files that changed and stayed unchanged for the settle time since they were last reported.
+		Paths are made by combining the watched directory with the name of the file.
+	*/
+	std::vector<std::string> FileWatcher::PollChanges()
+	{
+		std::vector<std::string> v_Result;
+		auto now = std::chrono::steady_clock::now();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		for (auto it = m_Changes.begin(); it != m_Changes.end();)
+		{
+			if (now - it->second < std::chrono::milliseconds(m_SettleTime))
+			{
+				// Until every file settles none is reported, files of one repack usually belong together
+				v_Result.clear();
+				return v_Result;
+			}
+
+			v_Result.push_back(it->first);
+			it++;
+		}
+
+		m_Changes.clear();
+		return v_Result;
+	}
+
+	/*
+		Starts waiting for changes in the directory.
+	*/
+	bool FileWatcher::BeginRead(WatchedDirectory& directory)
+	{
+		ResetEvent(directory.m_Overlapped.hEvent);
+
+		DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+
+		directory.m_Pending = ReadDirectoryChangesW(directory.m_Handle, directory.mv_Buffer.data(), (DWORD)NOTIFY_BUFFER_SIZE, FALSE, filter, nullptr, &directory.m_Overlapped, nullptr) != 0;
+		return directory.m_Pending;
+	}
+
+	/*
+		Records every file mentioned in received notifications.
+	*/
+	void FileWatcher::ReadNotifications(WatchedDirectory& directory, DWORD numBytes)
+	{
+		auto now = std::chrono::steady_clock::now();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Buffer overflowed so it's unknown which files changed, report the whole directory (or the watched file)
+		if (numBytes == 0)
+		{
+			m_Changes[directory.m_Path] = now;
+			return;
+		}
+
+		const uint8_t* p_Data = (const uint8_t*)directory.mv_Buffer.data();
+
+		while (true)
+		{
+			const FILE_NOTIFY_INFORMATION* p_Info = (const FILE_NOTIFY_INFORMATION*)p_Data;
+
+			std::string fileName = ConvertUtils::WideStringToString(std::wstring(p_Info->FileName, p_Info->FileNameLength / sizeof(WCHAR)));
+
+			if (directory.m_FileName.empty())
+				m_Changes[FileUtils::CombinePaths(directory.m_Path, fileName)] = now;
+			else if (_stricmp(fileName.c_str(), directory.m_FileName.c_str()) == 0)
+				m_Changes[directory.m_Path] = now;
+
+			if (p_Info->NextEntryOffset == 0) break;
+			p_Data += p_Info->NextEntryOffset;
+		}
+	}
+
+	/*
+		Waits for notifications from all directories until the watcher is destroyed.
+	*/
+	void FileWatcher::WatchLoop()
+	{
+		std::vector<HANDLE> v_Events = { mp_StopEvent };
+
+		for (auto& p_Directory : mv_Directories)
+			v_Events.push_back(p_Directory->m_Overlapped.hEvent);
+
+		while (true)
+		{
+			DWORD result = WaitForMultipleObjects((DWORD)v_Events.size(), v_Events.data(), FALSE, INFINITE);
+
+			if (result == WAIT_OBJECT_0 || result == WAIT_FAILED) return;
+
+			WatchedDirectory& directory = *mv_Directories[result - WAIT_OBJECT_0 - 1];
+
+			DWORD numBytes = 0;
+			directory.m_Pending = false;
+
+			if (GetOverlappedResult(directory.m_Handle, &directory.m_Overlapped, &numBytes, FALSE))
+				ReadNotifications(directory, numBytes);
+
+			if (!BeginRead(directory))
+			{
+				LOG_F(ERROR, "Stopped watching %s", directory.m_Path.c_str());
+				ResetEvent(directory.m_Overlapped.hEvent);
+			}
+		}
+	}
+}
\ No newline at end of file
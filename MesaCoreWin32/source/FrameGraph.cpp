@@ -0,0 +1,532 @@
+#include <Mesa/FrameGraph.h>
+
+namespace Mesa
+{
+	static const char* GetStateName(FrameResourceState state)
+	{
+		switch (state)
+		{
+		case FrameResourceState_RenderTarget: return "RenderTarget";
+		case FrameResourceState_ShaderRead: return "ShaderRead";
+		case FrameResourceState_CopySource: return "CopySource";
+		case FrameResourceState_CopyDest: return "CopyDest";
+		case FrameResourceState_Present: return "Present";
+		default: return "Undefined";
+		}
+	}
+
+	/*
+		Adds texture that lives outside of the graph (e.g. back buffer).
+		Imported textures are never aliased and are returned to the specified state after the frame.
+	*/
+	FrameResource FrameGraph::ImportTexture(const std::string& name, const FrameTextureDesc& desc, FrameResourceState state)
+	{
+		Resource resource;
+		resource.m_Name = name;
+		resource.m_Desc = desc;
+		resource.m_IsImported = true;
+		resource.m_ImportedState = state;
+
+		mv_Resources.push_back(resource);
+		return (FrameResource)mv_Resources.size();
+	}
+
+	/*
+		Adds texture that only lives during the frame, its contents are undefined until a pass writes it
+	*/
+	FrameResource FrameGraph::CreateTexture(const std::string& name, const FrameTextureDesc& desc)
+	{
+		Resource resource;
+		resource.m_Name = name;
+		resource.m_Desc = desc;
+
+		mv_Resources.push_back(resource);
+		return (FrameResource)mv_Resources.size();
+	}
+
+	/*
+		Adds pass that reads textures as shader resources and renders into written textures.
+		Passes run in the order they are added.
+	*/
+	void FrameGraph::AddPass(const std::string& name, const std::vector<FrameResource>& v_Reads, const std::vector<FrameResource>& v_Writes, FramePassFunction execute)
+	{
+		Pass pass;
+		pass.m_Name = name;
+		pass.m_Execute = std::move(execute);
+
+		for (FrameResource resource : v_Reads)
+		{
+			if (IsValid(resource)) pass.mv_Reads.push_back(resource);
+			else LOG_F(ERROR, "Pass %s reads invalid resource %u", name.c_str(), resource);
+		}
+
+		mv_Passes.push_back(std::move(pass));
+
+		for (FrameResource resource : v_Writes)
+		{
+			if (AddWrite((uint32_t)mv_Passes.size() - 1, resource))
+				mv_Passes.back().mv_Writes.push_back(resource);
+		}
+	}
+
+	/*
+		Adds copy of the whole source texture into the destination.
+		Copies are run by the backend unless compilation removes them.
+	*/
+	void FrameGraph::AddCopy(const std::string& name, FrameResource source, FrameResource destination)
+	{
+		if (!IsValid(source) || !IsValid(destination) || mv_Resources[source - 1].m_Desc != mv_Resources[destination - 1].m_Desc)
+		{
+			LOG_F(ERROR, "Copy %s needs two valid textures of the same size and format", name.c_str());
+			return;
+		}
+
+		Pass pass;
+		pass.m_Name = name;
+		pass.m_IsCopy = true;
+		pass.mv_Reads.push_back(source);
+
+		mv_Passes.push_back(std::move(pass));
+
+		if (AddWrite((uint32_t)mv_Passes.size() - 1, destination))
+			mv_Passes.back().mv_Writes.push_back(destination);
+	}
+
+	/*
+		Marks texture whose contents have to exist after the frame, passes that don't contribute to any output are culled
+	*/
+	void FrameGraph::MarkOutput(FrameResource resource)
+	{
+		if (IsValid(resource)) mv_Resources[resource - 1].m_IsOutput = true;
+	}
+
+	/*
+		Adds passes of all layers drawn by graphics backends and marks the output as output of the graph.
+		Every layer renders its color and specular pass into its own textures. The first layer becomes
+		the previous layer and following layers are blended with it if blend function is set.
+		Result of the last specular pass or blend is copied into the output.
+		Layers are handed between passes with copies, Compile() rebinds textures instead wherever it can.
+	*/
+	void FrameGraph::AddLayerPasses(FrameResource output, const FrameTextureDesc& desc, uint32_t numLayers, const FrameLayerFunction& draw, const FrameBlendFunction& blend)
+	{
+		FrameResource prevColor = 0;
+		FrameResource prevSpec = 0;
+		FrameResource result = 0;
+
+		for (uint32_t i = 0; i < numLayers; i++)
+		{
+			FrameResource color = CreateTexture("LayerColor", desc);
+			FrameResource spec = CreateTexture("LayerSpecular", desc);
+
+			AddPass("Color", {}, { color }, [draw, i, color](const FrameGraph& graph) { draw(graph, color, i, DrawPass_Color); });
+			AddPass("Specular", {}, { spec }, [draw, i, spec](const FrameGraph& graph) { draw(graph, spec, i, DrawPass_Specular); });
+
+			result = spec;
+
+			if (i == 0)
+			{
+				prevColor = CreateTexture("PrevLayerColor", desc);
+				prevSpec = CreateTexture("PrevLayerSpecular", desc);
+
+				AddCopy("CopyColor", color, prevColor);
+				AddCopy("CopySpecular", spec, prevSpec);
+				continue;
+			}
+
+			if (!blend) continue;
+
+			FrameResource blendedColor = CreateTexture("BlendedColor", desc);
+			FrameResource blendedSpec = CreateTexture("BlendedSpecular", desc);
+
+			AddPass("BlendColor", { color, prevColor }, { blendedColor }, [blend, color, prevColor, blendedColor](const FrameGraph& graph) { blend(graph, blendedColor, color, prevColor); });
+			AddPass("BlendSpecular", { spec, prevSpec }, { blendedSpec }, [blend, spec, prevSpec, blendedSpec](const FrameGraph& graph) { blend(graph, blendedSpec, spec, prevSpec); });
+
+			prevColor = CreateTexture("PrevLayerColor", desc);
+			prevSpec = CreateTexture("PrevLayerSpecular", desc);
+
+			AddCopy("CopyBlendedColor", blendedColor, prevColor);
+			AddCopy("CopyBlendedSpecular", blendedSpec, prevSpec);
+
+			result = blendedSpec;
+		}
+
+		if (result != 0) AddCopy("CopyToBackBuffer", result, output);
+		MarkOutput(output);
+	}
+
+	/*
+		Removes all passes and resources, memory is kept for the next frame
+	*/
+	void FrameGraph::Reset()
+	{
+		mv_Resources.clear();
+		mv_Passes.clear();
+		mv_Steps.clear();
+		mv_Textures.clear();
+		mv_FinalBarriers.clear();
+		m_Statistics = FrameGraphStatistics();
+	}
+
+	/*
+		Builds the list of passes to run, physical textures and barriers
+	*/
+	void FrameGraph::Compile()
+	{
+		mv_Steps.clear();
+		mv_Textures.clear();
+		mv_FinalBarriers.clear();
+		m_Statistics = FrameGraphStatistics();
+		m_Statistics.m_NumPasses = (uint32_t)mv_Passes.size();
+
+		for (auto& resource : mv_Resources)
+		{
+			resource.m_Alias = 0;
+			resource.m_FirstStep = NO_STEP;
+			resource.m_LastStep = NO_STEP;
+			resource.m_Texture = NO_TEXTURE;
+		}
+
+		for (auto& pass : mv_Passes)
+		{
+			pass.m_IsNeeded = false;
+			pass.m_IsEliminated = false;
+		}
+
+		CullPasses();
+		EliminateCopies();
+
+		for (uint32_t i = 0; i < mv_Passes.size(); i++)
+		{
+			if (!mv_Passes[i].m_IsNeeded || mv_Passes[i].m_IsEliminated) continue;
+
+			Step step;
+			step.m_Pass = i;
+			mv_Steps.push_back(std::move(step));
+		}
+
+		AssignTextures();
+		PlaceBarriers();
+	}
+
+	/*
+		Runs compiled passes in order. Barriers of a pass are reported before the pass runs,
+		copies that weren't eliminated are run by the copy function with physical textures.
+	*/
+	void FrameGraph::Execute(const FrameBarrierFunction& barrier, const FrameCopyFunction& copy) const
+	{
+		for (const auto& step : mv_Steps)
+		{
+			for (const auto& b : step.mv_Barriers)
+				barrier(b);
+
+			const Pass& pass = mv_Passes[step.m_Pass];
+
+			if (pass.m_IsCopy)
+				copy(GetTexture(pass.mv_Reads[0]), GetTexture(pass.mv_Writes[0]));
+			else if (pass.m_Execute)
+				pass.m_Execute(*this);
+		}
+
+		for (const auto& b : mv_FinalBarriers)
+			barrier(b);
+	}
+
+	/*
+		Returns physical texture that holds the resource, or NO_TEXTURE if no compiled pass uses it
+	*/
+	uint32_t FrameGraph::GetTexture(FrameResource resource) const
+	{
+		if (!IsValid(resource)) return NO_TEXTURE;
+		return mv_Resources[Resolve(resource) - 1].m_Texture;
+	}
+
+	/*
+		Returns compiled graph in CSV format.
+		Every line holds: step, pass name, physical textures it reads and writes separated with ';' and
+		its barriers as texture:before>after.
+	*/
+	std::string FrameGraph::Dump() const
+	{
+		std::ostringstream oss;
+		oss << "step,name,reads,writes,barriers\n";
+
+		auto writeTextures = [this, &oss](const std::vector<FrameResource>& v_Resources)
+		{
+			for (size_t i = 0; i < v_Resources.size(); i++)
+				oss << (i > 0 ? ";" : "") << GetTexture(v_Resources[i]);
+		};
+
+		for (size_t i = 0; i < mv_Steps.size(); i++)
+		{
+			const Pass& pass = mv_Passes[mv_Steps[i].m_Pass];
+
+			oss << i << ',' << pass.m_Name << ',';
+			writeTextures(pass.mv_Reads);
+			oss << ',';
+			writeTextures(pass.mv_Writes);
+			oss << ',';
+
+			for (size_t j = 0; j < mv_Steps[i].mv_Barriers.size(); j++)
+			{
+				const FrameBarrier& b = mv_Steps[i].mv_Barriers[j];
+				oss << (j > 0 ? ";" : "") << b.m_Texture << ':' << GetStateName(b.m_Before) << '>' << GetStateName(b.m_After);
+			}
+
+			oss << '\n';
+		}
+
+		return oss.str();
+	}
+
+	bool FrameGraph::IsValid(FrameResource resource) const
+	{
+		return resource != 0 && resource <= mv_Resources.size();
+	}
+
+	/*
+		Follows aliases created by copy elimination to the resource that holds the contents
+	*/
+	FrameResource FrameGraph::Resolve(FrameResource resource) const
+	{
+		while (mv_Resources[resource - 1].m_Alias != 0)
+			resource = mv_Resources[resource - 1].m_Alias;
+
+		return resource;
+	}
+
+	/*
+		Registers pass as the writer of the resource, every resource can only be written once
+	*/
+	bool FrameGraph::AddWrite(uint32_t pass, FrameResource resource)
+	{
+		if (!IsValid(resource))
+		{
+			LOG_F(ERROR, "Pass %s writes invalid resource %u", mv_Passes[pass].m_Name.c_str(), resource);
+			return false;
+		}
+
+		Resource& target = mv_Resources[resource - 1];
+
+		if (target.m_Writer != NO_PASS)
+		{
+			LOG_F(ERROR, "Pass %s writes %s that is already written by %s", mv_Passes[pass].m_Name.c_str(), target.m_Name.c_str(), mv_Passes[target.m_Writer].m_Name.c_str());
+			return false;
+		}
+
+		target.m_Writer = pass;
+		return true;
+	}
+
+	/*
+		Marks passes that contribute to outputs.
+		Passes are ordered after the passes they read from, so a single backward walk finds all of them.
+	*/
+	void FrameGraph::CullPasses()
+	{
+		std::vector<uint8_t> v_IsLive(mv_Resources.size());
+
+		for (size_t i = 0; i < mv_Resources.size(); i++)
+			v_IsLive[i] = mv_Resources[i].m_IsOutput;
+
+		for (size_t i = mv_Passes.size(); i-- > 0;)
+		{
+			Pass& pass = mv_Passes[i];
+
+			for (FrameResource resource : pass.mv_Writes)
+			{
+				if (v_IsLive[resource - 1]) pass.m_IsNeeded = true;
+			}
+
+			if (!pass.m_IsNeeded)
+			{
+				m_Statistics.m_NumCulledPasses++;
+				continue;
+			}
+
+			for (FrameResource resource : pass.mv_Reads)
+				v_IsLive[resource - 1] = 1;
+		}
+	}
+
+	/*
+		Removes copies whose textures can be rebound instead.
+		Copy into a transient texture is removed by reading the source wherever the destination is read,
+		since the source is never written again. Copy into an imported texture is removed by rendering
+		into the destination directly if the copy is the only reader of the source and nothing reads
+		the destination between the two passes.
+	*/
+	void FrameGraph::EliminateCopies()
+	{
+		for (auto& pass : mv_Passes)
+		{
+			if (!pass.m_IsNeeded || !pass.m_IsCopy) continue;
+
+			FrameResource source = Resolve(pass.mv_Reads[0]);
+			FrameResource destination = pass.mv_Writes[0];
+
+			if (mv_Resources[destination - 1].m_IsImported) continue;
+
+			mv_Resources[destination - 1].m_Alias = source;
+			pass.m_IsEliminated = true;
+			m_Statistics.m_NumEliminatedCopies++;
+		}
+
+		std::vector<uint32_t> v_NumReaders(mv_Resources.size());
+
+		for (const auto& pass : mv_Passes)
+		{
+			if (!pass.m_IsNeeded || pass.m_IsEliminated) continue;
+
+			for (FrameResource resource : pass.mv_Reads)
+				v_NumReaders[Resolve(resource) - 1]++;
+		}
+
+		for (uint32_t i = 0; i < mv_Passes.size(); i++)
+		{
+			Pass& pass = mv_Passes[i];
+			if (!pass.m_IsNeeded || pass.m_IsEliminated || !pass.m_IsCopy) continue;
+
+			FrameResource source = Resolve(pass.mv_Reads[0]);
+			FrameResource destination = pass.mv_Writes[0];
+			const Resource& sourceResource = mv_Resources[source - 1];
+
+			if (sourceResource.m_IsImported || v_NumReaders[source - 1] != 1) continue;
+
+			uint32_t writer = sourceResource.m_Writer;
+			if (writer == NO_PASS || mv_Passes[writer].m_IsCopy) continue;
+
+			// Destination gets its contents at the writer now, so it can't be read from the writer until the copy
+			bool isDestinationRead = false;
+
+			for (uint32_t j = writer; j < i; j++)
+			{
+				if (!mv_Passes[j].m_IsNeeded || mv_Passes[j].m_IsEliminated) continue;
+
+				for (FrameResource resource : mv_Passes[j].mv_Reads)
+				{
+					if (Resolve(resource) == destination) isDestinationRead = true;
+				}
+			}
+
+			if (isDestinationRead) continue;
+
+			mv_Resources[source - 1].m_Alias = destination;
+			pass.m_IsEliminated = true;
+			m_Statistics.m_NumEliminatedCopies++;
+		}
+	}
+
+	/*
+		Finds lifetimes of resources and places them into physical textures.
+		Transient resources are placed in the order of their first use into the first texture
+		of the same size and format that isn't used anymore, imported resources get their own textures.
+	*/
+	void FrameGraph::AssignTextures()
+	{
+		std::vector<FrameResource> v_Used;
+
+		for (uint32_t i = 0; i < mv_Steps.size(); i++)
+		{
+			const Pass& pass = mv_Passes[mv_Steps[i].m_Pass];
+
+			auto use = [this, i, &v_Used](FrameResource resource)
+			{
+				Resource& target = mv_Resources[Resolve(resource) - 1];
+
+				if (target.m_FirstStep == NO_STEP)
+				{
+					target.m_FirstStep = i;
+					v_Used.push_back(Resolve(resource));
+				}
+
+				target.m_LastStep = i;
+			};
+
+			for (FrameResource resource : pass.mv_Reads) use(resource);
+			for (FrameResource resource : pass.mv_Writes) use(resource);
+		}
+
+		for (FrameResource id : v_Used)
+		{
+			Resource& resource = mv_Resources[id - 1];
+
+			if (resource.m_IsImported)
+			{
+				Texture texture;
+				texture.m_Desc = resource.m_Desc;
+				texture.m_Imported = id;
+				texture.m_LastStep = resource.m_LastStep;
+
+				resource.m_Texture = (uint32_t)mv_Textures.size();
+				mv_Textures.push_back(texture);
+				continue;
+			}
+
+			m_Statistics.m_NumTransientResources++;
+
+			for (uint32_t i = 0; i < mv_Textures.size(); i++)
+			{
+				Texture& texture = mv_Textures[i];
+
+				if (texture.m_Imported == 0 && texture.m_Desc == resource.m_Desc && texture.m_LastStep < resource.m_FirstStep)
+				{
+					texture.m_LastStep = resource.m_LastStep;
+					resource.m_Texture = i;
+					break;
+				}
+			}
+
+			if (resource.m_Texture != NO_TEXTURE) continue;
+
+			Texture texture;
+			texture.m_Desc = resource.m_Desc;
+			texture.m_LastStep = resource.m_LastStep;
+
+			resource.m_Texture = (uint32_t)mv_Textures.size();
+			mv_Textures.push_back(texture);
+			m_Statistics.m_NumPhysicalTextures++;
+		}
+	}
+
+	/*
+		Tracks state of every physical texture through the passes and adds a barrier wherever a pass needs another state
+	*/
+	void FrameGraph::PlaceBarriers()
+	{
+		std::vector<FrameResourceState> v_States(mv_Textures.size(), FrameResourceState_Undefined);
+
+		for (size_t i = 0; i < mv_Textures.size(); i++)
+		{
+			if (mv_Textures[i].m_Imported != 0)
+				v_States[i] = mv_Resources[mv_Textures[i].m_Imported - 1].m_ImportedState;
+		}
+
+		for (auto& step : mv_Steps)
+		{
+			const Pass& pass = mv_Passes[step.m_Pass];
+
+			auto transition = [this, &step, &v_States](FrameResource resource, FrameResourceState state)
+			{
+				uint32_t texture = GetTexture(resource);
+				if (v_States[texture] == state) return;
+
+				step.mv_Barriers.push_back({ texture, v_States[texture], state });
+				v_States[texture] = state;
+			};
+
+			for (FrameResource resource : pass.mv_Reads)
+				transition(resource, pass.m_IsCopy ? FrameResourceState_CopySource : FrameResourceState_ShaderRead);
+
+			for (FrameResource resource : pass.mv_Writes)
+				transition(resource, pass.m_IsCopy ? FrameResourceState_CopyDest : FrameResourceState_RenderTarget);
+		}
+
+		for (uint32_t i = 0; i < mv_Textures.size(); i++)
+		{
+			if (mv_Textures[i].m_Imported == 0) continue;
+
+			FrameResourceState state = mv_Resources[mv_Textures[i].m_Imported - 1].m_ImportedState;
+			if (v_States[i] != state) mv_FinalBarriers.push_back({ i, v_States[i], state });
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include <Mesa/FrustumCuller.h>
+
+namespace Mesa
+{
+	/*
+		Extracts frustum planes from view-projection matrix of DirectXMath (points are row vectors
+		and depth of the clip space goes from 0 to w). Column j of the matrix is viewProj[j].
+		Planes are normalized so distances to them can be compared with sphere radii.
+	*/
+	void FrustumCuller::SetViewProjection(const glm::mat4x4& viewProj)
+	{
+		auto combine = [&viewProj](int column, float sign)
+		{
+			glm::vec4 plane;
+			for (int i = 0; i < 4; i++)
+				plane[i] = viewProj[3][i] + sign * viewProj[column][i];
+
+			return plane;
+		};
+
+		ma_Planes[0] = combine(0, 1.0f); // Left
+		ma_Planes[1] = combine(0, -1.0f); // Right
+		ma_Planes[2] = combine(1, 1.0f); // Bottom
+		ma_Planes[3] = combine(1, -1.0f); // Top
+		ma_Planes[4] = viewProj[2]; // Near
+		ma_Planes[5] = combine(2, -1.0f); // Far
+
+		for (auto& plane : ma_Planes)
+		{
+			float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+			if (length <= 0.0f) continue;
+
+			for (int i = 0; i < 4; i++)
+				plane[i] /= length;
+		}
+	}
+
+	/*
+		Tests bounds of every object transformed by its world matrix.
+		Writes 1 for visible and 0 for culled objects into the output, in order of the input.
+	*/
+	void FrustumCuller::Cull(std::span<const glm::mat4x4> worlds, std::span<const BoundingVolume> bounds, std::vector<uint8_t>& v_OutVisible)
+	{
+		size_t count = std::min(worlds.size(), bounds.size());
+		v_OutVisible.resize(count);
+
+		m_Statistics.m_NumTested = count;
+
+		if (count <= BATCH_SIZE)
+		{
+			m_Statistics.m_NumVisible = CullBatch(worlds.data(), bounds.data(), v_OutVisible.data(), count);
+			return;
+		}
+
+		std::atomic<uint64_t> numVisible = 0;
+		size_t numBatches = (count + BATCH_SIZE - 1) / BATCH_SIZE;
+
+		JobSystem::GetDefault().ParallelFor(numBatches, [&](size_t batch)
+		{
+			size_t begin = batch * BATCH_SIZE;
+			size_t batchCount = std::min(BATCH_SIZE, count - begin);
+
+			numVisible += CullBatch(worlds.data() + begin, bounds.data() + begin, v_OutVisible.data() + begin, batchCount);
+		});
+
+		m_Statistics.m_NumVisible = numVisible;
+	}
+
+	/*
+		Tests a single volume that is already in world space
+	*/
+	bool FrustumCuller::IsVisible(const BoundingVolume& worldBounds) const
+	{
+		for (const auto& plane : ma_Planes)
+		{
+			float distance = plane[0] * worldBounds.m_Center.x + plane[1] * worldBounds.m_Center.y + plane[2] * worldBounds.m_Center.z + plane[3];
+			float boxRadius = std::abs(plane[0]) * worldBounds.m_Extents.x + std::abs(plane[1]) * worldBounds.m_Extents.y + std::abs(plane[2]) * worldBounds.m_Extents.z;
+
+			if (distance + std::min(boxRadius, worldBounds.m_Radius) < 0.0f) return false;
+		}
+
+		return true;
+	}
+
+	/*
+		Tests objects in groups of four. Each object is moved to world space with SSE (one column of the
+		world matrix per lane), and the four results are transposed so every plane is tested against
+		all four objects at once. Returns number of visible objects.
+	*/
+	size_t FrustumCuller::CullBatch(const glm::mat4x4* p_Worlds, const BoundingVolume* p_Bounds, uint8_t* p_OutVisible, size_t count) const
+	{
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 zero = _mm_setzero_ps();
+
+		size_t numVisible = 0;
+
+		for (size_t first = 0; first < count; first += 4)
+		{
+			size_t numInGroup = std::min((size_t)4, count - first);
+
+			__m128 a_Centers[4];
+			__m128 a_Extents[4];
+			alignas(16) std::array<float, 4> a_Radii;
+
+			for (size_t lane = 0; lane < 4; lane++)
+			{
+				// Last group is padded with copies of its last object
+				size_t i = first + std::min(lane, numInGroup - 1);
+
+				const float* p_World = &p_Worlds[i][0][0];
+				const BoundingVolume& local = p_Bounds[i];
+
+				__m128 column0 = _mm_loadu_ps(p_World);
+				__m128 column1 = _mm_loadu_ps(p_World + 4);
+				__m128 column2 = _mm_loadu_ps(p_World + 8);
+				__m128 column3 = _mm_loadu_ps(p_World + 12);
+
+				__m128 center = _mm_add_ps(column3, _mm_mul_ps(column0, _mm_set1_ps(local.m_Center.x)));
+				center = _mm_add_ps(center, _mm_mul_ps(column1, _mm_set1_ps(local.m_Center.y)));
+				a_Centers[lane] = _mm_add_ps(center, _mm_mul_ps(column2, _mm_set1_ps(local.m_Center.z)));
+
+				__m128 extents = _mm_mul_ps(_mm_andnot_ps(signMask, column0), _mm_set1_ps(local.m_Extents.x));
+				extents = _mm_add_ps(extents, _mm_mul_ps(_mm_andnot_ps(signMask, column1), _mm_set1_ps(local.m_Extents.y)));
+				a_Extents[lane] = _mm_add_ps(extents, _mm_mul_ps(_mm_andnot_ps(signMask, column2), _mm_set1_ps(local.m_Extents.z)));
+
+				float scale0 = p_World[0] * p_World[0] + p_World[1] * p_World[1] + p_World[2] * p_World[2];
+				float scale1 = p_World[4] * p_World[4] + p_World[5] * p_World[5] + p_World[6] * p_World[6];
+				float scale2 = p_World[8] * p_World[8] + p_World[9] * p_World[9] + p_World[10] * p_World[10];
+				a_Radii[lane] = local.m_Radius * std::sqrt(std::max(scale0, std::max(scale1, scale2)));
+			}
+
+			// Rows become x, y, z and w of all four objects
+			_MM_TRANSPOSE4_PS(a_Centers[0], a_Centers[1], a_Centers[2], a_Centers[3]);
+			_MM_TRANSPOSE4_PS(a_Extents[0], a_Extents[1], a_Extents[2], a_Extents[3]);
+			__m128 radii = _mm_load_ps(a_Radii.data());
+
+			__m128 outside = _mm_setzero_ps();
+
+			for (const auto& plane : ma_Planes)
+			{
+				__m128 nx = _mm_set1_ps(plane[0]);
+				__m128 ny = _mm_set1_ps(plane[1]);
+				__m128 nz = _mm_set1_ps(plane[2]);
+
+				__m128 distance = _mm_add_ps(_mm_mul_ps(nx, a_Centers[0]), _mm_set1_ps(plane[3]));
+				distance = _mm_add_ps(distance, _mm_mul_ps(ny, a_Centers[1]));
+				distance = _mm_add_ps(distance, _mm_mul_ps(nz, a_Centers[2]));
+
+				__m128 boxRadius = _mm_mul_ps(_mm_andnot_ps(signMask, nx), a_Extents[0]);
+				boxRadius = _mm_add_ps(boxRadius, _mm_mul_ps(_mm_andnot_ps(signMask, ny), a_Extents[1]));
+				boxRadius = _mm_add_ps(boxRadius, _mm_mul_ps(_mm_andnot_ps(signMask, nz), a_Extents[2]));
+
+				__m128 radius = _mm_min_ps(boxRadius, radii);
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			int outsideMask = _mm_movemask_ps(outside);
+
+			for (size_t lane = 0; lane < numInGroup; lane++)
+			{
+				uint8_t visible = ((outsideMask >> lane) & 1) == 0;
+				p_OutVisible[first + lane] = visible;
+				numVisible += visible;
+			}
+		}
+
+		return numVisible;
+	}
+}
\ No newline at end of file
@@ -21,5 +21,7 @@ namespace Mesa
 		m_WorldMatrix = glm::translate(m_WorldMatrix, m_Position);
 
 		m_WorldMatrix = glm::scale(m_WorldMatrix, m_Scale);
+
+		m_Version++;
 	}
 }
\ No newline at end of file
@@ -2,7 +2,102 @@
 
 namespace Mesa
 {
+	/*
+		Computes bounds of points. Positions are read as three floats every stride bytes,
+		so they can be read straight from vertex arrays.
+		Sphere is centered on the box and its radius is distance to the farthest point.
+	*/
+	BoundingVolume BoundingVolume::FromPoints(const float* p_Positions, size_t count, size_t stride)
+	{
+		BoundingVolume volume;
+		if (p_Positions == nullptr || count == 0) return volume;
 
-}
+		auto getPoint = [p_Positions, stride](size_t i) { return (const float*)((const uint8_t*)p_Positions + i * stride); };
 
+		float a_Min[3] = { getPoint(0)[0], getPoint(0)[1], getPoint(0)[2] };
+		float a_Max[3] = { a_Min[0], a_Min[1], a_Min[2] };
 
+		for (size_t i = 1; i < count; i++)
+		{
+			const float* p_Point = getPoint(i);
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				a_Min[axis] = std::min(a_Min[axis], p_Point[axis]);
+				a_Max[axis] = std::max(a_Max[axis], p_Point[axis]);
+			}
+		}
+
+		volume.m_Center = glm::vec3((a_Min[0] + a_Max[0]) * 0.5f, (a_Min[1] + a_Max[1]) * 0.5f, (a_Min[2] + a_Max[2]) * 0.5f);
+		volume.m_Extents = glm::vec3((a_Max[0] - a_Min[0]) * 0.5f, (a_Max[1] - a_Min[1]) * 0.5f, (a_Max[2] - a_Min[2]) * 0.5f);
+
+		float maxDistance = 0.0f;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const float* p_Point = getPoint(i);
+
+			float dx = p_Point[0] - volume.m_Center.x;
+			float dy = p_Point[1] - volume.m_Center.y;
+			float dz = p_Point[2] - volume.m_Center.z;
+
+			maxDistance = std::max(maxDistance, dx * dx + dy * dy + dz * dz);
+		}
+
+		volume.m_Radius = std::sqrt(maxDistance);
+
+		return volume;
+	}
+
+	/*
+		Returns bounds that contain both volumes
+	*/
+	BoundingVolume BoundingVolume::Merge(const BoundingVolume& a, const BoundingVolume& b)
+	{
+		BoundingVolume volume;
+
+		float a_Min[3], a_Max[3];
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			a_Min[axis] = std::min(a.m_Center[axis] - a.m_Extents[axis], b.m_Center[axis] - b.m_Extents[axis]);
+			a_Max[axis] = std::max(a.m_Center[axis] + a.m_Extents[axis], b.m_Center[axis] + b.m_Extents[axis]);
+
+			volume.m_Center[axis] = (a_Min[axis] + a_Max[axis]) * 0.5f;
+			volume.m_Extents[axis] = (a_Max[axis] - a_Min[axis]) * 0.5f;
+		}
+
+		// Sphere around the new center that contains both spheres
+		auto distance = [](const glm::vec3& p, const glm::vec3& q)
+		{
+			return std::sqrt((p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y) + (p.z - q.z) * (p.z - q.z));
+		};
+
+		volume.m_Radius = std::max(distance(volume.m_Center, a.m_Center) + a.m_Radius, distance(volume.m_Center, b.m_Center) + b.m_Radius);
+
+		return volume;
+	}
+
+	/*
+		Returns bounds in the space of the world matrix.
+		Box is the box around the transformed box, and sphere radius is scaled by the largest scale of the matrix.
+	*/
+	BoundingVolume BoundingVolume::Transform(const glm::mat4x4& world) const
+	{
+		BoundingVolume volume;
+		float maxScale = 0.0f;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			volume.m_Center[axis] = world[0][axis] * m_Center.x + world[1][axis] * m_Center.y + world[2][axis] * m_Center.z + world[3][axis];
+			volume.m_Extents[axis] = std::abs(world[0][axis]) * m_Extents.x + std::abs(world[1][axis]) * m_Extents.y + std::abs(world[2][axis]) * m_Extents.z;
+
+			const glm::vec4& column = world[axis];
+			maxScale = std::max(maxScale, column.x * column.x + column.y * column.y + column.z * column.z);
+		}
+
+		volume.m_Radius = m_Radius * std::sqrt(maxScale);
+
+		return volume;
+	}
+}
\ No newline at end of file
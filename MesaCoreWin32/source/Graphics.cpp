@@ -1,4 +1,8 @@
 #include <Mesa/Graphics.h>
+#include <Mesa/EngineConfig.h>
+#include <Mesa/FileUtils.h>
+#include <Mesa/LookUpUtils.h>
+#include <Mesa/PackUtils.h>
 
 namespace Mesa
 {
@@ -12,4 +16,33 @@ namespace Mesa
 
 	}
 
+	/*
+		Reads single asset from its pack.
+		Asset type is the name of the key in [Path] section of config that holds directory of the pack.
+		Returns empty blob if the asset could not be read.
+	*/
+	AssetBlob Graphics::ReadAssetFromPack(const std::string& assetType, const std::string& originalName)
+	{
+		// Use lookup table to find in which pack the asset is contained in
+		// and what index it has
+		auto packName = LookUpUtils::FindFilePack(originalName);
+		auto packIndex = LookUpUtils::FindFileIndex(originalName);
+
+		// Validate lookup results
+		if (packName.empty() || !packIndex.has_value())
+		{
+			LOG_F(ERROR, "Could not find %s in lookup table!", originalName.c_str());
+			return AssetBlob();
+		}
+
+		// Read only the asset data from its pack
+		std::string packPath = FileUtils::CombinePaths(EngineConfig::GetSnapshot().GetText("Path", assetType), packName);
+		AssetBlob data = AssetBlob::FromVector(PackUtils::ReadEntry(packPath, packIndex.value()));
+
+		if (data.IsEmpty())
+			LOG_F(ERROR, "Could not read %s from %s", originalName.c_str(), packPath.c_str());
+
+		return data;
+	}
+
 }
\ No newline at end of file
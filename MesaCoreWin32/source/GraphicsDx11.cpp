@@ -1,12 +1,21 @@
 #include <Mesa/Graphics.h>
-#include <Mesa/ConfigUtils.h>
+#include <Mesa/EngineConfig.h>
 #include <Mesa/FileUtils.h>
 #include <Mesa/LookUpUtils.h>
+#include <Mesa/PackUtils.h>
+#include <Mesa/JobSystem.h>
 #include <Mesa/ConstBuffer.h>
 #include <Mesa/ConvertUtils.h>
+#include <Mesa/AsyncFileReader.h>
+#include <Mesa/AssetCache.h>
+#include <Mesa/StreamingPipeline.h>
 
 namespace Mesa
 {
+    // Versions of processed data kept in asset cache, have to be increased whenever decoding or importing changes its output
+    static constexpr uint32_t TEXTURE_CACHE_VERSION = 1;
+    static constexpr uint32_t MODEL_CACHE_VERSION = 1;
+
     /*
        Constructor: Initializes a DirectX exception.
     */
@@ -78,17 +87,17 @@ namespace Mesa
         // Configure blend state
         InitializeBlendState();
         LOG_F(INFO, "Blend state initialized");
-
-        // Create renderpass buffers
-        std::thread colorPassBuf(GraphicsDx11::CreateCriticalTexture, p_Window->GetWindowWidth(), p_Window->GetWindowHeight(), DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE, this, mp_LayerColorBuffer.GetAddressOf(), mp_ColorResourceView.GetAddressOf());
-        std::thread prevColorPassBuf(GraphicsDx11::CreateCriticalTexture, p_Window->GetWindowWidth(), p_Window->GetWindowHeight(), DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE, this, mp_PrevLayerColorBuffer.GetAddressOf(), mp_PrevColorResourceView.GetAddressOf());
-        std::thread specPassBuf(GraphicsDx11::CreateCriticalTexture, p_Window->GetWindowWidth(), p_Window->GetWindowHeight(), DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE, this, mp_LayerSpecBuffer.GetAddressOf(), mp_SpecResourceView.GetAddressOf());
-        std::thread prevSpecPassBuf(GraphicsDx11::CreateCriticalTexture, p_Window->GetWindowWidth(), p_Window->GetWindowHeight(), DXGI_FORMAT_R8G8B8A8_UNORM, D3D11_BIND_SHADER_RESOURCE, this, mp_PrevLayerSpecBuffer.GetAddressOf(), mp_PrevSpecResourceView.GetAddressOf());
-    
-        colorPassBuf.join();
-        prevColorPassBuf.join();
-        specPassBuf.join();
-        prevSpecPassBuf.join();
+        // Create ring buffer for constants of draws
+        InitializeUploadRing();
+        LOG_F(INFO, "Upload ring initialized");
+        // Create contexts that record draws on workers
+        InitializeDeferredContexts();
+        // Read upload and memory budgets
+        ReadStreamingSettings();
+        // Start watching packs for changes if enabled
+        InitializeHotReload();
+
+        // Layer textures are created by the frame graph once it knows how many it needs
 
         InitializeBlendingMesh();
     }
@@ -135,69 +144,137 @@ namespace Mesa
         // Configure blend state
         InitializeBlendState();
         LOG_F(INFO, "Blend state initialized");
+        // Create ring buffer for constants of draws
+        InitializeUploadRing();
+        LOG_F(INFO, "Upload ring initialized");
+        // Create contexts that record draws on workers
+        InitializeDeferredContexts();
+        // Read upload and memory budgets
+        ReadStreamingSettings();
+        // Start watching packs for changes if enabled
+        InitializeHotReload();
     }
 
     GraphicsDx11::~GraphicsDx11()
     {
+        LogLoadStatistics();
     }
 
     /*
-        Draws a single frame
+        Reads how much time per frame can be spent on finishing asynchronous loads and evicting assets,
+        how much memory loaded assets can take before unused ones are evicted and how packs are streamed
     */
-    void GraphicsDx11::DrawFrame(Window* p_Window)
+    void GraphicsDx11::ReadStreamingSettings()
     {
-        for (int i = 0; i < m_NumLayers; i++)
-        {
-            RenderColorBuffer(i);
-            mp_Context->CopyResource(mp_LayerColorBuffer.Get(), mp_BackBuffer.Get());
-            RenderSpecularBuffer(i);
-            mp_Context->CopyResource(mp_LayerSpecBuffer.Get(), mp_BackBuffer.Get());
-            if (i == 0)
-            {
-                mp_Context->CopyResource(mp_PrevLayerColorBuffer.Get(), mp_LayerColorBuffer.Get());
-                mp_Context->CopyResource(mp_PrevLayerSpecBuffer.Get(), mp_LayerSpecBuffer.Get());
-            }
-            else
-            {
-                BlendLayers();
-            }
-        }
+        const ConfigSnapshot& config = EngineConfig::GetSnapshot();
 
-        mp_SwapChain->Present(0, 0);
+        float uploadBudget = config.Get<ConfigKey_StreamingUploadBudget>();
+        if (uploadBudget > 0.0f) m_UploadBudget = uploadBudget;
+
+        float evictionBudget = config.Get<ConfigKey_StreamingEvictionBudget>();
+        if (evictionBudget > 0.0f) m_EvictionBudget = evictionBudget;
+
+        // Memory budgets are set in megabytes, 0 disables eviction of the category
+        auto toBytes = [](float megabytes) { return (uint64_t)(std::max(megabytes, 0.0f) * 1024.0 * 1024.0); };
+
+        m_Textures.SetBudget(toBytes(config.Get<ConfigKey_StreamingTextureBudget>()));
+        m_Models.SetBudget(toBytes(config.Get<ConfigKey_StreamingModelBudget>()));
+        m_Materials.SetBudget(toBytes(config.Get<ConfigKey_StreamingMaterialBudget>()));
+
+        // Pipelines that stream whole packs
+        uint64_t pipelineMemory = toBytes(config.Get<ConfigKey_StreamingPipelineMemory>());
+        if (pipelineMemory > 0) m_PipelineSettings.m_MaxBytesInFlight = pipelineMemory;
+
+        auto toWorkers = [](int32_t value, uint32_t defaultValue) { return value > 0 ? (uint32_t)value : defaultValue; };
+
+        m_PipelineSettings.m_NumReadWorkers = toWorkers(config.Get<ConfigKey_StreamingPipelineReadWorkers>(), m_PipelineSettings.m_NumReadWorkers);
+        m_PipelineSettings.m_NumDecodeWorkers = toWorkers(config.Get<ConfigKey_StreamingPipelineDecodeWorkers>(), std::max(std::thread::hardware_concurrency(), 2u) - 1);
+        m_PipelineSettings.m_NumUploadWorkers = toWorkers(config.Get<ConfigKey_StreamingPipelineUploadWorkers>(), m_PipelineSettings.m_NumUploadWorkers);
     }
 
-    void GraphicsDx11::SetNumberOfLayers(const uint32_t& layers)
+    /*
+        Starts watching asset packs, lookup table and config if HotReload in [Debug] section of config is enabled.
+        Hashes of all pack entries are remembered so only entries that actually changed are reloaded.
+    */
+    void GraphicsDx11::InitializeHotReload()
     {
-        // Validate if the requested number of layers is valid
-        if (layers > 0)
-            m_NumLayers = layers;
-        else // If not set it to minimal valid option
-            m_NumLayers = 1;
+        if (!EngineConfig::Get<ConfigKey_DebugHotReload>()) return;
+
+        for (const auto& entry : LookUpUtils::LoadLookupTable())
+            m_EntryHashes[entry.m_OriginalName] = entry.m_Hash;
+
+        mp_FileWatcher = std::make_unique<FileWatcher>(std::vector<std::string>{
+            EngineConfig::Get<ConfigKey_PathShader>(),
+            EngineConfig::Get<ConfigKey_PathTexture>(),
+            EngineConfig::Get<ConfigKey_PathModel>(),
+            EngineConfig::Get<ConfigKey_PathMaterial>(),
+            "lookup.csv",
+            "engine.ini"
+        });
+
+        LOG_F(INFO, "Hot reload enabled");
     }
 
-    void GraphicsDx11::SetCamera(Camera* p_Camera)
+    /*
+        Draws a single frame
+    */
+    void GraphicsDx11::DrawFrame(Window* p_Window)
     {
-        mp_Camera = (CameraDx11*)p_Camera;
+        // Replace assets whose packs were rebuilt
+        ProcessHotReload();
+
+        // Finish asynchronous loads that wait for the main thread
+        m_UploadQueue.Process(m_UploadBudget);
+
+        // Free memory of assets that haven't been used recently
+        EvictUnusedAssets();
+
+        // Collect draws of all layers and passes and sort them once
+        BuildRenderQueue(mp_Camera);
+
+        // Passes of layers are compiled into the frame graph, which removes unused passes and copies
+        BuildFrameGraph();
+        m_FrameGraph.Compile();
+        CreateFrameTextures();
+
+        // Fence of this frame is reused, so the frame that signaled it last has to be finished
+        ReleaseCompletedFrames(false);
+
+        while (m_UploadRing.GetNumFramesInFlight() > 0 && m_UploadRing.GetOldestFrame() + UploadRing::MAX_FRAMES_IN_FLIGHT <= m_FrameIndex)
+            ReleaseCompletedFrames(true);
+
+        m_UploadRing.BeginFrame(m_FrameIndex);
+
+        m_FrameGraph.Execute([this](const FrameBarrier& barrier) { ApplyFrameBarrier(barrier); },
+            [this](uint32_t source, uint32_t destination) { mp_Context->CopyResource(GetFrameTexture(destination), GetFrameTexture(source)); });
+
+        m_UploadRing.EndFrame();
+
+        // Staging memory is copied when constants are bound, so it can be reused right away
+        if (mp_Context1.Get() != nullptr)
+            mp_Context->End(ma_FrameFences[m_FrameIndex % UploadRing::MAX_FRAMES_IN_FLIGHT].Get());
+        else
+            m_UploadRing.ReleaseFrames(m_FrameIndex);
+
+        mp_SwapChain->Present(0, 0);
+
+        m_FrameIndex++;
     }
 
-    void GraphicsDx11::InsertGameObject(GameObject3D* p_GameObject)
+    void GraphicsDx11::SetCamera(Camera* p_Camera)
     {
-        if (p_GameObject != nullptr)
-            mv_Objects.push_back(p_GameObject);
-        else
-            LOG_F(WARNING, "Nullptr was passed to InsertGameObject function");
+        mp_Camera = (CameraDx11*)p_Camera;
     }
 
     void GraphicsDx11::SetBlendingShader(uint32_t shaderId)
     {
-        for (const auto& shader : mv_Shaders)
+        const ShaderDx11* p_Shader = m_Shaders.Get(shaderId);
+
+        if (p_Shader != nullptr)
         {
-            if (shader.GetShaderUID() == shaderId)
-            {
-                LOG_F(INFO, "Blending shader set to %s", shader.GetVertexShaderName().c_str());
-                m_BlendingShaderId = shaderId;
-                return;
-            }
+            LOG_F(INFO, "Blending shader set to %s", p_Shader->GetVertexShaderName().c_str());
+            m_BlendingShaderId = shaderId;
+            return;
         }
 
         LOG_F(WARNING, "Couldn't find shader with ID = %u! Blending shader unchanged!", shaderId);
@@ -208,68 +285,43 @@ namespace Mesa
     */
     std::map<std::string, uint32_t> GraphicsDx11::CompileForwardShaderPack(const std::string& packPath)
     {
-        std::string shaderDir = ConfigUtils::GetValueFromConfigCS("Path", "Shader");
+        std::string shaderDir = EngineConfig::Get<ConfigKey_PathShader>();
 
         std::string relativePackPath = FileUtils::CombinePaths(shaderDir, packPath);
 
-        // Read the contents of the pack
-        std::vector<uint8_t> v_PackData = FileUtils::ReadBinaryData(relativePackPath);
-        if (v_PackData.empty()) return std::map<std::string, uint32_t>();
+        // Map the pack, entries are handed to the compilers without being copied
+        AssetBlob pack = AssetBlob::MapFile(relativePackPath);
+        auto v_Locations = PackUtils::ParsePackHeader(pack);
+        if (v_Locations.empty()) return std::map<std::string, uint32_t>();
 
         // Search the lookup table for files in this pack
         auto v_entries = LookUpUtils::LoadSpecificPackInfo(packPath);
 
-        // Calculate number of files in pack
-        uint32_t numFilesInPack = 0;
-        memcpy(&numFilesInPack, &v_PackData[0], sizeof(uint32_t));
-        
-        // Validate calculated number of files
-        if(numFilesInPack <= 0) return std::map<std::string, uint32_t>();
-        if(numFilesInPack != v_entries.size()) return std::map<std::string, uint32_t>();
-
-        // Calculate all starting positions for each file
-        std::vector<uint64_t> v_startingPositions;
-
-        for (int i = 0; i < numFilesInPack; i++)
-        {
-            uint32_t headerPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * i;
-
-            uint64_t startPos = 0;
-            memcpy(&startPos, &v_PackData[headerPos], sizeof(uint64_t));
-
-            v_startingPositions.push_back(startPos-1);
-        }
+        // Validate number of files
+        if (v_Locations.size() != v_entries.size()) return std::map<std::string, uint32_t>();
 
         // Validate that every vertex shader has its pixel shader
-        if(v_entries.size() % 2 != 0) return std::map<std::string, uint32_t>();
+        if (v_entries.size() % 2 != 0) return std::map<std::string, uint32_t>();
 
-        std::vector<std::thread> v_CompilationThreads;
+        JobCounter counter;
 
-        for (int i =0;i < v_entries.size(); i += 2)
+        for (int i = 0; i < v_entries.size(); i += 2)
         {
-            // Load vertex shader data
-            std::vector<uint8_t> v_VertBuffer;
-            v_VertBuffer.resize(v_entries[i].m_Size);
+            if (v_entries[i].m_Index >= v_Locations.size() || v_entries[i + 1].m_Index >= v_Locations.size()) continue;
 
-            uint64_t startPos = v_startingPositions[v_entries[i].m_Index];
-            memcpy(&v_VertBuffer[0], &v_PackData[startPos], v_entries[i].m_Size);
+            // Vertex and pixel shader data share the mapping of the pack
+            AssetBlob vertexData = PackUtils::ExtractEntry(pack, v_Locations[v_entries[i].m_Index]);
+            AssetBlob pixelData = PackUtils::ExtractEntry(pack, v_Locations[v_entries[i + 1].m_Index]);
 
-            // Load pixel shader data
-            std::vector<uint8_t> v_PixlBuffer;
-            v_PixlBuffer.resize(v_entries[i + 1].m_Size);
-
-            startPos = v_startingPositions[v_entries[i+1].m_Index];
-            memcpy(&v_PixlBuffer[0], &v_PackData[startPos], v_entries[i+1].m_Size);
-
-            // Begin compiling shaders on another thread
-            v_CompilationThreads.push_back(std::thread(GraphicsDx11::CompileShader, v_VertBuffer, v_PixlBuffer, ShaderType_Forward, this, v_entries[i].m_OriginalName, v_entries[i+1].m_OriginalName));
+            // Begin compiling shaders on one of the job system workers
+            JobSystem::GetDefault().Run([this, vertexData, pixelData, vertexName = v_entries[i].m_OriginalName, pixelName = v_entries[i + 1].m_OriginalName]()
+            {
+                GraphicsDx11::CompileShader(vertexData, pixelData, ShaderType_Forward, this, vertexName, pixelName);
+            }, &counter);
         }
 
-        // Join all compilation threads
-        for (auto& compThread : v_CompilationThreads)
-        {
-            compThread.join();
-        }
+        // Wait for all shaders to be compiled
+        JobSystem::GetDefault().Wait(counter);
 
         std::map<std::string, uint32_t> result;
 
@@ -287,68 +339,43 @@ namespace Mesa
     */
     std::map<std::string, uint32_t> GraphicsDx11::CompileDeferredShaderPack(const std::string& packPath)
     {
-        std::string shaderDir = ConfigUtils::GetValueFromConfigCS("Path", "Shader");
+        std::string shaderDir = EngineConfig::Get<ConfigKey_PathShader>();
 
         std::string relativePackPath = FileUtils::CombinePaths(shaderDir, packPath);
 
-        // Read the contents of the pack
-        std::vector<uint8_t> v_PackData = FileUtils::ReadBinaryData(relativePackPath);
-        if (v_PackData.empty()) return std::map<std::string, uint32_t>();
+        // Map the pack, entries are handed to the compilers without being copied
+        AssetBlob pack = AssetBlob::MapFile(relativePackPath);
+        auto v_Locations = PackUtils::ParsePackHeader(pack);
+        if (v_Locations.empty()) return std::map<std::string, uint32_t>();
 
         // Search the lookup table for files in this pack
         auto v_entries = LookUpUtils::LoadSpecificPackInfo(packPath);
 
-        // Calculate number of files in pack
-        uint32_t numFilesInPack = 0;
-        memcpy(&numFilesInPack, &v_PackData[0], sizeof(uint32_t));
-
-        // Validate calculated number of files
-        if (numFilesInPack <= 0) return std::map<std::string, uint32_t>();
-        if (numFilesInPack != v_entries.size()) return std::map<std::string, uint32_t>();
-
-        // Calculate all starting positions for each file
-        std::vector<uint64_t> v_startingPositions;
-
-        for (int i = 0; i < numFilesInPack; i++)
-        {
-            uint32_t headerPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * i;
-
-            uint64_t startPos = 0;
-            memcpy(&startPos, &v_PackData[headerPos], sizeof(uint64_t));
-
-            v_startingPositions.push_back(startPos - 1);
-        }
+        // Validate number of files
+        if (v_Locations.size() != v_entries.size()) return std::map<std::string, uint32_t>();
 
         // Validate that every vertex shader has its pixel shader
         if (v_entries.size() % 2 != 0) return std::map<std::string, uint32_t>();
 
-        std::vector<std::thread> v_CompilationThreads;
+        JobCounter counter;
 
         for (int i = 0; i < v_entries.size(); i += 2)
         {
-            // Load vertex shader data
-            std::vector<uint8_t> v_VertBuffer;
-            v_VertBuffer.resize(v_entries[i].m_Size);
+            if (v_entries[i].m_Index >= v_Locations.size() || v_entries[i + 1].m_Index >= v_Locations.size()) continue;
 
-            uint64_t startPos = v_startingPositions[v_entries[i].m_Index];
-            memcpy(&v_VertBuffer[0], &v_PackData[startPos], v_entries[i].m_Size);
+            // Vertex and pixel shader data share the mapping of the pack
+            AssetBlob vertexData = PackUtils::ExtractEntry(pack, v_Locations[v_entries[i].m_Index]);
+            AssetBlob pixelData = PackUtils::ExtractEntry(pack, v_Locations[v_entries[i + 1].m_Index]);
 
-            // Load pixel shader data
-            std::vector<uint8_t> v_PixlBuffer;
-            v_PixlBuffer.resize(v_entries[i + 1].m_Size);
-
-            startPos = v_startingPositions[v_entries[i + 1].m_Index];
-            memcpy(&v_PixlBuffer[0], &v_PackData[startPos], v_entries[i + 1].m_Size);
-
-            // Begin compiling shaders on another thread
-            v_CompilationThreads.push_back(std::thread(GraphicsDx11::CompileShader, v_VertBuffer, v_PixlBuffer, ShaderType_Deferred, this, v_entries[i].m_OriginalName, v_entries[i + 1].m_OriginalName));
+            // Begin compiling shaders on one of the job system workers
+            JobSystem::GetDefault().Run([this, vertexData, pixelData, vertexName = v_entries[i].m_OriginalName, pixelName = v_entries[i + 1].m_OriginalName]()
+            {
+                GraphicsDx11::CompileShader(vertexData, pixelData, ShaderType_Deferred, this, vertexName, pixelName);
+            }, &counter);
         }
 
-        // Join all compilation threads
-        for (auto& compThread : v_CompilationThreads)
-        {
-            compThread.join();
-        }
+        // Wait for all shaders to be compiled
+        JobSystem::GetDefault().Wait(counter);
 
         std::map<std::string, uint32_t> result;
 
@@ -362,69 +389,98 @@ namespace Mesa
     }
 
     /*
-        Loads textures from archive
+        Loads textures from archive.
+        Entries are streamed through read, decode and upload stages that run concurrently,
+        so reading overlaps with decoding and memory used by the load stays within the pipeline budget.
     */
     std::map<std::string, uint32_t> GraphicsDx11::LoadTexturePack(const std::string& packPath)
     {
-        std::string matDir = ConfigUtils::GetValueFromConfigCS("Path", "Texture");
+        std::string texDir = EngineConfig::Get<ConfigKey_PathTexture>();
 
-        std::string relativePackPath = FileUtils::CombinePaths(matDir, packPath);
+        std::string relativePackPath = FileUtils::CombinePaths(texDir, packPath);
 
-        // Read the contents of the pack
-        std::vector<uint8_t> v_PackData = FileUtils::ReadBinaryData(relativePackPath);
-        if (v_PackData.empty()) return std::map<std::string, uint32_t>();
+        // Read only the header, entries are streamed one by one
+        auto v_Locations = PackUtils::ReadPackHeader(relativePackPath);
+        if (v_Locations.empty()) return std::map<std::string, uint32_t>();
 
         // Search the lookup table for files in this pack
         auto v_entries = LookUpUtils::LoadSpecificPackInfo(packPath);
 
-        // Calculate number of files in pack
-        uint32_t numFilesInPack = 0;
-        memcpy(&numFilesInPack, &v_PackData[0], sizeof(uint32_t));
+        // Validate number of files
+        if (v_Locations.size() != v_entries.size()) return std::map<std::string, uint32_t>();
+
+        // Stream entries in order they are stored in so the pack is read front to back
+        std::sort(v_entries.begin(), v_entries.end(), [&v_Locations](const LookUpEntry& a, const LookUpEntry& b)
+        {
+            uint64_t offsetA = a.m_Index < v_Locations.size() ? v_Locations[a.m_Index].m_Offset : 0;
+            uint64_t offsetB = b.m_Index < v_Locations.size() ? v_Locations[b.m_Index].m_Offset : 0;
+            return offsetA < offsetB;
+        });
 
-        // Validate calculated number of files
-        if (numFilesInPack <= 0) return std::map<std::string, uint32_t>();
-        if (numFilesInPack != v_entries.size()) return std::map<std::string, uint32_t>();
+        // Texture that moves through the pipeline, it holds either its encoded data or decoded pixels
+        struct TextureStreamItem
+        {
+            std::string m_Name;
+            uint32_t m_Index = 0;
+            PackEntryLocation m_Location;
+            std::vector<uint8_t> mv_Data;
+            DecodedTexture m_Texture;
+        };
 
-        // Calculate all starting positions for each file
-        std::vector<uint64_t> v_startingPositions;
+        StreamingPipeline<TextureStreamItem> pipeline(m_PipelineSettings.m_MaxBytesInFlight, [](const TextureStreamItem& item)
+        {
+            // Entry is counted before it's read so the budget also limits reads
+            return (uint64_t)std::max<size_t>(item.mv_Data.size(), item.m_Location.m_Size) + item.m_Texture.mv_Pixels.size();
+        });
 
-        for (int i = 0; i < numFilesInPack; i++)
+        pipeline.AddStage("Read", m_PipelineSettings.m_NumReadWorkers, [relativePackPath](TextureStreamItem& item)
         {
-            uint32_t headerPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * i;
+            item.mv_Data = PackUtils::ReadEntryAt(relativePackPath, item.m_Index, item.m_Location);
+            return !item.mv_Data.empty();
+        });
 
-            uint64_t startPos = 0;
-            memcpy(&startPos, &v_PackData[headerPos], sizeof(uint64_t));
+        // Entries of packs aren't compressed so read data goes straight to the decoders
+        pipeline.AddStage("Decode", m_PipelineSettings.m_NumDecodeWorkers, [](TextureStreamItem& item)
+        {
+            bool decoded = DecodeTexture(item.mv_Data, item.m_Name, item.m_Texture);
+            item.mv_Data = std::vector<uint8_t>();
+            return decoded;
+        });
 
-            v_startingPositions.push_back(startPos - 1);
-        }
+        pipeline.AddStage("Upload", m_PipelineSettings.m_NumUploadWorkers, [this](TextureStreamItem& item)
+        {
+            CreateTexture(item.m_Texture, this, item.m_Name);
+            return true;
+        });
 
-        std::vector<std::thread> v_LoadThreads;
+        size_t next = 0;
 
-        for (int i = 0; i < v_entries.size(); i ++)
+        pipeline.Run([&](TextureStreamItem& item)
         {
-            // Load texture data
-            std::vector<uint8_t> v_DataBuffer;
-            v_DataBuffer.resize(v_entries[i].m_Size);
+            while (next < v_entries.size())
+            {
+                const LookUpEntry& entry = v_entries[next++];
 
-            uint64_t startPos = v_startingPositions[v_entries[i].m_Index];
-            memcpy(&v_DataBuffer[0], &v_PackData[startPos], v_entries[i].m_Size);
+                // Skip textures that are loaded already
+                if (entry.m_Index >= v_Locations.size() || GetTextureIdByName(entry.m_OriginalName) != 0) continue;
 
-            // Begin decoding material on another thread
-            v_LoadThreads.push_back(std::thread(GraphicsDx11::LoadTexture, v_DataBuffer, this, v_entries[i].m_OriginalName));
-        }
+                item.m_Name = entry.m_OriginalName;
+                item.m_Index = entry.m_Index;
+                item.m_Location = v_Locations[entry.m_Index];
+                return true;
+            }
 
-        // Join all compilation threads
-        for (auto& ldThread : v_LoadThreads)
-        {
-            ldThread.join();
-        }
+            return false;
+        });
+
+        pipeline.LogSummary(packPath);
 
         std::map<std::string, uint32_t> result;
 
         // Associate texture ids with their names
         for (int i = 0; i < v_entries.size(); i++)
         {
-            result[v_entries[i].m_OriginalName] = GetShaderIdByVertexName(v_entries[i].m_OriginalName);
+            result[v_entries[i].m_OriginalName] = GetTextureIdByName(v_entries[i].m_OriginalName);
         }
 
         return result;
@@ -435,58 +491,33 @@ namespace Mesa
     */
     std::map<std::string, uint32_t> GraphicsDx11::LoadModelPack(const std::string& packPath)
     {
-        std::string modelDir = ConfigUtils::GetValueFromConfigCS("Path", "Model");
+        std::string modelDir = EngineConfig::Get<ConfigKey_PathModel>();
 
         std::string relativePackPath = FileUtils::CombinePaths(modelDir, packPath);
 
-        // Read the contents of the pack
-        std::vector<uint8_t> v_PackData = FileUtils::ReadBinaryData(relativePackPath);
-        if (v_PackData.empty()) return std::map<std::string, uint32_t>();
+        // Map the pack, entries are handed to the loaders without being copied
+        AssetBlob pack = AssetBlob::MapFile(relativePackPath);
+        auto v_Locations = PackUtils::ParsePackHeader(pack);
+        if (v_Locations.empty()) return std::map<std::string, uint32_t>();
 
         // Search the lookup table for files in this pack
         auto v_entries = LookUpUtils::LoadSpecificPackInfo(packPath);
 
-        // Calculate number of files in pack
-        uint32_t numFilesInPack = 0;
-        memcpy(&numFilesInPack, &v_PackData[0], sizeof(uint32_t));
-
-        // Validate calculated number of files
-        if (numFilesInPack <= 0) return std::map<std::string, uint32_t>();
-        if (numFilesInPack != v_entries.size()) return std::map<std::string, uint32_t>();
-
-        // Calculate all starting positions for each file
-        std::vector<uint64_t> v_startingPositions;
-
-        for (int i = 0; i < numFilesInPack; i++)
-        {
-            uint32_t headerPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * i;
-
-            uint64_t startPos = 0;
-            memcpy(&startPos, &v_PackData[headerPos], sizeof(uint64_t));
-
-            v_startingPositions.push_back(startPos - 1);
-        }
+        // Validate number of files
+        if (v_Locations.size() != v_entries.size()) return std::map<std::string, uint32_t>();
 
-        std::vector<std::thread> v_LoadThreads;
+        TaskGraph graph;
 
         for (int i = 0; i < v_entries.size(); i++)
         {
-            // Load model data
-            std::vector<uint8_t> v_DataBuffer;
-            v_DataBuffer.resize(v_entries[i].m_Size);
-
-            uint64_t startPos = v_startingPositions[v_entries[i].m_Index];
-            memcpy(&v_DataBuffer[0], &v_PackData[startPos], v_entries[i].m_Size);
+            if (v_entries[i].m_Index >= v_Locations.size()) continue;
 
-            // Begin importing models on another thread
-            v_LoadThreads.push_back(std::thread(GraphicsDx11::LoadModel, v_DataBuffer, this, v_entries[i].m_OriginalName));
+            // Schedule import of the model together with its materials and textures
+            ScheduleModelLoad(graph, v_entries[i].m_OriginalName, PackUtils::ExtractEntry(pack, v_Locations[v_entries[i].m_Index]));
         }
 
-        // Join all compilation threads
-        for (auto& ldThread : v_LoadThreads)
-        {
-            ldThread.join();
-        }
+        // Wait for all models to be loaded
+        ExecuteLoadGraph(graph);
 
         std::map<std::string, uint32_t> result;
 
@@ -504,58 +535,33 @@ namespace Mesa
     */
     std::map<std::string, uint32_t> GraphicsDx11::LoadMaterialPack(const std::string& packPath)
     {
-        std::string modelDir = ConfigUtils::GetValueFromConfigCS("Path", "Material");
+        std::string modelDir = EngineConfig::Get<ConfigKey_PathMaterial>();
 
         std::string relativePackPath = FileUtils::CombinePaths(modelDir, packPath);
 
-        // Read the contents of the pack
-        std::vector<uint8_t> v_PackData = FileUtils::ReadBinaryData(relativePackPath);
-        if (v_PackData.empty()) return std::map<std::string, uint32_t>();
+        // Map the pack, entries are handed to the loaders without being copied
+        AssetBlob pack = AssetBlob::MapFile(relativePackPath);
+        auto v_Locations = PackUtils::ParsePackHeader(pack);
+        if (v_Locations.empty()) return std::map<std::string, uint32_t>();
 
         // Search the lookup table for files in this pack
         auto v_entries = LookUpUtils::LoadSpecificPackInfo(packPath);
 
-        // Calculate number of files in pack
-        uint32_t numFilesInPack = 0;
-        memcpy(&numFilesInPack, &v_PackData[0], sizeof(uint32_t));
-
-        // Validate calculated number of files
-        if (numFilesInPack <= 0) return std::map<std::string, uint32_t>();
-        if (numFilesInPack != v_entries.size()) return std::map<std::string, uint32_t>();
-
-        // Calculate all starting positions for each file
-        std::vector<uint64_t> v_startingPositions;
+        // Validate number of files
+        if (v_Locations.size() != v_entries.size()) return std::map<std::string, uint32_t>();
 
-        for (int i = 0; i < numFilesInPack; i++)
-        {
-            uint32_t headerPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * i;
-
-            uint64_t startPos = 0;
-            memcpy(&startPos, &v_PackData[headerPos], sizeof(uint64_t));
-
-            v_startingPositions.push_back(startPos - 1);
-        }
-
-        std::vector<std::thread> v_LoadThreads;
+        TaskGraph graph;
 
         for (int i = 0; i < v_entries.size(); i++)
         {
-            // Load model data
-            std::vector<uint8_t> v_DataBuffer;
-            v_DataBuffer.resize(v_entries[i].m_Size);
-
-            uint64_t startPos = v_startingPositions[v_entries[i].m_Index];
-            memcpy(&v_DataBuffer[0], &v_PackData[startPos], v_entries[i].m_Size);
+            if (v_entries[i].m_Index >= v_Locations.size()) continue;
 
-            // Begin importing models on another thread
-            v_LoadThreads.push_back(std::thread(GraphicsDx11::CreateMaterial, v_DataBuffer, this, v_entries[i].m_OriginalName));
+            // Schedule creation of the material together with its textures
+            ScheduleMaterialLoad(graph, v_entries[i].m_OriginalName, PackUtils::ExtractEntry(pack, v_Locations[v_entries[i].m_Index]));
         }
 
-        // Join all compilation threads
-        for (auto& ldThread : v_LoadThreads)
-        {
-            ldThread.join();
-        }
+        // Wait for all materials to be created
+        ExecuteLoadGraph(graph);
 
         std::map<std::string, uint32_t> result;
 
@@ -573,68 +579,39 @@ namespace Mesa
     */
     uint32_t GraphicsDx11::LoadModelFromPack(const std::string& originalName)
     {
-        // Use lookup table to find in which pack the model is contained in
-        // and what index it has
-        auto packName = LookUpUtils::FindFilePack(originalName);
-        auto packIndex = LookUpUtils::FindFileIndex(originalName);
+        // Model, its materials and their textures are loaded as one task graph
+        TaskGraph graph;
+        ScheduleModelLoad(graph, originalName);
+        ExecuteLoadGraph(graph);
 
-        // Validate lookup results
-        if (packName.empty() || !packIndex.has_value())
-        {
-            LOG_F(ERROR, "Could not find %s in lookup table!", originalName.c_str());
-            return 0;
-        }
-
-        // Read pack contents
-        std::string packPath = FileUtils::CombinePaths(ConfigUtils::GetValueFromConfigCS("Path", "Model"), packName);
-        std::vector<uint8_t> v_PackData = FileUtils::ReadBinaryData(packPath);
-
-        if (v_PackData.empty())
-        {
-            LOG_F(ERROR, "Could not read %s", packPath.c_str());
-            return 0;
-        }
-
-        // Calculate where file details are
-        uint32_t headerPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * packIndex.value();
+        return GetModelIdByName(originalName);
+    }
 
-        // Validate calculation results
-        if (headerPos >= v_PackData.size())
-        {
-            LOG_F(ERROR, "Invalid header position of %s", originalName.c_str());
-            return 0;
-        }
+    /*
+        Loads multiple models that can be spread across multiple model packs.
+        All models are loaded by a single task graph so materials and textures
+        shared between them are loaded only once.
+    */
+    std::map<std::string, uint32_t> GraphicsDx11::LoadModelsFromPack(const std::vector<std::string>& v_OriginalNames)
+    {
+        std::map<std::string, uint32_t> result;
 
-        // Calculate where file data starts
-        uint64_t startPos = 0;
-        memcpy(&startPos, &v_PackData[headerPos], sizeof(uint64_t));
+        TaskGraph graph;
 
-        // Validate calculation results
-        if (startPos <= headerPos)
+        for (const auto& name : v_OriginalNames)
         {
-            LOG_F(ERROR, "Invalid starting position of %s", originalName.c_str());
-            return 0;
+            if (!name.empty()) ScheduleModelLoad(graph, name);
         }
 
-        // Grab file size
-        uint32_t fileSize = 0;
-        memcpy(&fileSize, &v_PackData[headerPos + sizeof(uint64_t)], sizeof(uint32_t));
+        ExecuteLoadGraph(graph);
 
-        // Validate file size
-        if(fileSize <= 0)
+        // Associate model ids with their names
+        for (const auto& name : v_OriginalNames)
         {
-            LOG_F(ERROR, "Invalid size of %s", originalName.c_str());
-            return 0;
+            if (!name.empty()) result[name] = GetModelIdByName(name);
         }
 
-        // Load model data
-        std::vector<uint8_t> v_ModelData(fileSize);
-        memcpy(&v_ModelData[0], &v_PackData[startPos - 1], fileSize);
-
-        // Import loaded data using ASSIMP
-        LoadModel(v_ModelData, this, originalName);
-
-        return GetModelIdByName(originalName);
+        return result;
     }
 
     /*
@@ -658,7 +635,7 @@ namespace Mesa
             return 0;
         }
 
-        std::string packPath = FileUtils::CombinePaths(ConfigUtils::GetValueFromConfigCS("Path", "Shader"), packName);
+        std::string packPath = FileUtils::CombinePaths(EngineConfig::Get<ConfigKey_PathShader>(), packName);
 
         // Calculate pixel shader position using vertex shader index
         auto vertexIndex = LookUpUtils::FindFileIndex(vertexName);
@@ -680,64 +657,20 @@ namespace Mesa
             return 0;
         }
 
-        // Load pack contents
-        std::vector<uint8_t> v_PackData = FileUtils::ReadBinaryData(packPath);
+        // Read both shaders with a single batch read since they are next to each other in pack
+        PackReadRequest vertexRequest = { packPath, vertexIndex.value() };
+        PackReadRequest pixelRequest = { packPath, pixelIndex };
+        auto v_ShaderData = PackUtils::ReadEntries({ vertexRequest, pixelRequest });
 
         // Validate loading results
-        if (v_PackData.empty())
-        {
-            LOG_F(ERROR, "Could not read %s", packPath.c_str());
-            return 0;
-        }
-
-        // Calculate header positions
-        uint32_t vertexHeadPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * vertexIndex.value();
-        uint32_t pixelHeadPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * pixelIndex;
-
-        // Validate header positions
-        if (vertexHeadPos >= v_PackData.size() || pixelHeadPos >= v_PackData.size())
-        {
-            LOG_F(ERROR, "Invalid header position of %s", vertexName.c_str());
-            return 0;
-        }
-
-        // Calculate where the data actually begins
-        uint64_t vertexStartPos = 0;
-        uint64_t pixelStartPos = 0;
-
-        memcpy(&vertexStartPos, &v_PackData[vertexHeadPos], sizeof(uint64_t));
-        memcpy(&pixelStartPos, &v_PackData[pixelHeadPos], sizeof(uint64_t));
-
-        // Validate calculation results
-        if (vertexStartPos <= vertexHeadPos || pixelStartPos <= pixelHeadPos)
-        {
-            LOG_F(ERROR, "Invalid header position of %s", vertexName.c_str());
-            return 0;
-        }
-
-        // Grab file sizes
-        uint64_t vertexSize = 0;
-        uint64_t pixelSize = 0;
-
-        memcpy(&vertexSize, &v_PackData[vertexHeadPos + sizeof(uint64_t)], sizeof(uint32_t));
-        memcpy(&pixelSize, &v_PackData[pixelHeadPos + sizeof(uint64_t)], sizeof(uint32_t));
-
-        // Validate file sizes
-        if (vertexSize <= 0 || pixelSize <= 0)
+        if (v_ShaderData[0].empty() || v_ShaderData[1].empty())
         {
-            LOG_F(ERROR, "Invalid size of %s", vertexName.c_str());
+            LOG_F(ERROR, "Could not read %s from %s", vertexName.c_str(), packPath.c_str());
             return 0;
         }
 
-        // Load actuall shader data from pack
-        std::vector<uint8_t> v_VertexData(vertexSize);
-        std::vector<uint8_t> v_PixelData(pixelSize);
-
-        memcpy(&v_VertexData[0], &v_PackData[vertexStartPos - 1], vertexSize);
-        memcpy(&v_PixelData[0], &v_PackData[pixelStartPos - 1], pixelSize);
-
         // Compile shaders
-        CompileShader(v_VertexData, v_PixelData, ShaderType_Forward, this, vertexName, pixelName);
+        CompileShader(v_ShaderData[0], v_ShaderData[1], ShaderType_Forward, this, vertexName, pixelName);
 
         return GetShaderIdByVertexName(vertexName);
     }
@@ -747,67 +680,78 @@ namespace Mesa
     */
     uint32_t GraphicsDx11::LoadTextureFromPack(const std::string& originalName)
     {
-        // Use lookup table to find in which pack the texture is contained in
-        // and what index it has
-        auto packName = LookUpUtils::FindFilePack(originalName);
-        auto packIndex = LookUpUtils::FindFileIndex(originalName);
+        // Read texture only if it's not being loaded by another thread already
+        return LoadTextureOnce(originalName, [this, &originalName]() { return ReadAssetFromPack("Texture", originalName); });
+    }
 
-        // Validate lookup results
-        if (packName.empty() || !packIndex.has_value())
-        {
-            LOG_F(ERROR, "Could not find %s in lookup table!", originalName.c_str());
-            return 0;
-        }
+    /*
+        Loads multiple textures that can be spread across multiple texture packs.
+        Data of all textures is fetched with a single batch read and decoded in parallel.
+    */
+    std::map<std::string, uint32_t> GraphicsDx11::LoadTexturesFromPack(const std::vector<std::string>& v_OriginalNames)
+    {
+        std::map<std::string, uint32_t> result;
 
-        // Read pack contents
-        std::string packPath = FileUtils::CombinePaths(ConfigUtils::GetValueFromConfigCS("Path", "Texture"), packName);
-        std::vector<uint8_t> v_PackData = FileUtils::ReadBinaryData(packPath);
+        // Read lookup table once instead of once per texture
+        auto v_LookUpEntries = LookUpUtils::LoadLookupTable();
+        std::string textureDir = EngineConfig::Get<ConfigKey_PathTexture>();
 
-        if (v_PackData.empty())
+        std::vector<std::string> v_Names;
+        std::vector<PackReadRequest> v_Requests;
+
+        for (const auto& name : v_OriginalNames)
         {
-            LOG_F(ERROR, "Could not read %s", packPath.c_str());
-            return 0;
-        }
+            // Skip empty names, duplicates and textures that are loaded already
+            if (name.empty() || result.find(name) != result.end()) continue;
 
-        // Calculate where file details are
-        uint32_t headerPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * packIndex.value();
+            result[name] = GetTextureIdByName(name);
+            if (result[name] != 0) continue;
 
-        // Validate calculation results
-        if (headerPos >= v_PackData.size())
-        {
-            LOG_F(ERROR, "Invalid header position of %s", originalName.c_str());
-            return 0;
-        }
+            auto entry = std::find_if(v_LookUpEntries.begin(), v_LookUpEntries.end(), [&name](const LookUpEntry& e) { return e.m_OriginalName == name; });
+            if (entry == v_LookUpEntries.end())
+            {
+                LOG_F(ERROR, "Could not find %s in lookup table!", name.c_str());
+                continue;
+            }
 
-        // Calculate where file data starts
-        uint64_t startPos = 0;
-        memcpy(&startPos, &v_PackData[headerPos], sizeof(uint64_t));
+            PackReadRequest request = {};
+            request.m_PackPath = FileUtils::CombinePaths(textureDir, entry->m_PackName);
+            request.m_Index = entry->m_Index;
 
-        // Validate calculation results
-        if (startPos <= headerPos)
-        {
-            LOG_F(ERROR, "Invalid starting position of %s", originalName.c_str());
-            return 0;
+            v_Names.push_back(name);
+            v_Requests.push_back(request);
         }
 
-        // Grab file size
-        uint32_t fileSize = 0;
-        memcpy(&fileSize, &v_PackData[headerPos + sizeof(uint64_t)], sizeof(uint32_t));
+        // Fetch data of all textures sorted by their position in packs
+        auto v_TextureData = PackUtils::ReadEntries(v_Requests);
 
-        // Validate file size
-        if (fileSize <= 0)
+        JobCounter counter;
+
+        for (size_t i = 0; i < v_Names.size(); i++)
         {
-            LOG_F(ERROR, "Invalid size of %s", originalName.c_str());
-            return 0;
+            if (v_TextureData[i].empty())
+            {
+                LOG_F(ERROR, "Could not read %s", v_Names[i].c_str());
+                continue;
+            }
+
+            // Begin decoding texture on one of the job system workers
+            JobSystem::GetDefault().Run([this, data = AssetBlob::FromVector(std::move(v_TextureData[i])), name = v_Names[i]]()
+            {
+                GraphicsDx11::LoadTexture(data, this, name);
+            }, &counter);
         }
 
-        // Load texture data
-        std::vector<uint8_t> v_TextureData(fileSize);
-        memcpy(&v_TextureData[0], &v_PackData[startPos - 1], fileSize);
+        // Wait for all textures to be decoded
+        JobSystem::GetDefault().Wait(counter);
 
-        LoadTexture(v_TextureData, this, originalName);
+        // Associate texture ids with their names
+        for (const auto& name : v_Names)
+        {
+            result[name] = GetTextureIdByName(name);
+        }
 
-        return GetTextureIdByName(originalName);
+        return result;
     }
 
     /*
@@ -823,127 +767,294 @@ namespace Mesa
             return existsCheck;
         }
 
-        // Use lookup table to find in which pack the texture is contained in
-        // and what index it has
-        auto packName = LookUpUtils::FindFilePack(originalName);
-        auto packIndex = LookUpUtils::FindFileIndex(originalName);
+        // Material and its textures are loaded as one task graph
+        TaskGraph graph;
+        ScheduleMaterialLoad(graph, originalName);
+        ExecuteLoadGraph(graph);
 
-        // Validate lookup results
-        if (packName.empty() || !packIndex.has_value())
-        {
-            LOG_F(ERROR, "Could not find %s in lookup table!", originalName.c_str());
-            return 0;
-        }
+        return GetMaterialIdByName(originalName);
+    }
+
+    /*
+        Loads model without blocking the caller.
+        If the model is being loaded already handle of that load is returned.
+    */
+    AssetHandle<uint32_t> GraphicsDx11::LoadModelAsync(std::string originalName)
+    {
+        return m_AsyncModelRequests.Do(originalName, [this, &originalName]() { return BeginModelLoad(originalName); });
+    }
+
+    /*
+        Loads texture without blocking the caller.
+        If the texture is being loaded already handle of that load is returned.
+    */
+    AssetHandle<uint32_t> GraphicsDx11::LoadTextureAsync(std::string originalName)
+    {
+        // Materials don't have to use every kind of texture
+        if (originalName.empty()) return BeginTextureLoad(originalName);
+
+        return m_AsyncTextureRequests.Do(originalName, [this, &originalName]() { return BeginTextureLoad(originalName); });
+    }
+
+    /*
+        Loads material without blocking the caller.
+        If the material is being loaded already handle of that load is returned.
+    */
+    AssetHandle<uint32_t> GraphicsDx11::LoadMaterialAsync(std::string originalName)
+    {
+        return m_AsyncMaterialRequests.Do(originalName, [this, &originalName]() { return BeginMaterialLoad(originalName); });
+    }
+
+    /*
+        Starts loading a model.
+        Model is read and imported on the job system while its materials are loaded in parallel.
+        Buffers of the model are created on the main thread, one mesh per upload job.
+    */
+    AssetHandle<uint32_t> GraphicsDx11::BeginModelLoad(std::string originalName)
+    {
+        uint32_t existingId = GetModelIdByName(originalName);
+        if (existingId != 0) co_return existingId;
+
+        co_await JobSystem::GetDefault().Schedule();
+
+        AssetBlob modelData = ReadAssetFromPack("Model", originalName);
+        if (modelData.IsEmpty()) co_return 0;
+
+        auto matDef = LoadMaterialDefinitions(FileUtils::StripPathToFileName(originalName) + ".matdef");
 
-        // Read pack contents
-        std::string packPath = FileUtils::CombinePaths(ConfigUtils::GetValueFromConfigCS("Path", "Material"), packName);
-        std::vector<uint8_t> v_PackData = FileUtils::ReadBinaryData(packPath);
+        std::vector<MeshData> v_Meshes;
+        if (!ImportMeshes(modelData, this, originalName, v_Meshes)) co_return 0;
+        modelData = AssetBlob();
 
-        if (v_PackData.empty())
+        // Start loading materials before the buffers are created
+        std::vector<std::string> v_MaterialNames;
+        std::map<std::string, AssetHandle<uint32_t>> materials;
+
+        for (const auto& meshData : v_Meshes)
         {
-            LOG_F(ERROR, "Could not read %s", packPath.c_str());
-            return 0;
+            std::string materialName = ConvertUtils::ReplaceCharInString(matDef[meshData.m_MeshMatName], '\\', '/');
+            v_MaterialNames.push_back(materialName);
+
+            if (!materialName.empty() && materials.find(materialName) == materials.end())
+                materials[materialName] = LoadMaterialAsync(materialName);
         }
 
-        // Calculate where file details are
-        uint32_t headerPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * packIndex.value();
+        ModelDx11 model = {};
 
-        // Validate calculation results
-        if (headerPos >= v_PackData.size())
+        // Create buffers of one mesh at a time so that large models are spread over several frames
+        for (const auto& meshData : v_Meshes)
         {
-            LOG_F(ERROR, "Invalid header position of %s", originalName.c_str());
-            return 0;
+            co_await m_UploadQueue.Schedule();
+
+            MeshDx11 mesh;
+            CreateMeshBuffers(meshData, mesh);
+            model.m_Bounds = model.mv_Meshes.empty() ? mesh.m_Bounds : BoundingVolume::Merge(model.m_Bounds, mesh.m_Bounds);
+            model.mv_Meshes.push_back(mesh);
         }
 
-        // Calculate where file data starts
-        uint64_t startPos = 0;
-        memcpy(&startPos, &v_PackData[headerPos], sizeof(uint64_t));
+        bool bufResult = false;
+
+        // Create constant buffer for MVP matrix
+        GraphicsDx11::CreateEmptyBuffer(sizeof(ConstBufferDx11::MvpBuffer), D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DEFAULT, 0, this, model.mp_ConstBufferMVP.GetAddressOf(), bufResult);
 
-        // Validate calculation results
-        if (startPos <= headerPos)
+        if (!bufResult)
         {
-            LOG_F(ERROR, "Invalid starting position of %s", originalName.c_str());
-            return 0;
+            LOG_F(ERROR, "Cration of constant buffer failed!");
+            co_return 0;
         }
 
-        // Grab file size
-        uint32_t fileSize = 0;
-        memcpy(&fileSize, &v_PackData[headerPos + sizeof(uint64_t)], sizeof(uint32_t));
-
-        // Validate file size
-        if (fileSize <= 0)
+        for (size_t i = 0; i < model.mv_Meshes.size(); i++)
         {
-            LOG_F(ERROR, "Invalid size of %s", originalName.c_str());
-            return 0;
+            model.mv_Meshes[i].m_MaterialName = v_MaterialNames[i];
+
+            if (!v_MaterialNames[i].empty())
+                model.mv_Meshes[i].m_MaterialId = co_await materials[v_MaterialNames[i]];
         }
 
-        // Load texture data
-        std::vector<uint8_t> v_MatData(fileSize);
-        memcpy(&v_MatData[0], &v_PackData[startPos - 1], fileSize);
+        // Materials could have finished on a worker so go back to the main thread
+        co_await m_UploadQueue.Schedule();
 
-        CreateMaterial(v_MatData, this, originalName);
+        RegisterModel(std::move(model), this, originalName);
 
-        return GetMaterialIdByName(originalName);
+        co_return GetModelIdByName(originalName);
     }
 
     /*
-        Returns shader ID if the its vertex name matches with provided string
+        Starts loading a texture.
+        Texture is read and decoded on the job system and its DirectX resources
+        are created on the main thread.
     */
-    uint32_t GraphicsDx11::GetShaderIdByVertexName(const std::string& name)
+    AssetHandle<uint32_t> GraphicsDx11::BeginTextureLoad(std::string originalName)
     {
-        for (const auto& shader : mv_Shaders)
-        {
-            if (strcmp(shader.GetVertexShaderName().c_str(), name.c_str()) == 0)
-                return shader.GetShaderUID();
-        }
+        // Materials don't have to use every kind of texture
+        if (originalName.empty()) co_return 0;
 
-        // If shader ID can't be found return 0 to indicate that the shader isn't loaded
-        return 0;
+        uint32_t existingId = GetTextureIdByName(originalName);
+        if (existingId != 0) co_return existingId;
+
+        co_await JobSystem::GetDefault().Schedule();
+
+        AssetBlob textureData = ReadAssetFromPack("Texture", originalName);
+        if (textureData.IsEmpty()) co_return 0;
+
+        DecodedTexture decodedTexture = {};
+        if (!DecodeTexture(textureData, originalName, decodedTexture)) co_return 0;
+        textureData = AssetBlob();
+
+        co_await m_UploadQueue.Schedule();
+
+        CreateTexture(decodedTexture, this, originalName);
+
+        co_return GetTextureIdByName(originalName);
     }
 
     /*
-        Returns shader ID if the its pixel name matches with provided string
+        Starts loading a material.
+        All textures of the material are loaded in parallel and the material is
+        created on the main thread once they are ready.
     */
-    uint32_t GraphicsDx11::GetShaderIdByPixelName(const std::string& name)
+    AssetHandle<uint32_t> GraphicsDx11::BeginMaterialLoad(std::string originalName)
     {
-        for (const auto& shader : mv_Shaders)
-        {
-            if (strcmp(shader.GetPixelShaderName().c_str(), name.c_str()) == 0)
-                return shader.GetShaderUID();
-        }
+        uint32_t existingId = GetMaterialIdByName(originalName);
+        if (existingId != 0) co_return existingId;
 
-        // If shader ID can't be found return 0 to indicate that the shader isn't loaded
-        return 0;
+        co_await JobSystem::GetDefault().Schedule();
+
+        AssetBlob matData = ReadAssetFromPack("Material", originalName);
+        if (matData.IsEmpty()) co_return 0;
+
+        MaterialDescription description = MaterialFormat::Parse(matData);
+
+        // Start loading all textures before waiting for any of them
+        AssetHandle<uint32_t> diffuseTexture = LoadTextureAsync(description.m_DiffuseTexture);
+        AssetHandle<uint32_t> specularTexture = LoadTextureAsync(description.m_SpecularTexture);
+        AssetHandle<uint32_t> normalTexture = LoadTextureAsync(description.m_NormalTexture);
+
+        co_await diffuseTexture;
+        co_await specularTexture;
+        co_await normalTexture;
+
+        co_await m_UploadQueue.Schedule();
+
+        CreateMaterial(description, this, originalName);
+
+        co_return GetMaterialIdByName(originalName);
     }
 
     /*
-        Returns texture ID if the its name matches with provided string
+        Loads all models from a model pack without blocking the caller
     */
-    uint32_t GraphicsDx11::GetTextureIdByName(const std::string& name)
+    AssetHandle<std::map<std::string, uint32_t>> GraphicsDx11::LoadModelPackAsync(std::string packPath)
     {
-        for (const auto& texture : mv_Textures)
-        {
-            if (strcmp(texture.GetTextureName().c_str(), name.c_str()) == 0)
-                return texture.GetTextureUID();
-        }
-
-        // If texture ID can't be found return 0 to indicate that the texture isn't loaded
-        return 0;
+        return LoadPackAsync(packPath, &GraphicsDx11::LoadModelAsync);
     }
 
     /*
-        Returns model ID if the its name matches with provided string
+        Loads all textures from a texture pack without blocking the caller
     */
-    uint32_t GraphicsDx11::GetModelIdByName(const std::string& name)
+    AssetHandle<std::map<std::string, uint32_t>> GraphicsDx11::LoadTexturePackAsync(std::string packPath)
+    {
+        return LoadPackAsync(packPath, &GraphicsDx11::LoadTextureAsync);
+    }
+
+    /*
+        Loads all materials from a material pack without blocking the caller
+    */
+    AssetHandle<std::map<std::string, uint32_t>> GraphicsDx11::LoadMaterialPackAsync(std::string packPath)
+    {
+        return LoadPackAsync(packPath, &GraphicsDx11::LoadMaterialAsync);
+    }
+
+    /*
+        Starts asynchronous load of every asset in the pack and waits for all of them.
+        Result maps names of the assets to their ids.
+    */
+    AssetHandle<std::map<std::string, uint32_t>> GraphicsDx11::LoadPackAsync(std::string packPath, AssetHandle<uint32_t>(GraphicsDx11::* p_LoadAsync)(std::string))
+    {
+        co_await JobSystem::GetDefault().Schedule();
+
+        // Search the lookup table for files in this pack
+        auto v_entries = LookUpUtils::LoadSpecificPackInfo(packPath);
+
+        std::vector<AssetHandle<uint32_t>> v_Handles;
+        for (const auto& entry : v_entries)
+            v_Handles.push_back((this->*p_LoadAsync)(entry.m_OriginalName));
+
+        std::map<std::string, uint32_t> result;
+        for (size_t i = 0; i < v_entries.size(); i++)
+            result[v_entries[i].m_OriginalName] = co_await v_Handles[i];
+
+        co_return result;
+    }
+
+    /*
+        Logs how many loads were shared with a load of the same asset that was already running
+    */
+    void GraphicsDx11::LogLoadStatistics()
     {
-        for (const auto& model : mv_Models)
+        LOG_F(INFO, "Texture loads: %llu requests, %llu duplicates avoided", (unsigned long long)m_TextureRequests.GetNumRequests(), (unsigned long long)m_TextureRequests.GetNumCoalesced());
+        LOG_F(INFO, "Async texture loads: %llu requests, %llu duplicates avoided", (unsigned long long)m_AsyncTextureRequests.GetNumRequests(), (unsigned long long)m_AsyncTextureRequests.GetNumCoalesced());
+        LOG_F(INFO, "Async material loads: %llu requests, %llu duplicates avoided", (unsigned long long)m_AsyncMaterialRequests.GetNumRequests(), (unsigned long long)m_AsyncMaterialRequests.GetNumCoalesced());
+        LOG_F(INFO, "Async model loads: %llu requests, %llu duplicates avoided", (unsigned long long)m_AsyncModelRequests.GetNumRequests(), (unsigned long long)m_AsyncModelRequests.GetNumCoalesced());
+        LOG_F(INFO, "Duplicate resources dropped: %llu", (unsigned long long)m_NumDuplicateResources.load());
+        LOG_F(INFO, "Asset cache: %llu hits, %llu misses", (unsigned long long)AssetCache::GetDefault().GetNumHits(), (unsigned long long)AssetCache::GetDefault().GetNumMisses());
+        LOG_F(INFO, "Material definitions: %llu requests, %llu pack reads", (unsigned long long)m_MaterialDefinitions.GetNumRequests(), (unsigned long long)m_MaterialDefinitions.GetNumPackReads());
+
+        const char* names[] = { "Shaders", "Textures", "Models", "Materials" };
+
+        for (uint32_t type = AssetType_Shader; type <= AssetType_Material; type++)
         {
-            if (strcmp(model.GetModelName().c_str(), name.c_str()) == 0)
-                return model.GetModelUID();
+            AssetRegistryStatistics statistics = GetAssetStatistics((AssetType)type);
+
+            LOG_F(INFO, "%s: %llu loaded (%llu KB of %llu KB budget), %llu evicted (%llu KB), %llu reloaded", names[type],
+                (unsigned long long)statistics.m_NumAssets, (unsigned long long)(statistics.m_NumBytes / 1024), (unsigned long long)(statistics.m_Budget / 1024),
+                (unsigned long long)statistics.m_NumEvictions, (unsigned long long)(statistics.m_NumEvictedBytes / 1024), (unsigned long long)statistics.m_NumReloads);
         }
+    }
+
+    /*
+        Returns shader ID if the its vertex name matches with provided string
+    */
+    uint32_t GraphicsDx11::GetShaderIdByVertexName(const std::string& name)
+    {
+        // If shader ID can't be found 0 is returned to indicate that the shader isn't loaded
+        return m_Shaders.Find(name);
+    }
+
+    /*
+        Returns shader ID if the its pixel name matches with provided string
+    */
+    uint32_t GraphicsDx11::GetShaderIdByPixelName(const std::string& name)
+    {
+        uint32_t id = 0;
+
+        // Shaders are indexed by their vertex name so pixel name has to be searched for
+        m_Shaders.ForEach([&](uint32_t handle, ShaderDx11& shader)
+        {
+            if (id == 0 && shader.GetPixelShaderName() == name)
+                id = handle;
+        });
+
+        // If shader ID can't be found return 0 to indicate that the shader isn't loaded
+        return id;
+    }
+
+    /*
+        Returns texture ID if the its name matches with provided string
+    */
+    uint32_t GraphicsDx11::GetTextureIdByName(const std::string& name)
+    {
+        // If texture ID can't be found 0 is returned to indicate that the texture isn't loaded
+        return m_Textures.Find(name);
+    }
 
-        // If model ID can't be found return 0 to indicate that the model isn't loaded
-        return 0;
+    /*
+        Returns model ID if the its name matches with provided string
+    */
+    uint32_t GraphicsDx11::GetModelIdByName(const std::string& name)
+    {
+        // If model ID can't be found 0 is returned to indicate that the model isn't loaded
+        return m_Models.Find(name);
     }
 
     /*
@@ -951,14 +1062,8 @@ namespace Mesa
     */
     uint32_t GraphicsDx11::GetMaterialIdByName(const std::string& name)
     {
-        for (const auto& material : mv_Materials)
-        {
-            if (strcmp(material.GetMaterialName().c_str(), name.c_str()) == 0)
-                return material.GetMaterialUID();
-        }
-
-        // If model ID can't be found return 0 to indicate that the material isn't loaded
-        return 0;
+        // If material ID can't be found 0 is returned to indicate that the material isn't loaded
+        return m_Materials.Find(name);
     }
 
     /*
@@ -1141,6 +1246,14 @@ namespace Mesa
         // the back buffer's existing format (e.g., R8G8B8A8_UNORM)
         THROW_IF_FAILED_DX(mp_Device->CreateRenderTargetView(mp_BackBuffer.Get(), nullptr, mp_RenderTarget.GetAddressOf()));
 
+        // Layer textures of the frame graph match the back buffer
+        D3D11_TEXTURE2D_DESC backBufferDesc = {};
+        mp_BackBuffer->GetDesc(&backBufferDesc);
+
+        m_BackBufferDesc.m_Width = backBufferDesc.Width;
+        m_BackBufferDesc.m_Height = backBufferDesc.Height;
+        m_BackBufferDesc.m_Format = (uint32_t)backBufferDesc.Format;
+
         // Bind the Render Target and the Depth/Stencil view to the Output Merger (OM) stage
         mp_Context->OMSetRenderTargets(1, mp_RenderTarget.GetAddressOf(), mp_DepthView.Get());
     }
@@ -1253,33 +1366,93 @@ namespace Mesa
 
     }
 
+    /*
+        Creates the upload ring buffer and fences of frames in flight.
+        Constants are bound by their offsets in the ring, which needs D3D11.1. Otherwise they are
+        written to staging memory and copied into buffers of models and meshes when bound.
+    */
+    void GraphicsDx11::InitializeUploadRing()
+    {
+        D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+        bool hasOffsets = SUCCEEDED(mp_Device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options)))
+            && options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer
+            && SUCCEEDED(mp_Context.As(&mp_Context1));
+
+        if (!hasOffsets)
+        {
+            mp_Context1.Reset();
+            LOG_F(WARNING, "Constant buffer offsets aren't supported, constants will be copied into separate buffers");
+        }
+
+        D3D11_QUERY_DESC desc = {};
+        desc.Query = D3D11_QUERY_EVENT;
+
+        for (auto& fence : ma_FrameFences)
+            THROW_IF_FAILED_DX(mp_Device->CreateQuery(&desc, fence.GetAddressOf()));
+
+        CreateUploadBuffer(UploadRing::DEFAULT_CAPACITY);
+    }
+
+    /*
+        Creates one deferred context per worker of the job system.
+        Contexts are only used if the driver records command lists itself and constants can be bound by offset,
+        since emulated command lists and copies of staging constants would be slower than drawing on one thread.
+    */
+    void GraphicsDx11::InitializeDeferredContexts()
+    {
+        D3D11_FEATURE_DATA_THREADING threading = {};
+
+        if (mp_Context1.Get() == nullptr || FAILED(mp_Device->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading))) || !threading.DriverCommandLists)
+        {
+            LOG_F(INFO, "Driver command lists aren't supported, draws will be replayed on the immediate context");
+            return;
+        }
+
+        uint32_t numContexts = std::max(JobSystem::GetDefault().GetNumWorkers(), 1u);
+
+        for (uint32_t i = 0; i < numContexts; i++)
+        {
+            Microsoft::WRL::ComPtr<ID3D11DeviceContext> p_Context;
+            THROW_IF_FAILED_DX(mp_Device->CreateDeferredContext(0, p_Context.GetAddressOf()));
+
+            Microsoft::WRL::ComPtr<ID3D11DeviceContext1> p_Context1;
+            THROW_IF_FAILED_DX(p_Context.As(&p_Context1));
+
+            mv_DeferredContexts.push_back(p_Context1);
+        }
+
+        mv_CommandLists.resize(numContexts);
+        LOG_F(INFO, "Draws will be recorded on %u deferred contexts", numContexts);
+    }
+
     /*
         Processes nodes of the model imported by ASSIMP
     */
-    void GraphicsDx11::ProcessNode(ModelDx11& outMdl, aiNode* p_Node, const aiScene* p_Scene)
+    void GraphicsDx11::ProcessNode(std::vector<MeshData>& v_OutMeshes, aiNode* p_Node, const aiScene* p_Scene)
     {
         // Go and process each mesh in a node
         for (size_t i = 0; i < p_Node->mNumMeshes; i++)
         {
-            outMdl.mv_Meshes.push_back(ProcessMesh(p_Scene->mMeshes[p_Node->mMeshes[i]], p_Scene));
+            v_OutMeshes.push_back(ProcessMesh(p_Scene->mMeshes[p_Node->mMeshes[i]], p_Scene));
         }
 
         // Repeat processing for all child nodes
         for (size_t i = 0; i < p_Node->mNumChildren; i++)
         {
-            ProcessNode(outMdl, p_Node->mChildren[i], p_Scene);
+            ProcessNode(v_OutMeshes, p_Node->mChildren[i], p_Scene);
         }
     }
 
     /*
-        Processes mesh data and creates vertex and index buffer for it.
+        Copies vertex and index data of a mesh.
+        Buffers for the mesh are created later by CreateMeshBuffers().
     */
-    MeshDx11 GraphicsDx11::ProcessMesh(aiMesh* p_Mesh, const aiScene* p_Scene)
+    GraphicsDx11::MeshData GraphicsDx11::ProcessMesh(aiMesh* p_Mesh, const aiScene* p_Scene)
     {
-        MeshDx11 mesh;
+        MeshData mesh;
 
-        std::vector<VertexDx11> v_vertices;
-        std::vector<uint32_t> v_indices;
+        std::vector<VertexDx11>& v_vertices = mesh.mv_Vertices;
+        std::vector<uint32_t>& v_indices = mesh.mv_Indices;
 
         // Go through each vertex in a model and copy important data to vectors
         for (size_t i = 0; i < p_Mesh->mNumVertices; i++)
@@ -1328,330 +1501,1200 @@ namespace Mesa
                 v_indices.push_back(face.mIndices[j]);
         }
 
+        if (p_Mesh->mMaterialIndex >= 0)
+        {
+            aiMaterial* material = p_Scene->mMaterials[p_Mesh->mMaterialIndex];
+
+            mesh.m_MeshMatName = material->GetName().C_Str();
+        }
+
+        return mesh;
+    }
+
+    /*
+        Creates vertex, index and material buffers for processed mesh.
+        Buffers are created one after another instead of on the job system, since
+        waiting for jobs on the main thread could make it pick up unrelated long jobs.
+        Returns false if creation of any of the buffers fails.
+    */
+    bool GraphicsDx11::CreateMeshBuffers(const MeshData& meshData, MeshDx11& outMesh)
+    {
         bool vertexResult, indexResult, colorPassResult, specPassResult;
 
         // Create index and vertex buffers
-        std::thread vertexThread(GraphicsDx11::CreateVertexBuffer, v_vertices, mesh.mp_VertexBuffer.GetAddressOf(), this, std::ref(vertexResult));
-        std::thread indexThread(GraphicsDx11::CreateIndexBuffer, v_indices, mesh.mp_IndexBuffer.GetAddressOf(), this, std::ref(indexResult));
-        std::thread colorPassThread(GraphicsDx11::CreateEmptyBuffer, sizeof(ConstBufferDx11::MaterialBufferColorPass), D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DEFAULT, 0, this, mesh.mp_ColorPassBuffer.GetAddressOf(), std::ref(colorPassResult));
-        std::thread specularPassThread(GraphicsDx11::CreateEmptyBuffer, sizeof(ConstBufferDx11::MaterialBufferSpecularPass), D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DEFAULT, 0, this, mesh.mp_SpecularPassBuffer.GetAddressOf(), std::ref(specPassResult));
-
-        vertexThread.join();
-        indexThread.join();
-        colorPassThread.join();
-        specularPassThread.join();
+        GraphicsDx11::CreateVertexBuffer(meshData.mv_Vertices, outMesh.mp_VertexBuffer.GetAddressOf(), this, vertexResult);
+        GraphicsDx11::CreateIndexBuffer(meshData.mv_Indices, outMesh.mp_IndexBuffer.GetAddressOf(), this, indexResult);
+        GraphicsDx11::CreateEmptyBuffer(sizeof(ConstBufferDx11::MaterialBufferColorPass), D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DEFAULT, 0, this, outMesh.mp_ColorPassBuffer.GetAddressOf(), colorPassResult);
+        GraphicsDx11::CreateEmptyBuffer(sizeof(ConstBufferDx11::MaterialBufferSpecularPass), D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DEFAULT, 0, this, outMesh.mp_SpecularPassBuffer.GetAddressOf(), specPassResult);
 
         // Validate creation results
         if (!vertexResult || !indexResult || !colorPassResult || !specPassResult)
         {
             LOG_F(ERROR, "Creation of one or more buffers failed!");
-            return MeshDx11();
+            outMesh = MeshDx11();
+            return false;
         }
 
-        if (p_Mesh->mMaterialIndex >= 0)
-        {
-            aiMaterial* material = p_Scene->mMaterials[p_Mesh->mMaterialIndex];
-
-            mesh.m_MeshMatName = material->GetName().C_Str();
-        }
+        outMesh.m_MeshMatName = meshData.m_MeshMatName;
 
         // Save number of indices
-        mesh.m_NumIndices = v_indices.size();
+        outMesh.m_NumIndices = meshData.mv_Indices.size();
 
-        return mesh;
-    }
+        // Position is the first member of the vertex
+        outMesh.m_Bounds = BoundingVolume::FromPoints((const float*)meshData.mv_Vertices.data(), meshData.mv_Vertices.size(), sizeof(VertexDx11));
 
-    void GraphicsDx11::InitializeBlendingMesh()
-    {
-        std::vector<DeferredVertexDx11> v = {
-             { DirectX::XMFLOAT3(-1.0f, -1.0f, 0.0f), DirectX::XMFLOAT2(0, 1) },
-             { DirectX::XMFLOAT3(1.0f, 1.0f, 0.0f), DirectX::XMFLOAT2(1, 0) },
-             { DirectX::XMFLOAT3(1.0f, -1.0f, 0.0f), DirectX::XMFLOAT2(1, 1) },
-             { DirectX::XMFLOAT3(-1.0f, 1.0f, 0.0f), DirectX::XMFLOAT2(0, 0) },
-             { DirectX::XMFLOAT3(1.0f, 1.0f, 0.0f), DirectX::XMFLOAT2(1, 0) },
-             { DirectX::XMFLOAT3(-1.0f, -1.0f, 0.0f), DirectX::XMFLOAT2(0, 1) },
-        };
+        // Memory taken by the buffers of the mesh
+        outMesh.m_NumBytes = meshData.mv_Vertices.size() * sizeof(VertexDx11) + meshData.mv_Indices.size() * sizeof(uint32_t)
+            + sizeof(ConstBufferDx11::MaterialBufferColorPass) + sizeof(ConstBufferDx11::MaterialBufferSpecularPass);
 
-        GraphicsDx11::CreateDeferredVertexBufferCritical(v, mp_BlendingPlaneBuffer.GetAddressOf(), this);
+        return true;
     }
 
-    void GraphicsDx11::RenderColorBuffer(int layer)
+    /*
+        Appends raw bytes of values to serialized data
+    */
+    template<typename T>
+    static void WriteValues(std::vector<uint8_t>& v_Data, const T* p_Values, size_t count)
     {
-        float color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-        mp_Context->ClearRenderTargetView(mp_RenderTarget.Get(), color);
-        mp_Context->ClearDepthStencilView(mp_DepthView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+        const uint8_t* p_Bytes = (const uint8_t*)p_Values;
+        v_Data.insert(v_Data.end(), p_Bytes, p_Bytes + count * sizeof(T));
+    }
 
-        for (auto& object : mv_Objects)
-        {
-            if (object->GetLayer() != layer) continue;
+    /*
+        Reads raw values from serialized data.
+        Returns false if the data ends before all values are read.
+    */
+    template<typename T>
+    static bool ReadValues(const std::vector<uint8_t>& v_Data, size_t& offset, T* p_Values, size_t count)
+    {
+        if (count > (v_Data.size() - offset) / sizeof(T)) return false;
 
-            for (auto& shader : mv_Shaders)
-            {
-                if (shader.GetShaderUID() != object->GetColorShader()) continue;
+        memcpy(p_Values, v_Data.data() + offset, count * sizeof(T));
+        offset += count * sizeof(T);
+        return true;
+    }
 
-                mp_Context->VSSetShader(shader.mp_VertexShader.Get(), nullptr, 0);
-                mp_Context->PSSetShader(shader.mp_PixelShader.Get(), nullptr, 0);
-                mp_Context->IASetInputLayout(shader.mp_InputLayout.Get());
-            }
+    /*
+        Appends number of elements followed by the elements to serialized data
+    */
+    template<typename T>
+    static void WriteVector(std::vector<uint8_t>& v_Data, const std::vector<T>& v_Values)
+    {
+        uint32_t count = (uint32_t)v_Values.size();
+        WriteValues(v_Data, &count, 1);
+        WriteValues(v_Data, v_Values.data(), v_Values.size());
+    }
 
-            ConstBufferDx11::MvpBuffer mvp = {};
+    /*
+        Reads vector written by WriteVector().
+        Returns false if the data ends before all elements are read.
+    */
+    template<typename T>
+    static bool ReadVector(const std::vector<uint8_t>& v_Data, size_t& offset, std::vector<T>& v_OutValues)
+    {
+        uint32_t count = 0;
+        if (!ReadValues(v_Data, offset, &count, 1)) return false;
 
-            if (mp_Camera != nullptr)
-            {
-                float fov = 60.0f / 360.0f * DirectX::XM_PIDIV2;
-                mvp.m_Proj = DirectX::XMMatrixPerspectiveFovLH(fov, 1280.0f / 720.0f, 0.01f, 1000.0f);
-                mvp.m_Proj = mp_Camera->GetProjectionMatrix();
-                mvp.m_View = mp_Camera->GetViewMatrix();
-            }
+        // Check the size before allocating so damaged counts can't request huge allocations
+        if (count > (v_Data.size() - offset) / sizeof(T)) return false;
 
-            for (auto& model : mv_Models)
-            {
-                if (model.GetModelUID() != object->GetModel()) continue;
-
-                mvp.m_Model = ConvertUtils::Mat4x4ToXmMatrix(object->GetWorldMatrix());
-                mp_Context->UpdateSubresource(model.mp_ConstBufferMVP.Get(), 0, nullptr, &mvp, 0, 0);
-                mp_Context->VSSetConstantBuffers(0, 1, model.mp_ConstBufferMVP.GetAddressOf());
-                mp_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-                
-                for (auto& mesh : model.mv_Meshes)
-                {
-                    if (mesh.m_MaterialId != 0)
-                    {
-                        for (const auto& mat : mv_Materials)
-                        {
-                            if (mat.GetMaterialUID() != mesh.m_MaterialId) continue;
+        v_OutValues.resize(count);
+        return ReadValues(v_Data, offset, v_OutValues.data(), count);
+    }
 
-                            ConstBufferDx11::MaterialBufferColorPass cpBuffer = {};
-                            cpBuffer.m_BaseColor = ConvertUtils::Vec4ToXmFloat4(mat.GetBaseColor());
-                            cpBuffer.m_SubColor = ConvertUtils::Vec4ToXmFloat4(mat.GetSubColor());
-                            
-                            mp_Context->UpdateSubresource(mesh.mp_ColorPassBuffer.Get(), 0, nullptr, &cpBuffer, 0, 0);
-                            mp_Context->PSSetConstantBuffers(0, 1, mesh.mp_ColorPassBuffer.GetAddressOf());
+    /*
+        Turns decoded texture into bytes stored in asset cache
+    */
+    std::vector<uint8_t> GraphicsDx11::SerializeTexture(const DecodedTexture& texture)
+    {
+        std::vector<uint8_t> v_Data;
+        v_Data.reserve(sizeof(uint32_t) * 3 + texture.mv_Pixels.size());
 
-                            for (const auto& texture : mv_Textures)
-                            {
-                                if (texture.GetTextureUID() != mat.GetDiffuseTextureId()) continue;
+        WriteValues(v_Data, &texture.m_Width, 1);
+        WriteValues(v_Data, &texture.m_Height, 1);
+        WriteVector(v_Data, texture.mv_Pixels);
 
-                                mp_Context->PSSetShaderResources(0, 1, texture.mp_ResourceView.GetAddressOf());
-                            }
+        return v_Data;
+    }
 
-                        }
+    /*
+        Reads texture written by SerializeTexture().
+        Returns false if the data is incomplete.
+    */
+    bool GraphicsDx11::DeserializeTexture(const std::vector<uint8_t>& v_Data, DecodedTexture& outTexture)
+    {
+        size_t offset = 0;
 
-                        
-                    }
+        if (!ReadValues(v_Data, offset, &outTexture.m_Width, 1) ||
+            !ReadValues(v_Data, offset, &outTexture.m_Height, 1) ||
+            !ReadVector(v_Data, offset, outTexture.mv_Pixels))
+            return false;
 
-                    UINT stride = sizeof(VertexDx11);
-                    UINT offset = 0;
-                    mp_Context->IASetVertexBuffers(0, 1, mesh.mp_VertexBuffer.GetAddressOf(), &stride, &offset);
-                    mp_Context->IASetIndexBuffer(mesh.mp_IndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
-                    mp_Context->DrawIndexed(mesh.m_NumIndices, 0, 0);
-                }
-            }
-        }
+        // Texture is stored as 4 bytes per pixel
+        return outTexture.mv_Pixels.size() == (size_t)outTexture.m_Width * outTexture.m_Height * 4;
     }
 
-    void GraphicsDx11::RenderSpecularBuffer(int layer)
+    /*
+        Turns meshes imported by ASSIMP into bytes stored in asset cache
+    */
+    std::vector<uint8_t> GraphicsDx11::SerializeMeshes(const std::vector<MeshData>& v_Meshes)
     {
-        float color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-        mp_Context->ClearRenderTargetView(mp_RenderTarget.Get(), color);
-        mp_Context->ClearDepthStencilView(mp_DepthView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
-
-        for (auto& object : mv_Objects)
-        {
-            if (object->GetLayer() != layer) continue;
+        std::vector<uint8_t> v_Data;
 
-            for (auto& shader : mv_Shaders)
-            {
-                if (shader.GetShaderUID() != object->GetSpecularShader()) continue;
+        uint32_t numMeshes = (uint32_t)v_Meshes.size();
+        WriteValues(v_Data, &numMeshes, 1);
 
-                mp_Context->VSSetShader(shader.mp_VertexShader.Get(), nullptr, 0);
-                mp_Context->PSSetShader(shader.mp_PixelShader.Get(), nullptr, 0);
-                mp_Context->IASetInputLayout(shader.mp_InputLayout.Get());
-            }
+        for (const auto& mesh : v_Meshes)
+        {
+            WriteVector(v_Data, mesh.mv_Vertices);
+            WriteVector(v_Data, mesh.mv_Indices);
+            WriteVector(v_Data, std::vector<char>(mesh.m_MeshMatName.begin(), mesh.m_MeshMatName.end()));
+        }
 
-            ConstBufferDx11::MvpBuffer mvp = {};
+        return v_Data;
+    }
 
-            if (mp_Camera != nullptr)
-            {
-                float fov = 60.0f / 360.0f * DirectX::XM_PIDIV2;
-                mvp.m_Proj = DirectX::XMMatrixPerspectiveFovLH(fov, 1280.0f / 720.0f, 0.01f, 1000.0f);
-                mvp.m_Proj = mp_Camera->GetProjectionMatrix();
-                mvp.m_View = mp_Camera->GetViewMatrix();
-            }
+    /*
+        Reads meshes written by SerializeMeshes().
+        Returns false if the data is incomplete.
+    */
+    bool GraphicsDx11::DeserializeMeshes(const std::vector<uint8_t>& v_Data, std::vector<MeshData>& v_OutMeshes)
+    {
+        size_t offset = 0;
+        uint32_t numMeshes = 0;
 
-            for (auto& model : mv_Models)
-            {
-                if (model.GetModelUID() != object->GetModel()) continue;
+        if (!ReadValues(v_Data, offset, &numMeshes, 1)) return false;
 
-                mvp.m_Model = ConvertUtils::Mat4x4ToXmMatrix(object->GetWorldMatrix());
-                mp_Context->UpdateSubresource(model.mp_ConstBufferMVP.Get(), 0, nullptr, &mvp, 0, 0);
-                mp_Context->VSSetConstantBuffers(0, 1, model.mp_ConstBufferMVP.GetAddressOf());
-                mp_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        std::vector<MeshData> v_Meshes;
 
-                for (auto& mesh : model.mv_Meshes)
-                {
-                    if (mesh.m_MaterialId != 0)
-                    {
-                        for (const auto& mat : mv_Materials)
-                        {
-                            if (mat.GetMaterialUID() != mesh.m_MaterialId) continue;
+        for (uint32_t i = 0; i < numMeshes; i++)
+        {
+            MeshData mesh;
+            std::vector<char> v_MatName;
 
-                            ConstBufferDx11::MaterialBufferSpecularPass spBuffer = {};
+            if (!ReadVector(v_Data, offset, mesh.mv_Vertices) ||
+                !ReadVector(v_Data, offset, mesh.mv_Indices) ||
+                !ReadVector(v_Data, offset, v_MatName))
+                return false;
 
-                            spBuffer.m_SpecularPower = mat.GetSpecularPower();
+            mesh.m_MeshMatName = std::string(v_MatName.begin(), v_MatName.end());
+            v_Meshes.push_back(std::move(mesh));
+        }
 
-                            mp_Context->UpdateSubresource(mesh.mp_SpecularPassBuffer.Get(), 0, nullptr, &spBuffer, 0, 0);
-                            mp_Context->PSSetConstantBuffers(0, 1, mesh.mp_SpecularPassBuffer.GetAddressOf());
+        v_OutMeshes = std::move(v_Meshes);
+        return true;
+    }
 
-                            for (const auto& texture : mv_Textures)
-                            {
-                                if (texture.GetTextureUID() != mat.GetSpecularTextureId()) continue;
+    void GraphicsDx11::InitializeBlendingMesh()
+    {
+        std::vector<DeferredVertexDx11> v = {
+             { DirectX::XMFLOAT3(-1.0f, -1.0f, 0.0f), DirectX::XMFLOAT2(0, 1) },
+             { DirectX::XMFLOAT3(1.0f, 1.0f, 0.0f), DirectX::XMFLOAT2(1, 0) },
+             { DirectX::XMFLOAT3(1.0f, -1.0f, 0.0f), DirectX::XMFLOAT2(1, 1) },
+             { DirectX::XMFLOAT3(-1.0f, 1.0f, 0.0f), DirectX::XMFLOAT2(0, 0) },
+             { DirectX::XMFLOAT3(1.0f, 1.0f, 0.0f), DirectX::XMFLOAT2(1, 0) },
+             { DirectX::XMFLOAT3(-1.0f, -1.0f, 0.0f), DirectX::XMFLOAT2(0, 1) },
+        };
 
-                                mp_Context->PSSetShaderResources(0, 1, texture.mp_ResourceView.GetAddressOf());
-                            }
+        GraphicsDx11::CreateDeferredVertexBufferCritical(v, mp_BlendingPlaneBuffer.GetAddressOf(), this);
+    }
 
-                        }
+    /*
+        Draws queued meshes of one pass of a layer.
+        Objects of instanced shaders that share a mesh are drawn by a single instanced draw call
+        with their world matrices read from the instance buffer.
+        Batches are recorded into draw streams by workers, constants of the streams are copied
+        into the upload ring, and the streams are replayed in order.
+    */
+    void GraphicsDx11::SubmitDrawItems(uint32_t layer, DrawPass pass)
+    {
+        m_InstanceBatcher.Build(m_RenderQueue.GetItems(layer, pass), [this](uint32_t shaderId)
+        {
+            const ShaderDx11* p_Shader = m_Shaders.Get(shaderId);
+            return p_Shader != nullptr && p_Shader->IsInstanced();
+        });
 
+        RecordDrawStreams(pass);
+        UploadDrawStreams();
 
-                    }
+        bool hasInstances = UploadInstances(m_InstanceBatcher.GetInstances());
 
-                    UINT stride = sizeof(VertexDx11);
-                    UINT offset = 0;
-                    mp_Context->IASetVertexBuffers(0, 1, mesh.mp_VertexBuffer.GetAddressOf(), &stride, &offset);
-                    mp_Context->IASetIndexBuffer(mesh.mp_IndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
-                    mp_Context->DrawIndexed(mesh.m_NumIndices, 0, 0);
-                }
-            }
-        }
+        ReplayDrawStreams(pass, hasInstances);
     }
 
-    void GraphicsDx11::BlendLayers()
+    /*
+        Records batches of the pass into draw streams on the job system.
+        Constants are written by the workers, so writers only read camera and assets.
+    */
+    void GraphicsDx11::RecordDrawStreams(DrawPass pass)
     {
-        if (m_BlendingShaderId == 0) return;
+        ConstBufferDx11::MvpBuffer mvp = {};
 
-        float color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-        mp_Context->ClearRenderTargetView(mp_RenderTarget.Get(), color);
-        mp_Context->ClearDepthStencilView(mp_DepthView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
-
-        for (const auto& shader : mv_Shaders)
+        if (mp_Camera != nullptr)
         {
-            if (m_BlendingShaderId != shader.GetShaderUID()) continue;
-
-            mp_Context->VSSetShader(shader.mp_VertexShader.Get(), nullptr, 0);
-            mp_Context->PSSetShader(shader.mp_PixelShader.Get(), nullptr, 0);
-            mp_Context->IASetInputLayout(shader.mp_InputLayout.Get());
+            mvp.m_Proj = mp_Camera->GetProjectionMatrix();
+            mvp.m_View = mp_Camera->GetViewMatrix();
         }
 
-        mp_Context->PSSetShaderResources(0, 1, mp_ColorResourceView.GetAddressOf());
-        mp_Context->PSSetShaderResources(1, 1, mp_PrevColorResourceView.GetAddressOf());
-
-        UINT stride = sizeof(DeferredVertexDx11);
-        UINT offset = 0;
-        mp_Context->IASetVertexBuffers(0, 1, mp_BlendingPlaneBuffer.GetAddressOf(), &stride, &offset);
-        mp_Context->Draw(6, 0);
+        DrawConstantWriters writers;
+        writers.m_MvpSize = sizeof(ConstBufferDx11::MvpBuffer);
+        writers.m_MaterialSize = pass == DrawPass_Color ? sizeof(ConstBufferDx11::MaterialBufferColorPass) : sizeof(ConstBufferDx11::MaterialBufferSpecularPass);
 
-        mp_Context->CopyResource(mp_PrevLayerColorBuffer.Get(), mp_BackBuffer.Get());
+        // Instanced draws read world matrices from the instance buffer, their MVP constants hold identity model matrix
+        writers.m_WriteMvp = [&mvp](const GameObject3D* p_Object, uint8_t* p_Out)
+        {
+            ConstBufferDx11::MvpBuffer objectMvp = mvp;
+            objectMvp.m_Model = p_Object != nullptr ? ConvertUtils::Mat4x4ToXmMatrix(p_Object->GetWorldMatrix()) : DirectX::XMMatrixIdentity();
 
-        mp_Context->ClearRenderTargetView(mp_RenderTarget.Get(), color);
-        mp_Context->ClearDepthStencilView(mp_DepthView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+            memcpy(p_Out, &objectMvp, sizeof(objectMvp));
+        };
 
-        for (const auto& shader : mv_Shaders)
+        writers.m_WriteMaterial = [this, pass](uint32_t materialId, uint8_t* p_Out)
         {
-            if (m_BlendingShaderId != shader.GetShaderUID()) continue;
+            const Material* p_Material = m_Materials.Get(materialId);
+            if (p_Material == nullptr) return false;
 
-            mp_Context->VSSetShader(shader.mp_VertexShader.Get(), nullptr, 0);
-            mp_Context->PSSetShader(shader.mp_PixelShader.Get(), nullptr, 0);
-            mp_Context->IASetInputLayout(shader.mp_InputLayout.Get());
-        }
+            if (pass == DrawPass_Color)
+            {
+                ConstBufferDx11::MaterialBufferColorPass cpBuffer = {};
+                cpBuffer.m_BaseColor = ConvertUtils::Vec4ToXmFloat4(p_Material->GetBaseColor());
+                cpBuffer.m_SubColor = ConvertUtils::Vec4ToXmFloat4(p_Material->GetSubColor());
+
+                memcpy(p_Out, &cpBuffer, sizeof(cpBuffer));
+            }
+            else
+            {
+                ConstBufferDx11::MaterialBufferSpecularPass spBuffer = {};
+                spBuffer.m_SpecularPower = p_Material->GetSpecularPower();
 
-        mp_Context->PSSetShaderResources(0, 1, mp_SpecResourceView.GetAddressOf());
-        mp_Context->PSSetShaderResources(1, 1, mp_PrevSpecResourceView.GetAddressOf());
+                memcpy(p_Out, &spBuffer, sizeof(spBuffer));
+            }
 
-        mp_Context->IASetVertexBuffers(0, 1, mp_BlendingPlaneBuffer.GetAddressOf(), &stride, &offset);
-        mp_Context->Draw(6, 0);
+            return true;
+        };
 
-        mp_Context->CopyResource(mp_PrevLayerSpecBuffer.Get(), mp_BackBuffer.Get());
+        m_DrawRecorder.Record(m_InstanceBatcher.GetBatches(), writers);
     }
 
     /*
-        Loads material definitions from specific file
+        Copies constants of all draw streams of the pass into the upload ring, mapping the buffer only once.
+        If the ring is full, waits for frames in flight, and creates a larger buffer when the frame doesn't fit even into an empty ring.
     */
-    std::map<std::string, std::string> GraphicsDx11::LoadMaterialDefinitions(const std::string& matDefName)
+    void GraphicsDx11::UploadDrawStreams()
     {
-        std::map<std::string, std::string> result;
-
-        // Use lookup table to find in which pack the model is contained in
-        // and what index it has
-        auto entryData = LookUpUtils::FindByFileNameOnly(matDefName);
-
-        // Validate lookup results
-        if (entryData.m_PackName.empty())
+        while (true)
         {
-            LOG_F(ERROR, "Could not find %s in lookup table!", matDefName.c_str());
-            return result;
-        }
+            if (mp_Context1.Get() == nullptr)
+            {
+                if (CopyDrawStreams(mv_UploadStaging.data())) return;
+            }
+            else
+            {
+                // Frames in flight and earlier passes own the rest of the buffer, so only a new buffer may be discarded
+                D3D11_MAP mapType = m_IsUploadBufferNew ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+                D3D11_MAPPED_SUBRESOURCE mapped = {};
+                THROW_IF_FAILED_DX(mp_Context->Map(mp_UploadBuffer.Get(), 0, mapType, 0, &mapped));
+                m_IsUploadBufferNew = false;
 
-        // Read pack contents
-        std::string packPath = FileUtils::CombinePaths(ConfigUtils::GetValueFromConfigCS("Path", "Model"), entryData.m_PackName);
-        std::vector<uint8_t> v_PackData = FileUtils::ReadBinaryData(packPath);
+                bool result = CopyDrawStreams((uint8_t*)mapped.pData);
+                mp_Context->Unmap(mp_UploadBuffer.Get(), 0);
 
-        // Calculate where file details are
-        uint32_t headerPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * entryData.m_Index;
+                if (result) return;
+            }
 
-        // Validate calculation results
-        if (headerPos >= v_PackData.size())
-        {
-            LOG_F(ERROR, "Invalid header position of %s", matDefName.c_str());
-            return result;
+            if (m_UploadRing.GetNumFramesInFlight() > 0)
+            {
+                ReleaseCompletedFrames(true);
+                continue;
+            }
+
+            LOG_F(WARNING, "Constants of a frame don't fit into %llu bytes, upload ring will grow", m_UploadRing.GetCapacity());
+            CreateUploadBuffer(m_UploadRing.GetCapacity() * 2);
         }
+    }
 
-        // Calculate where file data starts
-        uint64_t startPos = 0;
-        memcpy(&startPos, &v_PackData[headerPos], sizeof(uint64_t));
+    /*
+        Allocates constants of every stream from the upload ring in the order of the streams and copies them to p_Data.
+        Returns false if the ring is full, slices of streams that did fit are freed again, so the whole pass is allocated on retry.
+    */
+    bool GraphicsDx11::CopyDrawStreams(uint8_t* p_Data)
+    {
+        UploadRing::Checkpoint checkpoint = m_UploadRing.GetCheckpoint();
 
-        // Validate calculation results
-        if (startPos <= headerPos)
+        for (auto& stream : m_DrawRecorder.GetStreams())
         {
-            LOG_F(ERROR, "Invalid starting position of %s", matDefName.c_str());
-            return result;
-        }
+            if (stream.mv_Constants.empty()) continue;
 
-        // Grab file size
-        uint32_t fileSize = 0;
-        memcpy(&fileSize, &v_PackData[headerPos + sizeof(uint64_t)], sizeof(uint32_t));
+            if (!m_UploadRing.Allocate(stream.mv_Constants.size(), stream.m_ConstantOffset))
+            {
+                m_UploadRing.Rollback(checkpoint);
+                return false;
+            }
 
-        // Validate file size
-        if (fileSize <= 0)
-        {
-            LOG_F(ERROR, "Invalid size of %s", matDefName.c_str());
-            return result;
+            memcpy(p_Data + stream.m_ConstantOffset, stream.mv_Constants.data(), stream.mv_Constants.size());
         }
 
-        // Load matdef data
-        std::vector<uint8_t> v_MatDefData(fileSize);
-        memcpy(&v_MatDefData[0], &v_PackData[startPos - 1], fileSize);
-
-        std::string matDefText = std::string(v_MatDefData.begin(), v_MatDefData.end());
+        return true;
+    }
 
-        matDefText = ConvertUtils::RemoveCharFromString(matDefText, '\r');
-        std::vector<std::string> v_Lines = ConvertUtils::SplitStringByChar(matDefText, '\n');
+    /*
+        Replays draw streams of the pass. If the driver supports command lists, streams are split into
+        contiguous ranges that are replayed by workers on deferred contexts, and their command lists
+        are executed in the order of the ranges. Otherwise streams are replayed on the immediate context.
+    */
+    void GraphicsDx11::ReplayDrawStreams(DrawPass pass, bool hasInstances)
+    {
+        std::span<DrawStream> streams = m_DrawRecorder.GetStreams();
 
-        for (const auto& line : v_Lines)
+        if (mv_DeferredContexts.empty() || streams.size() < 2)
         {
-            std::vector<std::string> v_Params = ConvertUtils::SplitStringByChar(line, '=');
+            if (hasInstances)
+            {
+                UINT stride = sizeof(glm::mat4x4);
+                UINT offset = 0;
+                mp_Context->IASetVertexBuffers(1, 1, mp_InstanceBuffer.GetAddressOf(), &stride, &offset);
+            }
+
+            mp_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+            for (const auto& stream : streams)
+                ReplayDrawStream(mp_Context.Get(), mp_Context1.Get(), stream, pass, hasInstances);
+
+            return;
+        }
+
+        // Deferred contexts start with default state, so they get the state of the pass from the immediate context
+        Microsoft::WRL::ComPtr<ID3D11RenderTargetView> p_Target;
+        Microsoft::WRL::ComPtr<ID3D11DepthStencilView> p_DepthView;
+        mp_Context->OMGetRenderTargets(1, p_Target.GetAddressOf(), p_DepthView.GetAddressOf());
+
+        D3D11_VIEWPORT viewport = {};
+        UINT numViewports = 1;
+        mp_Context->RSGetViewports(&numViewports, &viewport);
+
+        size_t numContexts = std::min(streams.size(), mv_DeferredContexts.size());
+
+        JobSystem::GetDefault().ParallelFor(numContexts, [&](size_t index)
+        {
+            ID3D11DeviceContext1* p_Context = mv_DeferredContexts[index].Get();
+
+            p_Context->OMSetRenderTargets(1, p_Target.GetAddressOf(), p_DepthView.Get());
+            p_Context->OMSetDepthStencilState(mp_DepthState.Get(), 0);
+            p_Context->RSSetViewports(1, &viewport);
+            p_Context->RSSetState(mp_RasterizerState.Get());
+            p_Context->PSSetSamplers(0, 1, mp_Sampler.GetAddressOf());
+            p_Context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+            if (hasInstances)
+            {
+                UINT stride = sizeof(glm::mat4x4);
+                UINT offset = 0;
+                p_Context->IASetVertexBuffers(1, 1, mp_InstanceBuffer.GetAddressOf(), &stride, &offset);
+            }
+
+            size_t begin = streams.size() * index / numContexts;
+            size_t end = streams.size() * (index + 1) / numContexts;
+
+            for (size_t i = begin; i < end; i++)
+                ReplayDrawStream(p_Context, p_Context, streams[i], pass, hasInstances);
+
+            THROW_IF_FAILED_DX(p_Context->FinishCommandList(FALSE, mv_CommandLists[index].ReleaseAndGetAddressOf()));
+        });
+
+        // Immediate context gets its state back after every command list, so the next pass starts from it
+        for (size_t i = 0; i < numContexts; i++)
+        {
+            mp_Context->ExecuteCommandList(mv_CommandLists[i].Get(), TRUE);
+            mv_CommandLists[i].Reset();
+        }
+    }
+
+    /*
+        Replays commands of a draw stream on the context.
+        p_Context1 is the same context if constants can be bound by offset, null otherwise.
+        Commands of assets that are no longer loaded are skipped.
+    */
+    void GraphicsDx11::ReplayDrawStream(ID3D11DeviceContext* p_Context, ID3D11DeviceContext1* p_Context1, const DrawStream& stream, DrawPass pass, bool hasInstances)
+    {
+        const MeshDx11* p_Mesh = nullptr;
+        ID3D11ShaderResourceView* p_BoundTexture = nullptr;
+
+        for (const auto& command : stream.mv_Commands)
+        {
+            switch (command.m_Type)
+            {
+            case DrawCommandType_SetShader:
+            {
+                const ShaderDx11* p_Shader = m_Shaders.Get(command.m_Id);
+
+                if (p_Shader != nullptr)
+                {
+                    p_Context->VSSetShader(p_Shader->mp_VertexShader.Get(), nullptr, 0);
+                    p_Context->PSSetShader(p_Shader->mp_PixelShader.Get(), nullptr, 0);
+                    p_Context->IASetInputLayout(p_Shader->mp_InputLayout.Get());
+                }
+
+                break;
+            }
+            case DrawCommandType_SetMvp:
+            {
+                const ModelDx11* p_Model = m_Models.Get(command.m_Id);
+
+                if (p_Model != nullptr)
+                    BindConstants(p_Context, p_Context1, false, stream.m_ConstantOffset + command.m_Offset, sizeof(ConstBufferDx11::MvpBuffer), p_Model->mp_ConstBufferMVP.Get());
+
+                break;
+            }
+            case DrawCommandType_SetMesh:
+            {
+                const ModelDx11* p_Model = m_Models.Get(command.m_Id);
+                p_Mesh = p_Model != nullptr ? &p_Model->mv_Meshes[command.m_MeshIndex] : nullptr;
+
+                if (p_Mesh != nullptr)
+                {
+                    UINT stride = sizeof(VertexDx11);
+                    UINT offset = 0;
+                    p_Context->IASetVertexBuffers(0, 1, p_Mesh->mp_VertexBuffer.GetAddressOf(), &stride, &offset);
+                    p_Context->IASetIndexBuffer(p_Mesh->mp_IndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+                }
+
+                break;
+            }
+            case DrawCommandType_SetMaterial:
+            {
+                const Material* p_Material = m_Materials.Get(command.m_Id);
+                if (p_Mesh == nullptr || p_Material == nullptr) break;
+
+                uint64_t offset = stream.m_ConstantOffset + command.m_Offset;
+                uint32_t textureId = 0;
+
+                if (pass == DrawPass_Color)
+                {
+                    BindConstants(p_Context, p_Context1, true, offset, sizeof(ConstBufferDx11::MaterialBufferColorPass), p_Mesh->mp_ColorPassBuffer.Get());
+                    textureId = p_Material->GetDiffuseTextureId();
+                }
+                else
+                {
+                    BindConstants(p_Context, p_Context1, true, offset, sizeof(ConstBufferDx11::MaterialBufferSpecularPass), p_Mesh->mp_SpecularPassBuffer.Get());
+                    textureId = p_Material->GetSpecularTextureId();
+                }
+
+                const TextureDx11* p_Texture = m_Textures.Use(textureId, m_FrameIndex);
+
+                if (p_Texture != nullptr && p_Texture->mp_ResourceView.Get() != p_BoundTexture)
+                {
+                    p_Context->PSSetShaderResources(0, 1, p_Texture->mp_ResourceView.GetAddressOf());
+                    p_BoundTexture = p_Texture->mp_ResourceView.Get();
+                }
+
+                break;
+            }
+            case DrawCommandType_Draw:
+            {
+                if (p_Mesh != nullptr) p_Context->DrawIndexed(p_Mesh->m_NumIndices, 0, 0);
+                break;
+            }
+            case DrawCommandType_DrawInstanced:
+            {
+                // Instances can only be drawn if their matrices reached the GPU
+                if (p_Mesh != nullptr && hasInstances) p_Context->DrawIndexedInstanced(p_Mesh->m_NumIndices, command.m_NumInstances, 0, 0, command.m_FirstInstance);
+                break;
+            }
+            }
+        }
+    }
+
+    /*
+        Binds constants at the offset of the upload ring to slot 0 of the vertex or pixel shader.
+        Without D3D11.1 offsets p_Context1 is null, and the constants are copied from staging memory into p_Buffer, which is bound instead.
+    */
+    void GraphicsDx11::BindConstants(ID3D11DeviceContext* p_Context, ID3D11DeviceContext1* p_Context1, bool isPixelStage, uint64_t offset, uint32_t size, ID3D11Buffer* p_Buffer)
+    {
+        if (p_Context1 != nullptr)
+        {
+            // Offsets and sizes are in 16 byte constants
+            UINT firstConstant = (UINT)(offset / 16);
+            UINT numConstants = (UINT)(UploadRing::AlignSize(size) / 16);
+
+            if (isPixelStage)
+                p_Context1->PSSetConstantBuffers1(0, 1, mp_UploadBuffer.GetAddressOf(), &firstConstant, &numConstants);
+            else
+                p_Context1->VSSetConstantBuffers1(0, 1, mp_UploadBuffer.GetAddressOf(), &firstConstant, &numConstants);
+
+            return;
+        }
+
+        p_Context->UpdateSubresource(p_Buffer, 0, nullptr, mv_UploadStaging.data() + offset, 0, 0);
+
+        if (isPixelStage)
+            p_Context->PSSetConstantBuffers(0, 1, &p_Buffer);
+        else
+            p_Context->VSSetConstantBuffers(0, 1, &p_Buffer);
+    }
+
+    /*
+        Creates the buffer of the upload ring and resets the ring to its size.
+        Old buffer may still be read by frames in flight, D3D keeps it alive until they finish.
+    */
+    void GraphicsDx11::CreateUploadBuffer(uint64_t capacity)
+    {
+        m_UploadRing.Reset(UploadRing::AlignSize(capacity));
+        m_IsUploadBufferNew = true;
+
+        if (mp_Context1.Get() == nullptr)
+        {
+            mv_UploadStaging.resize(m_UploadRing.GetCapacity());
+            return;
+        }
+
+        mp_UploadBuffer.Reset();
+        CreateCriticalBuffer((uint32_t)m_UploadRing.GetCapacity(), D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE, this, mp_UploadBuffer.GetAddressOf());
+    }
+
+    /*
+        Returns space of frames the GPU has finished to the upload ring.
+        If waitForOldest is set, blocks until at least the oldest frame in flight finishes.
+    */
+    void GraphicsDx11::ReleaseCompletedFrames(bool waitForOldest)
+    {
+        while (m_UploadRing.GetNumFramesInFlight() > 0)
+        {
+            uint64_t frameIndex = m_UploadRing.GetOldestFrame();
+            ID3D11Query* p_Fence = ma_FrameFences[frameIndex % UploadRing::MAX_FRAMES_IN_FLIGHT].Get();
+
+            // Only a wait may flush the command buffer
+            UINT flags = waitForOldest ? 0 : D3D11_ASYNC_GETDATA_DONOTFLUSH;
+
+            if (mp_Context->GetData(p_Fence, nullptr, 0, flags) == S_OK)
+            {
+                m_UploadRing.ReleaseFrames(frameIndex);
+                waitForOldest = false;
+                continue;
+            }
+
+            if (!waitForOldest) return;
+            std::this_thread::yield();
+        }
+    }
+
+    /*
+        Copies world matrices of instanced draws into the instance buffer.
+        Buffer is discarded on every upload and grows to twice the needed size when it is too small.
+        Returns false if there is nothing to draw or the buffer could not be written.
+    */
+    bool GraphicsDx11::UploadInstances(std::span<const glm::mat4x4> instances)
+    {
+        if (instances.empty()) return false;
+
+        if (instances.size() > m_InstanceCapacity)
+        {
+            uint32_t capacity = std::max((uint32_t)instances.size() * 2, m_InstanceCapacity * 2);
+            bool result = false;
+
+            mp_InstanceBuffer.Reset();
+            m_InstanceCapacity = 0;
+
+            CreateEmptyBuffer(capacity * sizeof(glm::mat4x4), D3D11_BIND_VERTEX_BUFFER, D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE, this, mp_InstanceBuffer.GetAddressOf(), result);
+
+            if (!result)
+            {
+                LOG_F(ERROR, "Could not create instance buffer for %u objects", capacity);
+                return false;
+            }
+
+            m_InstanceCapacity = capacity;
+        }
+
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        if (FAILED(mp_Context->Map(mp_InstanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) return false;
+
+        memcpy(mapped.pData, instances.data(), instances.size_bytes());
+        mp_Context->Unmap(mp_InstanceBuffer.Get(), 0);
+
+        return true;
+    }
+
+    /*
+        Draws plane that blends the layer with the previous layers into the bound render target
+    */
+    void GraphicsDx11::BlendLayer(ID3D11ShaderResourceView* p_Layer, ID3D11ShaderResourceView* p_Previous)
+    {
+        const ShaderDx11* p_Shader = m_Shaders.Get(m_BlendingShaderId);
+        if (p_Shader == nullptr) return;
+
+        mp_Context->VSSetShader(p_Shader->mp_VertexShader.Get(), nullptr, 0);
+        mp_Context->PSSetShader(p_Shader->mp_PixelShader.Get(), nullptr, 0);
+        mp_Context->IASetInputLayout(p_Shader->mp_InputLayout.Get());
+
+        mp_Context->PSSetShaderResources(0, 1, &p_Layer);
+        mp_Context->PSSetShaderResources(1, 1, &p_Previous);
+
+        UINT stride = sizeof(DeferredVertexDx11);
+        UINT offset = 0;
+        mp_Context->IASetVertexBuffers(0, 1, mp_BlendingPlaneBuffer.GetAddressOf(), &stride, &offset);
+        mp_Context->Draw(6, 0);
+    }
+
+    /*
+        Adds passes of all layers to the frame graph, layers are blended only if the blending shader is loaded
+    */
+    void GraphicsDx11::BuildFrameGraph()
+    {
+        m_FrameGraph.Reset();
+        m_BackBufferResource = m_FrameGraph.ImportTexture("BackBuffer", m_BackBufferDesc, FrameResourceState_Present);
+
+        auto getResourceView = [this](const FrameGraph& graph, FrameResource resource)
+        {
+            uint32_t texture = graph.GetTexture(resource);
+            return texture < mv_FrameTextures.size() ? mv_FrameTextures[texture].mp_ResourceView.Get() : nullptr;
+        };
+
+        FrameBlendFunction blend;
+
+        if (m_Shaders.Get(m_BlendingShaderId) != nullptr)
+        {
+            blend = [this, getResourceView](const FrameGraph& graph, FrameResource target, FrameResource layer, FrameResource previous)
+            {
+                BeginFramePass(graph, target);
+                BlendLayer(getResourceView(graph, layer), getResourceView(graph, previous));
+            };
+        }
+
+        m_FrameGraph.AddLayerPasses(m_BackBufferResource, m_BackBufferDesc, m_NumLayers, [this](const FrameGraph& graph, FrameResource target, uint32_t layer, DrawPass pass)
+        {
+            BeginFramePass(graph, target);
+            SubmitDrawItems(layer, pass);
+        }, blend);
+    }
+
+    /*
+        Creates physical textures of the compiled frame graph that don't exist yet or changed their size or format.
+        Textures are kept between frames, so they are only created again when the graph changes.
+    */
+    void GraphicsDx11::CreateFrameTextures()
+    {
+        mv_FrameTextures.resize(m_FrameGraph.GetNumTextures());
+
+        for (uint32_t i = 0; i < mv_FrameTextures.size(); i++)
+        {
+            FrameTextureDx11& texture = mv_FrameTextures[i];
+
+            // Imported textures belong to the swap chain
+            if (m_FrameGraph.GetImportedResource(i) != 0)
+            {
+                texture = FrameTextureDx11();
+                continue;
+            }
+
+            const FrameTextureDesc& desc = m_FrameGraph.GetTextureDesc(i);
+            if (texture.mp_Texture.Get() != nullptr && texture.m_Desc == desc) continue;
+
+            texture = FrameTextureDx11();
+            texture.m_Desc = desc;
+
+            CreateCriticalTexture(desc.m_Width, desc.m_Height, (DXGI_FORMAT)desc.m_Format, (D3D11_BIND_FLAG)(D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET),
+                this, texture.mp_Texture.GetAddressOf(), texture.mp_ResourceView.GetAddressOf());
+            THROW_IF_FAILED_DX(mp_Device->CreateRenderTargetView(texture.mp_Texture.Get(), nullptr, texture.mp_TargetView.GetAddressOf()));
+        }
+    }
+
+    /*
+        Binds texture of the resource as render target of a pass and clears it together with the depth buffer
+    */
+    void GraphicsDx11::BeginFramePass(const FrameGraph& graph, FrameResource target)
+    {
+        uint32_t texture = graph.GetTexture(target);
+        ID3D11RenderTargetView* p_Target = mp_RenderTarget.Get();
+
+        if (graph.GetImportedResource(texture) != m_BackBufferResource)
+            p_Target = mv_FrameTextures[texture].mp_TargetView.Get();
+
+        mp_Context->OMSetRenderTargets(1, &p_Target, mp_DepthView.Get());
+
+        float color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        mp_Context->ClearRenderTargetView(p_Target, color);
+        mp_Context->ClearDepthStencilView(mp_DepthView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+    }
+
+    /*
+        DirectX 11 tracks states of resources by itself, but a texture can't be bound for reading and writing at once.
+        Textures that stop being read or rendered to are unbound, so the next pass can bind them the other way.
+    */
+    void GraphicsDx11::ApplyFrameBarrier(const FrameBarrier& barrier)
+    {
+        if (barrier.m_Before == FrameResourceState_ShaderRead)
+        {
+            ID3D11ShaderResourceView* pp_Views[2] = { nullptr, nullptr };
+            mp_Context->PSSetShaderResources(0, 2, pp_Views);
+        }
+        else if (barrier.m_Before == FrameResourceState_RenderTarget)
+        {
+            mp_Context->OMSetRenderTargets(0, nullptr, nullptr);
+        }
+    }
+
+    /*
+        Returns texture behind a physical texture of the frame graph
+    */
+    ID3D11Texture2D* GraphicsDx11::GetFrameTexture(uint32_t texture) const
+    {
+        if (m_FrameGraph.GetImportedResource(texture) == m_BackBufferResource) return mp_BackBuffer.Get();
+        return mv_FrameTextures[texture].mp_Texture.Get();
+    }
+
+    /*
+        Reloads loaded assets whose entries changed since the packs were last read.
+        Changed entries are found by comparing hashes in the lookup table, so rewriting a whole pack
+        only reloads assets that are actually different. Reloaded assets keep their IDs, so objects
+        that use them don't have to be updated. Textures are reloaded before materials and materials
+        before models, so assets pick up new versions of assets they depend on.
+        Draws find their shaders by ID when they are replayed, so recompiled shaders are used from the next frame.
+    */
+    void GraphicsDx11::ProcessHotReload()
+    {
+        if (!mp_FileWatcher) return;
+
+        std::vector<std::string> v_ChangedFiles = mp_FileWatcher->PollChanges();
+        if (v_ChangedFiles.empty()) return;
+
+        // Handles of rewritten packs point to their old contents
+        for (const auto& path : v_ChangedFiles)
+            AsyncFileReader::GetDefault().CloseFile(path);
+
+        // New config snapshot is published, assets keep paths they were loaded from
+        if (std::find(v_ChangedFiles.begin(), v_ChangedFiles.end(), "engine.ini") != v_ChangedFiles.end())
+        {
+            EngineConfig::Reload();
+            ReadStreamingSettings();
+            LOG_F(INFO, "Reloaded engine.ini");
+        }
+
+        std::vector<std::string> v_ChangedEntries;
+
+        for (const auto& entry : LookUpUtils::LoadLookupTable())
+        {
+            auto it = m_EntryHashes.find(entry.m_OriginalName);
+            if (it != m_EntryHashes.end() && it->second == entry.m_Hash) continue;
+
+            v_ChangedEntries.push_back(entry.m_OriginalName);
+            m_EntryHashes[entry.m_OriginalName] = entry.m_Hash;
+        }
+
+        // Entries could have moved between packs, so material definitions are indexed and parsed again
+        m_MaterialDefinitions.Clear();
+
+        size_t numReloaded = 0;
+
+        // Shader is recompiled when either its vertex or its pixel part changed
+        std::vector<std::pair<uint32_t, std::string>> v_Shaders;
+
+        m_Shaders.ForEach([&](uint32_t id, ShaderDx11& shader)
+        {
+            if (std::find(v_ChangedEntries.begin(), v_ChangedEntries.end(), shader.GetVertexShaderName()) != v_ChangedEntries.end() ||
+                std::find(v_ChangedEntries.begin(), v_ChangedEntries.end(), shader.GetPixelShaderName()) != v_ChangedEntries.end())
+                v_Shaders.push_back({ id, shader.GetVertexShaderName() });
+        });
+
+        for (const auto& [id, vertexName] : v_Shaders)
+        {
+            if (ReloadShader(id, vertexName)) numReloaded++;
+        }
+
+        for (const auto& name : v_ChangedEntries)
+        {
+            uint32_t id = m_Textures.Find(name);
+            if (id != 0 && ReloadTexture(id, name)) numReloaded++;
+        }
+
+        for (const auto& name : v_ChangedEntries)
+        {
+            uint32_t id = m_Materials.Find(name);
+            if (id != 0 && ReloadMaterial(id, name)) numReloaded++;
+        }
+
+        // Models are also reloaded when their material definitions change
+        std::set<std::string> changedNames;
+        for (const auto& name : v_ChangedEntries)
+            changedNames.insert(FileUtils::StripPathToFileName(name));
+
+        std::vector<std::pair<uint32_t, std::string>> v_Models;
+
+        m_Models.ForEach([&](uint32_t id, ModelDx11& model)
+        {
+            const std::string& modelName = model.GetModelName();
+
+            if (std::find(v_ChangedEntries.begin(), v_ChangedEntries.end(), modelName) != v_ChangedEntries.end() ||
+                changedNames.find(FileUtils::StripPathToFileName(modelName) + ".matdef") != changedNames.end())
+                v_Models.push_back({ id, modelName });
+        });
+
+        for (const auto& [id, modelName] : v_Models)
+        {
+            if (ReloadModel(id, modelName)) numReloaded++;
+        }
+
+        LOG_F(INFO, "Hot reload: %zu changed files, %zu changed entries, %zu assets reloaded", v_ChangedFiles.size(), v_ChangedEntries.size(), numReloaded);
+    }
+
+    /*
+        Compiles new versions of vertex and pixel shader of a loaded shader and swaps them in place of the old ones.
+        Old version stays in use if the new one doesn't compile.
+    */
+    bool GraphicsDx11::ReloadShader(uint32_t id, const std::string& vertexName)
+    {
+        const ShaderDx11* p_Shader = m_Shaders.Get(id);
+        if (p_Shader == nullptr) return false;
+
+        std::string pixelName = p_Shader->GetPixelShaderName();
+        ShaderType type = p_Shader->GetShaderType();
+
+        AssetBlob vertexData = ReadAssetFromPack("Shader", vertexName);
+        AssetBlob pixelData = ReadAssetFromPack("Shader", pixelName);
+        if (vertexData.IsEmpty() || pixelData.IsEmpty()) return false;
+
+        ShaderDx11 shader = {};
+        if (!BuildShader(vertexData, pixelData, type, this, shader)) return false;
+
+        shader.m_ShaderType = type;
+        shader.m_VertexShaderName = vertexName;
+        shader.m_PixelShaderName = pixelName;
+        shader.m_ShaderUID = id;
+
+        if (!m_Shaders.Replace(id, shader, 0)) return false;
+
+        LOG_F(INFO, "Reloaded %s", vertexName.c_str());
+        return true;
+    }
+
+    /*
+        Reads and decodes new version of a loaded texture and swaps it in place of the old one
+    */
+    bool GraphicsDx11::ReloadTexture(uint32_t id, const std::string& textureName)
+    {
+        AssetBlob textureData = ReadAssetFromPack("Texture", textureName);
+        if (textureData.IsEmpty()) return false;
+
+        DecodedTexture decodedTexture = {};
+        if (!DecodeTexture(textureData, textureName, decodedTexture)) return false;
+
+        TextureDx11 texture = {};
+        if (!BuildTexture(decodedTexture, this, texture)) return false;
+
+        texture.m_TextureName = textureName;
+        texture.m_TextureUID = id;
+
+        uint64_t numBytes = (uint64_t)decodedTexture.m_Width * decodedTexture.m_Height * 4;
+        if (!m_Textures.Replace(id, texture, numBytes)) return false;
+
+        LOG_F(INFO, "Reloaded %s", textureName.c_str());
+        return true;
+    }
+
+    /*
+        Reads new version of a loaded material and swaps it in place of the old one.
+        Textures the material didn't use before are loaded first.
+    */
+    bool GraphicsDx11::ReloadMaterial(uint32_t id, const std::string& matName)
+    {
+        AssetBlob matData = ReadAssetFromPack("Material", matName);
+        if (matData.IsEmpty()) return false;
+
+        MaterialDescription description = MaterialFormat::Parse(matData);
+
+        for (const auto& texture : { description.m_DiffuseTexture, description.m_SpecularTexture, description.m_NormalTexture })
+        {
+            if (!texture.empty())
+                LoadTextureFromPack(texture);
+        }
+
+        Material material = BuildMaterial(description, this, matName);
+        material.m_MaterialId = id;
+
+        // New textures are referenced before the old ones are released so shared textures aren't evicted in between
+        for (uint32_t textureId : { material.GetDiffuseTextureId(), material.GetSpecularTextureId(), material.GetNormalTextureId() })
+        {
+            if (textureId != 0) m_Textures.AddReference(textureId);
+        }
+
+        if (!m_Materials.Replace(id, material, sizeof(Material))) return false;
+
+        // After the swap material holds the previous version
+        for (uint32_t textureId : { material.GetDiffuseTextureId(), material.GetSpecularTextureId(), material.GetNormalTextureId() })
+        {
+            if (textureId != 0) m_Textures.ReleaseReference(textureId);
+        }
+
+        LOG_F(INFO, "Reloaded %s", matName.c_str());
+        return true;
+    }
+
+    /*
+        Imports new version of a loaded model and swaps it in place of the old one.
+        Material definitions of the model are read again and missing materials are loaded.
+    */
+    bool GraphicsDx11::ReloadModel(uint32_t id, const std::string& modelName)
+    {
+        AssetBlob modelData = ReadAssetFromPack("Model", modelName);
+        if (modelData.IsEmpty()) return false;
+
+        ModelDx11 model = {};
+        if (!ImportModel(modelData, this, modelName, model)) return false;
+
+        auto matDef = LoadMaterialDefinitions(FileUtils::StripPathToFileName(modelName) + ".matdef");
+        uint64_t numBytes = sizeof(ConstBufferDx11::MvpBuffer);
+
+        for (auto& mesh : model.mv_Meshes)
+        {
+            mesh.m_MaterialName = ConvertUtils::ReplaceCharInString(matDef[mesh.m_MeshMatName], '\\', '/');
+            if (!mesh.m_MaterialName.empty()) mesh.m_MaterialId = LoadMaterialFromPack(mesh.m_MaterialName);
+
+            numBytes += mesh.m_NumBytes;
+        }
+
+        model.m_ModelName = modelName;
+        model.m_ModelUID = id;
+
+        // New materials are referenced before the old ones are released so shared materials aren't evicted in between
+        for (const auto& mesh : model.mv_Meshes)
+        {
+            if (mesh.m_MaterialId != 0) m_Materials.AddReference(mesh.m_MaterialId);
+        }
+
+        if (!m_Models.Replace(id, model, numBytes)) return false;
+
+        // After the swap model holds the previous version
+        for (const auto& mesh : model.mv_Meshes)
+        {
+            if (mesh.m_MaterialId != 0) m_Materials.ReleaseReference(mesh.m_MaterialId);
+        }
+
+        LOG_F(INFO, "Reloaded %s", modelName.c_str());
+        return true;
+    }
+
+    /*
+        Returns material definitions from specific file.
+        Definitions are parsed once per pack and shared by all loads of the session.
+    */
+    std::map<std::string, std::string> GraphicsDx11::LoadMaterialDefinitions(const std::string& matDefName)
+    {
+        auto p_Definitions = m_MaterialDefinitions.Find(matDefName);
+        if (!p_Definitions) return std::map<std::string, std::string>();
+
+        return *p_Definitions;
+    }
+
+    // Data passed between tasks that load a single model
+    struct ModelLoadState
+    {
+        AssetBlob m_Data;
+        std::map<std::string, std::string> m_MaterialDefinitions;
+        ModelDx11 m_Model;
+        bool m_Loaded = false; // Model was already loaded before the graph started
+        bool m_Imported = false;
+    };
+
+    /*
+        Adds tasks that load a model to the graph and returns the task that finishes the load.
+        Model and its material definitions are read in parallel. Once the model is imported materials
+        of its meshes are scheduled and the model is registered after all of them are created.
+        If model data is provided it's not read from the pack.
+    */
+    TaskId GraphicsDx11::ScheduleModelLoad(TaskGraph& graph, const std::string& modelName, AssetBlob modelData)
+    {
+        return graph.FindOrAddTasks("model:" + modelName, [&]()
+        {
+            auto p_State = std::make_shared<ModelLoadState>();
+            p_State->m_Data = std::move(modelData);
+
+            // Resolving materials adds them as dependencies of the task that registers the model
+            auto p_RegisterTask = std::make_shared<TaskId>(0);
+
+            TaskId readTask = graph.AddTask("Read " + modelName, [this, p_State, modelName]()
+            {
+                if (GetModelIdByName(modelName) != 0)
+                {
+                    LOG_F(INFO, "%s already loaded with ID = %u", modelName.c_str(), GetModelIdByName(modelName));
+                    p_State->m_Loaded = true;
+                    return;
+                }
+
+                if (p_State->m_Data.IsEmpty())
+                    p_State->m_Data = ReadAssetFromPack("Model", modelName);
+            });
+
+            std::string matDefName = FileUtils::StripPathToFileName(modelName) + ".matdef";
+
+            TaskId matDefTask = graph.AddTask("Read " + matDefName, [this, p_State, modelName, matDefName]()
+            {
+                if (GetModelIdByName(modelName) != 0) return;
+
+                p_State->m_MaterialDefinitions = LoadMaterialDefinitions(matDefName);
+            });
+
+            TaskId importTask = graph.AddTask("Import " + modelName, [this, p_State, modelName]()
+            {
+                if (p_State->m_Loaded || p_State->m_Data.IsEmpty()) return;
+
+                p_State->m_Imported = ImportModel(p_State->m_Data, this, modelName, p_State->m_Model);
+                p_State->m_Data = AssetBlob();
+            }, { readTask });
+
+            TaskId resolveTask = graph.AddTask("Resolve materials of " + modelName, [this, &graph, p_State, p_RegisterTask]()
+            {
+                if (!p_State->m_Imported) return;
+
+                for (auto& mesh : p_State->m_Model.mv_Meshes)
+                {
+                    mesh.m_MaterialName = ConvertUtils::ReplaceCharInString(p_State->m_MaterialDefinitions[mesh.m_MeshMatName], '\\', '/');
+
+                    if (mesh.m_MaterialName.empty())
+                    {
+                        LOG_F(ERROR, "No material defined for %s", mesh.m_MeshMatName.c_str());
+                        continue;
+                    }
+
+                    // Materials shared by several meshes or models are scheduled only once
+                    graph.AddDependency(*p_RegisterTask, ScheduleMaterialLoad(graph, mesh.m_MaterialName));
+                }
+            }, { importTask, matDefTask });
+
+            *p_RegisterTask = graph.AddTask("Register " + modelName, [this, p_State, modelName]()
+            {
+                if (!p_State->m_Imported) return;
+
+                for (auto& mesh : p_State->m_Model.mv_Meshes)
+                    mesh.m_MaterialId = GetMaterialIdByName(mesh.m_MaterialName);
+
+                RegisterModel(std::move(p_State->m_Model), this, modelName);
+            }, { resolveTask });
+
+            return *p_RegisterTask;
+        });
+    }
+
+    // Data passed between tasks that load a single material
+    struct MaterialLoadState
+    {
+        AssetBlob m_Data;
+        bool m_Loaded = false; // Material was already loaded before the graph started
+        bool m_Parsed = false;
+    };
+
+    /*
+        Adds tasks that load a material to the graph and returns the task that creates the material.
+        After the material is parsed its textures are scheduled and the material is created after all of them are loaded.
+        If material data is provided it's not read from the pack.
+    */
+    TaskId GraphicsDx11::ScheduleMaterialLoad(TaskGraph& graph, const std::string& materialName, AssetBlob matData)
+    {
+        return graph.FindOrAddTasks("material:" + materialName, [&]()
+        {
+            auto p_State = std::make_shared<MaterialLoadState>();
+            p_State->m_Data = std::move(matData);
+
+            auto p_Description = std::make_shared<MaterialDescription>();
+
+            // Parsing the material adds its textures as dependencies of the task that creates the material
+            auto p_CreateTask = std::make_shared<TaskId>(0);
+
+            TaskId readTask = graph.AddTask("Read " + materialName, [this, p_State, materialName]()
+            {
+                if (GetMaterialIdByName(materialName) != 0)
+                {
+                    LOG_F(INFO, "%s already loaded with ID = %u", materialName.c_str(), GetMaterialIdByName(materialName));
+                    p_State->m_Loaded = true;
+                    return;
+                }
+
+                if (p_State->m_Data.IsEmpty())
+                    p_State->m_Data = ReadAssetFromPack("Material", materialName);
+            });
+
+            TaskId parseTask = graph.AddTask("Parse " + materialName, [this, &graph, p_State, p_Description, p_CreateTask]()
+            {
+                if (p_State->m_Loaded || p_State->m_Data.IsEmpty()) return;
+
+                *p_Description = MaterialFormat::Parse(p_State->m_Data);
+                p_State->m_Parsed = true;
+
+                // Textures shared by several materials are scheduled only once
+                for (const auto& texture : { p_Description->m_DiffuseTexture, p_Description->m_SpecularTexture, p_Description->m_NormalTexture })
+                {
+                    if (!texture.empty())
+                        graph.AddDependency(*p_CreateTask, ScheduleTextureLoad(graph, texture));
+                }
+            }, { readTask });
 
-            if (v_Params.size() < 2) continue;
+            *p_CreateTask = graph.AddTask("Create " + materialName, [this, p_State, p_Description, materialName]()
+            {
+                if (!p_State->m_Parsed) return;
 
-            result[v_Params[0]] = v_Params[1];
-        }
+                CreateMaterial(*p_Description, this, materialName);
+            }, { parseTask });
 
-        return result;
+            return *p_CreateTask;
+        });
+    }
+
+    // Data passed between tasks that load a single texture
+    struct TextureLoadState
+    {
+        AssetBlob m_Data;
+    };
+
+    /*
+        Adds tasks that load a texture to the graph and returns the task that creates the texture.
+        Texture is decoded and its DirectX resources are created by one task, so that
+        the whole load can be shared with loads of the same texture outside of the graph.
+        If texture data is provided it's not read from the pack.
+    */
+    TaskId GraphicsDx11::ScheduleTextureLoad(TaskGraph& graph, const std::string& textureName, AssetBlob textureData)
+    {
+        return graph.FindOrAddTasks("texture:" + textureName, [&]()
+        {
+            auto p_State = std::make_shared<TextureLoadState>();
+            p_State->m_Data = std::move(textureData);
+
+            TaskId readTask = graph.AddTask("Read " + textureName, [this, p_State, textureName]()
+            {
+                if (GetTextureIdByName(textureName) != 0)
+                {
+                    LOG_F(INFO, "%s already loaded with ID = %u", textureName.c_str(), GetTextureIdByName(textureName));
+                    p_State->m_Data = AssetBlob();
+                    return;
+                }
+
+                if (p_State->m_Data.IsEmpty())
+                    p_State->m_Data = ReadAssetFromPack("Texture", textureName);
+            });
+
+            return graph.AddTask("Decode and create " + textureName, [this, p_State, textureName]()
+            {
+                if (p_State->m_Data.IsEmpty()) return;
+
+                LoadTextureOnce(textureName, [p_State]() { return std::move(p_State->m_Data); });
+            }, { readTask });
+        });
+    }
+
+    /*
+        Executes asset load graph and reports its timings.
+        If LoadGraph in [Debug] section of config is set the graph is also saved to that file.
+    */
+    void GraphicsDx11::ExecuteLoadGraph(TaskGraph& graph)
+    {
+        graph.Execute();
+        graph.LogSummary();
+
+        std::string dumpPath = EngineConfig::Get<ConfigKey_DebugLoadGraph>();
+        if (!dumpPath.empty()) graph.SaveDump(dumpPath);
     }
 
     /*
         Compiles singular shader
     */
-    void GraphicsDx11::CompileShader(std::vector<uint8_t> v_VertexData, std::vector<uint8_t> v_PixelData, ShaderType type, GraphicsDx11* p_Gfx, std::string vertexName, std::string pixelName)
+    void GraphicsDx11::CompileShader(ByteView vertexData, ByteView pixelData, ShaderType type, GraphicsDx11* p_Gfx, std::string vertexName, std::string pixelName)
     {
         // Check if shader isn't loaded already
         if (p_Gfx->GetShaderIdByVertexName(vertexName) != 0)
@@ -1662,39 +2705,56 @@ namespace Mesa
 
         // Create new shader instance
         ShaderDx11 shader = {};
-
-        // Compile both vertex and pixel shader on separate threads
-        std::thread vertexThread(GraphicsDx11::CompileVertexShader, v_VertexData, type, shader.mp_VertexShader.GetAddressOf(), shader.mp_InputLayout.GetAddressOf(), p_Gfx);
-        std::thread pixelThread(GraphicsDx11::CompilePixelShader, v_PixelData, type, shader.mp_PixelShader.GetAddressOf(), p_Gfx);
-
-        vertexThread.join();
-        pixelThread.join();
-
-        // Validate compilation results
-        if (shader.mp_InputLayout.Get() == nullptr || shader.mp_VertexShader.Get() == nullptr || shader.mp_PixelShader.Get() == nullptr)
-        {
-            LOG_F(ERROR, "At least one of the shader submodules could not be initialized properly! ");
+        if (!BuildShader(vertexData, pixelData, type, p_Gfx, shader))
             return;
-        }
 
         // Fill out shader details
         shader.m_ShaderType = type;
         shader.m_PixelShaderName = pixelName;
         shader.m_VertexShaderName = vertexName;
-        p_Gfx->m_ShaderIdSemaphore.acquire();
-        shader.m_ShaderUID = p_Gfx->GenerateShaderUID();
-        p_Gfx->mv_Shaders.push_back(shader);
-        p_Gfx->m_ShaderIdSemaphore.release();
+        uint32_t id = p_Gfx->m_Shaders.Insert(vertexName, shader, 0, [](ShaderDx11& s, uint32_t handle) { s.m_ShaderUID = handle; });
+
+        if (id == 0)
+        {
+            LOG_F(WARNING, "Shader %s is already compiled, dropping the second copy", vertexName.c_str());
+            return;
+        }
 
-        LOG_F(INFO, "Shader fully compiled with ID = %u", shader.GetShaderUID());
+        LOG_F(INFO, "Shader fully compiled with ID = %u", id);
 
         return;
     }
 
     /*
-        Compiles vertex shader
+        Compiles vertex and pixel shader as separate jobs into a shader that isn't registered yet.
+        Returns false if any of the submodules couldn't be created.
+    */
+    bool GraphicsDx11::BuildShader(ByteView vertexData, ByteView pixelData, ShaderType type, GraphicsDx11* p_Gfx, ShaderDx11& outShader)
+    {
+        JobSystem& jobSystem = JobSystem::GetDefault();
+        JobCounter counter;
+
+        jobSystem.Run([&]() { GraphicsDx11::CompileVertexShader(vertexData, type, outShader.mp_VertexShader.GetAddressOf(), outShader.mp_InputLayout.GetAddressOf(), &outShader.m_IsInstanced, p_Gfx); }, &counter);
+        jobSystem.Run([&]() { GraphicsDx11::CompilePixelShader(pixelData, type, outShader.mp_PixelShader.GetAddressOf(), p_Gfx); }, &counter);
+
+        jobSystem.Wait(counter);
+
+        // Validate compilation results
+        if (outShader.mp_InputLayout.Get() == nullptr || outShader.mp_VertexShader.Get() == nullptr || outShader.mp_PixelShader.Get() == nullptr)
+        {
+            LOG_F(ERROR, "At least one of the shader submodules could not be initialized properly! ");
+            return false;
+        }
+
+        return true;
+    }
+
+    /*
+        Compiles vertex shader.
+        Forward shaders that declare INSTANCE_WORLD0-3 inputs get a layout with world matrix rows
+        read per instance from the second vertex buffer, and are drawn with instancing.
     */
-    void GraphicsDx11::CompileVertexShader(std::vector<uint8_t> v_VertexData, ShaderType type, ID3D11VertexShader** pp_Shader, ID3D11InputLayout** pp_Layout, GraphicsDx11* p_Gfx)
+    void GraphicsDx11::CompileVertexShader(ByteView vertexData, ShaderType type, ID3D11VertexShader** pp_Shader, ID3D11InputLayout** pp_Layout, bool* p_OutInstanced, GraphicsDx11* p_Gfx)
     {
         // Set compilation flags
         UINT compileFlag = D3DCOMPILE_ENABLE_STRICTNESS;
@@ -1709,7 +2769,7 @@ namespace Mesa
         ID3DBlob* p_Error = nullptr;
 
         // Compile shader
-        HRESULT hr = D3DCompile(v_VertexData.data(), v_VertexData.size(), nullptr, nullptr, nullptr, "main", "vs_5_0", compileFlag, 0, &p_Code, &p_Error);
+        HRESULT hr = D3DCompile(vertexData.data(), vertexData.size(), nullptr, nullptr, nullptr, "main", "vs_5_0", compileFlag, 0, &p_Code, &p_Error);
         // Validate compilation results
         if (FAILED(hr))
         {
@@ -1730,13 +2790,37 @@ namespace Mesa
         // Create appropriate input layout
         if (type == ShaderType_Forward)
         {
+            // Check if shader reads world matrix from the instance buffer
+            Microsoft::WRL::ComPtr<ID3D11ShaderReflection> p_Reflection;
+            if (SUCCEEDED(D3DReflect(p_Code->GetBufferPointer(), p_Code->GetBufferSize(), IID_PPV_ARGS(p_Reflection.GetAddressOf()))))
+            {
+                D3D11_SHADER_DESC shaderDesc = {};
+                p_Reflection->GetDesc(&shaderDesc);
+
+                for (UINT i = 0; i < shaderDesc.InputParameters; i++)
+                {
+                    D3D11_SIGNATURE_PARAMETER_DESC paramDesc = {};
+                    p_Reflection->GetInputParameterDesc(i, &paramDesc);
+
+                    if (strcmp(paramDesc.SemanticName, Shader::INSTANCE_SEMANTIC) == 0) *p_OutInstanced = true;
+                }
+            }
+
+            // Instance buffer holds glm world matrices, so float4x4(INSTANCE_WORLD0, ..., INSTANCE_WORLD3)
+            // in the shader is the same matrix as m_Model of the MVP buffer
             D3D11_INPUT_ELEMENT_DESC layoutDesc[] = {
                 {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
                 {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
                 {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+                {Shader::INSTANCE_SEMANTIC, 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+                {Shader::INSTANCE_SEMANTIC, 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+                {Shader::INSTANCE_SEMANTIC, 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+                {Shader::INSTANCE_SEMANTIC, 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1},
             };
+            UINT numElements = *p_OutInstanced ? _countof(layoutDesc) : 3;
+
             // Validate creation results
-            hr = p_Gfx->mp_Device->CreateInputLayout(layoutDesc, _countof(layoutDesc), p_Code->GetBufferPointer(), p_Code->GetBufferSize(), pp_Layout);
+            hr = p_Gfx->mp_Device->CreateInputLayout(layoutDesc, numElements, p_Code->GetBufferPointer(), p_Code->GetBufferSize(), pp_Layout);
             if (FAILED(hr))
             {
                 LOG_F(ERROR, "CreateInputLayout function failed for forward shader!");
@@ -1764,7 +2848,7 @@ namespace Mesa
     /*
         Compiles pixel shader
     */
-    void GraphicsDx11::CompilePixelShader(std::vector<uint8_t> v_PixelData, ShaderType type, ID3D11PixelShader** pp_Shader, GraphicsDx11* p_Gfx)
+    void GraphicsDx11::CompilePixelShader(ByteView pixelData, ShaderType type, ID3D11PixelShader** pp_Shader, GraphicsDx11* p_Gfx)
     {
         // Set compilation flags
         UINT compileFlag = D3DCOMPILE_ENABLE_STRICTNESS;
@@ -1778,7 +2862,7 @@ namespace Mesa
         ID3DBlob* p_Code = nullptr;
         ID3DBlob* p_Error = nullptr;
         // Compile shader
-        HRESULT hr = D3DCompile(v_PixelData.data(), v_PixelData.size(), nullptr, nullptr, nullptr, "main", "ps_5_0", compileFlag, 0, &p_Code, &p_Error);
+        HRESULT hr = D3DCompile(pixelData.data(), pixelData.size(), nullptr, nullptr, nullptr, "main", "ps_5_0", compileFlag, 0, &p_Code, &p_Error);
         // Validate compilation results
         if (FAILED(hr))
         {
@@ -1799,32 +2883,114 @@ namespace Mesa
         LOG_F(INFO, "Compiled pixel shader!");
     }
 
-    void GraphicsDx11::LoadTexture(std::vector<uint8_t> v_TextureData, GraphicsDx11* p_Gfx, std::string textureName)
+    /*
+        Decodes texture and creates its DirectX resources
+    */
+    void GraphicsDx11::LoadTexture(AssetBlob textureData, GraphicsDx11* p_Gfx, std::string textureName)
+    {
+        p_Gfx->LoadTextureOnce(textureName, [&textureData]() { return std::move(textureData); });
+    }
+
+    /*
+        Loads texture unless it's loaded already. If the same texture is being loaded by another
+        thread this function waits for that load instead of decoding the texture again.
+        Data of the texture is requested from readData only if this call performs the load.
+        Returns id of the texture or 0 if loading failed.
+    */
+    uint32_t GraphicsDx11::LoadTextureOnce(const std::string& textureName, const std::function<AssetBlob()>& readData)
     {
-        // Check if the texture is already loaded
-        if (p_Gfx->GetTextureIdByName(textureName) != 0)
+        return m_TextureRequests.Do(textureName, [&]()
         {
-            LOG_F(INFO, "%s already loaded with ID = %u", p_Gfx->GetTextureIdByName(textureName));
-            return;
-        }
+            // Check if the texture is already loaded
+            uint32_t existingId = GetTextureIdByName(textureName);
+            if (existingId != 0)
+            {
+                LOG_F(INFO, "%s already loaded with ID = %u", textureName.c_str(), existingId);
+                return existingId;
+            }
+
+            AssetBlob textureData = readData();
+            if (textureData.IsEmpty()) return 0u;
 
+            DecodedTexture decodedTexture = {};
+            if (!DecodeTexture(textureData, textureName, decodedTexture)) return 0u;
+
+            CreateTexture(decodedTexture, this, textureName);
+
+            return GetTextureIdByName(textureName);
+        });
+    }
+
+    /*
+        Decodes PNG data into RGBA pixels.
+        Returns false if decoding fails.
+    */
+    bool GraphicsDx11::DecodeTexture(ByteView textureData, const std::string& textureName, DecodedTexture& outTexture)
+    {
         LOG_F(INFO, "Loading %s", textureName.c_str());
 
-        // Create new texture instance
-        TextureDx11 texture = {};
+        // Texture decoded by previous runs is read from asset cache
+        AssetCache& cache = AssetCache::GetDefault();
+        std::string cacheKey = cache.IsEnabled() ? AssetCache::MakeKey("texture", TEXTURE_CACHE_VERSION, textureData) : std::string();
+        std::vector<uint8_t> v_CachedData;
+
+        if (cache.IsEnabled() && cache.Load(cacheKey, v_CachedData) && DeserializeTexture(v_CachedData, outTexture))
+        {
+            LOG_F(INFO, "Read decoded %s from asset cache", textureName.c_str());
+            return true;
+        }
 
-        // Create variables to store height and width of the texture
-        uint32_t width, height; 
+        // Cached data could have been damaged after it was partially read
+        outTexture = DecodedTexture();
 
-        std::vector<uint8_t> v_DecodedBuffer;
-        uint32_t error = lodepng::decode(v_DecodedBuffer, width, height, v_TextureData);
+        uint32_t error = lodepng::decode(outTexture.mv_Pixels, outTexture.m_Width, outTexture.m_Height, textureData.data(), textureData.size());
         if (error) 
         {
             LOG_F(ERROR, "Failed to decode %s", textureName.c_str());
-            return;
+            return false;
         }
 
+        if (cache.IsEnabled()) cache.Store(cacheKey, SerializeTexture(outTexture));
+
         LOG_F(INFO, "Decoded %s", textureName.c_str());
+        return true;
+    }
+
+    /*
+        Creates DirectX texture from decoded pixels and adds it to loaded textures
+    */
+    void GraphicsDx11::CreateTexture(const DecodedTexture& decodedTexture, GraphicsDx11* p_Gfx, std::string textureName)
+    {
+        // Create new texture instance
+        TextureDx11 texture = {};
+        if (!BuildTexture(decodedTexture, p_Gfx, texture)) return;
+
+        // Fill out the rest of the texture details
+        texture.m_TextureName = textureName;
+        // Texture is stored as 4 bytes per pixel
+        uint64_t numBytes = (uint64_t)decodedTexture.m_Width * decodedTexture.m_Height * 4;
+        uint32_t id = p_Gfx->m_Textures.Insert(textureName, texture, numBytes, [](TextureDx11& t, uint32_t handle) { t.m_TextureUID = handle; });
+
+        // Loads that don't share requests (e.g. synchronous and asynchronous one) could have created the same texture
+        if (id == 0)
+        {
+            p_Gfx->m_NumDuplicateResources++;
+            LOG_F(WARNING, "%s was loaded twice, dropping the second copy", textureName.c_str());
+            return;
+        }
+
+        LOG_F(INFO, "%s loaded with UID = %u", textureName.c_str(), id);
+        return;
+    }
+
+    /*
+        Creates DirectX texture and its resource view from decoded pixels.
+        Returns false if any of them could not be created.
+    */
+    bool GraphicsDx11::BuildTexture(const DecodedTexture& decodedTexture, GraphicsDx11* p_Gfx, TextureDx11& outTexture)
+    {
+        uint32_t width = decodedTexture.m_Width;
+        uint32_t height = decodedTexture.m_Height;
 
         // Fill out DirectX structures for texture
         D3D11_TEXTURE2D_DESC desc = {};
@@ -1839,15 +3005,15 @@ namespace Mesa
         desc.ArraySize = 1;
 
         D3D11_SUBRESOURCE_DATA initData = {};
-        initData.pSysMem = v_DecodedBuffer.data();
+        initData.pSysMem = decodedTexture.mv_Pixels.data();
         initData.SysMemPitch = width * 4;
         initData.SysMemSlicePitch = width * height * 4;
 
-        HRESULT hr = p_Gfx->mp_Device->CreateTexture2D(&desc, &initData, texture.mp_RawData.GetAddressOf());
+        HRESULT hr = p_Gfx->mp_Device->CreateTexture2D(&desc, &initData, outTexture.mp_RawData.GetAddressOf());
         if (FAILED(hr))
         {
             LOG_F(ERROR, "CreateTexture2D failed!");
-            return;
+            return false;
         }
 
         // Fill out DirectX structures for resource view
@@ -1856,77 +3022,122 @@ namespace Mesa
         srv.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
         srv.Texture2D.MipLevels = 1;
 
-        hr = p_Gfx->mp_Device->CreateShaderResourceView(texture.mp_RawData.Get(), &srv, texture.mp_ResourceView.GetAddressOf());
+        hr = p_Gfx->mp_Device->CreateShaderResourceView(outTexture.mp_RawData.Get(), &srv, outTexture.mp_ResourceView.GetAddressOf());
         if (FAILED(hr))
         {
             LOG_F(ERROR, "CreateShaderResourceView failed!");
-            return;
+            return false;
         }
 
-        // Fill out the rest of the texture details
-        texture.m_TextureName = textureName;
-        p_Gfx->m_TextureIdSemaphore.acquire();
-        texture.m_TextureUID = p_Gfx->GenerateTextureUID();
-        p_Gfx->mv_Textures.push_back(texture);
-        p_Gfx->m_TextureIdSemaphore.release();
-        LOG_F(INFO, "%s loaded with UID = %u", texture.GetTextureName().c_str(), texture.GetTextureUID());
-        return;
+        return true;
     }
 
     /*
-        Imports model data using ASSIMP library
+        Imports model data using ASSIMP library without creating any DirectX resources.
+        Returns false if importing fails.
     */
-    void GraphicsDx11::LoadModel(std::vector<uint8_t> v_ModelData, GraphicsDx11* p_Gfx, std::string modelName)
+    bool GraphicsDx11::ImportMeshes(ByteView modelData, GraphicsDx11* p_Gfx, const std::string& modelName, std::vector<MeshData>& v_OutMeshes)
     {
         LOG_F(INFO, "Loading %s", modelName.c_str());
 
-        std::string matDefName = FileUtils::StripPathToFileName(modelName);
-        matDefName += ".matdef";
+        // Meshes imported by previous runs are read from asset cache
+        AssetCache& cache = AssetCache::GetDefault();
+        std::string cacheKey = cache.IsEnabled() ? AssetCache::MakeKey("model", MODEL_CACHE_VERSION, modelData) : std::string();
+        std::vector<uint8_t> v_CachedData;
 
-        auto matDef = p_Gfx->LoadMaterialDefinitions(matDefName);
+        if (cache.IsEnabled() && cache.Load(cacheKey, v_CachedData) && DeserializeMeshes(v_CachedData, v_OutMeshes))
+        {
+            LOG_F(INFO, "Read imported %s from asset cache", modelName.c_str());
+            return true;
+        }
 
         Assimp::Importer importer;
 
         // Read raw bytes and treat them as a contents of FBX file
-        const aiScene* p_Scene = importer.ReadFileFromMemory(v_ModelData.data(), v_ModelData.size(), aiProcess_Triangulate | aiProcess_ConvertToLeftHanded, ".fbx");
+        const aiScene* p_Scene = importer.ReadFileFromMemory(modelData.data(), modelData.size(), aiProcess_Triangulate | aiProcess_ConvertToLeftHanded, ".fbx");
 
         // Validate importing results
         if (p_Scene == nullptr)
         {
             LOG_F(ERROR, "Failed to import %s with error %s", modelName.c_str(), importer.GetErrorString());
-            return;
+            return false;
         }
 
-        ModelDx11 model = {};
-
         // Process nodes of the model
-        p_Gfx->ProcessNode(model, p_Scene->mRootNode, p_Scene);
+        p_Gfx->ProcessNode(v_OutMeshes, p_Scene->mRootNode, p_Scene);
+
+        if (cache.IsEnabled()) cache.Store(cacheKey, SerializeMeshes(v_OutMeshes));
+
+        return true;
+    }
+
+    /*
+        Imports model data using ASSIMP library and creates its buffers.
+        Materials of the meshes are not loaded here.
+        Returns false if importing fails.
+    */
+    bool GraphicsDx11::ImportModel(ByteView modelData, GraphicsDx11* p_Gfx, const std::string& modelName, ModelDx11& outModel)
+    {
+        std::vector<MeshData> v_Meshes;
+        if (!ImportMeshes(modelData, p_Gfx, modelName, v_Meshes)) return false;
+
+        for (const auto& meshData : v_Meshes)
+        {
+            MeshDx11 mesh;
+            p_Gfx->CreateMeshBuffers(meshData, mesh);
+            outModel.m_Bounds = outModel.mv_Meshes.empty() ? mesh.m_Bounds : BoundingVolume::Merge(outModel.m_Bounds, mesh.m_Bounds);
+            outModel.mv_Meshes.push_back(mesh);
+        }
 
         bool bufResult = false;
 
         // Create constant buffer for MVP matrix
-        GraphicsDx11::CreateEmptyBuffer(sizeof(ConstBufferDx11::MvpBuffer), D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DEFAULT, 0, p_Gfx, model.mp_ConstBufferMVP.GetAddressOf(), bufResult);
+        GraphicsDx11::CreateEmptyBuffer(sizeof(ConstBufferDx11::MvpBuffer), D3D11_BIND_CONSTANT_BUFFER, D3D11_USAGE_DEFAULT, 0, p_Gfx, outModel.mp_ConstBufferMVP.GetAddressOf(), bufResult);
     
         // Validate constant buffer creation
         if (!bufResult)
         {
             LOG_F(ERROR, "Cration of constant buffer failed!");
+            return false;
+        }
+
+        return true;
+    }
+
+    /*
+        Adds imported model to loaded models
+    */
+    void GraphicsDx11::RegisterModel(ModelDx11 model, GraphicsDx11* p_Gfx, std::string modelName)
+    {
+        // Fill out the rest of the model details
+        model.m_ModelName = modelName;
+        uint64_t numBytes = sizeof(ConstBufferDx11::MvpBuffer);
+        std::vector<uint32_t> v_MaterialIds;
+
+        for (const auto& mesh : model.mv_Meshes)
+        {
+            numBytes += mesh.m_NumBytes;
+            v_MaterialIds.push_back(mesh.m_MaterialId);
+        }
+
+        uint32_t id = p_Gfx->m_Models.Insert(modelName, std::move(model), numBytes, [](ModelDx11& m, uint32_t handle) { m.m_ModelUID = handle; });
+
+        // Loads that don't share requests (e.g. synchronous and asynchronous one) could have imported the same model
+        if (id == 0)
+        {
+            p_Gfx->m_NumDuplicateResources++;
+            LOG_F(WARNING, "%s was loaded twice, dropping the second copy", modelName.c_str());
             return;
         }
 
-        for (auto& mesh : model.mv_Meshes)
+        // Materials used by the model can't be evicted while the model is loaded
+        for (uint32_t materialId : v_MaterialIds)
         {
-            mesh.m_MaterialName = ConvertUtils::ReplaceCharInString(matDef[mesh.m_MeshMatName], '\\', '/');
-            mesh.m_MaterialId = p_Gfx->LoadMaterialFromPack(mesh.m_MaterialName);
+            if (materialId != 0 && !p_Gfx->m_Materials.AddReference(materialId))
+                LOG_F(WARNING, "Material of %s was evicted before the model was registered", modelName.c_str());
         }
 
-        // Fill out the rest of the model details
-        model.m_ModelName = modelName;
-        p_Gfx->m_ModelIdSemaphore.acquire();
-        model.m_ModelUID = p_Gfx->GenerateModelUID();
-        p_Gfx->mv_Models.push_back(model);
-        p_Gfx->m_ModelIdSemaphore.release();
-        LOG_F(INFO, "%s loaded with UID = %u", model.GetModelName().c_str(), model.GetModelUID());
+        LOG_F(INFO, "%s loaded with UID = %u", modelName.c_str(), id);
         return;
     }
 
@@ -1938,9 +3149,9 @@ namespace Mesa
     {
         D3D11_BUFFER_DESC desc = {};
         desc.ByteWidth = size;
-        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.Usage = usage;
         desc.BindFlags = bindFlag;
-        desc.CPUAccessFlags = 0;
+        desc.CPUAccessFlags = cpuAccess;
 
         THROW_IF_FAILED_DX(p_Gfx->mp_Device->CreateBuffer(&desc, nullptr, pp_Buffer));
     }
@@ -1950,7 +3161,7 @@ namespace Mesa
         Function returns ture if creation was sucessful or false otherwise
         via reference bool.
     */
-    void GraphicsDx11::CreateVertexBuffer(std::vector<VertexDx11> v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result)
+    void GraphicsDx11::CreateVertexBuffer(const std::vector<VertexDx11>& v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result)
     {
         D3D11_BUFFER_DESC desc = {};
         desc.ByteWidth = sizeof(VertexDx11) * v_verts.size();
@@ -1974,7 +3185,7 @@ namespace Mesa
         Function returns ture if creation was sucessful or false otherwise
         via reference bool.
     */
-    void GraphicsDx11::CreateDeferredVertexBuffer(std::vector<DeferredVertexDx11> v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result)
+    void GraphicsDx11::CreateDeferredVertexBuffer(const std::vector<DeferredVertexDx11>& v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result)
     {
         D3D11_BUFFER_DESC desc = {};
         desc.ByteWidth = sizeof(DeferredVertexDx11) * v_verts.size();
@@ -1997,7 +3208,7 @@ namespace Mesa
         Creates DirectX buffer with vertex data.
         Function throw exception if creation fails.
     */
-    void GraphicsDx11::CreateVertexBufferCritical(std::vector<VertexDx11> v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx)
+    void GraphicsDx11::CreateVertexBufferCritical(const std::vector<VertexDx11>& v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx)
     {
         D3D11_BUFFER_DESC desc = {};
         desc.ByteWidth = sizeof(VertexDx11) * v_verts.size();
@@ -2015,7 +3226,7 @@ namespace Mesa
         Creates DirectX buffer with deferred vertex data.
         Function throw exception if creation fails.
     */
-    void GraphicsDx11::CreateDeferredVertexBufferCritical(std::vector<DeferredVertexDx11> v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx)
+    void GraphicsDx11::CreateDeferredVertexBufferCritical(const std::vector<DeferredVertexDx11>& v_verts, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx)
     {
         D3D11_BUFFER_DESC desc = {};
         desc.ByteWidth = sizeof(DeferredVertexDx11) * v_verts.size();
@@ -2034,7 +3245,7 @@ namespace Mesa
         Function returns ture if creation was sucessful or false otherwise
         via reference bool.
     */
-    void GraphicsDx11::CreateIndexBuffer(std::vector<uint32_t> v_inds, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result)
+    void GraphicsDx11::CreateIndexBuffer(const std::vector<uint32_t>& v_inds, ID3D11Buffer** pp_Buffer, GraphicsDx11* p_Gfx, bool& result)
     {
         D3D11_BUFFER_DESC desc = {};
         desc.ByteWidth = sizeof(uint32_t) * v_inds.size();
@@ -2062,9 +3273,9 @@ namespace Mesa
     {
         D3D11_BUFFER_DESC desc = {};
         desc.ByteWidth = size;
-        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.Usage = usage;
         desc.BindFlags = bindFlag;
-        desc.CPUAccessFlags = 0;
+        desc.CPUAccessFlags = cpuAccess;
 
         if (FAILED(p_Gfx->mp_Device->CreateBuffer(&desc, nullptr, pp_Buffer)))
             result = false;
@@ -2074,102 +3285,53 @@ namespace Mesa
         return;
     }
 
-    void GraphicsDx11::CreateMaterial(std::vector<uint8_t> v_MatData, GraphicsDx11* p_Gfx, std::string matName)
+    /*
+        Creates material from its description and adds it to loaded materials.
+        Textures used by the material have to be loaded before.
+    */
+    void GraphicsDx11::CreateMaterial(const MaterialDescription& description, GraphicsDx11* p_Gfx, std::string matName)
     {
-        std::string matText = std::string(v_MatData.begin(), v_MatData.end());
-        matText = ConvertUtils::RemoveCharFromString(matText, '\r');
+        Material material = BuildMaterial(description, p_Gfx, matName);
 
-        // Split material text into single lines
-        std::vector<std::string> v_Lines = ConvertUtils::SplitStringByChar(matText, '\n');
+        // Add material to Graphics class instance
+        uint32_t id = p_Gfx->m_Materials.Insert(matName, material, sizeof(Material), [](Material& m, uint32_t handle) { m.m_MaterialId = handle; });
 
-        Material material = {};
-        glm::vec4 baseColor = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-        glm::vec4 subColor = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
-        float specPower = 1.0f;
-        std::string diffTex, normTex, specTex;
-
-        // Create threads that texture loading functions will be sent to
-        std::thread diffThread, normThread, specThread;
-
-        for (const auto& line : v_Lines)
-        {
-            // Skip lines that are empty or simply have only newline character
-            if (line.empty() || strcmp(line.c_str(), "\n") == 0) continue;
-
-            // Split line into single words
-            std::vector<std::string> v_Words = ConvertUtils::SplitStringByChar(line, '=');
-
-            // Skip line that have only one word since all parameters require at least two
-            if (v_Words.size() <= 1) continue;
-
-            // Base color parameters
-            if (strcmp(v_Words[0].c_str(), "$base_r") == 0) baseColor.x = ConvertUtils::StringToFloat(v_Words[1]);
-            else if (strcmp(v_Words[0].c_str(), "$base_g") == 0) baseColor.y = ConvertUtils::StringToFloat(v_Words[1]);
-            else if (strcmp(v_Words[0].c_str(), "$base_b") == 0) baseColor.z = ConvertUtils::StringToFloat(v_Words[1]);
-            else if (strcmp(v_Words[0].c_str(), "$base_a") == 0) baseColor.w = ConvertUtils::StringToFloat(v_Words[1]);
-            // Sub color parameters
-            else if (strcmp(v_Words[0].c_str(), "$sub_r") == 0) subColor.x = ConvertUtils::StringToFloat(v_Words[1]);
-            else if (strcmp(v_Words[0].c_str(), "$sub_g") == 0) subColor.y = ConvertUtils::StringToFloat(v_Words[1]);
-            else if (strcmp(v_Words[0].c_str(), "$sub_b") == 0) subColor.z = ConvertUtils::StringToFloat(v_Words[1]);
-            else if (strcmp(v_Words[0].c_str(), "$sub_a") == 0) subColor.w = ConvertUtils::StringToFloat(v_Words[1]);
-            // Specular data
-            else if (strcmp(v_Words[0].c_str(), "$specular") == 0) specPower = ConvertUtils::StringToFloat(v_Words[1]);
-            // Texture data
-            else if (strcmp(v_Words[0].c_str(), "$diffuseTex") == 0)
-            {
-                diffThread = std::thread(LoadTextureFromPackAsync, v_Words[1], p_Gfx);
-                diffTex = v_Words[1];
-            }
-            else if (strcmp(v_Words[0].c_str(), "$specularTex") == 0)
-            {
-                specThread = std::thread(LoadTextureFromPackAsync, v_Words[1], p_Gfx);
-                specTex = v_Words[1];
-            }
-            else if (strcmp(v_Words[0].c_str(), "$normalTex") == 0)
-            {
-                normThread = std::thread(LoadTextureFromPackAsync, v_Words[1], p_Gfx);
-                normTex = v_Words[1];
-            }
+        // Loads that don't share requests (e.g. synchronous and asynchronous one) could have created the same material
+        if (id == 0)
+        {
+            p_Gfx->m_NumDuplicateResources++;
+            LOG_F(WARNING, "%s was loaded twice, dropping the second copy", matName.c_str());
+            return;
         }
 
-        // Check if other threads were started and if yes join them
-        if (normThread.get_id() != std::thread::id()) {
-            if (normThread.joinable())
-                normThread.join();
-            else
-                LOG_F(ERROR, "Normal thread was started but is not joinable!");
+        // Textures used by the material can't be evicted while the material is loaded
+        for (uint32_t textureId : { material.GetDiffuseTextureId(), material.GetSpecularTextureId(), material.GetNormalTextureId() })
+        {
+            if (textureId != 0 && !p_Gfx->m_Textures.AddReference(textureId))
+                LOG_F(WARNING, "Texture of %s was evicted before the material was created", matName.c_str());
         }
 
-        if (diffThread.get_id() != std::thread::id()) {
-            if (diffThread.joinable())
-                diffThread.join();
-            else
-                LOG_F(ERROR, "Diffuse thread was started but is not joinable!");
-        }
+        LOG_F(INFO, "Material %s created with ID %u", matName.c_str(), id);
+    }
 
-        if (specThread.get_id() != std::thread::id()) {
-            if (specThread.joinable())
-                specThread.join();
-            else
-                LOG_F(ERROR, "Specular thread was started but is not joinable!");
-        }
+    /*
+        Fills out material from its description.
+        Textures used by the material have to be loaded before.
+    */
+    Material GraphicsDx11::BuildMaterial(const MaterialDescription& description, GraphicsDx11* p_Gfx, const std::string& matName)
+    {
+        Material material = {};
 
         // Set material properties
-        material.SetBaseColor(baseColor);
-        material.SetSubColor(subColor);
-        material.SetSpecularPower(specPower);
-        material.SetDiffuseTextureId(p_Gfx->GetTextureIdByName(diffTex));
-        material.SetSpecularTextureId(p_Gfx->GetTextureIdByName(specTex));
-        material.SetNormalTextureId(p_Gfx->GetTextureIdByName(normTex));
+        material.SetBaseColor(description.m_BaseColor);
+        material.SetSubColor(description.m_SubColor);
+        material.SetSpecularPower(description.m_SpecularPower);
+        material.SetDiffuseTextureId(p_Gfx->GetTextureIdByName(description.m_DiffuseTexture));
+        material.SetSpecularTextureId(p_Gfx->GetTextureIdByName(description.m_SpecularTexture));
+        material.SetNormalTextureId(p_Gfx->GetTextureIdByName(description.m_NormalTexture));
         material.m_MaterialName = matName;
 
-        // Add material to Graphics class instance
-        p_Gfx->m_MaterialIdSemaphore.acquire();
-        material.m_MaterialId = p_Gfx->GenerateMaterialUID();
-        p_Gfx->mv_Materials.push_back(material);
-        p_Gfx->m_MaterialIdSemaphore.release();
-
-        LOG_F(INFO, "Material %s created with ID %u", material.GetMaterialName().c_str(), material.GetMaterialUID());
+        return material;
     }
 
     /*
@@ -2178,65 +3340,7 @@ namespace Mesa
     */
     void GraphicsDx11::LoadTextureFromPackAsync(std::string originalName, GraphicsDx11* p_Gfx)
     {
-        // Use lookup table to find in which pack the texture is contained in
-            // and what index it has
-        auto packName = LookUpUtils::FindFilePack(originalName);
-        auto packIndex = LookUpUtils::FindFileIndex(originalName);
-
-        // Validate lookup results
-        if (packName.empty() || !packIndex.has_value())
-        {
-            LOG_F(ERROR, "Could not find %s in lookup table!", originalName.c_str());
-            return;
-        }
-
-        // Read pack contents
-        std::string packPath = FileUtils::CombinePaths(ConfigUtils::GetValueFromConfigCS("Path", "Texture"), packName);
-        std::vector<uint8_t> v_PackData = FileUtils::ReadBinaryData(packPath);
-
-        if (v_PackData.empty())
-        {
-            LOG_F(ERROR, "Could not read %s", packPath.c_str());
-            return;
-        }
-
-        // Calculate where file details are
-        uint32_t headerPos = sizeof(uint32_t) + (sizeof(uint64_t) + sizeof(uint32_t)) * packIndex.value();
-
-        // Validate calculation results
-        if (headerPos >= v_PackData.size())
-        {
-            LOG_F(ERROR, "Invalid header position of %s", originalName.c_str());
-            return;
-        }
-
-        // Calculate where file data starts
-        uint64_t startPos = 0;
-        memcpy(&startPos, &v_PackData[headerPos], sizeof(uint64_t));
-
-        // Validate calculation results
-        if (startPos <= headerPos)
-        {
-            LOG_F(ERROR, "Invalid starting position of %s", originalName.c_str());
-            return;
-        }
-
-        // Grab file size
-        uint32_t fileSize = 0;
-        memcpy(&fileSize, &v_PackData[headerPos + sizeof(uint64_t)], sizeof(uint32_t));
-
-        // Validate file size
-        if (fileSize <= 0)
-        {
-            LOG_F(ERROR, "Invalid size of %s", originalName.c_str());
-            return;
-        }
-
-        // Load texture data
-        std::vector<uint8_t> v_TextureData(fileSize);
-        memcpy(&v_TextureData[0], &v_PackData[startPos - 1], fileSize);
-
-        LoadTexture(v_TextureData, p_Gfx, originalName);
+        p_Gfx->LoadTextureOnce(originalName, [p_Gfx, &originalName]() { return p_Gfx->ReadAssetFromPack("Texture", originalName); });
     }
 
     void GraphicsDx11::CreateCriticalTexture(uint32_t width, uint32_t height, DXGI_FORMAT format, D3D11_BIND_FLAG bindFlag, GraphicsDx11* p_Gfx, ID3D11Texture2D** pp_Texture, ID3D11ShaderResourceView** pp_View)
@@ -2264,131 +3368,4 @@ namespace Mesa
         THROW_IF_FAILED_DX(p_Gfx->mp_Device->CreateShaderResourceView(*pp_Texture, &srv, pp_View));
     }
 
-    /*
-        Generate unique shader ID
-    */
-    uint32_t GraphicsDx11::GenerateShaderUID()
-    {
-        // If no shaders have been loaded yet don't bother looking for free ID and simply give it 1
-        if (mv_Shaders.empty()) return 1;
-
-        // Start search with ID of 1 - (0 will be reserved for fallback shader)
-        uint32_t id = 1;
-        bool idFound = false;
-
-        do {
-            idFound = false;
-
-            for (auto& shader : mv_Shaders)
-            {
-                // Check if ID is already in use
-                if (shader.m_ShaderUID == id)
-                    idFound = true;
-            }
-
-            // If ID is in use increment target ID and repeat the search
-            if (idFound)
-                id++;
-
-        } while (idFound);
-
-        // Return free ID
-        return id;
-    }
-
-    /*
-        Generate unique texture ID
-    */
-    uint32_t GraphicsDx11::GenerateTextureUID()
-    {
-        // If no textures have been loaded yet don't bother looking for free ID and simply give it 1
-        if (mv_Textures.empty()) return 1;
-
-        // Start search with ID of 1 - (0 will be reserved for fallback texture)
-        uint32_t id = 1;
-        bool idFound = false;
-
-        do {
-            idFound = false;
-
-            for (auto& texture : mv_Textures)
-            {
-                // Check if ID is already in use
-                if (texture.m_TextureUID == id)
-                    idFound = true;
-            }
-
-            // If ID is in use increment target ID and repeat the search
-            if (idFound)
-                id++;
-
-        } while (idFound);
-
-        // Return free ID
-        return id;
-    }
-
-    /*
-        Generates unique model ID
-    */
-    uint32_t GraphicsDx11::GenerateModelUID()
-    {
-        // If no models have been loaded yet don't bother looking for free ID and simply give it 1
-        if (mv_Models.empty()) return 1;
-
-        // Start search with ID of 1 - (0 will be reserved for fallback model)
-        uint32_t id = 1;
-        bool idFound = false;
-
-        do {
-            idFound = false;
-
-            for (auto& model : mv_Models)
-            {
-                // Check if ID is already in use
-                if (model.m_ModelUID == id)
-                    idFound = true;
-            }
-
-            // If ID is in use increment target ID and repeat the search
-            if (idFound)
-                id++;
-
-        } while (idFound);
-
-        // Return free ID
-        return id;
-    }
-
-    /*
-        Generates unique material ID
-    */
-    uint32_t GraphicsDx11::GenerateMaterialUID()
-    {
-        // If no materials have been loaded yet don't bother looking for free ID and simply give it 1
-        if (mv_Materials.empty()) return 1;
-
-        // Start search with ID of 1 - (0 will be reserved for fallback material)
-        uint32_t id = 1;
-        bool idFound = false;
-
-        do {
-            idFound = false;
-
-            for (auto& material : mv_Materials)
-            {
-                // Check if ID is already in use
-                if (material.m_MaterialId == id)
-                    idFound = true;
-            }
-
-            // If ID is in use increment target ID and repeat the search
-            if (idFound)
-                id++;
-
-        } while (idFound);
-
-        // Return free ID
-        return id;
-    }
 }
\ No newline at end of file
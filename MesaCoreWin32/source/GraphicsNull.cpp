@@ -0,0 +1,777 @@
+#include <Mesa/GraphicsNull.h>
+#include <Mesa/EngineConfig.h>
+#include <Mesa/FileUtils.h>
+#include <Mesa/LookUpUtils.h>
+#include <Mesa/PackUtils.h>
+#include <Mesa/JobSystem.h>
+#include <Mesa/ConstBuffer.h>
+#include <Mesa/ConvertUtils.h>
+
+namespace Mesa
+{
+	/*
+		Adds work of one frame to the work of all frames
+	*/
+	static void AddStatistics(DrawStatistics& total, const DrawStatistics& frame)
+	{
+		total.m_NumDrawCalls += frame.m_NumDrawCalls;
+		total.m_NumIndices += frame.m_NumIndices;
+		total.m_NumShaderBinds += frame.m_NumShaderBinds;
+		total.m_NumTextureBinds += frame.m_NumTextureBinds;
+		total.m_NumBufferUpdates += frame.m_NumBufferUpdates;
+		total.m_NumCopies += frame.m_NumCopies;
+		total.m_NumInstances += frame.m_NumInstances;
+		total.m_NumConstantBytes += frame.m_NumConstantBytes;
+		total.m_NumDrawStreams += frame.m_NumDrawStreams;
+	}
+
+	GraphicsNull::GraphicsNull()
+	{
+		LOG_F(INFO, "Initializing null renderer...");
+
+		ReadStreamingSettings();
+
+		m_UploadRing.Reset(UploadRing::DEFAULT_CAPACITY);
+
+		LOG_F(INFO, "Null renderer initialized, draw calls will only be counted");
+	}
+
+	GraphicsNull::~GraphicsNull()
+	{
+		LogLoadStatistics();
+		LogFrameStatistics();
+	}
+
+	/*
+		Reads how much time per frame can be spent on evicting assets and how much memory
+		loaded assets can take before unused ones are evicted
+	*/
+	void GraphicsNull::ReadStreamingSettings()
+	{
+		const ConfigSnapshot& config = EngineConfig::GetSnapshot();
+
+		float evictionBudget = config.Get<ConfigKey_StreamingEvictionBudget>();
+		if (evictionBudget > 0.0f) m_EvictionBudget = evictionBudget;
+
+		// Memory budgets are set in megabytes, 0 disables eviction of the category
+		auto toBytes = [](float megabytes) { return (uint64_t)(std::max(megabytes, 0.0f) * 1024.0 * 1024.0); };
+
+		m_Textures.SetBudget(toBytes(config.Get<ConfigKey_StreamingTextureBudget>()));
+		m_Models.SetBudget(toBytes(config.Get<ConfigKey_StreamingModelBudget>()));
+		m_Materials.SetBudget(toBytes(config.Get<ConfigKey_StreamingMaterialBudget>()));
+	}
+
+	/*
+		Builds the render queue like GraphicsDx11 and counts work the frame would submit.
+		Window isn't used since nothing is presented.
+	*/
+	void GraphicsNull::DrawFrame(Window* p_Window)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		m_FrameStatistics = DrawStatistics();
+
+		// Free memory of assets that haven't been used recently
+		EvictUnusedAssets();
+
+		// Collect draws of all layers and passes and sort them once
+		BuildRenderQueue(mp_Camera);
+
+		// Passes that GraphicsDx11 would run are found by the same frame graph
+		BuildFrameGraph();
+		m_FrameGraph.Compile();
+
+		m_UploadRing.BeginFrame(m_FrameIndex);
+		m_FrameGraph.Execute([](const FrameBarrier&) {}, [this](uint32_t, uint32_t) { m_FrameStatistics.m_NumCopies++; });
+		m_UploadRing.EndFrame();
+		m_UploadRing.ReleaseFrames(m_FrameIndex);
+
+		AddStatistics(m_TotalStatistics, m_FrameStatistics);
+		m_TotalFrameTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		m_FrameIndex++;
+	}
+
+	/*
+		Counts queued draws of one pass of a layer.
+		Draws are batched and recorded into draw streams by workers like in GraphicsDx11,
+		and binds and buffer updates are counted when the streams are replayed.
+	*/
+	void GraphicsNull::RecordLayerPass(uint32_t layer, DrawPass pass)
+	{
+		m_InstanceBatcher.Build(m_RenderQueue.GetItems(layer, pass), [this](uint32_t shaderId)
+		{
+			const ShaderNull* p_Shader = m_Shaders.Get(shaderId);
+			return p_Shader != nullptr && p_Shader->IsInstanced();
+		});
+
+		// Matrices of all instances are uploaded at once
+		if (!m_InstanceBatcher.GetInstances().empty()) m_FrameStatistics.m_NumBufferUpdates++;
+
+		DrawConstantWriters writers;
+		writers.m_MvpSize = sizeof(ConstBufferDx11::MvpBuffer);
+		writers.m_MaterialSize = pass == DrawPass_Color ? sizeof(ConstBufferDx11::MaterialBufferColorPass) : sizeof(ConstBufferDx11::MaterialBufferSpecularPass);
+
+		// Only world matrices are written, camera of this backend has no matrices
+		writers.m_WriteMvp = [](const GameObject3D* p_Object, uint8_t* p_Out)
+		{
+			glm::mat4x4 world = p_Object != nullptr ? p_Object->GetWorldMatrix() : glm::mat4x4(1.0f);
+			memcpy(p_Out, &world, sizeof(world));
+		};
+
+		writers.m_WriteMaterial = [this](uint32_t materialId, uint8_t*) { return m_Materials.Get(materialId) != nullptr; };
+
+		m_DrawRecorder.Record(m_InstanceBatcher.GetBatches(), writers);
+
+		// Streams are counted against the registries, so commands of evicted assets are skipped like in GraphicsDx11
+		DrawAssetLookup assets;
+		assets.m_HasShader = [this](uint32_t shaderId) { return m_Shaders.Get(shaderId) != nullptr; };
+		assets.m_HasModel = [this](uint32_t modelId) { return m_Models.Get(modelId) != nullptr; };
+
+		assets.m_GetMesh = [this](uint32_t modelId, uint32_t meshIndex, uint32_t& outNumIndices)
+		{
+			const ModelNull* p_Model = m_Models.Get(modelId);
+			if (p_Model == nullptr) return false;
+
+			outNumIndices = p_Model->mv_Meshes[meshIndex].m_NumIndices;
+			return true;
+		};
+
+		assets.m_GetMaterialTexture = [this, pass](uint32_t materialId, uint32_t& outTextureId)
+		{
+			const Material* p_Material = m_Materials.Get(materialId);
+			if (p_Material == nullptr) return false;
+
+			outTextureId = pass == DrawPass_Specular ? p_Material->GetSpecularTextureId() : p_Material->GetDiffuseTextureId();
+			return true;
+		};
+
+		assets.m_UseTexture = [this](uint32_t textureId) { return m_Textures.Use(textureId, m_FrameIndex) != nullptr; };
+
+		for (const auto& stream : m_DrawRecorder.GetStreams())
+		{
+			if (!stream.mv_Constants.empty()) AllocateConstants(stream.mv_Constants.size());
+			DrawRecorder::CountStream(stream, assets, m_FrameStatistics);
+		}
+
+		m_FrameStatistics.m_NumDrawStreams += m_DrawRecorder.GetStreams().size();
+	}
+
+	/*
+		Counts constants of a draw stream and allocates them from the upload ring like GraphicsDx11,
+		so the ring grows to the size a frame needs.
+	*/
+	void GraphicsNull::AllocateConstants(uint64_t size)
+	{
+		uint64_t offset = 0;
+
+		while (!m_UploadRing.Allocate(size, offset))
+		{
+			LOG_F(WARNING, "Constants of a frame don't fit into %llu bytes, upload ring will grow", (unsigned long long)m_UploadRing.GetCapacity());
+			m_UploadRing.Reset(m_UploadRing.GetCapacity() * 2);
+		}
+
+		m_FrameStatistics.m_NumConstantBytes += UploadRing::AlignSize(size);
+	}
+
+	/*
+		Counts blending of a layer with the previous layers
+	*/
+	void GraphicsNull::RecordBlendPass()
+	{
+		if (m_Shaders.Get(m_BlendingShaderId) == nullptr) return;
+
+		m_FrameStatistics.m_NumShaderBinds++;
+		m_FrameStatistics.m_NumTextureBinds += 2;
+		m_FrameStatistics.m_NumDrawCalls++;
+		m_FrameStatistics.m_NumIndices += 6;
+	}
+
+	/*
+		Adds the same passes and copies as GraphicsDx11::BuildFrameGraph(), passes count their work instead of drawing.
+		Textures have no size since they are never created.
+	*/
+	void GraphicsNull::BuildFrameGraph()
+	{
+		m_FrameGraph.Reset();
+
+		FrameTextureDesc desc;
+		FrameResource backBuffer = m_FrameGraph.ImportTexture("BackBuffer", desc, FrameResourceState_Present);
+
+		FrameBlendFunction blend;
+		if (m_Shaders.Get(m_BlendingShaderId) != nullptr) blend = [this](const FrameGraph&, FrameResource, FrameResource, FrameResource) { RecordBlendPass(); };
+
+		m_FrameGraph.AddLayerPasses(backBuffer, desc, m_NumLayers, [this](const FrameGraph&, FrameResource, uint32_t layer, DrawPass pass) { RecordLayerPass(layer, pass); }, blend);
+	}
+
+	void GraphicsNull::SetCamera(Camera* p_Camera)
+	{
+		mp_Camera = p_Camera;
+	}
+
+	void GraphicsNull::SetBlendingShader(uint32_t shaderId)
+	{
+		if (m_Shaders.Get(shaderId) == nullptr)
+		{
+			LOG_F(WARNING, "Couldn't find shader with ID = %u! Blending shader unchanged!", shaderId);
+			return;
+		}
+
+		m_BlendingShaderId = shaderId;
+	}
+
+	std::map<std::string, uint32_t> GraphicsNull::CompileForwardShaderPack(const std::string& packPath)
+	{
+		return LoadShaderPack(packPath, ShaderType_Forward);
+	}
+
+	std::map<std::string, uint32_t> GraphicsNull::CompileDeferredShaderPack(const std::string& packPath)
+	{
+		return LoadShaderPack(packPath, ShaderType_Deferred);
+	}
+
+	/*
+		Reads shader pack and registers its pairs of vertex and pixel shaders.
+		Data is read so the load costs the same I/O as with DirectX, but shaders aren't compiled.
+	*/
+	std::map<std::string, uint32_t> GraphicsNull::LoadShaderPack(const std::string& packPath, ShaderType type)
+	{
+		AssetBlob pack = AssetBlob::MapFile(FileUtils::CombinePaths(EngineConfig::Get<ConfigKey_PathShader>(), packPath));
+		auto v_Locations = PackUtils::ParsePackHeader(pack);
+		if (v_Locations.empty()) return std::map<std::string, uint32_t>();
+
+		auto v_Entries = LookUpUtils::LoadSpecificPackInfo(packPath);
+
+		// Every vertex shader has to be followed by its pixel shader
+		if (v_Locations.size() != v_Entries.size() || v_Entries.size() % 2 != 0) return std::map<std::string, uint32_t>();
+
+		std::map<std::string, uint32_t> result;
+
+		for (size_t i = 0; i < v_Entries.size(); i += 2)
+		{
+			if (v_Entries[i].m_Index >= v_Locations.size() || v_Entries[i + 1].m_Index >= v_Locations.size()) continue;
+
+			AssetBlob vertexData = PackUtils::ExtractEntry(pack, v_Locations[v_Entries[i].m_Index]);
+
+			if (vertexData.IsEmpty() || PackUtils::ExtractEntry(pack, v_Locations[v_Entries[i + 1].m_Index]).IsEmpty()) continue;
+
+			result[v_Entries[i].m_OriginalName] = RegisterShader(v_Entries[i].m_OriginalName, v_Entries[i + 1].m_OriginalName, type, vertexData);
+		}
+
+		return result;
+	}
+
+	/*
+		Reads specified vertex shader and its pixel shader that follows it in the pack
+	*/
+	uint32_t GraphicsNull::CompileForwardShaderFromPack(const std::string& vertexName)
+	{
+		auto packName = LookUpUtils::FindFilePack(vertexName);
+		auto vertexIndex = LookUpUtils::FindFileIndex(vertexName);
+
+		if (packName.empty() || !vertexIndex.has_value())
+		{
+			LOG_F(ERROR, "Could not find %s in lookup table!", vertexName.c_str());
+			return 0;
+		}
+
+		uint32_t pixelIndex = vertexIndex.value() + 1;
+		auto pixelName = LookUpUtils::GetFileNameFromPack(packName, pixelIndex);
+		if (pixelName.empty())
+		{
+			LOG_F(ERROR, "Could not read pixel shader name");
+			return 0;
+		}
+
+		std::string packPath = FileUtils::CombinePaths(EngineConfig::Get<ConfigKey_PathShader>(), packName);
+		PackReadRequest vertexRequest = { packPath, vertexIndex.value() };
+		PackReadRequest pixelRequest = { packPath, pixelIndex };
+		auto v_ShaderData = PackUtils::ReadEntries({ vertexRequest, pixelRequest });
+
+		if (v_ShaderData[0].empty() || v_ShaderData[1].empty())
+		{
+			LOG_F(ERROR, "Could not read %s from %s", vertexName.c_str(), packPath.c_str());
+			return 0;
+		}
+
+		return RegisterShader(vertexName, pixelName, ShaderType_Forward, v_ShaderData[0]);
+	}
+
+	/*
+		Registers shader under the name of its vertex shader, returns ID of the shader that is registered already.
+		Source isn't compiled, so forward shaders are instanced if their source mentions the instance semantic.
+	*/
+	uint32_t GraphicsNull::RegisterShader(const std::string& vertexName, const std::string& pixelName, ShaderType type, ByteView vertexData)
+	{
+		ShaderNull shader = {};
+		shader.m_VertexShaderName = vertexName;
+		shader.m_PixelShaderName = pixelName;
+		shader.m_ShaderType = type;
+		shader.m_IsInstanced = type == ShaderType_Forward &&
+			std::string_view((const char*)vertexData.data(), vertexData.size()).find(Shader::INSTANCE_SEMANTIC) != std::string_view::npos;
+
+		uint32_t id = m_Shaders.Insert(vertexName, shader, 0, [](ShaderNull& s, uint32_t handle) { s.m_ShaderUID = handle; });
+		return id != 0 ? id : GetShaderIdByVertexName(vertexName);
+	}
+
+	/*
+		Loads textures from archive, entries are decoded in parallel
+	*/
+	std::map<std::string, uint32_t> GraphicsNull::LoadTexturePack(const std::string& packPath)
+	{
+		AssetBlob pack = AssetBlob::MapFile(FileUtils::CombinePaths(EngineConfig::Get<ConfigKey_PathTexture>(), packPath));
+		auto v_Locations = PackUtils::ParsePackHeader(pack);
+		if (v_Locations.empty()) return std::map<std::string, uint32_t>();
+
+		auto v_Entries = LookUpUtils::LoadSpecificPackInfo(packPath);
+		if (v_Locations.size() != v_Entries.size()) return std::map<std::string, uint32_t>();
+
+		JobCounter counter;
+
+		for (const auto& entry : v_Entries)
+		{
+			if (entry.m_Index >= v_Locations.size() || GetTextureIdByName(entry.m_OriginalName) != 0) continue;
+
+			JobSystem::GetDefault().Run([this, data = PackUtils::ExtractEntry(pack, v_Locations[entry.m_Index]), name = entry.m_OriginalName]()
+			{
+				LoadTexture(data, name);
+			}, &counter);
+		}
+
+		JobSystem::GetDefault().Wait(counter);
+
+		std::map<std::string, uint32_t> result;
+
+		for (const auto& entry : v_Entries)
+			result[entry.m_OriginalName] = GetTextureIdByName(entry.m_OriginalName);
+
+		return result;
+	}
+
+	/*
+		Loads models from archive together with their materials and textures
+	*/
+	std::map<std::string, uint32_t> GraphicsNull::LoadModelPack(const std::string& packPath)
+	{
+		AssetBlob pack = AssetBlob::MapFile(FileUtils::CombinePaths(EngineConfig::Get<ConfigKey_PathModel>(), packPath));
+		auto v_Locations = PackUtils::ParsePackHeader(pack);
+		if (v_Locations.empty()) return std::map<std::string, uint32_t>();
+
+		auto v_Entries = LookUpUtils::LoadSpecificPackInfo(packPath);
+		if (v_Locations.size() != v_Entries.size()) return std::map<std::string, uint32_t>();
+
+		JobCounter counter;
+
+		for (const auto& entry : v_Entries)
+		{
+			if (entry.m_Index >= v_Locations.size() || GetModelIdByName(entry.m_OriginalName) != 0) continue;
+
+			JobSystem::GetDefault().Run([this, data = PackUtils::ExtractEntry(pack, v_Locations[entry.m_Index]), name = entry.m_OriginalName]()
+			{
+				LoadModel(data, name);
+			}, &counter);
+		}
+
+		JobSystem::GetDefault().Wait(counter);
+
+		std::map<std::string, uint32_t> result;
+
+		for (const auto& entry : v_Entries)
+			result[entry.m_OriginalName] = GetModelIdByName(entry.m_OriginalName);
+
+		return result;
+	}
+
+	/*
+		Loads materials from archive together with their textures
+	*/
+	std::map<std::string, uint32_t> GraphicsNull::LoadMaterialPack(const std::string& packPath)
+	{
+		AssetBlob pack = AssetBlob::MapFile(FileUtils::CombinePaths(EngineConfig::Get<ConfigKey_PathMaterial>(), packPath));
+		auto v_Locations = PackUtils::ParsePackHeader(pack);
+		if (v_Locations.empty()) return std::map<std::string, uint32_t>();
+
+		auto v_Entries = LookUpUtils::LoadSpecificPackInfo(packPath);
+		if (v_Locations.size() != v_Entries.size()) return std::map<std::string, uint32_t>();
+
+		std::map<std::string, uint32_t> result;
+
+		for (const auto& entry : v_Entries)
+		{
+			if (entry.m_Index >= v_Locations.size()) continue;
+
+			uint32_t id = GetMaterialIdByName(entry.m_OriginalName);
+			result[entry.m_OriginalName] = id != 0 ? id : LoadMaterial(PackUtils::ExtractEntry(pack, v_Locations[entry.m_Index]), entry.m_OriginalName);
+		}
+
+		return result;
+	}
+
+	/*
+		Loads specified model from a model pack
+	*/
+	uint32_t GraphicsNull::LoadModelFromPack(const std::string& originalName)
+	{
+		uint32_t existingId = GetModelIdByName(originalName);
+		if (existingId != 0) return existingId;
+
+		AssetBlob modelData = ReadAssetFromPack("Model", originalName);
+		if (modelData.IsEmpty()) return 0;
+
+		return LoadModel(modelData, originalName);
+	}
+
+	/*
+		Loads multiple models in parallel
+	*/
+	std::map<std::string, uint32_t> GraphicsNull::LoadModelsFromPack(const std::vector<std::string>& v_OriginalNames)
+	{
+		JobCounter counter;
+
+		for (const auto& name : v_OriginalNames)
+		{
+			if (!name.empty()) JobSystem::GetDefault().Run([this, name]() { LoadModelFromPack(name); }, &counter);
+		}
+
+		JobSystem::GetDefault().Wait(counter);
+
+		std::map<std::string, uint32_t> result;
+
+		for (const auto& name : v_OriginalNames)
+		{
+			if (!name.empty()) result[name] = GetModelIdByName(name);
+		}
+
+		return result;
+	}
+
+	/*
+		Loads specified texture from a texture pack, concurrent requests for the same texture share one load
+	*/
+	uint32_t GraphicsNull::LoadTextureFromPack(const std::string& originalName)
+	{
+		if (originalName.empty()) return 0;
+
+		return m_TextureRequests.Do(originalName, [&]()
+		{
+			uint32_t existingId = GetTextureIdByName(originalName);
+			if (existingId != 0) return existingId;
+
+			AssetBlob textureData = ReadAssetFromPack("Texture", originalName);
+			if (textureData.IsEmpty()) return 0u;
+
+			return LoadTexture(textureData, originalName);
+		});
+	}
+
+	/*
+		Loads multiple textures in parallel
+	*/
+	std::map<std::string, uint32_t> GraphicsNull::LoadTexturesFromPack(const std::vector<std::string>& v_OriginalNames)
+	{
+		JobCounter counter;
+
+		for (const auto& name : v_OriginalNames)
+		{
+			if (!name.empty()) JobSystem::GetDefault().Run([this, name]() { LoadTextureFromPack(name); }, &counter);
+		}
+
+		JobSystem::GetDefault().Wait(counter);
+
+		std::map<std::string, uint32_t> result;
+
+		for (const auto& name : v_OriginalNames)
+		{
+			if (!name.empty()) result[name] = GetTextureIdByName(name);
+		}
+
+		return result;
+	}
+
+	/*
+		Loads single material from pack together with its textures
+	*/
+	uint32_t GraphicsNull::LoadMaterialFromPack(const std::string& originalName)
+	{
+		uint32_t existingId = GetMaterialIdByName(originalName);
+		if (existingId != 0) return existingId;
+
+		AssetBlob matData = ReadAssetFromPack("Material", originalName);
+		if (matData.IsEmpty()) return 0;
+
+		return LoadMaterial(matData, originalName);
+	}
+
+	/*
+		Decodes texture and registers its size, pixels are dropped since there is nothing to upload them to
+	*/
+	uint32_t GraphicsNull::LoadTexture(ByteView textureData, const std::string& textureName)
+	{
+		std::vector<uint8_t> v_Pixels;
+		uint32_t width = 0, height = 0;
+
+		if (lodepng::decode(v_Pixels, width, height, textureData.data(), textureData.size()))
+		{
+			LOG_F(ERROR, "Failed to decode %s", textureName.c_str());
+			return 0;
+		}
+
+		TextureNull texture = {};
+		texture.m_TextureName = textureName;
+		texture.m_Width = width;
+		texture.m_Height = height;
+
+		uint32_t id = m_Textures.Insert(textureName, texture, v_Pixels.size(), [](TextureNull& t, uint32_t handle) { t.m_TextureUID = handle; });
+
+		// Texture could have been loaded by another load in the meantime
+		if (id == 0)
+		{
+			m_NumDuplicateResources++;
+			return GetTextureIdByName(textureName);
+		}
+
+		return id;
+	}
+
+	/*
+		Imports model using ASSIMP and loads materials of its meshes
+	*/
+	uint32_t GraphicsNull::LoadModel(ByteView modelData, const std::string& modelName)
+	{
+		Assimp::Importer importer;
+
+		const aiScene* p_Scene = importer.ReadFileFromMemory(modelData.data(), modelData.size(), aiProcess_Triangulate | aiProcess_ConvertToLeftHanded, ".fbx");
+		if (p_Scene == nullptr)
+		{
+			LOG_F(ERROR, "Failed to import %s with error %s", modelName.c_str(), importer.GetErrorString());
+			return 0;
+		}
+
+		ModelNull model = {};
+		model.m_ModelName = modelName;
+
+		// Size of vertex and index buffers the model would take on the GPU
+		uint64_t numBytes = 0;
+		ProcessNode(model.mv_Meshes, numBytes, p_Scene->mRootNode, p_Scene);
+
+		for (size_t i = 0; i < model.mv_Meshes.size(); i++)
+			model.m_Bounds = i == 0 ? model.mv_Meshes[i].m_Bounds : BoundingVolume::Merge(model.m_Bounds, model.mv_Meshes[i].m_Bounds);
+
+		auto p_Definitions = m_MaterialDefinitions.Find(FileUtils::StripPathToFileName(modelName) + ".matdef");
+
+		for (auto& mesh : model.mv_Meshes)
+		{
+			if (p_Definitions)
+			{
+				auto it = p_Definitions->find(mesh.m_MeshMatName);
+				if (it != p_Definitions->end()) mesh.m_MaterialName = ConvertUtils::ReplaceCharInString(it->second, '\\', '/');
+			}
+
+			if (mesh.m_MaterialName.empty())
+			{
+				LOG_F(ERROR, "No material defined for %s", mesh.m_MeshMatName.c_str());
+				continue;
+			}
+
+			mesh.m_MaterialId = LoadMaterialFromPack(mesh.m_MaterialName);
+		}
+
+		uint32_t id = m_Models.Insert(modelName, model, numBytes, [](ModelNull& m, uint32_t handle) { m.m_ModelUID = handle; });
+
+		if (id == 0)
+		{
+			m_NumDuplicateResources++;
+			return GetModelIdByName(modelName);
+		}
+
+		// Materials used by the model can't be evicted while the model is loaded
+		for (const auto& mesh : model.mv_Meshes)
+		{
+			if (mesh.m_MaterialId != 0) m_Materials.AddReference(mesh.m_MaterialId);
+		}
+
+		return id;
+	}
+
+	/*
+		Collects index counts, bounds and material names of all meshes of the node and its children
+	*/
+	void GraphicsNull::ProcessNode(std::vector<MeshNull>& v_OutMeshes, uint64_t& outNumBytes, aiNode* p_Node, const aiScene* p_Scene)
+	{
+		for (size_t i = 0; i < p_Node->mNumMeshes; i++)
+		{
+			const aiMesh* p_Mesh = p_Scene->mMeshes[p_Node->mMeshes[i]];
+
+			MeshNull mesh = {};
+
+			for (size_t j = 0; j < p_Mesh->mNumFaces; j++)
+				mesh.m_NumIndices += p_Mesh->mFaces[j].mNumIndices;
+
+			if (p_Mesh->mMaterialIndex < p_Scene->mNumMaterials)
+				mesh.m_MeshMatName = p_Scene->mMaterials[p_Mesh->mMaterialIndex]->GetName().C_Str();
+
+			mesh.m_Bounds = BoundingVolume::FromPoints((const float*)p_Mesh->mVertices, p_Mesh->mNumVertices, sizeof(aiVector3D));
+
+			outNumBytes += p_Mesh->mNumVertices * sizeof(VertexDx11) + mesh.m_NumIndices * sizeof(uint32_t);
+			v_OutMeshes.push_back(std::move(mesh));
+		}
+
+		for (size_t i = 0; i < p_Node->mNumChildren; i++)
+			ProcessNode(v_OutMeshes, outNumBytes, p_Node->mChildren[i], p_Scene);
+	}
+
+	/*
+		Parses material and loads its textures
+	*/
+	uint32_t GraphicsNull::LoadMaterial(ByteView matData, const std::string& matName)
+	{
+		MaterialDescription description = MaterialFormat::Parse(matData);
+
+		Material material = {};
+		material.SetBaseColor(description.m_BaseColor);
+		material.SetSubColor(description.m_SubColor);
+		material.SetSpecularPower(description.m_SpecularPower);
+		material.SetDiffuseTextureId(LoadTextureFromPack(description.m_DiffuseTexture));
+		material.SetSpecularTextureId(LoadTextureFromPack(description.m_SpecularTexture));
+		material.SetNormalTextureId(LoadTextureFromPack(description.m_NormalTexture));
+		material.m_MaterialName = matName;
+
+		uint32_t id = m_Materials.Insert(matName, material, sizeof(Material), [](Material& m, uint32_t handle) { m.m_MaterialId = handle; });
+
+		if (id == 0)
+		{
+			m_NumDuplicateResources++;
+			return GetMaterialIdByName(matName);
+		}
+
+		// Textures used by the material can't be evicted while the material is loaded
+		for (uint32_t textureId : { material.GetDiffuseTextureId(), material.GetSpecularTextureId(), material.GetNormalTextureId() })
+		{
+			if (textureId != 0) m_Textures.AddReference(textureId);
+		}
+
+		return id;
+	}
+
+	AssetHandle<uint32_t> GraphicsNull::LoadModelAsync(std::string originalName)
+	{
+		return m_AsyncModelRequests.Do(originalName, [this, &originalName]() { return BeginLoad(originalName, &GraphicsNull::LoadModelFromPack); });
+	}
+
+	AssetHandle<uint32_t> GraphicsNull::LoadTextureAsync(std::string originalName)
+	{
+		// Materials don't have to use every kind of texture
+		if (originalName.empty()) return BeginLoad(originalName, &GraphicsNull::LoadTextureFromPack);
+
+		return m_AsyncTextureRequests.Do(originalName, [this, &originalName]() { return BeginLoad(originalName, &GraphicsNull::LoadTextureFromPack); });
+	}
+
+	AssetHandle<uint32_t> GraphicsNull::LoadMaterialAsync(std::string originalName)
+	{
+		return m_AsyncMaterialRequests.Do(originalName, [this, &originalName]() { return BeginLoad(originalName, &GraphicsNull::LoadMaterialFromPack); });
+	}
+
+	AssetHandle<std::map<std::string, uint32_t>> GraphicsNull::LoadModelPackAsync(std::string packPath)
+	{
+		return LoadPackAsync(packPath, &GraphicsNull::LoadModelAsync);
+	}
+
+	AssetHandle<std::map<std::string, uint32_t>> GraphicsNull::LoadTexturePackAsync(std::string packPath)
+	{
+		return LoadPackAsync(packPath, &GraphicsNull::LoadTextureAsync);
+	}
+
+	AssetHandle<std::map<std::string, uint32_t>> GraphicsNull::LoadMaterialPackAsync(std::string packPath)
+	{
+		return LoadPackAsync(packPath, &GraphicsNull::LoadMaterialAsync);
+	}
+
+	/*
+		Runs synchronous load of an asset on one of the job system workers.
+		Nothing has to be created on the main thread, so the whole load runs there.
+	*/
+	AssetHandle<uint32_t> GraphicsNull::BeginLoad(std::string originalName, uint32_t(GraphicsNull::* p_Load)(const std::string&))
+	{
+		if (originalName.empty()) co_return 0;
+
+		co_await JobSystem::GetDefault().Schedule();
+
+		co_return (this->*p_Load)(originalName);
+	}
+
+	/*
+		Starts loads of all assets in the pack and waits for all of them
+	*/
+	AssetHandle<std::map<std::string, uint32_t>> GraphicsNull::LoadPackAsync(std::string packPath, AssetHandle<uint32_t>(GraphicsNull::* p_LoadAsync)(std::string))
+	{
+		co_await JobSystem::GetDefault().Schedule();
+
+		auto v_Entries = LookUpUtils::LoadSpecificPackInfo(packPath);
+
+		std::vector<AssetHandle<uint32_t>> v_Handles;
+		for (const auto& entry : v_Entries)
+			v_Handles.push_back((this->*p_LoadAsync)(entry.m_OriginalName));
+
+		std::map<std::string, uint32_t> result;
+		for (size_t i = 0; i < v_Entries.size(); i++)
+			result[v_Entries[i].m_OriginalName] = co_await v_Handles[i];
+
+		co_return result;
+	}
+
+	/*
+		Logs how many assets were loaded and how many loads were shared
+	*/
+	void GraphicsNull::LogLoadStatistics()
+	{
+		LOG_F(INFO, "Texture loads: %llu requests, %llu duplicates avoided", (unsigned long long)m_TextureRequests.GetNumRequests(), (unsigned long long)m_TextureRequests.GetNumCoalesced());
+		LOG_F(INFO, "Duplicate assets dropped: %llu", (unsigned long long)m_NumDuplicateResources.load());
+		LOG_F(INFO, "Material definitions: %llu requests, %llu pack reads", (unsigned long long)m_MaterialDefinitions.GetNumRequests(), (unsigned long long)m_MaterialDefinitions.GetNumPackReads());
+
+		const char* names[] = { "Shaders", "Textures", "Models", "Materials" };
+
+		for (uint32_t type = AssetType_Shader; type <= AssetType_Material; type++)
+		{
+			AssetRegistryStatistics statistics = GetAssetStatistics((AssetType)type);
+
+			LOG_F(INFO, "%s: %llu loaded (%llu KB of %llu KB budget), %llu evicted (%llu KB), %llu reloaded", names[type],
+				(unsigned long long)statistics.m_NumAssets, (unsigned long long)(statistics.m_NumBytes / 1024), (unsigned long long)(statistics.m_Budget / 1024),
+				(unsigned long long)statistics.m_NumEvictions, (unsigned long long)(statistics.m_NumEvictedBytes / 1024), (unsigned long long)statistics.m_NumReloads);
+		}
+	}
+
+	/*
+		Logs work counted over all frames and average CPU time of a frame
+	*/
+	void GraphicsNull::LogFrameStatistics()
+	{
+		if (m_FrameIndex == 0) return;
+
+		LOG_F(INFO, "Frames: %llu, %.3f ms per frame", (unsigned long long)m_FrameIndex, m_TotalFrameTime / m_FrameIndex);
+		LOG_F(INFO, "Draw calls: %llu (%llu indices, %llu instances), shader binds: %llu, texture binds: %llu, buffer updates: %llu (%llu constant bytes), copies: %llu, draw streams: %llu",
+			(unsigned long long)m_TotalStatistics.m_NumDrawCalls, (unsigned long long)m_TotalStatistics.m_NumIndices, (unsigned long long)m_TotalStatistics.m_NumInstances,
+			(unsigned long long)m_TotalStatistics.m_NumShaderBinds, (unsigned long long)m_TotalStatistics.m_NumTextureBinds,
+			(unsigned long long)m_TotalStatistics.m_NumBufferUpdates, (unsigned long long)m_TotalStatistics.m_NumConstantBytes, (unsigned long long)m_TotalStatistics.m_NumCopies,
+			(unsigned long long)m_TotalStatistics.m_NumDrawStreams);
+	}
+
+	uint32_t GraphicsNull::GetShaderIdByVertexName(const std::string& name)
+	{
+		return m_Shaders.Find(name);
+	}
+
+	uint32_t GraphicsNull::GetTextureIdByName(const std::string& name)
+	{
+		return m_Textures.Find(name);
+	}
+
+	uint32_t GraphicsNull::GetModelIdByName(const std::string& name)
+	{
+		return m_Models.Find(name);
+	}
+
+	uint32_t GraphicsNull::GetMaterialIdByName(const std::string& name)
+	{
+		return m_Materials.Find(name);
+	}
+}
\ No newline at end of file
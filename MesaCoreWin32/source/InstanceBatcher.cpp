@@ -0,0 +1,87 @@
+#include <Mesa/InstanceBatcher.h>
+
+namespace Mesa
+{
+	/*
+		Checks whether two draws can share a batch apart from their mesh.
+		Keys only hold truncated IDs, so full IDs are compared too.
+	*/
+	bool InstanceBatcher::IsSameGroup(const DrawItem& a, const DrawItem& b)
+	{
+		return (a.m_SortKey >> RenderQueue::DEPTH_BITS) == (b.m_SortKey >> RenderQueue::DEPTH_BITS) &&
+			a.m_ShaderId == b.m_ShaderId && a.m_MaterialId == b.m_MaterialId && a.m_ModelId == b.m_ModelId;
+	}
+
+	/*
+		Builds batches from draws of one pass of a layer. Memory is kept for the next call.
+		isInstanced tells whether a shader reads world matrices from the instance buffer.
+	*/
+	void InstanceBatcher::Build(std::span<const DrawItem> items, const std::function<bool(uint32_t shaderId)>& isInstanced)
+	{
+		mv_Batches.clear();
+		mv_Instances.clear();
+
+		size_t begin = 0;
+		uint32_t lastShaderId = 0;
+		bool isShaderInstanced = false;
+
+		while (begin < items.size())
+		{
+			const DrawItem& first = items[begin];
+
+			if (begin == 0 || first.m_ShaderId != lastShaderId)
+			{
+				isShaderInstanced = isInstanced(first.m_ShaderId);
+				lastShaderId = first.m_ShaderId;
+			}
+
+			if (!isShaderInstanced)
+			{
+				InstanceBatch batch;
+				batch.mp_Object = first.mp_Object;
+				batch.m_ShaderId = first.m_ShaderId;
+				batch.m_ModelId = first.m_ModelId;
+				batch.m_MaterialId = first.m_MaterialId;
+				batch.m_MeshIndex = first.m_MeshIndex;
+
+				mv_Batches.push_back(batch);
+				begin++;
+				continue;
+			}
+
+			size_t end = begin + 1;
+			while (end < items.size() && IsSameGroup(first, items[end])) end++;
+
+			mv_Order.clear();
+			for (size_t i = begin; i < end; i++) mv_Order.push_back((uint32_t)i);
+
+			std::stable_sort(mv_Order.begin(), mv_Order.end(), [&items](uint32_t a, uint32_t b) { return items[a].m_MeshIndex < items[b].m_MeshIndex; });
+
+			for (size_t i = 0; i < mv_Order.size(); i++)
+			{
+				const DrawItem& item = items[mv_Order[i]];
+
+				// Every mesh of the group starts its own batch
+				if (i == 0 || item.m_MeshIndex != items[mv_Order[i - 1]].m_MeshIndex)
+				{
+					InstanceBatch batch;
+					batch.mp_Object = item.mp_Object;
+					batch.m_ShaderId = item.m_ShaderId;
+					batch.m_ModelId = item.m_ModelId;
+					batch.m_MaterialId = item.m_MaterialId;
+					batch.m_MeshIndex = item.m_MeshIndex;
+					batch.m_FirstInstance = (uint32_t)mv_Instances.size();
+					batch.m_NumInstances = 0;
+					batch.m_IsInstanced = true;
+
+					mv_Batches.push_back(batch);
+				}
+
+				mv_Batches.back().m_NumInstances++;
+				mv_Instances.push_back(item.mp_Object->GetWorldMatrix());
+			}
+
+			begin = end;
+		}
+	}
+}
\ No newline at end of file
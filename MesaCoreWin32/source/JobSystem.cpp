@@ -0,0 +1,266 @@
+#include <Mesa/JobSystem.h>
+
+namespace Mesa
+{
+	// Job system the current thread works for (nullptr if it isn't a worker)
+	static thread_local JobSystem* tp_OwnerSystem = nullptr;
+	// Index of the queue that belongs to the current worker
+	static thread_local size_t t_WorkerIndex = 0;
+
+	/*
+		Constructor: Creates work queues and starts worker threads.
+	*/
+	JobSystem::JobSystem(uint32_t numWorkers)
+	{
+		numWorkers = std::max(numWorkers, 1u);
+
+		// Additional queue is shared by threads that are not workers
+		for (uint32_t i = 0; i <= numWorkers; i++)
+			mv_Queues.push_back(std::make_unique<WorkQueue>());
+
+		m_NumActiveWorkers = numWorkers;
+
+		for (uint32_t i = 0; i < numWorkers; i++)
+			mv_Workers.push_back(std::thread(&JobSystem::WorkerLoop, this, (size_t)i));
+
+		LOG_F(INFO, "Job system started with %u workers", numWorkers);
+	}
+
+	/*
+		Destructor: Finishes all queued jobs and stops worker threads.
+	*/
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_Shutdown = true;
+		}
+
+		m_SleepCondition.notify_all();
+
+		for (auto& worker : mv_Workers)
+		{
+			if (worker.joinable())
+				worker.join();
+		}
+	}
+
+	/*
+		Returns job system shared by the whole engine.
+		One worker is started per hardware thread except the one that is used by the main thread.
+	*/
+	JobSystem& JobSystem::GetDefault()
+	{
+		static JobSystem jobSystem(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+		return jobSystem;
+	}
+
+	/*
+		Queues job for execution.
+		If counter is provided it is increased now and decreased once the job finishes.
+	*/
+	void JobSystem::Run(Job job, JobCounter* p_Counter)
+	{
+		if (p_Counter) p_Counter->m_Pending++;
+
+		// Workers push to their own queue so the jobs they spawn stay local, other threads use the shared one
+		WorkQueue& queue = *mv_Queues[GetQueueIndex()];
+
+		{
+			std::lock_guard<std::mutex> lock(queue.m_Mutex);
+			queue.m_Jobs.push_back({ std::move(job), p_Counter });
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_QueuedJobs++;
+		}
+
+		// Sleeping worker that is woken up could be one of the inactive ones
+		if (m_NumActiveWorkers < mv_Workers.size())
+			m_SleepCondition.notify_all();
+		else
+			m_SleepCondition.notify_one();
+	}
+
+	/*
+		Limits number of workers that execute jobs, the rest of them sleep until the limit is raised.
+		At least one worker stays active, so jobs that nobody waits for still run.
+		Used to measure how the engine scales with number of threads.
+	*/
+	void JobSystem::SetNumActiveWorkers(uint32_t numWorkers)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_NumActiveWorkers = std::clamp(numWorkers, 1u, (uint32_t)mv_Workers.size());
+		}
+
+		m_SleepCondition.notify_all();
+	}
+
+	/*
+		Blocks until all jobs attached to the counter are finished.
+		Instead of sleeping calling thread executes queued jobs while it waits.
+		If any of the jobs threw an exception it is rethrown here.
+	*/
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		size_t queueIndex = GetQueueIndex();
+
+		while (!counter.IsDone())
+		{
+			if (TryRunJob(queueIndex)) continue;
+
+			// There is nothing to do so sleep until new job is queued or the counter reaches zero
+			std::unique_lock<std::mutex> lock(m_SleepMutex);
+			m_SleepCondition.wait(lock, [&]() { return counter.IsDone() || m_QueuedJobs > 0; });
+		}
+
+		std::lock_guard<std::mutex> lock(counter.m_ExceptionMutex);
+		if (counter.mp_Exception)
+		{
+			std::exception_ptr p_Exception = counter.mp_Exception;
+			counter.mp_Exception = nullptr;
+			std::rethrow_exception(p_Exception);
+		}
+	}
+
+	/*
+		Executes one queued job on the calling thread, so threads that wait for something
+		other than a counter can help instead of blocking workers. Returns false if no job was queued.
+	*/
+	bool JobSystem::RunPendingJob()
+	{
+		return TryRunJob(GetQueueIndex());
+	}
+
+	/*
+		Calls body for every index in [0, count) splitting the work into jobs of batchSize indices.
+		Returns once every index was processed.
+	*/
+	void JobSystem::ParallelFor(size_t count, const std::function<void(size_t)>& body, size_t batchSize)
+	{
+		batchSize = std::max(batchSize, (size_t)1);
+
+		JobCounter counter;
+
+		for (size_t begin = 0; begin < count; begin += batchSize)
+		{
+			size_t end = std::min(begin + batchSize, count);
+
+			Run([&body, begin, end]()
+			{
+				for (size_t i = begin; i < end; i++)
+					body(i);
+			}, &counter);
+		}
+
+		Wait(counter);
+	}
+
+	/*
+		Returns index of the queue used by the calling thread.
+	*/
+	size_t JobSystem::GetQueueIndex() const
+	{
+		if (tp_OwnerSystem == this) return t_WorkerIndex;
+
+		return mv_Queues.size() - 1;
+	}
+
+	/*
+		Executes one job. The newest job from the thread's own queue is preferred,
+		if it's empty the oldest job is stolen from one of the other queues.
+		Returns false if there were no jobs to execute.
+	*/
+	bool JobSystem::TryRunJob(size_t queueIndex)
+	{
+		JobEntry entry;
+		bool found = false;
+
+		{
+			WorkQueue& queue = *mv_Queues[queueIndex];
+			std::lock_guard<std::mutex> lock(queue.m_Mutex);
+
+			if (!queue.m_Jobs.empty())
+			{
+				entry = std::move(queue.m_Jobs.back());
+				queue.m_Jobs.pop_back();
+				found = true;
+			}
+		}
+
+		// Start stealing from the next queue so all threads don't go after the same one
+		for (size_t i = 1; i < mv_Queues.size() && !found; i++)
+		{
+			WorkQueue& queue = *mv_Queues[(queueIndex + i) % mv_Queues.size()];
+			std::lock_guard<std::mutex> lock(queue.m_Mutex);
+
+			if (!queue.m_Jobs.empty())
+			{
+				entry = std::move(queue.m_Jobs.front());
+				queue.m_Jobs.pop_front();
+				found = true;
+			}
+		}
+
+		if (!found) return false;
+
+		m_QueuedJobs--;
+		Execute(entry);
+
+		return true;
+	}
+
+	/*
+		Runs the job and signals its counter.
+	*/
+	void JobSystem::Execute(JobEntry& entry)
+	{
+		try
+		{
+			entry.m_Job();
+		}
+		catch (const std::exception& e)
+		{
+			// Without a counter there is nobody to rethrow the exception to
+			if (entry.mp_Counter == nullptr)
+				LOG_F(ERROR, "Job failed: %s", e.what());
+			else
+			{
+				std::lock_guard<std::mutex> lock(entry.mp_Counter->m_ExceptionMutex);
+				if (!entry.mp_Counter->mp_Exception)
+					entry.mp_Counter->mp_Exception = std::current_exception();
+			}
+		}
+
+		if (entry.mp_Counter == nullptr) return;
+
+		// Wake up threads waiting for this counter once the last job is done
+		if (--entry.mp_Counter->m_Pending == 0)
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_SleepCondition.notify_all();
+		}
+	}
+
+	/*
+		Executes jobs until the job system is destroyed.
+	*/
+	void JobSystem::WorkerLoop(size_t queueIndex)
+	{
+		tp_OwnerSystem = this;
+		t_WorkerIndex = queueIndex;
+
+		while (true)
+		{
+			if (queueIndex < m_NumActiveWorkers && TryRunJob(queueIndex)) continue;
+
+			std::unique_lock<std::mutex> lock(m_SleepMutex);
+			m_SleepCondition.wait(lock, [this, queueIndex]() { return m_Shutdown || (queueIndex < m_NumActiveWorkers && m_QueuedJobs > 0); });
+
+			// Remaining jobs are finished by active workers
+			if (m_Shutdown && (queueIndex >= m_NumActiveWorkers || m_QueuedJobs <= 0)) return;
+		}
+	}
+}
\ No newline at end of file
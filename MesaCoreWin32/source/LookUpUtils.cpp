@@ -28,7 +28,7 @@ namespace Mesa
 			entry.m_OriginalName = v_details[0];
 			entry.m_PackName = v_details[1];
 			entry.m_Index = ConvertUtils::StringToInt(v_details[2]);
-			entry.m_Hash = ConvertUtils::StringToInt(v_details[3]);
+			entry.m_Hash = ConvertUtils::HexStringToUInt(v_details[3]); // Packer writes hashes in hexadecimal
 			entry.m_Size = ConvertUtils::StringToInt(v_details[4]);
 
 			v_result.push_back(entry);
@@ -0,0 +1,165 @@
+#include <Mesa/MaterialDefinitionCache.h>
+#include <Mesa/EngineConfig.h>
+#include <Mesa/FileUtils.h>
+#include <Mesa/PackUtils.h>
+
+namespace Mesa
+{
+	/*
+		Returns definitions from specified file or nullptr if the file can't be found or read.
+		Definitions of the whole pack are read and parsed if the file wasn't requested before.
+	*/
+	std::shared_ptr<const MaterialDefinitionCache::Definitions> MaterialDefinitionCache::Find(const std::string& matDefName)
+	{
+		m_NumRequests++;
+
+		std::string packName;
+		uint64_t generation = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			if (!m_Indexed) BuildIndex();
+
+			auto it = m_Definitions.find(matDefName);
+			if (it != m_Definitions.end()) return it->second;
+
+			auto packIt = m_FilePacks.find(matDefName);
+			if (packIt == m_FilePacks.end())
+			{
+				LOG_F(ERROR, "Could not find %s in lookup table!", matDefName.c_str());
+				return nullptr;
+			}
+
+			// Pack was parsed already but this file could not be read
+			if (m_ParsedPacks.find(packIt->second) != m_ParsedPacks.end()) return nullptr;
+
+			packName = packIt->second;
+			generation = m_Generation;
+		}
+
+		// Concurrent requests for files of the same pack wait for a single read
+		m_PackRequests.Do(packName, [&]() { ParsePack(packName, generation); return true; });
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		auto it = m_Definitions.find(matDefName);
+		return it != m_Definitions.end() ? it->second : nullptr;
+	}
+
+	/*
+		Drops all parsed definitions and the index, used after packs or lookup table changed
+	*/
+	void MaterialDefinitionCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		m_Indexed = false;
+		m_FilePacks.clear();
+		m_PackEntries.clear();
+		m_Definitions.clear();
+		m_ParsedPacks.clear();
+		m_Generation++;
+	}
+
+	/*
+		Parses contents of a material definition file.
+		Every line holds name of the mesh material and name of the material file separated by '='.
+	*/
+	MaterialDefinitionCache::Definitions MaterialDefinitionCache::Parse(ByteView data)
+	{
+		Definitions result;
+
+		std::string_view text((const char*)data.data(), data.size());
+
+		while (!text.empty())
+		{
+			size_t lineEnd = text.find('\n');
+			std::string_view line = text.substr(0, lineEnd);
+			text = lineEnd == std::string_view::npos ? std::string_view() : text.substr(lineEnd + 1);
+
+			if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+			size_t separator = line.find('=');
+			if (separator == std::string_view::npos) continue;
+
+			std::string_view value = line.substr(separator + 1);
+			value = value.substr(0, value.find('='));
+			if (value.empty()) continue;
+
+			result[std::string(line.substr(0, separator))] = std::string(value);
+		}
+
+		return result;
+	}
+
+	/*
+		Indexes definition files in lookup table by their file names.
+		Mutex has to be locked by the caller.
+	*/
+	void MaterialDefinitionCache::BuildIndex()
+	{
+		for (const auto& entry : LookUpUtils::LoadLookupTable())
+		{
+			if (std::filesystem::path(entry.m_OriginalName).extension() != ".matdef") continue;
+
+			std::string fileName = FileUtils::StripPathToFileName(entry.m_OriginalName);
+
+			// First entry with the name wins, same as a linear search of the table
+			if (!m_FilePacks.emplace(fileName, entry.m_PackName).second) continue;
+
+			m_PackEntries[entry.m_PackName].push_back(entry);
+		}
+
+		m_Indexed = true;
+	}
+
+	/*
+		Reads and parses all definition files stored in specified pack.
+		Results are dropped if the cache was cleared in the meantime.
+	*/
+	void MaterialDefinitionCache::ParsePack(const std::string& packName, uint64_t generation)
+	{
+		std::vector<LookUpEntry> v_Entries;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (generation != m_Generation || m_ParsedPacks.find(packName) != m_ParsedPacks.end()) return;
+
+			v_Entries = m_PackEntries[packName];
+		}
+
+		std::string packPath = FileUtils::CombinePaths(EngineConfig::Get<ConfigKey_PathModel>(), packName);
+
+		std::vector<PackReadRequest> v_Requests;
+		for (const auto& entry : v_Entries)
+			v_Requests.push_back({ packPath, entry.m_Index });
+
+		// Definition files are small, so reads of the whole pack are merged into a few large ones
+		auto v_Data = PackUtils::ReadEntries(v_Requests);
+		m_NumPackReads++;
+
+		std::vector<std::pair<std::string, std::shared_ptr<const Definitions>>> v_Parsed;
+
+		for (size_t i = 0; i < v_Entries.size(); i++)
+		{
+			if (v_Data[i].empty())
+			{
+				LOG_F(ERROR, "Could not read %s from %s", v_Entries[i].m_OriginalName.c_str(), packPath.c_str());
+				continue;
+			}
+
+			v_Parsed.push_back({ FileUtils::StripPathToFileName(v_Entries[i].m_OriginalName), std::make_shared<const Definitions>(Parse(v_Data[i])) });
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (generation != m_Generation) return;
+
+		for (auto& [fileName, p_Definitions] : v_Parsed)
+			m_Definitions[fileName] = std::move(p_Definitions);
+
+		m_ParsedPacks.insert(packName);
+
+		LOG_F(INFO, "Parsed %zu material definitions from %s", v_Parsed.size(), packPath.c_str());
+	}
+}
\ No newline at end of file
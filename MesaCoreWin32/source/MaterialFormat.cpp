@@ -0,0 +1,251 @@
+#include <Mesa/MaterialFormat.h>
+
+namespace Mesa
+{
+	// Keywords of text materials, order matches MaterialKeyword
+	static constexpr std::array<std::string_view, 12> MATERIAL_KEYWORDS = {
+		"$base_r", "$base_g", "$base_b", "$base_a",
+		"$sub_r", "$sub_g", "$sub_b", "$sub_a",
+		"$specular", "$diffuseTex", "$specularTex", "$normalTex"
+	};
+
+	enum MaterialKeyword
+	{
+		MaterialKeyword_BaseR = 0,
+		MaterialKeyword_BaseG,
+		MaterialKeyword_BaseB,
+		MaterialKeyword_BaseA,
+		MaterialKeyword_SubR,
+		MaterialKeyword_SubG,
+		MaterialKeyword_SubB,
+		MaterialKeyword_SubA,
+		MaterialKeyword_Specular,
+		MaterialKeyword_DiffuseTex,
+		MaterialKeyword_SpecularTex,
+		MaterialKeyword_NormalTex,
+	};
+
+	// Number of slots in keyword table, has to be a power of 2
+	static constexpr uint32_t KEYWORD_TABLE_SIZE = 32;
+
+	/*
+		FNV-1a hash of a keyword mixed with seed and reduced to a slot of keyword table
+	*/
+	static constexpr uint32_t HashKeyword(std::string_view keyword, uint32_t seed)
+	{
+		uint32_t hash = 2166136261u ^ seed;
+
+		for (char c : keyword)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 16777619u;
+		}
+
+		return (hash ^ (hash >> 15)) & (KEYWORD_TABLE_SIZE - 1);
+	}
+
+	/*
+		Searches for seed that puts every keyword into a different slot
+	*/
+	static constexpr uint32_t FindKeywordSeed()
+	{
+		for (uint32_t seed = 0; seed < 100000; seed++)
+		{
+			bool a_Used[KEYWORD_TABLE_SIZE] = {};
+			bool perfect = true;
+
+			for (const auto& keyword : MATERIAL_KEYWORDS)
+			{
+				uint32_t slot = HashKeyword(keyword, seed);
+				if (a_Used[slot]) { perfect = false; break; }
+				a_Used[slot] = true;
+			}
+
+			if (perfect) return seed;
+		}
+
+		return UINT32_MAX;
+	}
+
+	static constexpr uint32_t KEYWORD_SEED = FindKeywordSeed();
+	static_assert(KEYWORD_SEED != UINT32_MAX, "Could not find perfect hash of material keywords");
+
+	/*
+		Builds table that maps slot of a keyword to its index (-1 marks empty slots)
+	*/
+	static constexpr std::array<int8_t, KEYWORD_TABLE_SIZE> BuildKeywordTable()
+	{
+		std::array<int8_t, KEYWORD_TABLE_SIZE> table = {};
+		table.fill(-1);
+
+		for (size_t i = 0; i < MATERIAL_KEYWORDS.size(); i++)
+			table[HashKeyword(MATERIAL_KEYWORDS[i], KEYWORD_SEED)] = (int8_t)i;
+
+		return table;
+	}
+
+	static constexpr std::array<int8_t, KEYWORD_TABLE_SIZE> KEYWORD_TABLE = BuildKeywordTable();
+
+	/*
+		Returns index of the keyword or -1 if it isn't a keyword.
+		Only the keyword in the slot of the hash has to be compared.
+	*/
+	static int FindKeyword(std::string_view word)
+	{
+		int index = KEYWORD_TABLE[HashKeyword(word, KEYWORD_SEED)];
+		return index >= 0 && MATERIAL_KEYWORDS[index] == word ? index : -1;
+	}
+
+	/*
+		Parses float at the beginning of the text, returns 0 if the text doesn't start with a number
+	*/
+	static float ParseFloat(std::string_view text)
+	{
+		while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '+'))
+			text.remove_prefix(1);
+
+		float value = 0.0f;
+		auto [p_End, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+		return error == std::errc() ? value : 0.0f;
+	}
+
+	/*
+		Reads material in either format
+	*/
+	MaterialDescription MaterialFormat::Parse(ByteView data)
+	{
+		MaterialDescription description = {};
+
+		if (IsCompiled(data))
+		{
+			if (!ReadCompiled(data, description))
+				LOG_F(ERROR, "Compiled material is damaged!");
+
+			return description;
+		}
+
+		return ParseText(data);
+	}
+
+	/*
+		Parses text material. Every line holds keyword and its value separated by '='.
+		Lines with unknown keywords are skipped.
+	*/
+	MaterialDescription MaterialFormat::ParseText(ByteView data)
+	{
+		MaterialDescription description = {};
+
+		std::string_view text((const char*)data.data(), data.size());
+
+		while (!text.empty())
+		{
+			size_t lineEnd = text.find('\n');
+			std::string_view line = text.substr(0, lineEnd);
+			text = lineEnd == std::string_view::npos ? std::string_view() : text.substr(lineEnd + 1);
+
+			if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+			// Skip lines that don't have a value since all parameters require it
+			size_t separator = line.find('=');
+			if (separator == std::string_view::npos || separator + 1 == line.size()) continue;
+
+			std::string_view value = line.substr(separator + 1);
+			value = value.substr(0, value.find('='));
+
+			switch (FindKeyword(line.substr(0, separator)))
+			{
+			// Base color parameters
+			case MaterialKeyword_BaseR: description.m_BaseColor.x = ParseFloat(value); break;
+			case MaterialKeyword_BaseG: description.m_BaseColor.y = ParseFloat(value); break;
+			case MaterialKeyword_BaseB: description.m_BaseColor.z = ParseFloat(value); break;
+			case MaterialKeyword_BaseA: description.m_BaseColor.w = ParseFloat(value); break;
+			// Sub color parameters
+			case MaterialKeyword_SubR: description.m_SubColor.x = ParseFloat(value); break;
+			case MaterialKeyword_SubG: description.m_SubColor.y = ParseFloat(value); break;
+			case MaterialKeyword_SubB: description.m_SubColor.z = ParseFloat(value); break;
+			case MaterialKeyword_SubA: description.m_SubColor.w = ParseFloat(value); break;
+			// Specular data
+			case MaterialKeyword_Specular: description.m_SpecularPower = ParseFloat(value); break;
+			// Texture data
+			case MaterialKeyword_DiffuseTex: description.m_DiffuseTexture = std::string(value); break;
+			case MaterialKeyword_SpecularTex: description.m_SpecularTexture = std::string(value); break;
+			case MaterialKeyword_NormalTex: description.m_NormalTexture = std::string(value); break;
+			default: break;
+			}
+		}
+
+		return description;
+	}
+
+	/*
+		Copies compiled material into its description.
+		Returns false if the record or names of its textures don't fit into the data.
+	*/
+	bool MaterialFormat::ReadCompiled(ByteView data, MaterialDescription& outDescription)
+	{
+		if (!IsCompiled(data)) return false;
+
+		MaterialRecord record = {};
+		memcpy(&record, data.data(), sizeof(MaterialRecord));
+
+		ByteView names = data.subspan(sizeof(MaterialRecord));
+		std::string* a_Textures[3] = { &outDescription.m_DiffuseTexture, &outDescription.m_SpecularTexture, &outDescription.m_NormalTexture };
+
+		for (size_t i = 0; i < 3; i++)
+		{
+			const MaterialTextureRef& texture = record.ma_Textures[i];
+			if (texture.m_Offset > names.size() || texture.m_Length > names.size() - texture.m_Offset) return false;
+
+			a_Textures[i]->assign((const char*)names.data() + texture.m_Offset, texture.m_Length);
+		}
+
+		memcpy(&outDescription.m_BaseColor[0], record.ma_BaseColor, sizeof(record.ma_BaseColor));
+		memcpy(&outDescription.m_SubColor[0], record.ma_SubColor, sizeof(record.ma_SubColor));
+		outDescription.m_SpecularPower = record.m_SpecularPower;
+
+		return true;
+	}
+
+	/*
+		Writes material as a record followed by names of its textures
+	*/
+	std::vector<uint8_t> MaterialFormat::Compile(const MaterialDescription& description)
+	{
+		MaterialRecord record = {};
+		record.m_Magic = MATERIAL_MAGIC;
+		record.m_Version = MATERIAL_VERSION;
+		memcpy(record.ma_BaseColor, &description.m_BaseColor[0], sizeof(record.ma_BaseColor));
+		memcpy(record.ma_SubColor, &description.m_SubColor[0], sizeof(record.ma_SubColor));
+		record.m_SpecularPower = description.m_SpecularPower;
+
+		std::string names;
+		const std::string* a_Textures[3] = { &description.m_DiffuseTexture, &description.m_SpecularTexture, &description.m_NormalTexture };
+
+		for (size_t i = 0; i < 3; i++)
+		{
+			record.ma_Textures[i].m_Offset = (uint32_t)names.size();
+			record.ma_Textures[i].m_Length = (uint32_t)a_Textures[i]->size();
+			names += *a_Textures[i];
+		}
+
+		std::vector<uint8_t> v_Data(sizeof(MaterialRecord) + names.size());
+		memcpy(v_Data.data(), &record, sizeof(MaterialRecord));
+		if (!names.empty()) memcpy(v_Data.data() + sizeof(MaterialRecord), names.data(), names.size());
+
+		return v_Data;
+	}
+
+	/*
+		Checks if data starts with record of compiled material of the current version
+	*/
+	bool MaterialFormat::IsCompiled(ByteView data)
+	{
+		if (data.size() < sizeof(MaterialRecord)) return false;
+
+		uint32_t header[2] = {};
+		memcpy(header, data.data(), sizeof(header));
+
+		return header[0] == MATERIAL_MAGIC && header[1] == MATERIAL_VERSION;
+	}
+}
\ No newline at end of file
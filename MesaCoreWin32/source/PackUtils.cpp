@@ -0,0 +1,375 @@
+#include <Mesa/PackUtils.h>
+#include <Mesa/FileUtils.h>
+#include <Mesa/AsyncFileReader.h>
+#include <Mesa/AccessTrace.h>
+
+namespace Mesa
+{
+	// Size of a single record in archive header (8 bytes for starting position + 4 bytes for file size)
+	static constexpr uint64_t PACK_RECORD_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+
+	/*
+		Converts raw archive header into list of entry locations.
+		Header consists of number of files followed by starting position
+		and size of every file. Starting positions are stored with +1 offset.
+		If the header is invalid returns empty vector.
+	*/
+	static std::vector<PackEntryLocation> DecodeHeader(const uint8_t* p_Header, uint32_t numFiles, uint64_t packSize)
+	{
+		std::vector<PackEntryLocation> v_result;
+		v_result.reserve(numFiles);
+
+		uint64_t headerSize = sizeof(uint32_t) + PACK_RECORD_SIZE * numFiles;
+
+		for (uint32_t i = 0; i < numFiles; i++)
+		{
+			const uint8_t* p_Record = p_Header + PACK_RECORD_SIZE * i;
+
+			uint64_t startPos = 0;
+			uint32_t fileSize = 0;
+			memcpy(&startPos, p_Record, sizeof(uint64_t));
+			memcpy(&fileSize, p_Record + sizeof(uint64_t), sizeof(uint32_t));
+
+			PackEntryLocation location = {};
+			location.m_Offset = startPos - 1;
+			location.m_Size = fileSize;
+
+			// Make sure that the entry lies between the end of the header and the end of the archive
+			if (startPos == 0 || location.m_Offset < headerSize || location.m_Offset + location.m_Size > packSize)
+			{
+				LOG_F(ERROR, "Invalid header record %u in archive!", i);
+				return std::vector<PackEntryLocation>();
+			}
+
+			v_result.push_back(location);
+		}
+
+		return v_result;
+	}
+
+	/*
+		Reads locations of all entries from archive data that is already in memory.
+	*/
+	std::vector<PackEntryLocation> PackUtils::ParsePackHeader(ByteView packData)
+	{
+		if (packData.size() < sizeof(uint32_t)) return std::vector<PackEntryLocation>();
+
+		// Calculate number of files in pack
+		uint32_t numFiles = 0;
+		memcpy(&numFiles, packData.data(), sizeof(uint32_t));
+
+		// Validate that the whole header fits in the archive
+		if (numFiles == 0 || sizeof(uint32_t) + PACK_RECORD_SIZE * numFiles > packData.size())
+			return std::vector<PackEntryLocation>();
+
+		return DecodeHeader(packData.data() + sizeof(uint32_t), numFiles, packData.size());
+	}
+
+	/*
+		Reads locations of all entries in archive without reading the data itself.
+	*/
+	std::vector<PackEntryLocation> PackUtils::ReadPackHeader(const std::string& packPath)
+	{
+		auto packSize = FileUtils::FileSizeSafe(packPath);
+		if (!packSize.has_value()) return std::vector<PackEntryLocation>();
+
+		std::ifstream file(packPath, std::ios::binary);
+		if (!file.is_open()) return std::vector<PackEntryLocation>();
+
+		// Read number of files in pack
+		uint32_t numFiles = 0;
+		file.read((char*)&numFiles, sizeof(uint32_t));
+
+		// Validate that the whole header fits in the archive
+		if (!file || numFiles == 0 || sizeof(uint32_t) + PACK_RECORD_SIZE * numFiles > packSize.value())
+		{
+			LOG_F(ERROR, "Invalid header of %s", packPath.c_str());
+			return std::vector<PackEntryLocation>();
+		}
+
+		// Read the rest of the header in one go
+		std::vector<uint8_t> v_Header(PACK_RECORD_SIZE * numFiles);
+		file.read((char*)v_Header.data(), v_Header.size());
+
+		if (!file)
+		{
+			LOG_F(ERROR, "Could not read header of %s", packPath.c_str());
+			return std::vector<PackEntryLocation>();
+		}
+
+		return DecodeHeader(v_Header.data(), numFiles, packSize.value());
+	}
+
+	/*
+		Returns single entry of archive data that is already in memory.
+		Entry shares the buffer of the archive, so nothing is copied.
+	*/
+	AssetBlob PackUtils::ExtractEntry(const AssetBlob& pack, const PackEntryLocation& location)
+	{
+		return pack.Slice(location.m_Offset, location.m_Size);
+	}
+
+	/*
+		Reads single entry from archive.
+		Only the header and the entry itself are read from the disk.
+	*/
+	std::vector<uint8_t> PackUtils::ReadEntry(const std::string& packPath, uint32_t index)
+	{
+		PackReadRequest request = {};
+		request.m_PackPath = packPath;
+		request.m_Index = index;
+
+		return ReadEntries({ request }).front();
+	}
+
+	/*
+		Single coalesced read together with entries it covers.
+		Every span pairs location of an entry with index of the request it belongs to.
+	*/
+	struct MergedRead
+	{
+		std::string m_PackPath;
+		uint64_t m_Offset = 0;
+		uint64_t m_Size = 0;
+		std::vector<std::pair<PackEntryLocation, size_t>> mv_Spans;
+	};
+
+	/*
+		Groups requests by archive, sorts them by their position and merges
+		neighbouring entries (separated by at most mergeGap bytes) into single reads.
+	*/
+	static std::vector<MergedRead> PlanReads(const std::vector<PackReadRequest>& v_Requests, uint64_t mergeGap)
+	{
+		std::vector<MergedRead> v_result;
+
+		// Group requests by archive they belong to
+		std::map<std::string, std::vector<size_t>> packRequests;
+		for (size_t i = 0; i < v_Requests.size(); i++)
+			packRequests[v_Requests[i].m_PackPath].push_back(i);
+
+		for (const auto& pack : packRequests)
+		{
+			auto v_Locations = PackUtils::ReadPackHeader(pack.first);
+			if (v_Locations.empty())
+			{
+				LOG_F(ERROR, "Could not read %s", pack.first.c_str());
+				continue;
+			}
+
+			// Pair every request with location of its entry
+			std::vector<std::pair<PackEntryLocation, size_t>> v_Spans;
+			v_Spans.reserve(pack.second.size());
+
+			for (const auto& requestId : pack.second)
+			{
+				uint32_t index = v_Requests[requestId].m_Index;
+				if (index >= v_Locations.size())
+				{
+					LOG_F(ERROR, "Invalid index %u in %s", index, pack.first.c_str());
+					continue;
+				}
+
+				v_Spans.push_back(std::make_pair(v_Locations[index], requestId));
+			}
+
+			// Sort entries by their position so the archive is read front to back
+			std::sort(v_Spans.begin(), v_Spans.end(), [](const auto& a, const auto& b) { return a.first.m_Offset < b.first.m_Offset; });
+
+			size_t numReads = 0;
+			size_t first = 0;
+
+			while (first < v_Spans.size())
+			{
+				uint64_t rangeBegin = v_Spans[first].first.m_Offset;
+				uint64_t rangeEnd = rangeBegin + v_Spans[first].first.m_Size;
+				size_t last = first + 1;
+
+				// Extend the range with every following entry that is close enough
+				while (last < v_Spans.size())
+				{
+					const auto& next = v_Spans[last].first;
+					uint64_t nextEnd = std::max(rangeEnd, next.m_Offset + next.m_Size);
+
+					if (next.m_Offset > rangeEnd + mergeGap || nextEnd - rangeBegin > PackUtils::MAX_MERGED_READ) break;
+
+					rangeEnd = nextEnd;
+					last++;
+				}
+
+				MergedRead read = {};
+				read.m_PackPath = pack.first;
+				read.m_Offset = rangeBegin;
+				read.m_Size = rangeEnd - rangeBegin;
+				read.mv_Spans.assign(v_Spans.begin() + first, v_Spans.begin() + last);
+				v_result.push_back(std::move(read));
+				numReads++;
+
+				first = last;
+			}
+
+			LOG_F(INFO, "Read %zu entries from %s using %zu reads", v_Spans.size(), pack.first.c_str(), numReads);
+		}
+
+		return v_result;
+	}
+
+	/*
+		Submits all reads to the async file reader at once and waits until every one of them completes.
+		Callback is invoked from reader threads for every completed read.
+		Portable builds have no async file reader, reads are executed one by one on the calling thread.
+	*/
+	static void SubmitReads(const std::vector<MergedRead>& v_Reads, const std::function<void(const MergedRead&, const AsyncReadResult&)>& callback)
+	{
+#ifdef MESA_PORTABLE
+		std::vector<uint8_t> v_Buffer;
+
+		for (const auto& read : v_Reads)
+		{
+			v_Buffer.resize(read.m_Size);
+
+			std::ifstream file(read.m_PackPath, std::ios::binary);
+			file.seekg(read.m_Offset);
+			file.read((char*)v_Buffer.data(), read.m_Size);
+
+			AsyncReadResult result = {};
+			result.mp_Data = v_Buffer.data();
+			result.m_Offset = read.m_Offset;
+			result.m_Size = (uint32_t)read.m_Size;
+			result.m_BytesRead = (uint32_t)file.gcount();
+			result.m_Success = result.m_BytesRead == result.m_Size;
+
+			if (!result.m_Success)
+				LOG_F(ERROR, "Failed to read %llu bytes from %s", (unsigned long long)read.m_Size, read.m_PackPath.c_str());
+
+			callback(read, result);
+		}
+#else
+		// Counter of reads that are still in flight
+		size_t pendingReads = v_Reads.size();
+		std::mutex pendingMutex;
+		std::condition_variable pendingCondition;
+
+		AsyncFileReader& reader = AsyncFileReader::GetDefault();
+
+		for (const auto& read : v_Reads)
+		{
+			reader.Submit(read.m_PackPath, read.m_Offset, (uint32_t)read.m_Size, [&](const AsyncReadResult& result)
+			{
+				if (!result.m_Success)
+					LOG_F(ERROR, "Failed to read %llu bytes from %s", (unsigned long long)read.m_Size, read.m_PackPath.c_str());
+
+				callback(read, result);
+
+				std::lock_guard<std::mutex> lock(pendingMutex);
+				pendingReads--;
+				pendingCondition.notify_one();
+			});
+		}
+
+		// Wait until every read is completed
+		std::unique_lock<std::mutex> lock(pendingMutex);
+		pendingCondition.wait(lock, [&]() { return pendingReads == 0; });
+#endif
+	}
+
+	/*
+		Reads multiple entries from one or more archives.
+		Requests are grouped per archive and sorted by their position,
+		neighbouring entries (separated by at most mergeGap bytes) are read
+		with a single sequential read and then scattered back to their requests.
+		Reads of all archives are submitted to the async file reader at once
+		and this function returns after every one of them completes.
+		Result holds data for every request in the same order as requests were provided.
+		Entries that could not be read are left empty.
+	*/
+	std::vector<std::vector<uint8_t>> PackUtils::ReadEntries(const std::vector<PackReadRequest>& v_Requests, uint64_t mergeGap)
+	{
+		std::vector<std::vector<uint8_t>> v_result(v_Requests.size());
+
+		auto startTime = std::chrono::steady_clock::now();
+		uint64_t bytesRead = 0;
+
+		SubmitReads(PlanReads(v_Requests, mergeGap), [&](const MergedRead& read, const AsyncReadResult& result)
+		{
+			if (!result.m_Success) return;
+
+			// Scatter range data back to the requests (every request is written by exactly one read)
+			for (const auto& span : read.mv_Spans)
+			{
+				const uint8_t* p_Begin = result.mp_Data + (span.first.m_Offset - read.m_Offset);
+				v_result[span.second].assign(p_Begin, p_Begin + span.first.m_Size);
+			}
+		});
+
+		// Remember which entries were needed so they can be prefetched on the next run
+		for (size_t i = 0; i < v_Requests.size(); i++)
+		{
+			if (v_result[i].empty()) continue;
+
+			AccessTrace::Record(v_Requests[i].m_PackPath, v_Requests[i].m_Index);
+			bytesRead += v_result[i].size();
+		}
+
+		AccessTrace::RecordRead(bytesRead, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+
+		return v_result;
+	}
+
+	/*
+		Reads single entry whose location was already read from the header of its archive,
+		so reading many entries one at a time doesn't read the header again for every one of them.
+	*/
+	std::vector<uint8_t> PackUtils::ReadEntryAt(const std::string& packPath, uint32_t index, const PackEntryLocation& location)
+	{
+		std::vector<uint8_t> v_result;
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		MergedRead read = {};
+		read.m_PackPath = packPath;
+		read.m_Offset = location.m_Offset;
+		read.m_Size = location.m_Size;
+		read.mv_Spans.push_back(std::make_pair(location, (size_t)0));
+
+		SubmitReads({ read }, [&](const MergedRead&, const AsyncReadResult& result)
+		{
+			if (result.m_Success) v_result.assign(result.mp_Data, result.mp_Data + location.m_Size);
+		});
+
+		if (!v_result.empty()) AccessTrace::Record(packPath, index);
+		AccessTrace::RecordRead(v_result.size(), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+
+		return v_result;
+	}
+
+	/*
+		Reads specified entries without keeping their data so that
+		the following reads of the same entries are served from the system cache.
+		Reads are issued in order the requests were provided in.
+		Returns number of bytes that were read.
+	*/
+	uint64_t PackUtils::PrefetchEntries(const std::vector<PackReadRequest>& v_Requests, uint64_t mergeGap)
+	{
+		std::vector<MergedRead> v_Reads = PlanReads(v_Requests, mergeGap);
+
+		// Restore the order of requests (requests that come first are needed first)
+		auto firstRequest = [](const MergedRead& read)
+		{
+			size_t result = std::numeric_limits<size_t>::max();
+			for (const auto& span : read.mv_Spans)
+				result = std::min(result, span.second);
+			return result;
+		};
+
+		std::stable_sort(v_Reads.begin(), v_Reads.end(), [&](const auto& a, const auto& b) { return firstRequest(a) < firstRequest(b); });
+
+		std::atomic<uint64_t> bytesRead = 0;
+
+		SubmitReads(v_Reads, [&](const MergedRead& read, const AsyncReadResult& result)
+		{
+			if (result.m_Success) bytesRead += result.m_BytesRead;
+		});
+
+		return bytesRead;
+	}
+}
\ No newline at end of file
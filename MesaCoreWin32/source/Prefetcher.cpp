@@ -0,0 +1,58 @@
+#include <Mesa/Prefetcher.h>
+#include <Mesa/AccessTrace.h>
+#include <Mesa/PackUtils.h>
+
+namespace Mesa
+{
+	/*
+		Constructor: Starts replaying specified access trace in the background.
+	*/
+	Prefetcher::Prefetcher(const std::string& tracePath)
+	{
+		m_Thread = std::thread(&Prefetcher::Run, this, tracePath);
+	}
+
+	/*
+		Destructor: Waits for the prefetch to finish.
+	*/
+	Prefetcher::~Prefetcher()
+	{
+		Wait();
+	}
+
+	/*
+		Blocks until every entry from the trace was prefetched.
+	*/
+	void Prefetcher::Wait()
+	{
+		if (m_Thread.joinable())
+			m_Thread.join();
+	}
+
+	/*
+		Reads every entry from the access trace in order it was accessed in.
+	*/
+	void Prefetcher::Run(const std::string& tracePath)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+
+		std::vector<PackReadRequest> v_Requests;
+		for (const auto& entry : AccessTrace::Load(tracePath))
+		{
+			PackReadRequest request = {};
+			request.m_PackPath = entry.m_PackPath;
+			request.m_Index = entry.m_Index;
+			v_Requests.push_back(request);
+		}
+
+		if (!v_Requests.empty())
+		{
+			uint64_t bytesRead = PackUtils::PrefetchEntries(v_Requests);
+
+			LOG_F(INFO, "Prefetched %zu entries (%llu bytes) in %.2f ms", v_Requests.size(), (unsigned long long)bytesRead,
+				std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+		}
+
+		m_Finished = true;
+	}
+}
\ No newline at end of file
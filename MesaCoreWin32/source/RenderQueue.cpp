@@ -0,0 +1,143 @@
+#include <Mesa/RenderQueue.h>
+#include <Mesa/JobSystem.h>
+
+namespace Mesa
+{
+	static_assert(RenderQueue::LAYER_BITS + RenderQueue::PASS_BITS + RenderQueue::SHADER_BITS + RenderQueue::MATERIAL_BITS +
+		RenderQueue::MODEL_BITS + RenderQueue::DEPTH_BITS == 64, "Fields of sort key have to fill 64 bits");
+
+	static_assert(RenderQueue::MAX_LAYERS == (1u << RenderQueue::LAYER_BITS), "Every layer needs its own value in sort key");
+
+	// Number of bits the layer and pass are shifted by, they identify a range of the queue
+	static constexpr uint32_t RANGE_SHIFT = 64 - RenderQueue::LAYER_BITS - RenderQueue::PASS_BITS;
+
+	/*
+		Returns lower bits of the value that fit into a field of specified width
+	*/
+	static constexpr uint64_t Field(uint32_t value, uint32_t bits)
+	{
+		return value & ((1u << bits) - 1);
+	}
+
+	/*
+		Builds sort key of a draw. Depth is distance from the camera, closer draws are sorted first.
+		Bits of non-negative floats are ordered like the floats, so the highest bits of the depth are kept.
+	*/
+	uint64_t RenderQueue::MakeSortKey(uint32_t layer, DrawPass pass, uint32_t shaderId, uint32_t materialId, uint32_t modelId, float depth)
+	{
+		uint32_t depthBits = 0;
+		if (depth > 0.0f) memcpy(&depthBits, &depth, sizeof(depthBits));
+
+		uint64_t key = Field(layer, LAYER_BITS);
+		key = (key << PASS_BITS) | Field(pass, PASS_BITS);
+		key = (key << SHADER_BITS) | Field(shaderId, SHADER_BITS);
+		key = (key << MATERIAL_BITS) | Field(materialId, MATERIAL_BITS);
+		key = (key << MODEL_BITS) | Field(modelId, MODEL_BITS);
+		key = (key << DEPTH_BITS) | (depthBits >> (32 - DEPTH_BITS));
+
+		return key;
+	}
+
+	/*
+		Removes all draws, memory is kept for the next frame
+	*/
+	void RenderQueue::Clear()
+	{
+		mv_Items.clear();
+	}
+
+	void RenderQueue::Push(const DrawItem& item)
+	{
+		mv_Items.push_back(item);
+	}
+
+	/*
+		Pushes draws made from count sources, like visible objects, on the job system.
+		push(index, v_OutItems) adds draws of one source and is called by several workers at once.
+		Sources are split into slices with their own lists, which are appended in the order of the slices,
+		so the queue holds the same draws in the same order as if they were pushed one by one.
+	*/
+	void RenderQueue::PushParallel(size_t count, const std::function<void(size_t index, std::vector<DrawItem>& v_OutItems)>& push)
+	{
+		if (count <= PARALLEL_PUSH_SIZE)
+		{
+			for (size_t i = 0; i < count; i++)
+				push(i, mv_Items);
+
+			return;
+		}
+
+		size_t numSlices = (count + PARALLEL_PUSH_SIZE - 1) / PARALLEL_PUSH_SIZE;
+		if (mv_Slices.size() < numSlices) mv_Slices.resize(numSlices);
+
+		JobSystem::GetDefault().ParallelFor(numSlices, [&](size_t slice)
+		{
+			std::vector<DrawItem>& v_Items = mv_Slices[slice];
+			v_Items.clear();
+
+			size_t end = std::min((slice + 1) * PARALLEL_PUSH_SIZE, count);
+
+			for (size_t i = slice * PARALLEL_PUSH_SIZE; i < end; i++)
+				push(i, v_Items);
+		});
+
+		for (size_t slice = 0; slice < numSlices; slice++)
+			mv_Items.insert(mv_Items.end(), mv_Slices[slice].begin(), mv_Slices[slice].end());
+	}
+
+	/*
+		Sorts draws by their keys with a least significant digit radix sort over bytes of the key.
+		Histograms of all bytes are built in a single pass, and bytes that are equal in every key are skipped.
+		Sort is stable, so draws with equal keys keep the order they were pushed in.
+	*/
+	void RenderQueue::Sort()
+	{
+		if (mv_Items.size() < 2) return;
+
+		std::array<std::array<uint32_t, 256>, 8> a_Counts = {};
+
+		for (const auto& item : mv_Items)
+		{
+			for (uint32_t digit = 0; digit < 8; digit++)
+				a_Counts[digit][(item.m_SortKey >> (digit * 8)) & 0xFF]++;
+		}
+
+		mv_SortBuffer.resize(mv_Items.size());
+
+		for (uint32_t digit = 0; digit < 8; digit++)
+		{
+			auto& a_Offsets = a_Counts[digit];
+
+			// All keys share this byte, so the pass wouldn't change the order
+			if (a_Offsets[(mv_Items[0].m_SortKey >> (digit * 8)) & 0xFF] == mv_Items.size()) continue;
+
+			uint32_t offset = 0;
+			for (auto& count : a_Offsets)
+			{
+				uint32_t numItems = count;
+				count = offset;
+				offset += numItems;
+			}
+
+			for (const auto& item : mv_Items)
+				mv_SortBuffer[a_Offsets[(item.m_SortKey >> (digit * 8)) & 0xFF]++] = item;
+
+			mv_Items.swap(mv_SortBuffer);
+		}
+	}
+
+	/*
+		Returns draws of one pass of a layer in their sorted order. Queue has to be sorted first.
+	*/
+	std::span<const DrawItem> RenderQueue::GetItems(uint32_t layer, DrawPass pass) const
+	{
+		if (layer >= MAX_LAYERS) return {};
+
+		uint64_t range = ((uint64_t)layer << PASS_BITS) | Field(pass, PASS_BITS);
+
+		auto first = std::lower_bound(mv_Items.begin(), mv_Items.end(), range, [](const DrawItem& item, uint64_t value) { return (item.m_SortKey >> RANGE_SHIFT) < value; });
+		auto last = std::upper_bound(first, mv_Items.end(), range, [](uint64_t value, const DrawItem& item) { return value < (item.m_SortKey >> RANGE_SHIFT); });
+
+		return std::span<const DrawItem>(mv_Items.data() + (first - mv_Items.begin()), (size_t)(last - first));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include <Mesa/SceneIndex.h>
+
+namespace Mesa
+{
+	static bool IsSameVolume(const BoundingVolume& a, const BoundingVolume& b)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (a.m_Center[axis] != b.m_Center[axis] || a.m_Extents[axis] != b.m_Extents[axis]) return false;
+		}
+
+		return a.m_Radius == b.m_Radius;
+	}
+
+	/*
+		Adds object to the index, it enters the tree on the next update once its model is loaded
+	*/
+	void SceneIndex::Insert(GameObject3D* p_Object)
+	{
+		Entry entry;
+		entry.mp_Object = p_Object;
+
+		mv_Entries.push_back(entry);
+	}
+
+	/*
+		Moves objects whose world matrix, model or bounds of their model changed since the last update.
+		getModelBounds returns bounds of a model, or nullptr if it isn't loaded.
+	*/
+	void SceneIndex::Update(const std::function<const BoundingVolume*(uint32_t modelId)>& getModelBounds)
+	{
+		mv_Changed.clear();
+
+		for (uint32_t i = 0; i < mv_Entries.size(); i++)
+		{
+			Entry& entry = mv_Entries[i];
+			const GameObject3D* p_Object = entry.mp_Object;
+
+			const BoundingVolume* p_Bounds = getModelBounds(p_Object->GetModel());
+
+			if (p_Bounds == nullptr)
+			{
+				if (entry.m_Proxy != BoundingVolumeTree::NULL_NODE) m_Tree.Remove(entry.m_Proxy);
+
+				entry.m_Proxy = BoundingVolumeTree::NULL_NODE;
+				entry.m_HasBounds = false;
+				continue;
+			}
+
+			if (entry.m_HasBounds && entry.m_Version == p_Object->GetVersion() && entry.m_ModelId == p_Object->GetModel() && IsSameVolume(entry.m_LocalBounds, *p_Bounds))
+				continue;
+
+			entry.m_HasBounds = true;
+			entry.m_Version = p_Object->GetVersion();
+			entry.m_ModelId = p_Object->GetModel();
+			entry.m_LocalBounds = *p_Bounds;
+			entry.m_WorldBounds = p_Bounds->Transform(p_Object->GetWorldMatrix());
+
+			mv_Changed.push_back(i);
+		}
+
+		if (mv_Changed.empty()) return;
+
+		// Building the tree again is faster than moving most of its leaves one by one
+		if (mv_Changed.size() >= MIN_REBUILD_SIZE && mv_Changed.size() >= REBUILD_FRACTION * mv_Entries.size())
+		{
+			Rebuild();
+			return;
+		}
+
+		for (uint32_t index : mv_Changed)
+		{
+			Entry& entry = mv_Entries[index];
+
+			if (entry.m_Proxy == BoundingVolumeTree::NULL_NODE)
+				entry.m_Proxy = m_Tree.Insert(entry.m_WorldBounds, index);
+			else
+				m_Tree.Move(entry.m_Proxy, entry.m_WorldBounds);
+		}
+	}
+
+	/*
+		Returns objects whose boxes in the tree touch the frustum. Boxes are enlarged,
+		so callers test exact bounds of the returned objects themselves.
+	*/
+	void SceneIndex::QueryFrustum(const std::array<glm::vec4, 6>& planes, std::vector<GameObject3D*>& v_OutObjects)
+	{
+		mv_Results.clear();
+		m_Tree.QueryFrustum(planes, mv_Results);
+
+		for (uint32_t index : mv_Results)
+			v_OutObjects.push_back(mv_Entries[index].mp_Object);
+	}
+
+	/*
+		Returns objects whose world bounds overlap the box
+	*/
+	void SceneIndex::QueryBox(const glm::vec3& min, const glm::vec3& max, std::vector<GameObject3D*>& v_OutObjects)
+	{
+		BoundingVolumeTree::Box box;
+		box.m_Min = min;
+		box.m_Max = max;
+
+		mv_Results.clear();
+		m_Tree.QueryBox(box, mv_Results);
+
+		for (uint32_t index : mv_Results)
+		{
+			const BoundingVolume& bounds = mv_Entries[index].m_WorldBounds;
+			bool isOverlapping = true;
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (bounds.m_Center[axis] + bounds.m_Extents[axis] < min[axis] || bounds.m_Center[axis] - bounds.m_Extents[axis] > max[axis])
+					isOverlapping = false;
+			}
+
+			if (isOverlapping) v_OutObjects.push_back(mv_Entries[index].mp_Object);
+		}
+	}
+
+	/*
+		Returns objects whose world bounds overlap the sphere
+	*/
+	void SceneIndex::QuerySphere(const glm::vec3& center, float radius, std::vector<GameObject3D*>& v_OutObjects)
+	{
+		mv_Results.clear();
+		m_Tree.QuerySphere(center, radius, mv_Results);
+
+		for (uint32_t index : mv_Results)
+		{
+			const BoundingVolume& bounds = mv_Entries[index].m_WorldBounds;
+
+			float boxDistance = 0.0f;
+			float sphereDistance = 0.0f;
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float d = std::max(std::abs(center[axis] - bounds.m_Center[axis]) - bounds.m_Extents[axis], 0.0f);
+				boxDistance += d * d;
+
+				float c = center[axis] - bounds.m_Center[axis];
+				sphereDistance += c * c;
+			}
+
+			// Both volumes contain the object, so it can only overlap if both of them do
+			float sphereRadius = radius + bounds.m_Radius;
+			if (boxDistance <= radius * radius && sphereDistance <= sphereRadius * sphereRadius)
+				v_OutObjects.push_back(mv_Entries[index].mp_Object);
+		}
+	}
+
+	/*
+		Returns the closest object whose world box is hit by the ray, or nullptr if no object is hit.
+		Distance is in units of the direction vector.
+	*/
+	GameObject3D* SceneIndex::RayCast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* p_OutDistance) const
+	{
+		glm::vec3 invDirection = glm::vec3(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+		auto testLeaf = [this, &origin, &invDirection](uint32_t index, float maxDistance)
+		{
+			const BoundingVolume& bounds = mv_Entries[index].m_WorldBounds;
+
+			float enter = 0.0f;
+			float exit = maxDistance;
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float t1 = (bounds.m_Center[axis] - bounds.m_Extents[axis] - origin[axis]) * invDirection[axis];
+				float t2 = (bounds.m_Center[axis] + bounds.m_Extents[axis] - origin[axis]) * invDirection[axis];
+
+				if (t1 != t1 || t2 != t2) continue;
+
+				enter = std::max(enter, std::min(t1, t2));
+				exit = std::min(exit, std::max(t1, t2));
+			}
+
+			return enter <= exit ? enter : -1.0f;
+		};
+
+		uint32_t index = 0;
+		float distance = 0.0f;
+
+		if (!m_Tree.RayCast(origin, direction, maxDistance, testLeaf, index, distance)) return nullptr;
+
+		if (p_OutDistance != nullptr) *p_OutDistance = distance;
+		return mv_Entries[index].mp_Object;
+	}
+
+	/*
+		Builds the tree again from all objects with loaded models
+	*/
+	void SceneIndex::Rebuild()
+	{
+		std::vector<BoundingVolume> v_Bounds;
+		std::vector<uint32_t> v_Indices;
+
+		for (uint32_t i = 0; i < mv_Entries.size(); i++)
+		{
+			mv_Entries[i].m_Proxy = BoundingVolumeTree::NULL_NODE;
+			if (!mv_Entries[i].m_HasBounds) continue;
+
+			v_Bounds.push_back(mv_Entries[i].m_WorldBounds);
+			v_Indices.push_back(i);
+		}
+
+		m_Tree.Build(v_Bounds, v_Indices);
+
+		// Proxies of a built tree are positions in its input
+		for (uint32_t proxy = 0; proxy < v_Indices.size(); proxy++)
+			mv_Entries[v_Indices[proxy]].m_Proxy = proxy;
+	}
+}
\ No newline at end of file
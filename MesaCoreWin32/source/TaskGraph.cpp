@@ -0,0 +1,374 @@
+#include <Mesa/TaskGraph.h>
+#include <Mesa/FileUtils.h>
+
+namespace Mesa
+{
+	/*
+		Constructor: Creates empty graph that will be executed by specified job system.
+	*/
+	TaskGraph::TaskGraph(JobSystem& jobSystem)
+		: m_JobSystem(jobSystem)
+	{}
+
+	/*
+		Destructor
+	*/
+	TaskGraph::~TaskGraph()
+	{}
+
+	/*
+		Adds task to the graph and returns its id.
+		If the graph is already executing the task is started as soon as its dependencies are finished.
+	*/
+	TaskId TaskGraph::AddTask(const std::string& name, Job job, const std::vector<TaskId>& v_Dependencies)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		mv_Tasks.push_back(Task());
+		TaskId id = (TaskId)mv_Tasks.size();
+
+		Task& task = mv_Tasks.back();
+		task.m_Name = name;
+		task.m_Job = std::move(job);
+
+		for (TaskId dependency : v_Dependencies)
+		{
+			if (dependency == 0 || dependency >= id)
+			{
+				LOG_F(ERROR, "Task %s depends on invalid task %u! Skipping...", name.c_str(), dependency);
+				continue;
+			}
+
+			Task& dependencyTask = mv_Tasks[dependency - 1];
+			task.mv_Dependencies.push_back(dependency);
+
+			// Finished dependencies are only kept for the dump
+			if (dependencyTask.m_Finished) continue;
+
+			dependencyTask.mv_Dependents.push_back(id);
+			task.m_PendingDependencies++;
+		}
+
+		if (m_Executing && task.m_PendingDependencies == 0)
+		{
+			// Don't start tasks until the group that is being built is complete, so that
+			// other tasks from the group can still add dependencies to it
+			if (m_BuildDepth == 0) Schedule(id);
+			else mv_ReadyTasks.push_back(id);
+		}
+
+		return id;
+	}
+
+	/*
+		Adds group of tasks created by builder unless group with the same key is already in the graph.
+		Builder returns id of the task that finishes the group. The same id is returned for every call with the same key,
+		which lets several tasks depend on a shared asset while it's loaded only once.
+	*/
+	TaskId TaskGraph::FindOrAddTasks(const std::string& key, const std::function<TaskId()>& builder)
+	{
+		std::lock_guard<std::recursive_mutex> buildLock(m_BuildMutex);
+
+		auto it = m_Keys.find(key);
+		if (it != m_Keys.end()) return it->second;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_BuildDepth++;
+		}
+
+		TaskId id = 0;
+
+		try
+		{
+			id = builder();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_BuildDepth--;
+			ScheduleReadyTasks();
+			throw;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_BuildDepth--;
+			ScheduleReadyTasks();
+		}
+
+		m_Keys[key] = id;
+		return id;
+	}
+
+	/*
+		Makes task wait for another task to finish.
+		Dependency can only be added to a task that hasn't started yet. Usually it's a task
+		that depends on the one that is currently running and discovers what else has to be loaded.
+	*/
+	void TaskGraph::AddDependency(TaskId task, TaskId dependency)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (task == 0 || task > mv_Tasks.size() || dependency == 0 || dependency > mv_Tasks.size() || task == dependency)
+		{
+			LOG_F(ERROR, "Invalid dependency %u -> %u", task, dependency);
+			return;
+		}
+
+		Task& target = mv_Tasks[task - 1];
+		Task& dependencyTask = mv_Tasks[dependency - 1];
+
+		if (target.m_Started)
+		{
+			LOG_F(ERROR, "Cannot add dependency %s to task %s since it has already started", dependencyTask.m_Name.c_str(), target.m_Name.c_str());
+			return;
+		}
+
+		target.mv_Dependencies.push_back(dependency);
+
+		if (dependencyTask.m_Finished) return;
+
+		dependencyTask.mv_Dependents.push_back(task);
+		target.m_PendingDependencies++;
+
+		// Task could be waiting to be scheduled after the current group is built
+		auto it = std::find(mv_ReadyTasks.begin(), mv_ReadyTasks.end(), task);
+		if (it != mv_ReadyTasks.end()) mv_ReadyTasks.erase(it);
+	}
+
+	/*
+		Runs all tasks and blocks until every one of them is finished, including tasks added during execution.
+		Calling thread helps with executing tasks while it waits.
+		If any of the tasks threw an exception it is rethrown here.
+	*/
+	void TaskGraph::Execute()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			m_StartTime = std::chrono::steady_clock::now();
+			m_Executing = true;
+
+			for (TaskId id = 1; id <= mv_Tasks.size(); id++)
+			{
+				if (!mv_Tasks[id - 1].m_Started && mv_Tasks[id - 1].m_PendingDependencies == 0)
+					mv_ReadyTasks.push_back(id);
+			}
+
+			ScheduleReadyTasks();
+		}
+
+		try
+		{
+			m_JobSystem.Wait(m_Counter);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Executing = false;
+			m_TotalTime = GetElapsedTime();
+			throw;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Executing = false;
+		m_TotalTime = GetElapsedTime();
+
+		// Tasks that never started are part of a dependency cycle
+		for (const auto& task : mv_Tasks)
+		{
+			if (!task.m_Finished)
+				LOG_F(ERROR, "Task %s never ran since its dependencies were not finished!", task.m_Name.c_str());
+		}
+	}
+
+	/*
+		Returns chain of tasks that determined the total execution time, starting with the first one.
+		Path is built backwards from the task that finished last by following the dependency that finished last.
+	*/
+	std::vector<TaskId> TaskGraph::GetCriticalPath() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		std::vector<TaskId> v_Path;
+
+		auto endTime = [this](TaskId id) { return mv_Tasks[id - 1].m_StartTime + mv_Tasks[id - 1].m_Duration; };
+
+		TaskId current = 0;
+		for (TaskId id = 1; id <= mv_Tasks.size(); id++)
+		{
+			if (mv_Tasks[id - 1].m_Finished && (current == 0 || endTime(id) > endTime(current)))
+				current = id;
+		}
+
+		while (current != 0)
+		{
+			v_Path.push_back(current);
+
+			TaskId next = 0;
+			for (TaskId dependency : mv_Tasks[current - 1].mv_Dependencies)
+			{
+				if (next == 0 || endTime(dependency) > endTime(next))
+					next = dependency;
+			}
+
+			current = next;
+		}
+
+		std::reverse(v_Path.begin(), v_Path.end());
+		return v_Path;
+	}
+
+	/*
+		Returns the graph with its timings in CSV format.
+		Every line holds: task id, name, ids of dependencies separated with ';', start time, duration and
+		1 if the task is on the critical path. Times are in milliseconds.
+	*/
+	std::string TaskGraph::Dump() const
+	{
+		std::vector<TaskId> v_CriticalPath = GetCriticalPath();
+		std::set<TaskId> criticalTasks(v_CriticalPath.begin(), v_CriticalPath.end());
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		std::ostringstream oss;
+		oss << "id,name,dependencies,startMs,durationMs,critical\n";
+
+		for (TaskId id = 1; id <= mv_Tasks.size(); id++)
+		{
+			const Task& task = mv_Tasks[id - 1];
+
+			oss << id << ',' << task.m_Name << ',';
+
+			for (size_t i = 0; i < task.mv_Dependencies.size(); i++)
+				oss << (i > 0 ? ";" : "") << task.mv_Dependencies[i];
+
+			oss << ',' << task.m_StartTime << ',' << task.m_Duration << ',' << (criticalTasks.count(id) ? 1 : 0) << '\n';
+		}
+
+		return oss.str();
+	}
+
+	/*
+		Saves dump of the graph to specified file.
+	*/
+	bool TaskGraph::SaveDump(const std::string& path) const
+	{
+		FileUtils::MakeFileWithContent(path, Dump());
+
+		if (!FileUtils::FileExists(path))
+		{
+			LOG_F(ERROR, "Failed to save task graph to %s", path.c_str());
+			return false;
+		}
+
+		LOG_F(INFO, "Saved task graph to %s", path.c_str());
+		return true;
+	}
+
+	/*
+		Logs total execution time, time all tasks would take one after another and the critical path.
+	*/
+	void TaskGraph::LogSummary() const
+	{
+		std::vector<TaskId> v_CriticalPath = GetCriticalPath();
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		double serialTime = 0.0;
+		for (const auto& task : mv_Tasks)
+			serialTime += task.m_Duration;
+
+		double criticalTime = 0.0;
+		std::string criticalNames;
+
+		for (TaskId id : v_CriticalPath)
+		{
+			criticalTime += mv_Tasks[id - 1].m_Duration;
+			criticalNames += (criticalNames.empty() ? "" : " > ") + mv_Tasks[id - 1].m_Name;
+		}
+
+		LOG_F(INFO, "Task graph executed %zu tasks in %.2f ms (%.2f ms of work, %.2f ms on critical path)", mv_Tasks.size(), m_TotalTime, serialTime, criticalTime);
+		LOG_F(INFO, "Critical path: %s", criticalNames.c_str());
+	}
+
+	/*
+		Starts tasks that became ready while a group of tasks was being built.
+		Has to be called with the graph mutex locked.
+	*/
+	void TaskGraph::ScheduleReadyTasks()
+	{
+		if (!m_Executing || m_BuildDepth > 0) return;
+
+		for (TaskId id : mv_ReadyTasks)
+			Schedule(id);
+
+		mv_ReadyTasks.clear();
+	}
+
+	/*
+		Queues task on the job system.
+		Has to be called with the graph mutex locked.
+	*/
+	void TaskGraph::Schedule(TaskId id)
+	{
+		Task& task = mv_Tasks[id - 1];
+		if (task.m_Started) return;
+
+		task.m_Started = true;
+		m_JobSystem.Run([this, id]() { RunTask(id); }, &m_Counter);
+	}
+
+	/*
+		Executes task and starts every dependent task that has no more unfinished dependencies.
+	*/
+	void TaskGraph::RunTask(TaskId id)
+	{
+		Job job;
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			job = std::move(mv_Tasks[id - 1].m_Job);
+			mv_Tasks[id - 1].m_StartTime = GetElapsedTime();
+		}
+
+		auto finish = [this, id]()
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			Task& task = mv_Tasks[id - 1];
+			task.m_Finished = true;
+			task.m_Duration = GetElapsedTime() - task.m_StartTime;
+
+			for (TaskId dependent : task.mv_Dependents)
+			{
+				if (--mv_Tasks[dependent - 1].m_PendingDependencies == 0)
+					mv_ReadyTasks.push_back(dependent);
+			}
+
+			ScheduleReadyTasks();
+		};
+
+		// Dependent tasks are released even if the task failed so that the graph always finishes
+		try
+		{
+			if (job) job();
+		}
+		catch (...)
+		{
+			finish();
+			throw;
+		}
+
+		finish();
+	}
+
+	/*
+		Returns time since the execution started in milliseconds.
+	*/
+	double TaskGraph::GetElapsedTime() const
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_StartTime).count();
+	}
+}
\ No newline at end of file
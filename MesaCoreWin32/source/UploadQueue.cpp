@@ -0,0 +1,78 @@
+#include <Mesa/UploadQueue.h>
+
+namespace Mesa
+{
+	/*
+		Constructor
+	*/
+	UploadQueue::UploadQueue()
+	{}
+
+	/*
+		Destructor: Jobs that were never processed are dropped.
+	*/
+	UploadQueue::~UploadQueue()
+	{
+		if (!mv_Jobs.empty())
+			LOG_F(WARNING, "Upload queue destroyed with %zu unprocessed jobs", mv_Jobs.size());
+	}
+
+	/*
+		Adds job to the queue. Can be called from any thread.
+	*/
+	void UploadQueue::Enqueue(Job job)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		mv_Jobs.push_back(std::move(job));
+	}
+
+	/*
+		Executes queued jobs in order until the budget (in milliseconds) is used up.
+		At least one job is executed on every call so the queue always makes progress.
+		Jobs queued by the executed jobs can run in the same call if the budget allows it.
+		Returns number of executed jobs.
+	*/
+	uint32_t UploadQueue::Process(double budget)
+	{
+		auto start = std::chrono::steady_clock::now();
+		uint32_t numExecuted = 0;
+
+		while (true)
+		{
+			Job job;
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				if (mv_Jobs.empty()) break;
+
+				job = std::move(mv_Jobs.front());
+				mv_Jobs.pop_front();
+			}
+
+			try
+			{
+				job();
+			}
+			catch (const std::exception& e)
+			{
+				LOG_F(ERROR, "Upload job failed: %s", e.what());
+			}
+
+			numExecuted++;
+
+			if (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() >= budget)
+				break;
+		}
+
+		return numExecuted;
+	}
+
+	/*
+		Returns number of jobs waiting in the queue.
+	*/
+	size_t UploadQueue::GetNumPending() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return mv_Jobs.size();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <Mesa/UploadRing.h>
+
+namespace Mesa
+{
+	/*
+		Forgets all allocations and sets size of the buffer. Used when the backend replaces the buffer,
+		older frames keep reading the previous one.
+	*/
+	void UploadRing::Reset(uint64_t capacity)
+	{
+		m_Capacity = capacity & ~(ALIGNMENT - 1);
+		m_Head = 0;
+		m_Used = 0;
+		m_FrameBytes = 0;
+		mv_Frames.clear();
+	}
+
+	void UploadRing::BeginFrame(uint64_t frameIndex)
+	{
+		m_FrameIndex = frameIndex;
+		m_FrameBytes = 0;
+	}
+
+	/*
+		Takes aligned slice of the buffer for the current frame.
+		Slices never wrap around the end of the buffer, the rest of the buffer is skipped instead.
+		Returns false if the slice would overwrite data of a frame in flight.
+	*/
+	bool UploadRing::Allocate(uint64_t size, uint64_t& outOffset)
+	{
+		uint64_t alignedSize = AlignSize(std::max<uint64_t>(size, 1));
+		if (alignedSize > m_Capacity) return false;
+
+		// Empty ring has no data to protect, so slices start at the beginning instead of skipping the end
+		uint64_t offset = m_Used == 0 ? 0 : m_Head;
+		uint64_t skipped = 0;
+
+		if (offset + alignedSize > m_Capacity)
+		{
+			skipped = m_Capacity - offset;
+			offset = 0;
+		}
+
+		if (m_Used + skipped + alignedSize > m_Capacity) return false;
+
+		m_Used += skipped + alignedSize;
+		m_FrameBytes += skipped + alignedSize;
+		m_Head = offset + alignedSize == m_Capacity ? 0 : offset + alignedSize;
+
+		outOffset = offset;
+		return true;
+	}
+
+	/*
+		Returns position of the ring after the last allocation of the current frame
+	*/
+	UploadRing::Checkpoint UploadRing::GetCheckpoint() const
+	{
+		Checkpoint checkpoint;
+		checkpoint.m_Head = m_Head;
+		checkpoint.m_FrameBytes = m_FrameBytes;
+
+		return checkpoint;
+	}
+
+	/*
+		Frees allocations made by the current frame after the checkpoint.
+		Frames may be released in between since they don't move the head.
+	*/
+	void UploadRing::Rollback(const Checkpoint& checkpoint)
+	{
+		if (checkpoint.m_FrameBytes > m_FrameBytes) return;
+
+		m_Used -= m_FrameBytes - checkpoint.m_FrameBytes;
+		m_FrameBytes = checkpoint.m_FrameBytes;
+		m_Head = checkpoint.m_Head;
+	}
+
+	/*
+		Finishes the current frame, its space stays taken until the frame is released
+	*/
+	void UploadRing::EndFrame()
+	{
+		if (m_FrameBytes == 0) return;
+
+		FrameRange range;
+		range.m_FrameIndex = m_FrameIndex;
+		range.m_NumBytes = m_FrameBytes;
+
+		mv_Frames.push_back(range);
+		m_FrameBytes = 0;
+	}
+
+	/*
+		Frees space of frames up to the specified one, the GPU has to be done with all of them
+	*/
+	void UploadRing::ReleaseFrames(uint64_t lastCompletedFrame)
+	{
+		while (!mv_Frames.empty() && mv_Frames.front().m_FrameIndex <= lastCompletedFrame)
+		{
+			m_Used -= mv_Frames.front().m_NumBytes;
+			mv_Frames.pop_front();
+		}
+	}
+}
\ No newline at end of file
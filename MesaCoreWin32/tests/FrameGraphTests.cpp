@@ -0,0 +1,210 @@
+#include <Mesa/FrameGraph.h>
+#include <gtest/gtest.h>
+
+namespace Mesa
+{
+	// Layer passes of one frame compiled and executed the way graphics backends do it
+	class LayerGraph
+	{
+	public:
+		// Pass that ran, with physical textures it wrote and read
+		struct Run
+		{
+			std::string m_Name;
+			uint32_t m_Target = 0;
+			std::vector<uint32_t> mv_Sources;
+		};
+
+		LayerGraph(uint32_t numLayers, bool canBlend)
+		{
+			m_BackBuffer = m_Graph.ImportTexture("BackBuffer", m_Desc, FrameResourceState_Present);
+
+			FrameBlendFunction blend;
+
+			if (canBlend)
+			{
+				blend = [this](const FrameGraph& graph, FrameResource target, FrameResource layer, FrameResource previous)
+				{
+					mv_Runs.push_back({ "Blend", graph.GetTexture(target), { graph.GetTexture(layer), graph.GetTexture(previous) } });
+				};
+			}
+
+			m_Graph.AddLayerPasses(m_BackBuffer, m_Desc, numLayers, [this](const FrameGraph& graph, FrameResource target, uint32_t layer, DrawPass pass)
+			{
+				std::string name = (pass == DrawPass_Color ? "Color" : "Specular") + std::to_string(layer);
+				mv_Runs.push_back({ name, graph.GetTexture(target), {} });
+			}, blend);
+
+			m_Graph.Compile();
+			m_Graph.Execute([this](const FrameBarrier& barrier) { mv_Barriers.push_back(barrier); },
+				[this](uint32_t source, uint32_t destination) { mv_Runs.push_back({ "Copy", destination, { source } }); });
+		}
+
+		inline uint32_t GetBackBufferTexture() const { return m_Graph.GetTexture(m_BackBuffer); }
+
+		// States of one physical texture in the order barriers changed them
+		std::vector<FrameResourceState> GetStates(uint32_t texture) const
+		{
+			std::vector<FrameResourceState> v_States;
+
+			for (const auto& barrier : mv_Barriers)
+			{
+				if (barrier.m_Texture != texture) continue;
+				if (v_States.empty()) v_States.push_back(barrier.m_Before);
+
+				EXPECT_EQ(v_States.back(), barrier.m_Before);
+				v_States.push_back(barrier.m_After);
+			}
+
+			return v_States;
+		}
+
+	public:
+		FrameGraph m_Graph;
+		FrameTextureDesc m_Desc = { 1280, 720, 28 };
+		FrameResource m_BackBuffer = 0;
+		std::vector<Run> mv_Runs;
+		std::vector<FrameBarrier> mv_Barriers;
+	};
+
+	TEST(FrameGraphTests, SingleLayerDrawsSpecularIntoBackBuffer)
+	{
+		for (bool canBlend : { false, true })
+		{
+			LayerGraph layers(1, canBlend);
+			const FrameGraphStatistics& stats = layers.m_Graph.GetStatistics();
+
+			// Color pass and both copies into previous layer are never read
+			EXPECT_EQ(stats.m_NumPasses, 5u);
+			EXPECT_EQ(stats.m_NumCulledPasses, 3u);
+			EXPECT_EQ(stats.m_NumEliminatedCopies, 1u);
+			EXPECT_EQ(stats.m_NumTransientResources, 0u);
+			EXPECT_EQ(stats.m_NumPhysicalTextures, 0u);
+
+			ASSERT_EQ(layers.mv_Runs.size(), 1u);
+			EXPECT_EQ(layers.mv_Runs[0].m_Name, "Specular0");
+			EXPECT_EQ(layers.mv_Runs[0].m_Target, layers.GetBackBufferTexture());
+
+			std::vector<FrameResourceState> v_Expected = { FrameResourceState_Present, FrameResourceState_RenderTarget, FrameResourceState_Present };
+			EXPECT_EQ(layers.GetStates(layers.GetBackBufferTexture()), v_Expected);
+		}
+	}
+
+	TEST(FrameGraphTests, UnblendedLayersKeepOnlyLastSpecularPass)
+	{
+		for (uint32_t numLayers : { 2u, 3u })
+		{
+			LayerGraph layers(numLayers, false);
+			const FrameGraphStatistics& stats = layers.m_Graph.GetStatistics();
+
+			EXPECT_EQ(stats.m_NumPasses, 2 * numLayers + 3);
+			EXPECT_EQ(stats.m_NumCulledPasses, 2 * numLayers + 1);
+			EXPECT_EQ(stats.m_NumEliminatedCopies, 1u);
+			EXPECT_EQ(layers.m_Graph.GetNumTextures(), 1u);
+
+			ASSERT_EQ(layers.mv_Runs.size(), 1u);
+			EXPECT_EQ(layers.mv_Runs[0].m_Name, "Specular" + std::to_string(numLayers - 1));
+			EXPECT_EQ(layers.mv_Runs[0].m_Target, layers.GetBackBufferTexture());
+		}
+	}
+
+	TEST(FrameGraphTests, TwoBlendedLayersBlendIntoBackBuffer)
+	{
+		LayerGraph layers(2, true);
+		const FrameGraphStatistics& stats = layers.m_Graph.GetStatistics();
+
+		// Color passes, their blend and copies of blended layer aren't read, remaining copies are rebound
+		EXPECT_EQ(stats.m_NumPasses, 11u);
+		EXPECT_EQ(stats.m_NumCulledPasses, 6u);
+		EXPECT_EQ(stats.m_NumEliminatedCopies, 2u);
+		EXPECT_EQ(stats.m_NumTransientResources, 2u);
+		EXPECT_EQ(stats.m_NumPhysicalTextures, 2u);
+
+		ASSERT_EQ(layers.mv_Runs.size(), 3u);
+		EXPECT_EQ(layers.mv_Runs[0].m_Name, "Specular0");
+		EXPECT_EQ(layers.mv_Runs[1].m_Name, "Specular1");
+		EXPECT_EQ(layers.mv_Runs[2].m_Name, "Blend");
+
+		// Both layers are alive during the blend, so they can't share a texture
+		uint32_t first = layers.mv_Runs[0].m_Target;
+		uint32_t second = layers.mv_Runs[1].m_Target;
+		EXPECT_NE(first, second);
+
+		std::vector<uint32_t> v_Sources = { second, first };
+		EXPECT_EQ(layers.mv_Runs[2].mv_Sources, v_Sources);
+		EXPECT_EQ(layers.mv_Runs[2].m_Target, layers.GetBackBufferTexture());
+	}
+
+	TEST(FrameGraphTests, ThreeBlendedLayersAliasTextures)
+	{
+		LayerGraph layers(3, true);
+		const FrameGraphStatistics& stats = layers.m_Graph.GetStatistics();
+
+		EXPECT_EQ(stats.m_NumPasses, 17u);
+		EXPECT_EQ(stats.m_NumCulledPasses, 9u);
+		EXPECT_EQ(stats.m_NumEliminatedCopies, 3u);
+		EXPECT_EQ(stats.m_NumTransientResources, 4u);
+		EXPECT_EQ(stats.m_NumPhysicalTextures, 3u);
+
+		std::vector<std::string> v_Names;
+		for (const auto& run : layers.mv_Runs) v_Names.push_back(run.m_Name);
+
+		std::vector<std::string> v_Expected = { "Specular0", "Specular1", "Blend", "Specular2", "Blend" };
+		ASSERT_EQ(v_Names, v_Expected);
+
+		// Third layer reuses texture of the first one, which isn't read after the first blend
+		const auto& v_Runs = layers.mv_Runs;
+		EXPECT_EQ(v_Runs[3].m_Target, v_Runs[0].m_Target);
+
+		// Blended layer is read in place instead of being copied into the previous layer
+		std::vector<uint32_t> v_Sources = { v_Runs[3].m_Target, v_Runs[2].m_Target };
+		EXPECT_EQ(v_Runs[4].mv_Sources, v_Sources);
+		EXPECT_EQ(v_Runs[4].m_Target, layers.GetBackBufferTexture());
+	}
+
+	TEST(FrameGraphTests, BarriersFollowStatesOfTextures)
+	{
+		LayerGraph layers(3, true);
+
+		// Texture of the first layer is read by the first blend and written again by the third layer
+		std::vector<FrameResourceState> v_Reused = {
+			FrameResourceState_Undefined, FrameResourceState_RenderTarget, FrameResourceState_ShaderRead,
+			FrameResourceState_RenderTarget, FrameResourceState_ShaderRead };
+		EXPECT_EQ(layers.GetStates(layers.mv_Runs[0].m_Target), v_Reused);
+
+		std::vector<FrameResourceState> v_BackBuffer = { FrameResourceState_Present, FrameResourceState_RenderTarget, FrameResourceState_Present };
+		EXPECT_EQ(layers.GetStates(layers.GetBackBufferTexture()), v_BackBuffer);
+
+		// Every barrier changes the state
+		for (const auto& barrier : layers.mv_Barriers)
+			EXPECT_NE(barrier.m_Before, barrier.m_After);
+	}
+
+	TEST(FrameGraphTests, CopyOfSourceReadByOtherPassIsKept)
+	{
+		FrameGraph graph;
+		FrameTextureDesc desc = { 4, 4, 1 };
+
+		FrameResource backBuffer = graph.ImportTexture("BackBuffer", desc, FrameResourceState_Present);
+		FrameResource scene = graph.CreateTexture("Scene", desc);
+		FrameResource post = graph.CreateTexture("Post", desc);
+
+		graph.AddPass("Scene", {}, { scene }, nullptr);
+		graph.AddPass("Post", { scene }, { post }, nullptr);
+		graph.AddCopy("CopyToBackBuffer", scene, backBuffer);
+		graph.MarkOutput(backBuffer);
+		graph.MarkOutput(post);
+		graph.Compile();
+
+		uint32_t numCopies = 0;
+		graph.Execute([](const FrameBarrier&) {}, [&](uint32_t source, uint32_t destination)
+		{
+			EXPECT_NE(source, destination);
+			numCopies++;
+		});
+
+		EXPECT_EQ(numCopies, 1u);
+		EXPECT_EQ(graph.GetStatistics().m_NumEliminatedCopies, 0u);
+		EXPECT_NE(graph.GetTexture(scene), graph.GetTexture(post));
+	}
+}
\ No newline at end of file
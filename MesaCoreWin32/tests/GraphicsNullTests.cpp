@@ -0,0 +1,65 @@
+#include "TestAssets.h"
+#include <Mesa/GraphicsNull.h>
+#include <gtest/gtest.h>
+
+namespace Mesa
+{
+	TEST(GraphicsNullTests, LoadsAssetsFromPacks)
+	{
+		TestAssets assets("MesaGraphicsNullLoad");
+		GraphicsNull graphics;
+
+		uint32_t modelId = graphics.LoadModelFromPack(TestAssets::MODEL_NAME);
+		uint32_t shaderId = graphics.CompileForwardShaderFromPack(TestAssets::VERTEX_SHADER_NAME);
+
+		EXPECT_NE(modelId, 0u);
+		EXPECT_NE(shaderId, 0u);
+
+		// Material is loaded through the definitions packed next to the model
+		EXPECT_NE(graphics.GetMaterialIdByName(TestAssets::MATERIAL_NAME), 0u);
+
+		// Loading the same assets again returns the same IDs
+		EXPECT_EQ(graphics.LoadModelFromPack(TestAssets::MODEL_NAME), modelId);
+		EXPECT_EQ(graphics.CompileForwardShaderFromPack(TestAssets::VERTEX_SHADER_NAME), shaderId);
+		EXPECT_EQ(graphics.GetAssetStatistics(AssetType_Model).m_NumAssets, 1u);
+	}
+
+	TEST(GraphicsNullTests, DrawsOnlyVisibleObjects)
+	{
+		TestAssets assets("MesaGraphicsNullFrames");
+		GraphicsNull graphics;
+
+		uint32_t modelId = graphics.LoadModelFromPack(TestAssets::MODEL_NAME);
+		uint32_t shaderId = graphics.CompileForwardShaderFromPack(TestAssets::VERTEX_SHADER_NAME);
+		ASSERT_NE(modelId, 0u);
+		ASSERT_NE(shaderId, 0u);
+
+		CameraNull camera;
+		camera.SetProjectionValues(90.0f, 1.0f, 0.1f, 1000.0f);
+		graphics.SetCamera(&camera);
+
+		// Half of the objects is in front of the camera and half behind it
+		std::vector<GameObject3D> v_Objects(64);
+		for (size_t i = 0; i < v_Objects.size(); i++)
+		{
+			float z = i % 2 == 0 ? 20.0f : -20.0f;
+			v_Objects[i].SetModel(modelId);
+			v_Objects[i].SetColorShader(shaderId);
+			v_Objects[i].SetSpecularShader(shaderId);
+			v_Objects[i].SetPosition(glm::vec3((float)(i / 2 % 8) - 4.0f, (float)(i / 16) - 2.0f, z));
+			graphics.InsertGameObject(&v_Objects[i]);
+		}
+
+		for (uint32_t frame = 0; frame < 3; frame++)
+			graphics.DrawFrame(nullptr);
+
+		const DrawStatistics& statistics = graphics.GetFrameStatistics();
+		uint64_t numVisible = v_Objects.size() / 2;
+
+		// Visible objects share the model, material and instanced shader, so every pass draws all of them at once
+		ASSERT_GT(statistics.m_NumDrawCalls, 0u);
+		EXPECT_EQ(statistics.m_NumInstances, numVisible * statistics.m_NumDrawCalls);
+		EXPECT_EQ(statistics.m_NumIndices, 3 * statistics.m_NumInstances);
+		EXPECT_EQ(graphics.GetNumFrames(), 3u);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include <Mesa/InstanceBatcher.h>
+#include <Mesa/DrawRecorder.h>
+#include <gtest/gtest.h>
+
+namespace Mesa
+{
+	// Scene of objects whose draws are queued and batched like in one pass of a graphics backend
+	class BatchScene
+	{
+	public:
+		static constexpr uint32_t INSTANCED_SHADER = 1;
+		static constexpr uint32_t OTHER_INSTANCED_SHADER = 2;
+		static constexpr uint32_t PLAIN_SHADER = 3;
+		static constexpr uint32_t INDICES_PER_MESH = 36;
+
+		BatchScene(size_t maxObjects)
+		{
+			// Items point to objects, so they can't move
+			mv_Objects.reserve(maxObjects);
+		}
+
+		/*
+			Adds object at the depth and queues draws of its meshes
+		*/
+		const GameObject3D* Add(float depth, uint32_t shaderId, uint32_t materialId, uint32_t modelId, uint32_t numMeshes = 1)
+		{
+			GameObject3D& object = mv_Objects.emplace_back();
+			object.SetModel(modelId);
+			object.SetPosition(glm::vec3(depth, 0.0f, 0.0f));
+
+			for (uint32_t i = 0; i < numMeshes; i++)
+			{
+				DrawItem item;
+				item.mp_Object = &object;
+				item.m_ShaderId = shaderId;
+				item.m_MaterialId = materialId;
+				item.m_ModelId = modelId;
+				item.m_MeshIndex = i;
+				item.m_SortKey = RenderQueue::MakeSortKey(0, DrawPass_Color, shaderId, materialId, modelId, depth);
+				m_Queue.Push(item);
+			}
+
+			return &object;
+		}
+
+		std::span<const InstanceBatch> Build()
+		{
+			m_Queue.Sort();
+			m_Batcher.Build(m_Queue.GetItems(0, DrawPass_Color), [](uint32_t shaderId) { return shaderId != PLAIN_SHADER; });
+
+			return m_Batcher.GetBatches();
+		}
+
+		/*
+			Records the batches into draw streams and counts them the way GraphicsNull does, with every asset loaded
+		*/
+		DrawStatistics Count()
+		{
+			DrawConstantWriters writers;
+			writers.m_MvpSize = sizeof(glm::mat4x4);
+			writers.m_MaterialSize = sizeof(glm::vec4);
+			writers.m_WriteMvp = [](const GameObject3D*, uint8_t*) {};
+			writers.m_WriteMaterial = [](uint32_t, uint8_t*) { return true; };
+
+			DrawAssetLookup assets;
+			assets.m_HasShader = [](uint32_t) { return true; };
+			assets.m_HasModel = [](uint32_t) { return true; };
+			assets.m_GetMesh = [](uint32_t, uint32_t, uint32_t& outNumIndices) { outNumIndices = INDICES_PER_MESH; return true; };
+			assets.m_GetMaterialTexture = [](uint32_t materialId, uint32_t& outTextureId) { outTextureId = materialId; return true; };
+			assets.m_UseTexture = [](uint32_t) { return true; };
+
+			m_Recorder.Record(m_Batcher.GetBatches(), writers);
+
+			DrawStatistics statistics;
+			for (const auto& stream : m_Recorder.GetStreams())
+				DrawRecorder::CountStream(stream, assets, statistics);
+
+			return statistics;
+		}
+
+	public:
+		std::vector<GameObject3D> mv_Objects;
+		RenderQueue m_Queue;
+		InstanceBatcher m_Batcher;
+		DrawRecorder m_Recorder;
+	};
+
+	TEST(InstanceBatcherTests, GroupsDrawsThatShareShaderMaterialModelAndMesh)
+	{
+		BatchScene scene(8);
+
+		scene.Add(1.0f, BatchScene::INSTANCED_SHADER, 1, 1);
+		scene.Add(2.0f, BatchScene::INSTANCED_SHADER, 1, 1);
+		scene.Add(3.0f, BatchScene::INSTANCED_SHADER, 1, 1);
+		scene.Add(4.0f, BatchScene::INSTANCED_SHADER, 2, 1); // Other material
+		scene.Add(5.0f, BatchScene::INSTANCED_SHADER, 1, 2); // Other model
+		scene.Add(6.0f, BatchScene::OTHER_INSTANCED_SHADER, 1, 1);
+		scene.Add(7.0f, BatchScene::OTHER_INSTANCED_SHADER, 1, 1);
+
+		std::span<const InstanceBatch> batches = scene.Build();
+		ASSERT_EQ(batches.size(), 4u);
+
+		std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>> v_Groups;
+		for (const auto& batch : batches)
+		{
+			EXPECT_TRUE(batch.m_IsInstanced);
+			v_Groups.push_back({ batch.m_ShaderId, batch.m_MaterialId, batch.m_ModelId, batch.m_NumInstances });
+		}
+
+		// Batches follow the order of the queue, which sorts by shader, material and model
+		std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>> v_Expected = {
+			{ BatchScene::INSTANCED_SHADER, 1, 1, 3 },
+			{ BatchScene::INSTANCED_SHADER, 1, 2, 1 },
+			{ BatchScene::INSTANCED_SHADER, 2, 1, 1 },
+			{ BatchScene::OTHER_INSTANCED_SHADER, 1, 1, 2 },
+		};
+		EXPECT_EQ(v_Groups, v_Expected);
+
+		DrawStatistics statistics = scene.Count();
+		EXPECT_EQ(statistics.m_NumDrawCalls, 4u);
+		EXPECT_EQ(statistics.m_NumInstances, 7u);
+		EXPECT_EQ(statistics.m_NumIndices, 7u * BatchScene::INDICES_PER_MESH);
+		EXPECT_EQ(statistics.m_NumShaderBinds, 2u);
+	}
+
+	TEST(InstanceBatcherTests, SplitsMeshesOfModelAndKeepsDepthOrder)
+	{
+		BatchScene scene(3);
+
+		// Meshes of one model are interleaved by depth in the queue
+		const GameObject3D* p_Far = scene.Add(3.0f, BatchScene::INSTANCED_SHADER, 1, 1, 2);
+		const GameObject3D* p_Near = scene.Add(1.0f, BatchScene::INSTANCED_SHADER, 1, 1, 2);
+		const GameObject3D* p_Middle = scene.Add(2.0f, BatchScene::INSTANCED_SHADER, 1, 1, 2);
+
+		std::span<const InstanceBatch> batches = scene.Build();
+		std::span<const glm::mat4x4> instances = scene.m_Batcher.GetInstances();
+
+		ASSERT_EQ(batches.size(), 2u);
+		ASSERT_EQ(instances.size(), 6u);
+
+		std::vector<const GameObject3D*> v_DepthOrder = { p_Near, p_Middle, p_Far };
+
+		for (uint32_t mesh = 0; mesh < 2; mesh++)
+		{
+			const InstanceBatch& batch = batches[mesh];
+			EXPECT_EQ(batch.m_MeshIndex, mesh);
+			EXPECT_EQ(batch.m_NumInstances, 3u);
+			EXPECT_EQ(batch.mp_Object, p_Near);
+
+			for (uint32_t i = 0; i < batch.m_NumInstances; i++)
+				EXPECT_EQ(instances[batch.m_FirstInstance + i], v_DepthOrder[i]->GetWorldMatrix());
+		}
+
+		DrawStatistics statistics = scene.Count();
+		EXPECT_EQ(statistics.m_NumDrawCalls, 2u);
+		EXPECT_EQ(statistics.m_NumInstances, 6u);
+	}
+
+	TEST(InstanceBatcherTests, PacksInstancesOfBatchesBackToBack)
+	{
+		BatchScene scene(6);
+
+		for (uint32_t i = 0; i < 6; i++)
+			scene.Add((float)(i + 1), BatchScene::INSTANCED_SHADER, 1 + i % 3, 1);
+
+		std::span<const InstanceBatch> batches = scene.Build();
+		std::span<const glm::mat4x4> instances = scene.m_Batcher.GetInstances();
+
+		ASSERT_EQ(batches.size(), 3u);
+		ASSERT_EQ(instances.size(), 6u);
+
+		uint32_t next = 0;
+
+		for (const auto& batch : batches)
+		{
+			EXPECT_EQ(batch.m_FirstInstance, next);
+			EXPECT_EQ(batch.m_NumInstances, 2u);
+			EXPECT_EQ(instances[batch.m_FirstInstance], batch.mp_Object->GetWorldMatrix());
+
+			next += batch.m_NumInstances;
+		}
+
+		EXPECT_EQ(next, instances.size());
+
+		// Building again doesn't keep batches or instances of the previous pass
+		scene.Build();
+		EXPECT_EQ(scene.m_Batcher.GetBatches().size(), 3u);
+		EXPECT_EQ(scene.m_Batcher.GetInstances().size(), 6u);
+	}
+
+	TEST(InstanceBatcherTests, PassesDrawsOfOtherShadersThrough)
+	{
+		BatchScene scene(5);
+
+		const GameObject3D* p_First = scene.Add(1.0f, BatchScene::PLAIN_SHADER, 1, 1);
+		const GameObject3D* p_Second = scene.Add(2.0f, BatchScene::PLAIN_SHADER, 1, 1);
+		scene.Add(3.0f, BatchScene::INSTANCED_SHADER, 1, 1);
+		scene.Add(4.0f, BatchScene::INSTANCED_SHADER, 1, 1);
+
+		std::span<const InstanceBatch> batches = scene.Build();
+		ASSERT_EQ(batches.size(), 3u);
+
+		// Instanced shader has the lower ID, so its batch comes first
+		EXPECT_TRUE(batches[0].m_IsInstanced);
+		EXPECT_EQ(batches[0].m_NumInstances, 2u);
+
+		for (size_t i = 1; i < batches.size(); i++)
+		{
+			EXPECT_FALSE(batches[i].m_IsInstanced);
+			EXPECT_EQ(batches[i].m_NumInstances, 1u);
+			EXPECT_EQ(batches[i].m_FirstInstance, 0u);
+		}
+
+		EXPECT_EQ(batches[1].mp_Object, p_First);
+		EXPECT_EQ(batches[2].mp_Object, p_Second);
+		EXPECT_EQ(scene.m_Batcher.GetInstances().size(), 2u);
+
+		DrawStatistics statistics = scene.Count();
+		EXPECT_EQ(statistics.m_NumDrawCalls, 3u);
+		EXPECT_EQ(statistics.m_NumInstances, 2u);
+		EXPECT_EQ(statistics.m_NumIndices, 4u * BatchScene::INDICES_PER_MESH);
+		EXPECT_EQ(statistics.m_NumShaderBinds, 2u);
+	}
+}
\ No newline at end of file
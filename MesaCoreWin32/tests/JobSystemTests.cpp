@@ -0,0 +1,74 @@
+#include <Mesa/JobSystem.h>
+#include <gtest/gtest.h>
+
+namespace Mesa
+{
+	// Threads that executed jobs of a ParallelFor() whose jobs take long enough for every thread to join in
+	static std::set<std::thread::id> CollectThreads(JobSystem& jobSystem)
+	{
+		std::set<std::thread::id> threads;
+		std::mutex threadsMutex;
+
+		jobSystem.ParallelFor(64, [&](size_t)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+			std::lock_guard<std::mutex> lock(threadsMutex);
+			threads.insert(std::this_thread::get_id());
+		});
+
+		return threads;
+	}
+
+	TEST(JobSystemTests, InactiveWorkersDontRunJobs)
+	{
+		JobSystem jobSystem(4);
+		EXPECT_EQ(jobSystem.GetNumActiveWorkers(), 4u);
+
+		jobSystem.SetNumActiveWorkers(2);
+		EXPECT_EQ(jobSystem.GetNumActiveWorkers(), 2u);
+
+		// Two workers and the thread that waits
+		EXPECT_LE(CollectThreads(jobSystem).size(), 3u);
+
+		jobSystem.SetNumActiveWorkers(8);
+		EXPECT_EQ(jobSystem.GetNumActiveWorkers(), 4u);
+		EXPECT_LE(CollectThreads(jobSystem).size(), 5u);
+	}
+
+	TEST(JobSystemTests, OneWorkerStaysActive)
+	{
+		JobSystem jobSystem(3);
+		jobSystem.SetNumActiveWorkers(0);
+		EXPECT_EQ(jobSystem.GetNumActiveWorkers(), 1u);
+
+		// Job that nobody helps with is still executed by the active worker
+		JobCounter counter;
+		std::thread::id caller = std::this_thread::get_id();
+		std::atomic<bool> ranOnWorker = false;
+		jobSystem.Run([&]() { ranOnWorker = std::this_thread::get_id() != caller; }, &counter);
+
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (!counter.IsDone() && std::chrono::steady_clock::now() < deadline)
+			std::this_thread::yield();
+
+		ASSERT_TRUE(counter.IsDone());
+		EXPECT_TRUE(ranOnWorker);
+	}
+
+	TEST(JobSystemTests, ResultsDontDependOnActiveWorkers)
+	{
+		JobSystem jobSystem(4);
+
+		for (uint32_t numWorkers = 1; numWorkers <= jobSystem.GetNumWorkers(); numWorkers++)
+		{
+			jobSystem.SetNumActiveWorkers(numWorkers);
+
+			std::vector<uint32_t> v_Values(10000, 0);
+			jobSystem.ParallelFor(v_Values.size(), [&v_Values](size_t i) { v_Values[i] = (uint32_t)i * 2; }, 64);
+
+			for (size_t i = 0; i < v_Values.size(); i++)
+				ASSERT_EQ(v_Values[i], i * 2);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+#include <Mesa/EngineConfig.h>
+#include <Mesa/FileUtils.h>
+#include <Mesa/GfxUtils.h>
+#include <Mesa/MaterialFormat.h>
+
+namespace Mesa
+{
+	/*
+		Directory with packs, lookup table and engine.ini laid out like the output of AssetPackerWin32.
+		It becomes the working directory while the object lives, since the engine reads engine.ini
+		and lookup.csv from there, and it's deleted afterwards.
+		Holds one triangle model with its material and one forward shader.
+	*/
+	class TestAssets
+	{
+	public:
+		static constexpr const char* MODEL_NAME = "Model/Triangle.fbx";
+		static constexpr const char* MATERIAL_NAME = "Material/Red.mat";
+		static constexpr const char* VERTEX_SHADER_NAME = "Shader/V_Forward.hlsl";
+		static constexpr const char* PIXEL_SHADER_NAME = "Shader/P_Forward.hlsl";
+
+	public:
+		explicit TestAssets(const std::string& name)
+			: m_PreviousDirectory(std::filesystem::current_path()), m_Directory(std::filesystem::temp_directory_path() / name)
+		{
+			std::filesystem::remove_all(m_Directory);
+			std::filesystem::create_directories(m_Directory);
+			std::filesystem::current_path(m_Directory);
+
+			FileUtils::MakeFileWithContent("engine.ini", std::string("[Streaming]\nRecordAccessTrace = False\nPrefetch = False\n"));
+			EngineConfig::Reload();
+
+			MaterialDescription material;
+			material.m_BaseColor = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+
+			// Materials are stored compiled, definitions of models are packed next to the models
+			AddPack(EngineConfig::Get<ConfigKey_PathModel>(), "models0.pck", {
+				{ MODEL_NAME, ToBytes(TRIANGLE_FBX) },
+				{ std::string(MODEL_NAME) + ".matdef", ToBytes(std::string("Red=") + MATERIAL_NAME + "\n") } });
+			AddPack(EngineConfig::Get<ConfigKey_PathMaterial>(), "materials0.pck", {
+				{ MATERIAL_NAME, MaterialFormat::Compile(material) } });
+			AddPack(EngineConfig::Get<ConfigKey_PathShader>(), "shaders0.pck", {
+				{ VERTEX_SHADER_NAME, ToBytes(std::string("float4x4 world : ") + Shader::INSTANCE_SEMANTIC + ";\n") },
+				{ PIXEL_SHADER_NAME, ToBytes("float4 main() : SV_TARGET { return 1; }\n") } });
+
+			FileUtils::MakeFileWithContent("lookup.csv", m_Lookup);
+		}
+
+		~TestAssets()
+		{
+			std::error_code error;
+			std::filesystem::current_path(m_PreviousDirectory, error);
+			std::filesystem::remove_all(m_Directory, error);
+		}
+
+		TestAssets(const TestAssets&) = delete;
+		TestAssets& operator=(const TestAssets&) = delete;
+
+	private:
+		using Entry = std::pair<std::string, std::vector<uint8_t>>;
+
+		static std::vector<uint8_t> ToBytes(std::string_view text)
+		{
+			return std::vector<uint8_t>(text.begin(), text.end());
+		}
+
+		/*
+			Writes pack with the same header as AssetPackerWin32 and adds its entries to the lookup table
+		*/
+		void AddPack(const std::string& directory, const std::string& packName, const std::vector<Entry>& v_Entries)
+		{
+			static constexpr uint64_t RECORD_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+
+			std::vector<uint8_t> v_Pack(sizeof(uint32_t) + RECORD_SIZE * v_Entries.size());
+			uint32_t numFiles = (uint32_t)v_Entries.size();
+			memcpy(v_Pack.data(), &numFiles, sizeof(uint32_t));
+
+			for (uint32_t i = 0; i < numFiles; i++)
+			{
+				const std::vector<uint8_t>& v_Data = v_Entries[i].second;
+
+				// Starting positions are stored with +1 offset
+				uint64_t startPos = v_Pack.size() + 1;
+				uint32_t size = (uint32_t)v_Data.size();
+				memcpy(v_Pack.data() + sizeof(uint32_t) + RECORD_SIZE * i, &startPos, sizeof(uint64_t));
+				memcpy(v_Pack.data() + sizeof(uint32_t) + RECORD_SIZE * i + sizeof(uint64_t), &size, sizeof(uint32_t));
+				v_Pack.insert(v_Pack.end(), v_Data.begin(), v_Data.end());
+
+				std::ostringstream line;
+				line << v_Entries[i].first << ',' << packName << ',' << i << ',' << std::hex << FileUtils::HashData(v_Data) << std::dec << ',' << size << '\n';
+				m_Lookup += line.str();
+			}
+
+			std::filesystem::create_directories(directory);
+			FileUtils::MakeFileWithContent(FileUtils::CombinePaths(directory, packName), v_Pack);
+		}
+
+	private:
+		// Smallest ASCII FBX with a single triangle that uses material "Red"
+		static constexpr std::string_view TRIANGLE_FBX =
+			"; FBX 7.4.0 project file\n"
+			"FBXHeaderExtension:  {\n\tFBXHeaderVersion: 1003\n\tFBXVersion: 7400\n}\n"
+			"GlobalSettings:  {\n\tVersion: 1000\n}\n"
+			"Objects:  {\n"
+			"\tGeometry: 1000, \"Geometry::Triangle\", \"Mesh\" {\n"
+			"\t\tVertices: *9 {\n\t\t\ta: -1,-1,0,1,-1,0,0,1,0\n\t\t}\n"
+			"\t\tPolygonVertexIndex: *3 {\n\t\t\ta: 0,1,-3\n\t\t}\n"
+			"\t\tGeometryVersion: 124\n"
+			"\t\tLayerElementMaterial: 0 {\n\t\t\tVersion: 101\n\t\t\tName: \"\"\n\t\t\tMappingInformationType: \"AllSame\"\n"
+			"\t\t\tReferenceInformationType: \"IndexToDirect\"\n\t\t\tMaterials: *1 {\n\t\t\t\ta: 0\n\t\t\t}\n\t\t}\n"
+			"\t\tLayer: 0 {\n\t\t\tVersion: 100\n\t\t\tLayerElement:  {\n\t\t\t\tType: \"LayerElementMaterial\"\n\t\t\t\tTypedIndex: 0\n\t\t\t}\n\t\t}\n"
+			"\t}\n"
+			"\tModel: 2000, \"Model::Triangle\", \"Mesh\" {\n\t\tVersion: 232\n\t}\n"
+			"\tMaterial: 3000, \"Material::Red\", \"\" {\n\t\tVersion: 102\n\t\tShadingModel: \"phong\"\n\t}\n"
+			"}\n"
+			"Connections:  {\n\tC: \"OO\",1000,2000\n\tC: \"OO\",3000,2000\n\tC: \"OO\",2000,0\n}\n";
+
+	private:
+		std::filesystem::path m_PreviousDirectory;
+		std::filesystem::path m_Directory;
+		std::string m_Lookup;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include <Mesa/UploadRing.h>
+#include <gtest/gtest.h>
+
+namespace Mesa
+{
+	TEST(UploadRingTests, SlicesAreAlignedAndFollowEachOther)
+	{
+		UploadRing ring;
+		ring.Reset(4096);
+		ring.BeginFrame(0);
+
+		uint64_t first = 1, second = 1, third = 1;
+		ASSERT_TRUE(ring.Allocate(1, first));
+		ASSERT_TRUE(ring.Allocate(300, second));
+		ASSERT_TRUE(ring.Allocate(256, third));
+
+		EXPECT_EQ(first, 0u);
+		EXPECT_EQ(second, 256u);
+		EXPECT_EQ(third, 768u);
+		EXPECT_EQ(ring.GetFrameBytes(), 1024u);
+		EXPECT_EQ(ring.GetUsedBytes(), 1024u);
+	}
+
+	TEST(UploadRingTests, SliceSkipsEndOfBufferAndWraps)
+	{
+		UploadRing ring;
+		ring.Reset(4096);
+
+		uint64_t offset = 0;
+		ring.BeginFrame(0);
+		ASSERT_TRUE(ring.Allocate(2048, offset));
+		ring.EndFrame();
+
+		ring.BeginFrame(1);
+		ASSERT_TRUE(ring.Allocate(1536, offset));
+		EXPECT_EQ(offset, 2048u);
+		ring.EndFrame();
+
+		ring.ReleaseFrames(0);
+
+		// 512 bytes left at the end are too small, the slice starts at the beginning of the buffer
+		ring.BeginFrame(2);
+		ASSERT_TRUE(ring.Allocate(1024, offset));
+		EXPECT_EQ(offset, 0u);
+		EXPECT_EQ(ring.GetFrameBytes(), 512u + 1024u);
+		EXPECT_EQ(ring.GetUsedBytes(), 1536u + 512u + 1024u);
+
+		// Once every frame is released the ring starts again at the beginning
+		ring.EndFrame();
+		ring.ReleaseFrames(2);
+		ring.BeginFrame(3);
+		ASSERT_TRUE(ring.Allocate(4096, offset));
+		EXPECT_EQ(offset, 0u);
+		EXPECT_EQ(ring.GetFrameBytes(), 4096u);
+	}
+
+	TEST(UploadRingTests, ReleaseFreesOnlyCompletedFrames)
+	{
+		UploadRing ring;
+		ring.Reset(8192);
+
+		uint64_t offset = 0;
+
+		for (uint64_t frame = 0; frame < UploadRing::MAX_FRAMES_IN_FLIGHT; frame++)
+		{
+			ring.BeginFrame(frame);
+			ASSERT_TRUE(ring.Allocate(1024 * (frame + 1), offset));
+			ring.EndFrame();
+		}
+
+		EXPECT_EQ(ring.GetNumFramesInFlight(), 3u);
+		EXPECT_EQ(ring.GetUsedBytes(), 1024u + 2048u + 3072u);
+
+		// Fence of frame 1 signaled, frame 2 may still be read by the GPU
+		ring.ReleaseFrames(1);
+		EXPECT_EQ(ring.GetNumFramesInFlight(), 1u);
+		EXPECT_EQ(ring.GetOldestFrame(), 2u);
+		EXPECT_EQ(ring.GetUsedBytes(), 3072u);
+
+		// Frames without allocations are never in flight
+		ring.BeginFrame(3);
+		ring.EndFrame();
+		EXPECT_EQ(ring.GetNumFramesInFlight(), 1u);
+
+		ring.ReleaseFrames(3);
+		EXPECT_EQ(ring.GetNumFramesInFlight(), 0u);
+		EXPECT_EQ(ring.GetUsedBytes(), 0u);
+	}
+
+	TEST(UploadRingTests, FullRingFailsWithoutTakingSpace)
+	{
+		UploadRing ring;
+		ring.Reset(4096);
+
+		uint64_t offset = 0;
+		ring.BeginFrame(0);
+		ASSERT_TRUE(ring.Allocate(3072, offset));
+		ring.EndFrame();
+
+		ring.BeginFrame(1);
+		ASSERT_TRUE(ring.Allocate(512, offset));
+		EXPECT_FALSE(ring.Allocate(1024, offset));
+		EXPECT_FALSE(ring.Allocate(8192, offset));
+		EXPECT_EQ(ring.GetFrameBytes(), 512u);
+		EXPECT_EQ(ring.GetUsedBytes(), 3584u);
+
+		// Space of the frame in flight is available once it's released
+		ring.ReleaseFrames(0);
+		EXPECT_TRUE(ring.Allocate(1024, offset));
+	}
+
+	TEST(UploadRingTests, RollbackFreesSlicesOfFailedGroup)
+	{
+		UploadRing ring;
+		ring.Reset(10 * 1024);
+
+		uint64_t offset = 0;
+		ring.BeginFrame(0);
+		ASSERT_TRUE(ring.Allocate(7680, offset));
+		ring.EndFrame();
+
+		// Three streams of 1 KiB, the third one doesn't fit while frame 0 is in flight
+		ring.BeginFrame(1);
+		UploadRing::Checkpoint checkpoint = ring.GetCheckpoint();
+
+		ASSERT_TRUE(ring.Allocate(1024, offset));
+		ASSERT_TRUE(ring.Allocate(1024, offset));
+		ASSERT_FALSE(ring.Allocate(1024, offset));
+
+		ring.Rollback(checkpoint);
+		EXPECT_EQ(ring.GetFrameBytes(), 0u);
+		EXPECT_EQ(ring.GetUsedBytes(), 7680u);
+
+		// Retry after the fence of frame 0 takes only the streams
+		ring.ReleaseFrames(0);
+
+		for (uint64_t expected : { 0u, 1024u, 2048u })
+		{
+			ASSERT_TRUE(ring.Allocate(1024, offset));
+			EXPECT_EQ(offset, expected);
+		}
+
+		EXPECT_EQ(ring.GetFrameBytes(), 3072u);
+		EXPECT_EQ(ring.GetUsedBytes(), 3072u);
+	}
+
+	TEST(UploadRingTests, RollbackKeepsSlicesBeforeCheckpoint)
+	{
+		UploadRing ring;
+		ring.Reset(4096);
+
+		uint64_t offset = 0;
+		ring.BeginFrame(0);
+		ASSERT_TRUE(ring.Allocate(1024, offset));
+		ring.EndFrame();
+
+		ring.BeginFrame(1);
+		ASSERT_TRUE(ring.Allocate(2560, offset));
+		ring.EndFrame();
+		ring.ReleaseFrames(0);
+
+		ring.BeginFrame(2);
+		ASSERT_TRUE(ring.Allocate(256, offset));
+		EXPECT_EQ(offset, 3584u);
+
+		// First slice of the group skips the end of the buffer, the second one doesn't fit
+		UploadRing::Checkpoint checkpoint = ring.GetCheckpoint();
+		ASSERT_TRUE(ring.Allocate(1024, offset));
+		EXPECT_EQ(offset, 0u);
+		ASSERT_FALSE(ring.Allocate(256, offset));
+
+		// Skipped space is returned together with the slices
+		ring.Rollback(checkpoint);
+		EXPECT_EQ(ring.GetFrameBytes(), 256u);
+		EXPECT_EQ(ring.GetUsedBytes(), 2560u + 256u);
+
+		ASSERT_TRUE(ring.Allocate(256, offset));
+		EXPECT_EQ(offset, 3840u);
+	}
+}
\ No newline at end of file
@@ -2,7 +2,7 @@
 
 Sandbox::Sandbox()
 {
-	m_Camera.SetProjectionValues(60, mp_Window->GetWindowWidth()/(float)mp_Window->GetWindowHeight(), 0.01f, 1000.0f);
+	m_Camera.SetProjectionValues(60, GetAspectRatio(), 0.01f, 1000.0f);
 	mp_Graphics->SetCamera(&m_Camera);
 }
 
@@ -12,7 +12,7 @@ Sandbox::~Sandbox()
 
 void Sandbox::Run()
 {
-	while (mp_Window->Update())
+	while (Update())
 	{
 		ManageEvents();
 		mp_Graphics->DrawFrame(mp_Window);
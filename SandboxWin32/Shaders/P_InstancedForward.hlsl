@@ -0,0 +1,23 @@
+// Pixel shader of V_InstancedForward.hlsl, colors diffuse texture of the material with its base color
+
+cbuffer MaterialBuffer : register(b0)
+{
+    float4 baseColor;
+    float4 subColor;
+};
+
+Texture2D diffuseTexture : register(t0);
+SamplerState textureSampler : register(s0);
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float2 texCoord : TEXCOORD;
+    float3 normal : NORMAL;
+};
+
+float4 main(PSInput input) : SV_TARGET
+{
+    float4 color = diffuseTexture.Sample(textureSampler, input.texCoord) * baseColor;
+    return saturate(color + subColor);
+}
\ No newline at end of file
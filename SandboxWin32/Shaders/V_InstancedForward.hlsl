@@ -0,0 +1,44 @@
+// Forward color pass of objects drawn with instancing.
+// World matrix rows come from the instance buffer (INSTANCE_WORLD0-3), which makes the engine
+// draw all objects that share this shader, material, model and mesh with one draw call.
+// Model matrix of the MVP buffer is identity for instanced draws and isn't used.
+
+cbuffer MvpBuffer : register(b0)
+{
+    float4x4 model;
+    float4x4 view;
+    float4x4 proj;
+};
+
+struct VSInput
+{
+    float3 position : POSITION;
+    float2 texCoord : TEXCOORD;
+    float3 normal : NORMAL;
+    float4 world0 : INSTANCE_WORLD0;
+    float4 world1 : INSTANCE_WORLD1;
+    float4 world2 : INSTANCE_WORLD2;
+    float4 world3 : INSTANCE_WORLD3;
+};
+
+struct VSOutput
+{
+    float4 position : SV_POSITION;
+    float2 texCoord : TEXCOORD;
+    float3 normal : NORMAL;
+};
+
+VSOutput main(VSInput input)
+{
+    // Same matrix as model of the MVP buffer for objects drawn without instancing
+    float4x4 world = float4x4(input.world0, input.world1, input.world2, input.world3);
+
+    float4 worldPos = mul(float4(input.position, 1.0f), world);
+
+    VSOutput output;
+    output.position = mul(proj, mul(view, worldPos));
+    output.texCoord = input.texCoord;
+    output.normal = normalize(mul(input.normal, (float3x3)world));
+
+    return output;
+}
\ No newline at end of file